@@ -0,0 +1,106 @@
+#ifndef ASYNCSEQUENCECOMMANDHANDLER_H_
+#define ASYNCSEQUENCECOMMANDHANDLER_H_
+
+#include <giapi/giapi.h>
+#include <giapi/SequenceCommandHandler.h>
+#include <giapi/CompletionToken.h>
+
+#include <tr1/memory>
+
+namespace giapi {
+
+class AsyncSequenceCommandHandler;
+
+/**
+ * Definition of a smart pointer to an asynchronous sequence command
+ * handler.
+ */
+typedef std::tr1::shared_ptr<AsyncSequenceCommandHandler>
+		pAsyncSequenceCommandHandler;
+
+/**
+ * Sequence command handler for actions that take time to complete.
+ * <p/>
+ * Instead of answering STARTED, running the actions on a thread of its
+ * own and calling <code>CommandUtil::postCompletionInfo</code> at the
+ * end, an asynchronous handler only implements <code>start</code>,
+ * which returns a completion token. The GIAPI answers STARTED right
+ * away and, once the answer is sent, calls <code>start</code> on a pool
+ * of threads shared by all the asynchronous handlers, and posts
+ * COMPLETED or ERROR when the token is resolved. The completion
+ * information never reaches the GMP before STARTED, even for actions
+ * that are over when <code>start</code> returns. If <code>start</code> throws, ERROR is posted with the
+ * message of the exception.
+ * <p/>
+ * When the handler has a timeout, ERROR is posted if the token is not
+ * resolved in time after STARTED is sent; resolving the token
+ * later has no effect.
+ * <p/>
+ * The size of the pool is set by the <code>gmp.command.async.threads</code>
+ * property, 4 by default. Asynchronous handlers must be owned by a
+ * <code>pSequenceCommandHandler</code> or a
+ * <code>pAsyncSequenceCommandHandler</code>, as they are when they are
+ * subscribed through CommandUtil.
+ */
+class AsyncSequenceCommandHandler: public SequenceCommandHandler,
+		public std::tr1::enable_shared_from_this<AsyncSequenceCommandHandler> {
+public:
+
+	/**
+	 * Start the actions requested by a sequence command. Runs on one of
+	 * the threads of the shared pool, after STARTED has been answered.
+	 * The method may do all the work and return a resolved token, or
+	 * return a token that is resolved once the actions finish elsewhere.
+	 *
+	 * @param id the action id of the request
+	 * @param sequenceCommand the sequence command to handle
+	 * @param activity Activity requested by the sender, like START
+	 * @param config configuration associated to the command.
+	 *
+	 * @return a token resolved when the actions are over. A null token
+	 *         is reported as an error
+	 */
+	virtual pCompletionToken start(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) = 0;
+
+	/**
+	 * Answer STARTED. The call to <code>start</code> is queued after
+	 * the answer is sent. An ERROR response is returned if the handler
+	 * is not owned by a smart pointer, since the call can't be queued
+	 * then; if the actions can't be queued because the GIAPI is shutting
+	 * down, ERROR is posted as their completion information.
+	 */
+	virtual pHandlerResponse handle(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config);
+
+	/**
+	 * Milliseconds the actions have to complete, counted from the
+	 * moment STARTED is sent. Zero if there is no limit
+	 */
+	long getTimeout() const;
+
+	/**
+	 * Virtual destructor
+	 */
+	virtual ~AsyncSequenceCommandHandler();
+
+protected:
+	/**
+	 * Protected constructor. Instrument code needs to extend this class
+	 * and provide a concrete implementation of the <code>start</code>
+	 * method.
+	 *
+	 * @param timeout milliseconds the actions have to complete before
+	 *        an ERROR is posted for them. Zero for no limit
+	 */
+	AsyncSequenceCommandHandler(long timeout = 0);
+
+private:
+	long _timeout;
+};
+
+}
+
+#endif /* ASYNCSEQUENCECOMMANDHANDLER_H_ */
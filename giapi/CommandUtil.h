@@ -89,6 +89,10 @@ public:
 	 * when the actions complete successfully or with an error, notify the
 	 * GMP of the completion status of the actions associated with the
 	 * original <code>ActionId</code>, using this call.
+	 * <p/>
+	 * Handlers extending {@link AsyncSequenceCommandHandler} don't need
+	 * this call: the completion information of their actions is posted
+	 * when the completion token they return is resolved.
 	 *
 	 * @param id the original ActionId associated to the actions for which we
 	 *        are reporting completion info.
@@ -0,0 +1,81 @@
+#ifndef COMPLETIONTOKEN_H_
+#define COMPLETIONTOKEN_H_
+
+#include <string>
+#include <tr1/memory>
+
+namespace giapi {
+
+class CompletionToken;
+
+/**
+ * Definition of a smart pointer to a completion token
+ */
+typedef std::tr1::shared_ptr<CompletionToken> pCompletionToken;
+
+/**
+ * Promise of the end of the actions started by a sequence command.
+ * An asynchronous handler returns a completion token when it starts the
+ * actions, and resolves it, from any thread, when they are over. The
+ * GIAPI then posts the completion information to the GMP.
+ * <p/>
+ * A token is resolved only once: the first call to <code>complete</code>
+ * or <code>fail</code> counts, the others are ignored.
+ *
+ * @see AsyncSequenceCommandHandler
+ */
+class CompletionToken {
+public:
+	/**
+	 * Build a token to be resolved later
+	 */
+	static pCompletionToken create();
+
+	/**
+	 * Build a token already resolved as completed, for actions that
+	 * are over by the time the handler returns
+	 */
+	static pCompletionToken completed();
+
+	/**
+	 * Build a token already resolved as failed with the given message
+	 */
+	static pCompletionToken failed(const std::string &message);
+
+	/**
+	 * The actions completed successfully
+	 *
+	 * @return false if the token was resolved already
+	 */
+	virtual bool complete() = 0;
+
+	/**
+	 * The actions ended with an error.
+	 *
+	 * @param message description of the error. An empty message is
+	 *        replaced by a generic one, since the GMP requires one
+	 *
+	 * @return false if the token was resolved already
+	 */
+	virtual bool fail(const std::string &message) = 0;
+
+	/**
+	 * Return true once the token has been resolved
+	 */
+	virtual bool isResolved() const = 0;
+
+	/**
+	 * Virtual destructor
+	 */
+	virtual ~CompletionToken();
+
+protected:
+	/**
+	 * Tokens are built with the static factory methods
+	 */
+	CompletionToken();
+};
+
+}
+
+#endif /* COMPLETIONTOKEN_H_ */
@@ -19,6 +19,7 @@ namespace giapi {
  * This interface provides mechanisms to:
  * a) get the value associated to a given parameter (identified by key)
  * b) get all the keys present in the configuration.
+ * c) get the value of a parameter as a number or a boolean.
  */
 class Configuration {
 
@@ -29,21 +30,55 @@ public:
 	 *
 	 * @param key the name of the parameter whose value we need to retrieve
 	 *
-	 * @return the value associated to the given key or <code>NULL</code>
+	 * @return the value associated to the given key or an empty string
 	 *         if there is no value associated for the key in the current
-	 *         configuration.
+	 *         configuration. The reference is valid until the
+	 *         configuration is modified or destroyed.
 	 */
-	virtual const std::string  getValue(const std::string & key) = 0;
+	virtual const std::string & getValue(const std::string & key) const = 0;
 
 	/**
-	 * Return the keys contained in the configuration. If the configuration
-	 * does not contain any key, an empty vector is returned.
+	 * Return the keys contained in the configuration, sorted. If the
+	 * configuration does not contain any key, an empty vector is returned.
 	 *
 	 * @return a vector of strings representing the keys
 	 *         contained in the configuration. An empty list is returned
-	 *         if no keys are present.
+	 *         if no keys are present. The reference is valid until the
+	 *         configuration is modified or destroyed.
 	 */
-	virtual vector<std::string> getKeys() const = 0;
+	virtual const vector<std::string> & getKeys() const = 0;
+
+	/**
+	 * Get the value associated to the given key as a floating point
+	 * number. The value is parsed once, when it is set, not on every
+	 * request.
+	 *
+	 * @param key the name of the parameter
+	 * @param value set to the number if there is one
+	 *
+	 * @return false if there is no value for the key or it is not a
+	 *         number, in which case <code>value</code> is not changed
+	 */
+	virtual bool getDouble(const std::string & key, double & value) const = 0;
+
+	/**
+	 * Get the value associated to the given key as an integer, like
+	 * getDouble()
+	 *
+	 * @return false if there is no value for the key or it is not an
+	 *         integer
+	 */
+	virtual bool getInt(const std::string & key, int & value) const = 0;
+
+	/**
+	 * Get the value associated to the given key as a boolean, like
+	 * getDouble(). "true", "yes", "on" and "1" are true; "false", "no",
+	 * "off" and "0" are false, in any case.
+	 *
+	 * @return false if there is no value for the key or it is not a
+	 *         boolean
+	 */
+	virtual bool getBool(const std::string & key, bool & value) const = 0;
 
 	/**
 	 * Return the number of parameters contained in this configuration.
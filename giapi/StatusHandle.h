@@ -0,0 +1,85 @@
+#ifndef STATUSHANDLE_H_
+#define STATUSHANDLE_H_
+#include <tr1/memory>
+#include <string>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+
+namespace giapi {
+
+class StatusItem;
+class StatusUtil;
+
+/**
+ * A lightweight reference to a status item, obtained through
+ * {@link StatusUtil#getHandle()}.
+ * <p/>
+ * The status item is resolved once, when the handle is created. Setting
+ * and posting values through the handle goes straight to the status
+ * item, without looking it up by name, so handles are the preferred way
+ * to update status items in high rate loops.
+ * <p/>
+ * The template argument is the type of the values stored in the status
+ * item. Handles are available for int, double, float and std::string
+ * values, matching type::INT, type::DOUBLE, type::FLOAT and type::STRING
+ * status items.
+ * <p/>
+ * Handles are cheap to copy. A default constructed handle, or a handle
+ * obtained for a status item that doesn't exist, is not valid.
+ */
+template<class T> class StatusHandle {
+	friend class StatusUtil;
+public:
+	/**
+	 * Build an invalid handle, not associated to any status item
+	 */
+	StatusHandle();
+
+	/**
+	 * Return true if this handle refers to a status item
+	 */
+	bool isValid() const;
+
+	/**
+	 * Return the name of the status item referred by this handle, or
+	 * an empty string if the handle is not valid.
+	 */
+	const std::string & getName() const;
+
+	/**
+	 * Set the value of the status item. The status item is marked dirty
+	 * if the value is different from the current one.
+	 *
+	 * @param value the new value for the status item
+	 *
+	 * @return giapi::status::OK if the value was set correctly
+	 *         giapi::status::ERROR if the handle is not valid.
+	 */
+	int set(const T &value);
+
+	/**
+	 * Post the status item to Gemini. The status will be sent only if
+	 * it has changed since the last time it was posted.
+	 *
+	 * @return giapi::status::OK if the post succeeds.
+	 *         giapi::status::ERROR if the handle is not valid or
+	 *         if the status item is not posted since it has not
+	 *         changed since the last time it was posted
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to execute the post.
+	 */
+	int post() throw (GiapiException);
+
+private:
+	explicit StatusHandle(const std::tr1::shared_ptr<StatusItem> &item);
+
+	/**
+	 * The status item this handle refers to
+	 */
+	std::tr1::shared_ptr<StatusItem> _item;
+};
+
+}
+#endif /*STATUSHANDLE_H_*/
@@ -0,0 +1,149 @@
+#ifndef STATUSKEY_H_
+#define STATUSKEY_H_
+
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+#include <giapi/giapi.h>
+
+namespace giapi {
+
+/**
+ * The kinds of status items a StatusKey can refer to
+ */
+namespace kind {
+	/**
+	 * A status item that only holds a value
+	 */
+	struct Basic {
+	};
+	/**
+	 * A status item that holds a value and an alarm state
+	 */
+	struct Alarm {
+	};
+	/**
+	 * A health status item. Its values are health::Health
+	 */
+	struct Health {
+	};
+}
+
+template<class T> class StatusHandle;
+class StatusUtil;
+
+/**
+ * The status item type that holds values of type T. Only defined for
+ * the types a status item can hold.
+ */
+template<class T> struct StatusValueType;
+
+template<> struct StatusValueType<int> {
+	static const type::Type TYPE = type::INT;
+};
+
+template<> struct StatusValueType<double> {
+	static const type::Type TYPE = type::DOUBLE;
+};
+
+template<> struct StatusValueType<float> {
+	static const type::Type TYPE = type::FLOAT;
+};
+
+template<> struct StatusValueType<std::string> {
+	static const type::Type TYPE = type::STRING;
+};
+
+template<> struct StatusValueType<health::Health> {
+	static const type::Type TYPE = type::INT;
+};
+
+/**
+ * The name of a status item together with the type of its values and
+ * its kind, known at compile time.
+ * <p/>
+ * Keys are meant to be declared once, as constants, and used instead of
+ * the name in the StatusUtil calls. Using a key with a value of the
+ * wrong type, or an alarm call with a key that is not an alarm, fails
+ * to compile instead of returning giapi::status::ERROR.
+ * <p/>
+ * Example:
+ * <pre>
+ * constexpr StatusKey&lt;double, kind::Alarm&gt; TEMPERATURE("gpi:temperature");
+ * StatusUtil::createStatusItem(TEMPERATURE);
+ * StatusUtil::setValue(TEMPERATURE, 12.5);
+ * StatusUtil::setAlarm(TEMPERATURE, alarm::ALARM_WARNING, alarm::ALARM_CAUSE_HI);
+ * </pre>
+ * Health keys hold health::Health values:
+ * <code>StatusKey&lt;health::Health, kind::Health&gt;</code>.
+ * <p/>
+ * The first value set through a key binds the key to its status item,
+ * as a StatusHandle does. Later values go straight to the item, with no
+ * lookup by name and no check of its type.
+ */
+template<class T, class K = kind::Basic> class StatusKey {
+	static_assert(std::is_same<K, kind::Health>::value
+			== std::is_same<T, health::Health>::value,
+			"health status keys, and only them, hold health::Health values");
+public:
+	/**
+	 * The type of the values set through this key
+	 */
+	typedef T ValueType;
+
+	/**
+	 * The kind of the status item
+	 */
+	typedef K Kind;
+
+	/**
+	 * The type of the status item
+	 */
+	static const type::Type TYPE = StatusValueType<T>::TYPE;
+
+	/**
+	 * Build a key for the status item with the given name. The name
+	 * is not copied, it must outlive the key.
+	 */
+	constexpr explicit StatusKey(const char *name) :
+		_name(name), _handle(nullptr) {
+	}
+
+	/**
+	 * Copy a key. The copy is bound to the status item on its own
+	 */
+	constexpr StatusKey(const StatusKey &key) :
+		_name(key._name), _handle(nullptr) {
+	}
+
+	/**
+	 * Return the name of the status item
+	 */
+	constexpr const char * getName() const {
+		return _name;
+	}
+
+	/**
+	 * Return true once the key is bound to its status item
+	 */
+	bool isResolved() const {
+		return _handle.load(std::memory_order_acquire) != nullptr;
+	}
+
+private:
+	friend class StatusUtil;
+
+	const char *_name;
+
+	/**
+	 * The handle of the status item, set by StatusUtil the first time
+	 * a value is set through the key. Handles are kept by the library
+	 * for the life of the process
+	 */
+	mutable std::atomic<StatusHandle<T> *> _handle;
+};
+
+}
+
+#endif /* STATUSKEY_H_ */
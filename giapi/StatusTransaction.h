@@ -0,0 +1,66 @@
+#ifndef STATUSTRANSACTION_H_
+#define STATUSTRANSACTION_H_
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+
+namespace giapi {
+
+/**
+ * Stages the status changes made by the current thread while it's in
+ * scope, so they are applied and posted together. It starts a
+ * transaction with StatusUtil::beginTransaction() when built, and
+ * aborts it when destroyed unless commit() was called.
+ * <p/>
+ * Example:
+ * <pre>
+ * {
+ *     StatusTransaction transaction;
+ *     StatusUtil::setValueAsDouble("gpi:filter:position", 12.5);
+ *     StatusUtil::setValueAsString("gpi:filter:state", "MOVING");
+ *     transaction.commit();
+ * }
+ * </pre>
+ */
+class StatusTransaction {
+public:
+	/**
+	 * Start a status transaction in this thread. Check isOpen(): there
+	 * can't be two of them open in the same thread.
+	 */
+	StatusTransaction();
+
+	/**
+	 * Discard the staged changes if the transaction wasn't committed
+	 */
+	~StatusTransaction();
+
+	/**
+	 * Return true if this object started a transaction that is still
+	 * open
+	 */
+	bool isOpen() const;
+
+	/**
+	 * Apply the staged changes and post them together. See
+	 * StatusUtil::commitTransaction()
+	 *
+	 * @return giapi::status::OK if the changes were applied and posted,
+	 *         giapi::status::ERROR if the transaction is not open or
+	 *         any of the changes couldn't be applied.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	int commit() throw (GiapiException);
+
+private:
+	bool _open;
+
+	StatusTransaction(const StatusTransaction &);
+	StatusTransaction & operator=(const StatusTransaction &);
+};
+
+}
+
+#endif /* STATUSTRANSACTION_H_ */
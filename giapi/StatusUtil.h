@@ -1,12 +1,305 @@
 #ifndef STATUSUTIL_H_
 #define STATUSUTIL_H_
+#include <functional>
 #include <string>
+#include <vector>
 
 #include <giapi/giapi.h>
 #include <giapi/giapiexcept.h>
+#include <giapi/StatusHandle.h>
+#include <giapi/StatusKey.h>
 //$Id$
 namespace giapi {
 
+/**
+ * Counters of the asynchronous status post. See
+ * StatusUtil::setAsyncPost()
+ */
+struct AsyncPostStatistics {
+	/**
+	 * Status items waiting to be sent
+	 */
+	unsigned long queueDepth;
+	/**
+	 * Status items posted through the GMP connection. Items the
+	 * connection skipped or failed to send are not counted
+	 */
+	unsigned long sent;
+	/**
+	 * Posts of status items that couldn't be queued because the
+	 * queue was full. The status items stay pending for the next post.
+	 */
+	unsigned long dropped;
+	/**
+	 * Posts of status items that were already queued. Only the latest
+	 * value of the status item is sent.
+	 */
+	unsigned long coalesced;
+};
+
+/**
+ * Timing of the periodic status post. See StatusUtil::startAutoPost().
+ * Times are in milliseconds.
+ */
+struct AutoPostStatistics {
+	/**
+	 * Posts done
+	 */
+	unsigned long posts;
+	/**
+	 * Posts skipped because the previous one took longer than the
+	 * period
+	 */
+	unsigned long overruns;
+	/**
+	 * Average and maximum delay of the posts after their scheduled time
+	 */
+	double meanJitter;
+	double maxJitter;
+	/**
+	 * Longest time taken by a post
+	 */
+	double maxPostTime;
+};
+
+/**
+ * Counters of one of the sinks the status items are published to,
+ * when several are configured. See StatusUtil::getSinkStatistics().
+ * Times are in milliseconds.
+ */
+struct StatusSinkStatistics {
+	/**
+	 * Name of the sink, as configured: "jms", "log" or "journal"
+	 */
+	std::string name;
+	/**
+	 * Posts waiting to be handed over to the sink
+	 */
+	unsigned long queueDepth;
+	/**
+	 * Posts the sink sent. Posts the sink failed to send are not
+	 * counted
+	 */
+	unsigned long sent;
+	/**
+	 * Posts discarded because the queue of the sink was full
+	 */
+	unsigned long dropped;
+	/**
+	 * Posts merged with a post of the same status item that was
+	 * still queued
+	 */
+	unsigned long coalesced;
+	/**
+	 * Posts that had to wait for room in the queue of the sink
+	 */
+	unsigned long blocked;
+	/**
+	 * How long the oldest queued post has been waiting
+	 */
+	double lag;
+	/**
+	 * Average and maximum time from the post to its hand over to
+	 * the sink
+	 */
+	double meanLatency;
+	double maxLatency;
+};
+
+/**
+ * Distribution of the time taken by an operation, in microseconds.
+ * Bucket 0 counts the operations that took less than a microsecond,
+ * and bucket i those that took from 2^(i-1) to 2^i microseconds. The
+ * last bucket counts everything longer.
+ */
+struct LatencyStatistics {
+	unsigned long count;
+	double meanLatency;
+	double maxLatency;
+	std::vector<unsigned long> buckets;
+};
+
+/**
+ * Counters of a status sender. See StatusUtil::getStatistics()
+ */
+struct StatusSenderStatistics {
+	/**
+	 * Type of the sender: "log", "jms", "shared", "journal" or
+	 * "composite". The queue of the asynchronous sender has its own
+	 * statistics, see StatusUtil::getAsyncPostStatistics()
+	 */
+	std::string name;
+	/**
+	 * Status items dispatched, on their own or in batches
+	 */
+	unsigned long posts;
+	/**
+	 * Batches dispatched
+	 */
+	unsigned long batches;
+	/**
+	 * Posts of status items that had not changed since they were
+	 * last posted, and were not dispatched
+	 */
+	unsigned long unchanged;
+	/**
+	 * Posts deferred by the maximum post rate of the status item
+	 */
+	unsigned long throttled;
+	/**
+	 * Dispatches that failed
+	 */
+	unsigned long errors;
+	/**
+	 * Bytes serialized, by the senders that serialize the items
+	 */
+	unsigned long bytes;
+	/**
+	 * Time taken by each dispatch of an item or a batch
+	 */
+	LatencyStatistics latency;
+};
+
+/**
+ * Counters of a status item. See StatusUtil::getStatistics()
+ */
+struct StatusItemStatistics {
+	std::string name;
+	/**
+	 * Times the value or alarm state of the item changed
+	 */
+	unsigned long updates;
+	/**
+	 * Times the item was dispatched by a status sender
+	 */
+	unsigned long posts;
+	/**
+	 * Average posts per second since the statistics started
+	 */
+	double postRate;
+};
+
+/**
+ * What the status publishing has done since the process started.
+ * See StatusUtil::getStatistics()
+ */
+struct StatusStatistics {
+	/**
+	 * Seconds since the statistics started
+	 */
+	double elapsed;
+	/**
+	 * Changes of all the status items
+	 */
+	unsigned long updates;
+	/**
+	 * Operations on status items that don't exist
+	 */
+	unsigned long unknownItems;
+	/**
+	 * The status senders created so far
+	 */
+	std::vector<StatusSenderStatistics> senders;
+	/**
+	 * All the status items, in the order they were created
+	 */
+	std::vector<StatusItemStatistics> items;
+};
+
+/**
+ * Limits on how often a status item is published. See
+ * StatusUtil::setPublishPolicy()
+ */
+struct PublishPolicy {
+	/**
+	 * Changes of the value smaller or equal than this amount
+	 * don't make the status item pending. Zero disables it.
+	 */
+	double absoluteDeadband;
+	/**
+	 * Changes of the value smaller or equal than this fraction of
+	 * the last published value don't make the status item pending.
+	 * Zero disables it.
+	 */
+	double relativeDeadband;
+	/**
+	 * Maximum number of posts per second. Zero means no limit.
+	 */
+	double maxRate;
+
+	PublishPolicy() :
+		absoluteDeadband(0), relativeDeadband(0), maxRate(0) {
+	}
+};
+
+/**
+ * Describes a status item to be created by
+ * StatusUtil::createStatusItems()
+ */
+struct StatusItemSpec {
+	/**
+	 * The kind of status item
+	 */
+	enum Kind {
+		BASIC, ALARM, HEALTH
+	};
+
+	std::string name;
+	Kind kind;
+	/**
+	 * Type of the values. Health status items are always type::INT
+	 */
+	type::Type type;
+
+	StatusItemSpec(const std::string &name, Kind kind = BASIC,
+			type::Type type = type::INT) :
+		name(name), kind(kind), type(type) {
+	}
+};
+
+/**
+ * A change of a status item, as delivered to the observers registered
+ * with StatusUtil::addObserver()
+ */
+struct StatusChange {
+	/**
+	 * Name of the status item. Valid for as long as the status item
+	 * exists.
+	 */
+	const char *name;
+	/**
+	 * Type of the value. Only the matching member below is set.
+	 */
+	type::Type type;
+	int intValue;
+	double doubleValue;
+	float floatValue;
+	std::string stringValue;
+	/**
+	 * When the status item changed, in milliseconds since the epoch
+	 */
+	long64 timestamp;
+	/**
+	 * Alarm state, only for alarm status items
+	 */
+	bool isAlarm;
+	alarm::Severity severity;
+	alarm::Cause cause;
+	std::string message;
+
+	StatusChange() :
+		name(0), type(type::INT), intValue(0), doubleValue(0),
+				floatValue(0), timestamp(0), isAlarm(false),
+				severity(alarm::ALARM_OK), cause(alarm::ALARM_CAUSE_OK) {
+	}
+};
+
+/**
+ * Callback invoked when a status item changes. See
+ * StatusUtil::addObserver()
+ */
+typedef std::function<void(const StatusChange &)> StatusObserver;
+
 /**
  * A collection of utility mechanisms to handle status information and
  * alarms in the GIAPI.
@@ -60,6 +353,59 @@ public:
 	 */
 	static int createHealthStatusItem(const std::string &name);
 
+	/**
+	 * Create an array status item, holding a fixed number of values
+	 * of the same type that are published together, like a
+	 * temperature profile. The storage for the values is allocated
+	 * now; updates only copy values into it.
+	 *
+	 * @param name Name of the array status item
+	 * @param type Type of the elements. Only type::INT, type::DOUBLE
+	 *        and type::FLOAT are supported.
+	 * @param length Number of elements in the array, initially zero
+	 * @param rangeUpdates if true, each post carries only the range of
+	 *        elements changed since the previous post, and subscribers
+	 *        are expected to keep the rest. By default each post carries
+	 *        the whole array.
+	 *
+	 * @return giapi::status::OK if the item was successfully created,
+	 *         giapi::status::ERROR if the type is not supported, the
+	 *         length is zero or there is already a status item with the
+	 *         same name.
+	 */
+	static int createArrayStatusItem(const std::string &name,
+			const type::Type type, size_t length, bool rangeUpdates = false);
+
+	/**
+	 * Create several status items at once. The storage for all of them
+	 * is reserved up front, so this is much faster than creating them
+	 * one by one when there are thousands of them.
+	 *
+	 * @param items the status items to create, in order
+	 *
+	 * @return giapi::status::OK if all the items were created,
+	 *         giapi::status::ERROR if any of them couldn't be created,
+	 *         because there is already a status item with the same name.
+	 *         The other items are created anyway.
+	 */
+	static int createStatusItems(const std::vector<StatusItemSpec> &items);
+
+	/**
+	 * Create the status items listed in a manifest file. The manifest
+	 * is an XML file with a SimpleChannel, AlarmChannel or HealthChannel
+	 * element per status item, each one with a giapiname element and,
+	 * except for health items, a type element (INT, DOUBLE, FLOAT or
+	 * STRING). Other elements are ignored. See src/examples/stresstest.xml
+	 *
+	 * @param manifestPath path to the manifest file
+	 *
+	 * @return giapi::status::OK if all the items were created,
+	 *         giapi::status::ERROR if the manifest can't be read or has
+	 *         errors, in which case no item is created, or if any of the
+	 *         items couldn't be created.
+	 */
+	static int createStatusItems(const std::string &manifestPath);
+
 	/**
 	 * Post all pending status to Gemini. Pending statuses are those
 	 * whose value has changed since last time posted by GIAPI.
@@ -90,6 +436,442 @@ public:
 	 */
 	static int postStatus(const std::string &name) throw (GiapiException);
 
+	/**
+	 * Limit how often the given status item is published, for items
+	 * that change on every sample, like temperatures or positions.
+	 * <p/>
+	 * A deadband applies to numeric status items: new values that differ
+	 * from the last published one by no more than the deadband are stored,
+	 * but don't make the status item pending.
+	 * <p/>
+	 * A maximum rate applies to any status item: a post that comes too
+	 * soon after the previous one is deferred, and the latest value of the
+	 * status item is sent as soon as the interval expires.
+	 *
+	 * @param name The name of the status item
+	 * @param policy The deadbands and maximum rate for the status item.
+	 *        A default constructed PublishPolicy removes any limit.
+	 *
+	 * @return giapi::status::OK if the policy was set,
+	 *         giapi::status::ERROR if there is no status item associated
+	 *         to the <code>name</code>, if any of the limits is negative or
+	 *         if a deadband is requested for a string or array status
+	 *         item.
+	 */
+	static int setPublishPolicy(const std::string &name,
+			const PublishPolicy &policy);
+
+	/**
+	 * Start a status transaction on the calling thread. Until the
+	 * transaction is committed, the values, alarms and health set by
+	 * this thread, either by name or through handles, are only staged:
+	 * the status items don't change and can't be posted.
+	 * <p/>
+	 * Use it for status items that must reach Gemini together, like the
+	 * position, state and target of a mechanism. See also
+	 * StatusTransaction, which does the same in a scope.
+	 *
+	 * @return giapi::status::OK if the transaction was started,
+	 *         giapi::status::ERROR if this thread has one open already.
+	 */
+	static int beginTransaction();
+
+	/**
+	 * Apply the changes staged since beginTransaction(), all of them with
+	 * the same timestamp, and post the status items that changed in a
+	 * single message, no matter the batch mode. The transaction is closed.
+	 *
+	 * @return giapi::status::OK if the changes were applied and posted,
+	 *         giapi::status::ERROR if there is no transaction open in this
+	 *         thread, or if any of the changes couldn't be applied. The
+	 *         other changes are applied and posted anyway.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status. The status items stay pending for
+	 *         the next post.
+	 */
+	static int commitTransaction() throw (GiapiException);
+
+	/**
+	 * Discard the changes staged since beginTransaction() and close
+	 * the transaction. Does nothing if there is no transaction open
+	 * in this thread.
+	 */
+	static void abortTransaction();
+
+	/**
+	 * Select how postStatus() dispatches the pending status items. In
+	 * batch mode all the pending items are packed into a single message
+	 * to the GMP, so one post means one send. By default, each
+	 * pending status item is sent in its own message.
+	 *
+	 * @param batch true to enable the batch mode, false to send one
+	 *        message per status item.
+	 *
+	 * @return giapi::status::OK if the mode was set
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int setBatchPost(bool batch) throw (GiapiException);
+
+	/**
+	 * Select whether postStatus() sends the pending status items
+	 * itself, or leaves them to a background thread.
+	 * <p/>
+	 * In asynchronous mode postStatus() only queues the pending status
+	 * items and returns immediately; a publisher thread sends them
+	 * to the GMP. A status item posted again while it is still queued
+	 * is sent only once, with its latest value. The queue is bounded:
+	 * if it's full the post returns giapi::status::ERROR and the status
+	 * items remain pending for the next post.
+	 * <p/>
+	 * By default, posts are synchronous.
+	 *
+	 * @param async true to post from a background thread, false to
+	 *        post on the caller's thread.
+	 *
+	 * @return giapi::status::OK if the mode was set
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int setAsyncPost(bool async) throw (GiapiException);
+
+	/**
+	 * Wait until the status items queued by an asynchronous post, or
+	 * by the sinks configured in gmp.properties, have been sent.
+	 * Returns immediately if posts are synchronous.
+	 *
+	 * @param timeout maximum time to wait, in milliseconds. Zero waits
+	 *        for as long as needed.
+	 *
+	 * @return giapi::status::OK if all the queued status items were
+	 *         sent, giapi::status::ERROR if the timeout expired first.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int flushStatus(long timeout = 0) throw (GiapiException);
+
+	/**
+	 * Get the counters of the asynchronous post.
+	 *
+	 * @param stats where the counters are stored
+	 *
+	 * @return giapi::status::OK if the counters were stored,
+	 *         giapi::status::ERROR if posts are synchronous.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int getAsyncPostStatistics(AsyncPostStatistics &stats)
+			throw (GiapiException);
+
+	/**
+	 * Get the counters of each of the sinks the status items are
+	 * published to. Sinks are configured in gmp.properties:
+	 * <pre>
+	 * gmp.status.sinks=jms,journal
+	 * gmp.status.sink.journal.policy=drop-oldest
+	 * gmp.status.sink.journal.capacity=65536
+	 * gmp.status.journal.path=/var/log/gpi-status.journal
+	 * </pre>
+	 * The sinks are "jms" (the GMP), "journal" (a status journal file)
+	 * and "log". Each sink has its own queue and thread, so a slow sink doesn't
+	 * delay the others. When its queue is full, a sink either blocks
+	 * the post ("block"), discards the oldest queued post
+	 * ("drop-oldest"), or, the default, keeps only the latest value
+	 * of each queued status item and discards new ones ("coalesce").
+	 *
+	 * @param stats where the counters are stored, one per sink
+	 *
+	 * @return giapi::status::OK if the counters were stored,
+	 *         giapi::status::ERROR if no sinks are configured.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int getSinkStatistics(std::vector<StatusSinkStatistics> &stats)
+			throw (GiapiException);
+
+	/**
+	 * Take a snapshot of the counters kept while publishing status:
+	 * updates and posts of each status item, and posts, skipped
+	 * posts, bytes and latency of each status sender. Counting is
+	 * cheap enough to be always on.
+	 *
+	 * @param stats where the snapshot is stored
+	 *
+	 * @return giapi::status::OK
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int getStatistics(StatusStatistics &stats) throw (GiapiException);
+
+	/**
+	 * Write a snapshot of the counters returned by getStatistics()
+	 * to a text file, replacing it if it exists.
+	 *
+	 * @param path name of the file
+	 *
+	 * @return giapi::status::OK if the file was written,
+	 *         giapi::status::ERROR otherwise.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int dumpStatistics(const std::string &path) throw (GiapiException);
+
+	/**
+	 * Post the pending status items periodically from a background
+	 * thread, so the instrument doesn't need to call postStatus().
+	 * <p/>
+	 * Posts are scheduled at fixed times on a monotonic clock, so a
+	 * late post doesn't delay the following ones. Posts that should
+	 * have started while the previous one was still running are
+	 * skipped and counted as overruns. The posts go through the same
+	 * sender as postStatus(), with its batch, asynchronous and rate
+	 * limiting modes. If already started, only the period changes.
+	 *
+	 * @param periodMs time between posts, in milliseconds
+	 *
+	 * @return giapi::status::OK if the posts were started,
+	 *         giapi::status::ERROR if the period is not positive.
+	 *
+	 * @throws GiapiException in case there is a problem with the underlying
+	 *         mechanisms to post status.
+	 */
+	static int startAutoPost(long periodMs) throw (GiapiException);
+
+	/**
+	 * Stop the periodic post started by startAutoPost(). The periods
+	 * set for status items and groups are kept.
+	 *
+	 * @return giapi::status::OK
+	 */
+	static int stopAutoPost();
+
+	/**
+	 * Post the given status item at its own period instead of the
+	 * one given to startAutoPost(). Same as a group with the name of
+	 * the status item as its only member.
+	 *
+	 * @param name name of the status item
+	 * @param periodMs time between posts of the status item, in
+	 *        milliseconds. Zero goes back to the default period.
+	 *
+	 * @return giapi::status::OK if the period was set,
+	 *         giapi::status::ERROR if there is no such status item,
+	 *         it belongs to a group, or the period is negative.
+	 */
+	static int setAutoPostPeriod(const std::string &name, long periodMs);
+
+	/**
+	 * Post the given status items together, at their own period
+	 * instead of the one given to startAutoPost(). A group with the
+	 * same name is replaced.
+	 *
+	 * @param group name of the group
+	 * @param items names of the status items in the group
+	 * @param periodMs time between posts of the group, in
+	 *        milliseconds. Zero removes the group.
+	 *
+	 * @return giapi::status::OK if the period was set,
+	 *         giapi::status::ERROR if any of the status items doesn't
+	 *         exist or is in another group, or the period is negative.
+	 */
+	static int setAutoPostGroup(const std::string &group,
+			const std::vector<std::string> &items, long periodMs);
+
+	/**
+	 * Get the timing of the periodic post.
+	 *
+	 * @param stats where the timing is stored
+	 * @param group the group, or the status item given its own period.
+	 *        Empty for the default period.
+	 *
+	 * @return giapi::status::OK if the timing was stored,
+	 *         giapi::status::ERROR if there is no such group.
+	 */
+	static int getAutoPostStatistics(AutoPostStatistics &stats,
+			const std::string &group = "");
+
+	/**
+	 * Share the status items with other processes of the instrument
+	 * through a named POSIX shared memory segment, created by the first
+	 * process that attaches to it.
+	 * <p/>
+	 * From then on, postStatus() stores the pending status items in the
+	 * segment instead of sending them. One of the processes attached to
+	 * the segment is elected to send the status items posted by all of
+	 * them to the GMP, so only that process connects to the broker. If
+	 * it exits, another one takes over.
+	 *
+	 * @param segment the name of the shared memory segment, starting
+	 *        with '/', like "/gpi-status". All the processes of the
+	 *        instrument must use the same name.
+	 * @param capacity maximum number of status items in the segment.
+	 *        Only used by the process that creates the segment.
+	 *
+	 * @return giapi::status::OK if the process is attached to the segment
+	 *
+	 * @throws GiapiException if the segment can't be created or attached
+	 */
+	static int attachSharedStatus(const std::string &segment,
+			int capacity = 4096) throw (GiapiException);
+
+	/**
+	 * Record every status item posted from now on in a journal file,
+	 * a compact binary log that can be replayed later with
+	 * replayJournal(). Records are appended to the file if it's a
+	 * journal already.
+	 *
+	 * @param path the journal file
+	 * @param publish true to keep sending the status items to the GMP
+	 *        and record what was sent. False to record them only, with
+	 *        no connection to the GMP.
+	 *
+	 * @return giapi::status::OK if the posts are being recorded,
+	 *         giapi::status::ERROR if the sender in use can't record
+	 *
+	 * @throws GiapiException if the file can't be opened or is not a
+	 *         journal
+	 */
+	static int startJournal(const std::string &path, bool publish = true)
+			throw (GiapiException);
+
+	/**
+	 * Stop recording the posts and close the journal. If the posts
+	 * were only being recorded, they go to the GMP again.
+	 */
+	static int stopJournal();
+
+	/**
+	 * Post the status items recorded in a journal again, through the
+	 * sender in use. The status items of the journal are not created
+	 * in this process: only their posts are reproduced.
+	 *
+	 * @param path the journal file
+	 * @param speed how fast the records are posted compared to the time
+	 *        between them when they were recorded. 1 keeps the original
+	 *        pace; zero or less posts them as fast as possible.
+	 *
+	 * @return the number of status items posted
+	 *
+	 * @throws GiapiException if the journal can't be read or posting
+	 *         fails
+	 */
+	static int replayJournal(const std::string &path, double speed = 1.0)
+			throw (GiapiException);
+
+	/**
+	 * Create the status table of the process, for instruments with
+	 * tens of thousands of status items. The items of the table are
+	 * stored column by column instead of as objects, take a fraction
+	 * of the memory, and are referred to by the id returned when they
+	 * are created.
+	 * <p/>
+	 * Table items are apart from the status items created by name:
+	 * handles, keys, observers and transactions don't see them, and
+	 * they are posted with postStatusTable() only.
+	 *
+	 * @param capacity maximum number of items in the table
+	 *
+	 * @return giapi::status::OK if the table was created
+	 *         giapi::status::ERROR if there is a table already
+	 *
+	 * @throws GiapiException if the capacity is zero
+	 */
+	static int createStatusTable(size_t capacity) throw (GiapiException);
+
+	/**
+	 * Create an item in the status table
+	 *
+	 * @param kind what the item holds besides its value. Health items
+	 *        hold health::Health values and ignore <code>type</code>
+	 *
+	 * @return the id of the item, or giapi::status::ERROR if there is
+	 *         no table, the table is full, the type is not supported or
+	 *         there is an item with the same name
+	 */
+	static int createTableItem(const std::string &name,
+			StatusItemSpec::Kind kind = StatusItemSpec::BASIC,
+			type::Type type = type::INT);
+
+	/**
+	 * Return the id of the named item of the status table, or
+	 * giapi::status::ERROR if there is none
+	 */
+	static int findTableItem(const std::string &name);
+
+	/**
+	 * Set the value of an item of the status table. The item is
+	 * posted by the next postStatusTable() if the value changed.
+	 *
+	 * @return giapi::status::OK if the value was set
+	 *         giapi::status::ERROR if there is no table, no such item
+	 *         or it doesn't hold values of this type
+	 */
+	static int setTableValue(int id, int value);
+	static int setTableValue(int id, double value);
+	static int setTableValue(int id, float value);
+	static int setTableValue(int id, const std::string &value);
+
+	/**
+	 * Set the alarm state of an alarm item of the status table
+	 *
+	 * @see setAlarm()
+	 */
+	static int setTableAlarm(int id, alarm::Severity severity,
+			alarm::Cause cause, const std::string &message = std::string());
+
+	/**
+	 * Clear the alarm state of an alarm item of the status table
+	 */
+	static int clearTableAlarm(int id);
+
+	/**
+	 * Set the health of a health item of the status table
+	 */
+	static int setTableHealth(int id, health::Health health);
+
+	/**
+	 * Post the items of the status table that changed since they were
+	 * last posted, together in one message through the default status
+	 * sender. Alarm and health items get the message sent ahead of the
+	 * rest. Items that are not sent stay changed for the next call.
+	 *
+	 * @return giapi::status::OK if the post succeeds, also when nothing
+	 *         changed
+	 *         giapi::status::ERROR if there is no table, or the sender
+	 *         can't post tables, as the composite sender
+	 *
+	 * @throws GiapiException if there is a problem with the
+	 *         underlying mechanisms to execute the post
+	 */
+	static int postStatusTable() throw (GiapiException);
+
+	/**
+	 * Get a handle to the given status item. Values set and posted
+	 * through the handle go straight to the status item, with no
+	 * lookup by name. The template argument must match the type
+	 * of the status item: int for type::INT, double for type::DOUBLE,
+	 * float for type::FLOAT and std::string for type::STRING.
+	 * <p/>
+	 * Example: <code>StatusHandle&lt;int&gt; h =
+	 * StatusUtil::getHandle&lt;int&gt;("gpi:filter");</code>
+	 *
+	 * @param name Name of the status item
+	 *
+	 * @return a handle to the status item. The handle is not valid if
+	 *         there is no status item associated to the <code>name</code>
+	 *         or if the type of the status item doesn't match the type
+	 *         of the handle.
+	 */
+	template<class T> static StatusHandle<T> getHandle(const std::string &name);
+
 	/**
 	 * Set the value of the given status item to the provided
 	 * integer value.
@@ -152,6 +934,29 @@ public:
 	 */
 	static int setValueAsFloat(const std::string &name, float value);
 
+	/**
+	 * Copy <code>count</code> values into the given array status item,
+	 * starting at element <code>offset</code>. The item becomes pending
+	 * only if any of the values changed.
+	 *
+	 * @param name Name of the array status item
+	 * @param offset Index of the first element to set
+	 * @param values The new values
+	 * @param count Number of values to set
+	 *
+	 * @return giapi::status::OK if the values were set correctly
+	 *         giapi::status::ERROR if there is no array status item
+	 *         associated to the <code>name</code>, if the type of the
+	 *         values is not the type of the array, or if the range
+	 *         doesn't fit in the array.
+	 */
+	static int setArrayValues(const std::string &name, size_t offset,
+			const int *values, size_t count);
+	static int setArrayValues(const std::string &name, size_t offset,
+			const double *values, size_t count);
+	static int setArrayValues(const std::string &name, size_t offset,
+			const float *values, size_t count);
+
 
 	/**
 	 * Set the alarm for the specified status alarm item.
@@ -212,9 +1017,174 @@ public:
 	 */
 	static int setHealth(const std::string &name, const health::Health health);
 
+	/**
+	 * Call <code>observer</code> every time a status item whose name
+	 * matches <code>pattern</code> changes, in this process, without
+	 * going through the GMP. The observer sees the same changes that
+	 * make the item pending for the next post: values that are equal
+	 * to the current one or within the deadbands don't notify.
+	 * <p/>
+	 * The pattern is a status item name where '*' matches any sequence
+	 * of characters and '?' matches one character, like "gpi:cal:*".
+	 * It is matched once against each status item, when the observer
+	 * is added or the item created, so the patterns cost nothing when
+	 * items change. Items that have no observers only pay for an atomic
+	 * load when they are set.
+	 * <p/>
+	 * Inline observers run in the thread that sets the value, after
+	 * the item is updated. They must be quick and must not add or
+	 * remove observers. Asynchronous observers run, in order, in a
+	 * thread of the library; the value passed to them is copied when
+	 * the change happens.
+	 * <p/>
+	 * Array status items don't notify observers.
+	 *
+	 * @param pattern name or pattern of the status items to observe
+	 * @param observer the callback
+	 * @param async true to call the observer from a thread of the
+	 *        library instead of the thread that sets the value
+	 *
+	 * @return an id to remove the observer, or giapi::status::ERROR
+	 *         if the pattern is empty or the observer is not set
+	 */
+	static int addObserver(const std::string &pattern,
+			const StatusObserver &observer, bool async = false);
+
+	/**
+	 * Stop calling the observer with the given id. Asynchronous
+	 * notifications already queued may still be delivered.
+	 *
+	 * @return giapi::status::ERROR if there is no such observer
+	 */
+	static int removeObserver(int id);
+
+	/**
+	 * The calls below take a StatusKey instead of a name. They do the
+	 * same as the calls with a name, but the type and kind of the
+	 * status item are checked by the compiler.
+	 */
+
+	/**
+	 * Create the status item of the given key
+	 *
+	 * @see createStatusItem(), createAlarmStatusItem(),
+	 *      createHealthStatusItem()
+	 */
+	template<class T> static int createStatusItem(
+			const StatusKey<T, kind::Basic> &key) {
+		return createStatusItem(key.getName(), key.TYPE);
+	}
+
+	template<class T> static int createStatusItem(
+			const StatusKey<T, kind::Alarm> &key) {
+		return createAlarmStatusItem(key.getName(), key.TYPE);
+	}
 
+	static int createStatusItem(
+			const StatusKey<health::Health, kind::Health> &key) {
+		return createHealthStatusItem(key.getName());
+	}
+
+	/**
+	 * Get a handle to the status item of the given key
+	 *
+	 * @see getHandle()
+	 */
+	template<class T, class K> static StatusHandle<T> getHandle(
+			const StatusKey<T, K> &key) {
+		static_assert(!std::is_same<K, kind::Health>::value,
+				"there are no handles for health status items, use setHealth()");
+		return getHandle<T> (key.getName());
+	}
+
+	/**
+	 * Set the value of the status item of the given key. The value
+	 * must be of the type of the key. The item is looked up by name
+	 * until a value is set; from then on values are stored through the
+	 * handle the key is bound to.
+	 *
+	 * @see setValueAsInt(), setValueAsDouble(), setValueAsFloat(),
+	 *      setValueAsString()
+	 */
+	template<class T, class K> static int setValue(const StatusKey<T, K> &key,
+			const typename StatusKey<T, K>::ValueType &value) {
+		static_assert(!std::is_same<K, kind::Health>::value,
+				"health status items are set with setHealth()");
+		StatusHandle<T> *handle = key._handle.load(std::memory_order_acquire);
+		if (handle != 0) {
+			return handle->set(value);
+		}
+		//by name until the item is there, with the type of the key
+		int result = setKeyValue(key.getName(), value);
+		if (result == status::OK) {
+			handle = resolveHandle<T> (key.getName());
+			if (handle != 0) {
+				key._handle.store(handle, std::memory_order_release);
+			}
+		}
+		return result;
+	}
+
+	/**
+	 * Set the alarm state of the status item of the given alarm key
+	 *
+	 * @see setAlarm()
+	 */
+	template<class T> static int setAlarm(const StatusKey<T, kind::Alarm> &key,
+			alarm::Severity severity, alarm::Cause cause,
+			const std::string & message = std::string()) {
+		return setAlarm(key.getName(), severity, cause, message);
+	}
+
+	/**
+	 * Clear the alarm state of the status item of the given alarm key
+	 *
+	 * @see clearAlarm()
+	 */
+	template<class T> static int clearAlarm(
+			const StatusKey<T, kind::Alarm> &key) {
+		return clearAlarm(key.getName());
+	}
+
+	/**
+	 * Set the health of the status item of the given health key
+	 *
+	 * @see setHealth()
+	 */
+	static int setHealth(const StatusKey<health::Health, kind::Health> &key,
+			const health::Health health) {
+		return setHealth(key.getName(), health);
+	}
 
 private:
+	/**
+	 * Return the handle keys of the given status item are bound to, or
+	 * 0 if there is no such item or it doesn't hold values of type T.
+	 * There is one handle per item and type, kept for the life of the
+	 * process.
+	 */
+	template<class T> static StatusHandle<T> * resolveHandle(
+			const std::string &name);
+
+	/**
+	 * The setter for each type of key, chosen at compile time
+	 */
+	static int setKeyValue(const std::string &name, int value) {
+		return setValueAsInt(name, value);
+	}
+
+	static int setKeyValue(const std::string &name, double value) {
+		return setValueAsDouble(name, value);
+	}
+
+	static int setKeyValue(const std::string &name, float value) {
+		return setValueAsFloat(name, value);
+	}
+
+	static int setKeyValue(const std::string &name, const std::string &value) {
+		return setValueAsString(name, value);
+	}
+
 	StatusUtil();
 	~StatusUtil();
 };
@@ -0,0 +1,203 @@
+#include "AsyncCommandExecutor.h"
+#include "CompletionTokenImpl.h"
+
+#include <cstdlib>
+#include <exception>
+#include <sstream>
+
+#include <giapi/CommandUtil.h>
+#include <util/PropertiesUtil.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr AsyncCommandExecutor::logger(log4cxx::Logger::getLogger(
+		"giapi.AsyncCommandExecutor"));
+
+pAsyncCommandExecutor AsyncCommandExecutor::INSTANCE(
+		static_cast<AsyncCommandExecutor *>(0));
+
+/**
+ * Configuration key with the number of threads the asynchronous
+ * handlers run on
+ */
+static const char * ASYNC_THREADS_PROPERTY = "gmp.command.async.threads";
+
+AsyncCommandExecutor::Deadlines::Deadlines() :
+	running(true) {
+}
+
+AsyncCommandExecutor::Action::Action(command::ActionId id, long timeout,
+		pDeadlines deadlines) :
+	id(id), timeout(timeout), posted(false), deadlines(deadlines),
+			scheduled(false) {
+}
+
+AsyncCommandExecutor::AsyncCommandExecutor(size_t threads,
+		const Poster &poster) :
+	_poster(poster), _deadlines(new Deadlines()),
+			_executor(threads, "async commands") {
+	_watcher = std::thread(&AsyncCommandExecutor::watch, this);
+}
+
+AsyncCommandExecutor::~AsyncCommandExecutor() {
+	shutdown();
+}
+
+pAsyncCommandExecutor AsyncCommandExecutor::Instance() {
+	//asynchronous handlers are called from the consumers at the same time
+	static std::mutex instanceLock;
+	std::lock_guard<std::mutex> guard(instanceLock);
+	if (INSTANCE.get() == 0) {
+		int threads = atoi(util::PropertiesUtil::Instance().getProperty(
+				ASYNC_THREADS_PROPERTY).c_str());
+		if (threads <= 0) {
+			threads = DEFAULT_THREADS;
+		}
+		LOG4CXX_INFO(logger, "Running asynchronous sequence command handlers on "
+				<< threads << " threads");
+		INSTANCE.reset(new AsyncCommandExecutor(threads,
+				&CommandUtil::postCompletionInfo));
+	}
+	return INSTANCE;
+}
+
+bool AsyncCommandExecutor::submit(pAsyncSequenceCommandHandler handler,
+		command::ActionId id, command::SequenceCommand sequenceCommand,
+		command::Activity activity, pConfiguration config) {
+	pAction action(new Action(id, handler->getTimeout(), _deadlines));
+	Clock::time_point deadline = Clock::now() + std::chrono::milliseconds(
+			action->timeout);
+
+	if (!_executor.execute([this, handler, action, sequenceCommand, activity, config] {
+		run(handler, action, sequenceCommand, activity, config);
+	})) {
+		return false;
+	}
+
+	if (action->timeout > 0) {
+		bool first;
+		{
+			std::lock_guard<std::mutex> guard(_deadlines->lock);
+			//resolved already, post() found nothing to remove
+			if (!_deadlines->running || action->posted) {
+				return true;
+			}
+			action->deadline = _deadlines->actions.insert(std::make_pair(
+					deadline, action));
+			action->scheduled = true;
+			first = action->deadline == _deadlines->actions.begin();
+		}
+		if (first) {
+			_deadlines->added.notify_one();
+		}
+	}
+	return true;
+}
+
+void AsyncCommandExecutor::shutdown() {
+	_executor.shutdown();
+	{
+		std::lock_guard<std::mutex> guard(_deadlines->lock);
+		if (!_deadlines->running) {
+			return;
+		}
+		_deadlines->running = false;
+		for (DeadlineMap::iterator it = _deadlines->actions.begin(); it
+				!= _deadlines->actions.end(); ++it) {
+			it->second->scheduled = false;
+		}
+		_deadlines->actions.clear();
+	}
+	_deadlines->added.notify_one();
+	_watcher.join();
+}
+
+size_t AsyncCommandExecutor::getPendingTimeouts() {
+	std::lock_guard<std::mutex> guard(_deadlines->lock);
+	return _deadlines->actions.size();
+}
+
+void AsyncCommandExecutor::run(pAsyncSequenceCommandHandler handler,
+		pAction action, command::SequenceCommand sequenceCommand,
+		command::Activity activity, pConfiguration config) {
+	pCompletionToken token;
+	try {
+		token = handler->start(action->id, sequenceCommand, activity, config);
+		if (token.get() == 0) {
+			token = CompletionToken::failed("No completion token for the actions");
+		}
+	} catch (std::exception &e) {
+		token = CompletionToken::failed(e.what());
+	} catch (...) {
+		token = CompletionToken::failed("Unknown error starting the actions");
+	}
+
+	CompletionTokenImpl *impl = dynamic_cast<CompletionTokenImpl *> (token.get());
+	if (impl == 0) {
+		LOG4CXX_ERROR(logger, "Completion tokens must be built by CompletionToken::create()");
+		post(_poster, *action, HandlerResponse::createError(
+				"Invalid completion token for the actions"));
+		return;
+	}
+	Poster poster = _poster;
+	impl->setListener([poster, action](pHandlerResponse response) {
+		post(poster, *action, response);
+	});
+}
+
+void AsyncCommandExecutor::post(const Poster &poster, Action &action,
+		pHandlerResponse response) {
+	if (action.posted.exchange(true)) {
+		return; //timed out already, or the other way around
+	}
+	unschedule(action);
+	try {
+		if (poster(action.id, response) != status::OK) {
+			LOG4CXX_WARN(logger, "Completion info not posted for action " << action.id);
+		}
+	} catch (std::exception &e) {
+		LOG4CXX_WARN(logger, "Problem posting completion info for action "
+				<< action.id << ": " << e.what());
+	}
+}
+
+void AsyncCommandExecutor::unschedule(Action &action) {
+	pDeadlines deadlines = action.deadlines.lock();
+	if (deadlines.get() == 0) {
+		return; //the executor is gone
+	}
+	std::lock_guard<std::mutex> guard(deadlines->lock);
+	if (action.scheduled) {
+		deadlines->actions.erase(action.deadline);
+		action.scheduled = false;
+	}
+}
+
+void AsyncCommandExecutor::watch() {
+	std::unique_lock<std::mutex> lock(_deadlines->lock);
+	DeadlineMap &actions = _deadlines->actions;
+	while (_deadlines->running) {
+		if (actions.empty()) {
+			_deadlines->added.wait(lock);
+			continue;
+		}
+		Clock::time_point deadline = actions.begin()->first;
+		if (Clock::now() < deadline) {
+			_deadlines->added.wait_until(lock, deadline);
+			continue;
+		}
+		pAction action = actions.begin()->second;
+		actions.erase(actions.begin());
+		action->scheduled = false;
+		if (action->posted) {
+			continue;
+		}
+		lock.unlock();
+		std::ostringstream message;
+		message << "Actions not completed after " << action->timeout << " ms";
+		post(_poster, *action, HandlerResponse::createError(message.str()));
+		lock.lock();
+	}
+}
+
+}
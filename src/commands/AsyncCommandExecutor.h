@@ -0,0 +1,181 @@
+#ifndef ASYNCCOMMANDEXECUTOR_H_
+#define ASYNCCOMMANDEXECUTOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/AsyncSequenceCommandHandler.h>
+#include <giapi/HandlerResponse.h>
+#include <util/Executor.h>
+
+namespace giapi {
+
+class AsyncCommandExecutor;
+typedef std::tr1::shared_ptr<AsyncCommandExecutor> pAsyncCommandExecutor;
+
+/**
+ * Runs the actions of the asynchronous sequence command handlers and
+ * posts their completion information.
+ * <p/>
+ * The <code>start</code> method of the handlers runs on a pool of
+ * threads shared by all of them. The completion information is posted
+ * once per action: when the completion token returned by the handler
+ * is resolved, or when the timeout of the handler expires, whatever
+ * happens first. A thread of its own watches the timeouts.
+ */
+class AsyncCommandExecutor {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Where the completion information goes, CommandUtil::postCompletionInfo
+	 * for the instance of the library
+	 */
+	typedef std::function<int(command::ActionId, pHandlerResponse)> Poster;
+
+	/**
+	 * Threads of the pool when <code>gmp.command.async.threads</code> is
+	 * not set
+	 */
+	static const size_t DEFAULT_THREADS = 4;
+
+	/**
+	 * Start <code>threads</code> threads to run the handlers, at least
+	 * one, plus the one watching the timeouts
+	 */
+	AsyncCommandExecutor(size_t threads, const Poster &poster);
+
+	/**
+	 * Run the handlers still queued and stop the threads
+	 */
+	virtual ~AsyncCommandExecutor();
+
+	/**
+	 * Queue a call to the <code>start</code> method of the handler, and
+	 * start counting its timeout. Called once STARTED has been sent to
+	 * the GMP, since the completion information may be posted right away
+	 *
+	 * @return false if the executor is shut down, in which case the
+	 *         handler is not called
+	 */
+	bool submit(pAsyncSequenceCommandHandler handler, command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config);
+
+	/**
+	 * Stop accepting handlers, run the ones already queued and stop the
+	 * threads. Timeouts that have not expired yet are abandoned.
+	 */
+	void shutdown();
+
+	/**
+	 * Number of actions whose timeout is being watched: submitted with
+	 * a timeout, and neither resolved nor expired yet
+	 */
+	size_t getPendingTimeouts();
+
+	/**
+	 * The executor the asynchronous handlers of the process run on,
+	 * started the first time it's needed
+	 */
+	static pAsyncCommandExecutor Instance();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Action;
+	typedef std::tr1::shared_ptr<Action> pAction;
+	typedef std::multimap<Clock::time_point, pAction> DeadlineMap;
+
+	/**
+	 * Actions with a timeout, by the time it expires. Shared with the
+	 * actions, whose token may be resolved after the executor is gone
+	 */
+	struct Deadlines {
+		Deadlines();
+
+		DeadlineMap actions;
+		bool running;
+		std::mutex lock;
+		std::condition_variable added;
+	};
+	typedef std::tr1::shared_ptr<Deadlines> pDeadlines;
+
+	/**
+	 * The actions started by a sequence command
+	 */
+	struct Action {
+		Action(command::ActionId id, long timeout, pDeadlines deadlines);
+
+		command::ActionId id;
+		long timeout;
+		/**
+		 * Set once the completion information has been posted
+		 */
+		std::atomic<bool> posted;
+		/**
+		 * Where the timeout of the action is watched
+		 */
+		std::tr1::weak_ptr<Deadlines> deadlines;
+		/**
+		 * Entry of the action in the deadlines, valid while
+		 * <code>scheduled</code> is set. Both are guarded by the lock of
+		 * the deadlines
+		 */
+		DeadlineMap::iterator deadline;
+		bool scheduled;
+	};
+
+	/**
+	 * Call the handler and have its token post the completion
+	 * information once resolved
+	 */
+	void run(pAsyncSequenceCommandHandler handler, pAction action,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config);
+
+	/**
+	 * Post the completion information of the action, unless it has
+	 * been posted already, and stop watching its timeout
+	 */
+	static void post(const Poster &poster, Action &action,
+			pHandlerResponse response);
+
+	/**
+	 * Remove the action from the deadlines, if it is there
+	 */
+	static void unschedule(Action &action);
+
+	/**
+	 * Main loop of the thread watching the timeouts
+	 */
+	void watch();
+
+	Poster _poster;
+
+	pDeadlines _deadlines;
+	std::thread _watcher;
+
+	util::Executor _executor;
+
+	static pAsyncCommandExecutor INSTANCE;
+
+	AsyncCommandExecutor(const AsyncCommandExecutor &);
+	AsyncCommandExecutor & operator=(const AsyncCommandExecutor &);
+};
+
+}
+
+#endif /* ASYNCCOMMANDEXECUTOR_H_ */
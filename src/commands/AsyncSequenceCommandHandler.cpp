@@ -0,0 +1,29 @@
+#include <giapi/AsyncSequenceCommandHandler.h>
+
+namespace giapi {
+
+AsyncSequenceCommandHandler::AsyncSequenceCommandHandler(long timeout) :
+	_timeout(timeout > 0 ? timeout : 0) {
+}
+
+AsyncSequenceCommandHandler::~AsyncSequenceCommandHandler() {
+}
+
+long AsyncSequenceCommandHandler::getTimeout() const {
+	return _timeout;
+}
+
+pHandlerResponse AsyncSequenceCommandHandler::handle(command::ActionId id,
+		command::SequenceCommand sequenceCommand, command::Activity activity,
+		pConfiguration config) {
+	//the consumer queues the call to start() through this smart pointer
+	try {
+		shared_from_this();
+	} catch (std::tr1::bad_weak_ptr &) {
+		return HandlerResponse::createError(
+				"Asynchronous handler not owned by a smart pointer");
+	}
+	return HandlerResponse::create(HandlerResponse::STARTED);
+}
+
+}
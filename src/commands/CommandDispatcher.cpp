@@ -0,0 +1,153 @@
+#include "CommandDispatcher.h"
+
+#include <functional>
+#include <sstream>
+
+#include <cms/MapMessage.h>
+
+#include <giapi/AsyncSequenceCommandHandler.h>
+#include <giapi/CommandUtil.h>
+#include <gmp/JmsUtil.h>
+
+#include "AsyncCommandExecutor.h"
+
+namespace giapi {
+
+log4cxx::LoggerPtr CommandDispatcher::logger(log4cxx::Logger::getLogger(
+		"giapi.CommandDispatcher"));
+
+CommandDispatcher::CommandDispatcher(pSession session,
+		util::pOrderedExecutor executor) throw (cms::CMSException) :
+	_session(session), _executor(executor), _dispatched(0) {
+	//anonymous producer to reply to whatever destination each command asks for
+	if (_session.get() != 0) {
+		_replyProducer = pMessageProducer(_session->createProducer(NULL));
+	}
+}
+
+CommandDispatcher::~CommandDispatcher() {
+	close();
+}
+
+void CommandDispatcher::dispatch(const std::string &topic,
+		pSequenceCommandHandler handler, command::ActionId id,
+		command::SequenceCommand sequenceCommand, command::Activity activity,
+		pConfiguration config, const cms::Destination *replyTo) {
+
+	if (_executor.get() == 0) {
+		handle(handler, id, sequenceCommand, activity, config, replyTo);
+		return;
+	}
+
+	//the reply destination is destroyed with the message, keep a copy
+	pDestination destination(replyTo != NULL ? replyTo->clone() : NULL);
+	{
+		std::lock_guard<std::mutex> guard(_dispatchLock);
+		_dispatched++;
+	}
+	//a CANCEL gets a key of its own, so it doesn't wait for the
+	//command it may have to stop
+	std::ostringstream key;
+	key << topic;
+	if (activity == command::CANCEL) {
+		key << ":cancel:" << id;
+	}
+	if (!_executor->execute(key.str(), std::bind(&CommandDispatcher::run,
+			this, handler, id, sequenceCommand, activity, config, destination))) {
+		LOG4CXX_WARN(logger, "Command dispatcher stopped, handling command (" << id << ") on the delivery thread");
+		run(handler, id, sequenceCommand, activity, config, destination);
+	}
+}
+
+void CommandDispatcher::handle(pSequenceCommandHandler handler,
+		command::ActionId id, command::SequenceCommand sequenceCommand,
+		command::Activity activity, pConfiguration config,
+		const cms::Destination *replyTo) {
+
+	pHandlerResponse response = handler->handle(id, sequenceCommand, activity, config);
+
+	if (replyTo == NULL || _session.get() == 0) {
+		LOG4CXX_ERROR(logger, "Invalid destination received. Can't reply to request");
+		return;
+	}
+
+	reply(id, response, replyTo);
+	//the actions only start once the GMP has the reply
+	start(handler, response, id, sequenceCommand, activity, config);
+}
+
+void CommandDispatcher::reply(command::ActionId id, pHandlerResponse response,
+		const cms::Destination *replyTo) {
+
+	LOG4CXX_DEBUG(logger, "Replying to sequence command:(" << id << "): " << gmp::JmsUtil::getHandlerResponse(response));
+
+	std::lock_guard<std::mutex> guard(_replyLock);
+
+	cms::MapMessage *reply = _session->createMapMessage();
+
+	gmp::JmsUtil::makeHandlerResponseMsg(reply, response);
+
+	_replyProducer->send(replyTo, reply);
+
+	//delete allocated objects
+	delete reply;
+}
+
+void CommandDispatcher::start(pSequenceCommandHandler handler,
+		pHandlerResponse response, command::ActionId id,
+		command::SequenceCommand sequenceCommand, command::Activity activity,
+		pConfiguration config) {
+
+	pAsyncSequenceCommandHandler async = std::tr1::dynamic_pointer_cast<
+			AsyncSequenceCommandHandler>(handler);
+	if (async.get() == 0 || response.get() == 0 || response->getResponse()
+			!= HandlerResponse::STARTED) {
+		return;
+	}
+
+	if (!AsyncCommandExecutor::Instance()->submit(async, id, sequenceCommand,
+			activity, config)) {
+		LOG4CXX_WARN(logger, "Actions of sequence command (" << id << ") not started, shutting down");
+		try {
+			CommandUtil::postCompletionInfo(id, HandlerResponse::createError(
+					"Actions can't be started, shutting down"));
+		} catch (GiapiException &e) {
+			LOG4CXX_WARN(logger, "Problem posting completion info for action " << id << ": " << e.what());
+		}
+	}
+}
+
+void CommandDispatcher::run(pSequenceCommandHandler handler,
+		command::ActionId id, command::SequenceCommand sequenceCommand,
+		command::Activity activity, pConfiguration config,
+		pDestination replyTo) {
+
+	try {
+		handle(handler, id, sequenceCommand, activity, config, replyTo.get());
+	} catch (cms::CMSException& e) {
+		e.printStackTrace();
+	} catch (...) {
+		LOG4CXX_ERROR(logger, "Handler failed for sequence command (" << id << ")");
+	}
+
+	//notify with the lock held, the dispatcher may be destroyed right after
+	std::lock_guard<std::mutex> guard(_dispatchLock);
+	_dispatched--;
+	_dispatchDone.notify_all();
+}
+
+void CommandDispatcher::close() {
+	{
+		//the commands still in the executor reply through the session
+		std::unique_lock<std::mutex> lock(_dispatchLock);
+		_dispatchDone.wait(lock, [this] { return _dispatched == 0; });
+	}
+
+	try {
+		if (_replyProducer.get() != 0) {
+			_replyProducer->close();
+		}
+	} catch (cms::CMSException& e) {e.printStackTrace();}
+}
+
+}
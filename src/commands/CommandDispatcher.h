@@ -0,0 +1,152 @@
+#ifndef COMMANDDISPATCHER_H_
+#define COMMANDDISPATCHER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <tr1/memory>
+
+#include <cms/CMSException.h>
+#include <cms/Destination.h>
+#include <cms/Session.h>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/SequenceCommandHandler.h>
+#include <util/JmsSmartPointers.h>
+#include <util/OrderedExecutor.h>
+
+namespace giapi {
+
+class CommandDispatcher;
+typedef std::tr1::shared_ptr<CommandDispatcher> pCommandDispatcher;
+
+/**
+ * Hands the sequence commands received by a consumer to their handler
+ * and sends the response of the handler back, for the
+ * SequenceCommandConsumer and the MultiplexedCommandConsumer.
+ * <p/>
+ * The handler runs on the calling thread, the JMS delivery thread of
+ * the consumer, unless an executor is given. Then it runs on one of the
+ * threads of the executor. Commands that arrive on the same topic, that
+ * is, for the same sequence command or the same apply prefix, are still
+ * handled one after the other, in the order they arrive. A CANCEL is
+ * not queued behind them: it runs as soon as a thread is free, so a
+ * handler that blocks can be cancelled.
+ * <p/>
+ * Replies go out through a single anonymous producer of the session of
+ * the consumer, to the destination each command gives. The actions of
+ * the asynchronous handlers are started once the reply is out, so their
+ * completion information can't reach the GMP before it. A command that
+ * can't be replied to never has its actions started.
+ */
+class CommandDispatcher {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a dispatcher that replies through <code>session</code>
+	 *
+	 * @param session the session of the consumer. Without one no
+	 *        replies are sent, as if the commands gave no destination
+	 * @param executor the threads the handlers run on. If not given,
+	 *        they run on the thread calling dispatch()
+	 */
+	CommandDispatcher(pSession session, util::pOrderedExecutor executor)
+			throw (cms::CMSException);
+
+	/**
+	 * Wait for the commands still being handled and close the producer
+	 */
+	virtual ~CommandDispatcher();
+
+	/**
+	 * Invoke the handler for a command and send its response to
+	 * <code>replyTo</code>, now or on a thread of the executor
+	 *
+	 * @param topic the topic the command arrived on. Commands on the
+	 *        same topic are handled in order
+	 */
+	void dispatch(const std::string &topic, pSequenceCommandHandler handler,
+			command::ActionId id, command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config,
+			const cms::Destination *replyTo);
+
+	/**
+	 * Wait for the commands still being handled, which reply through
+	 * the session, and close the producer. Called before the session
+	 * is closed.
+	 */
+	void close();
+
+private:
+	/**
+	 * Invoke the handler and reply on the calling thread, then start
+	 * the actions of the handler if the reply was sent
+	 */
+	void handle(pSequenceCommandHandler handler, command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config,
+			const cms::Destination *replyTo);
+
+	/**
+	 * Send the response of the handler to <code>replyTo</code>
+	 */
+	void reply(command::ActionId id, pHandlerResponse response,
+			const cms::Destination *replyTo);
+
+	/**
+	 * Queue the actions of an asynchronous handler that answered
+	 * STARTED, or post ERROR if they can't be queued
+	 */
+	void start(pSequenceCommandHandler handler, pHandlerResponse response,
+			command::ActionId id, command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config);
+
+	/**
+	 * Handle a command on a thread of the executor
+	 */
+	void run(pSequenceCommandHandler handler, command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config,
+			pDestination replyTo);
+
+	pSession _session;
+
+	/**
+	 * Producer used to reply to the sequence commands. It has no
+	 * destination of its own, the reply goes to the destination given
+	 * by each command, so one producer serves all the replies instead
+	 * of registering a new one with the broker for every command
+	 */
+	pMessageProducer _replyProducer;
+
+	/**
+	 * Threads the handlers run on. Null to run them on the caller
+	 */
+	util::pOrderedExecutor _executor;
+
+	/**
+	 * Serializes the use of the session to reply, which may happen from
+	 * several threads of the executor at once
+	 */
+	std::mutex _replyLock;
+
+	/**
+	 * Number of commands handed to the executor and not handled yet
+	 */
+	size_t _dispatched;
+	std::mutex _dispatchLock;
+	std::condition_variable _dispatchDone;
+
+	CommandDispatcher(const CommandDispatcher &);
+	CommandDispatcher & operator=(const CommandDispatcher &);
+};
+
+}
+
+#endif /* COMMANDDISPATCHER_H_ */
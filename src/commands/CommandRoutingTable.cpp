@@ -0,0 +1,100 @@
+#include "CommandRoutingTable.h"
+
+#include <gmp/GMPKeys.h>
+#include <gmp/JmsUtil.h>
+
+namespace giapi {
+
+/**
+ * Activities of each activity set, the same the selector of a
+ * SequenceCommandConsumer matches
+ */
+static const bool SET_ACTIVITIES[][command::CANCEL + 1] = {
+	//PRESET, START, PRESET_START, CANCEL
+	{ true, false, false, false }, //SET_PRESET
+	{ false, true, false, false }, //SET_START
+	{ true, true, true, false }, //SET_PRESET_START
+	{ false, false, false, true }, //SET_CANCEL
+	{ true, false, false, true }, //SET_PRESET_CANCEL
+	{ false, true, false, true }, //SET_START_CANCEL
+	{ true, true, true, true } //SET_PRESET_START_CANCEL
+};
+
+CommandRoutingTable::CommandRoutingTable() :
+	_applyTopicPrefix(gmp::JmsUtil::getTopic(std::string())) {
+	for (size_t i = 0; i < COMMANDS; i++) {
+		command::SequenceCommand id = static_cast<command::SequenceCommand>(i);
+		_topics[gmp::JmsUtil::getTopic(id)] = id;
+	}
+}
+
+CommandRoutingTable::~CommandRoutingTable() {
+}
+
+void CommandRoutingTable::add(command::SequenceCommand id,
+		command::ActivitySet activities, pSequenceCommandHandler handler) {
+	std::lock_guard<std::mutex> guard(_lock);
+	add(_commands[id], activities, handler);
+}
+
+void CommandRoutingTable::add(const std::string &prefix,
+		command::ActivitySet activities, pSequenceCommandHandler handler) {
+	std::lock_guard<std::mutex> guard(_lock);
+	add(_applies[prefix], activities, handler);
+}
+
+void CommandRoutingTable::add(Handlers &handlers,
+		command::ActivitySet activities, pSequenceCommandHandler handler) {
+	for (size_t i = 0; i < ACTIVITIES; i++) {
+		if (SET_ACTIVITIES[activities][i]) {
+			handlers[i] = handler;
+		}
+	}
+}
+
+pSequenceCommandHandler CommandRoutingTable::find(const std::string &topic,
+		command::Activity activity, command::SequenceCommand &id) const {
+	std::lock_guard<std::mutex> guard(_lock);
+	std::unordered_map<std::string, command::SequenceCommand>::const_iterator
+			command = _topics.find(topic);
+	if (command != _topics.end()) {
+		pSequenceCommandHandler handler = _commands[command->second][activity];
+		if (handler.get() != 0) {
+			id = command->second;
+		}
+		return handler;
+	}
+
+	if (topic.compare(0, _applyTopicPrefix.size(), _applyTopicPrefix) == 0) {
+		std::unordered_map<std::string, Handlers>::const_iterator apply =
+				_applies.find(topic.substr(_applyTopicPrefix.size()));
+		if (apply != _applies.end() && apply->second[activity].get() != 0) {
+			id = command::APPLY;
+			return apply->second[activity];
+		}
+	}
+	return pSequenceCommandHandler();
+}
+
+bool CommandRoutingTable::parseActivity(const std::string &name,
+		command::Activity &activity) {
+	if (name == gmp::GMPKeys::GMP_ACTIVITY_PRESET) {
+		activity = command::PRESET;
+	} else if (name == gmp::GMPKeys::GMP_ACTIVITY_START) {
+		activity = command::START;
+	} else if (name == gmp::GMPKeys::GMP_ACTIVITY_PRESET_START) {
+		activity = command::PRESET_START;
+	} else if (name == gmp::GMPKeys::GMP_ACTIVITY_CANCEL) {
+		activity = command::CANCEL;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+bool CommandRoutingTable::includes(command::ActivitySet activities,
+		command::Activity activity) {
+	return SET_ACTIVITIES[activities][activity];
+}
+
+}
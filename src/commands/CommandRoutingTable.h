@@ -0,0 +1,105 @@
+#ifndef COMMANDROUTINGTABLE_H_
+#define COMMANDROUTINGTABLE_H_
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <giapi/giapi.h>
+#include <giapi/SequenceCommandHandler.h>
+
+namespace giapi {
+
+/**
+ * The handlers subscribed to each sequence command, activity and apply
+ * prefix, to find the one a command received on a sequence command
+ * topic goes to.
+ * <p/>
+ * A handler subscribed to a set of activities gets the commands the
+ * selector of a SequenceCommandConsumer for that set lets through. For
+ * each activity, the handler subscribed last replaces the one before.
+ * <p/>
+ * Sequence commands and activities index arrays; only the apply
+ * prefixes, and the topic names, need a lookup by name.
+ */
+class CommandRoutingTable {
+public:
+	CommandRoutingTable();
+
+	virtual ~CommandRoutingTable();
+
+	/**
+	 * Send the commands for the sequence command <code>id</code> and
+	 * the given activities to <code>handler</code>
+	 */
+	void add(command::SequenceCommand id, command::ActivitySet activities,
+			pSequenceCommandHandler handler);
+
+	/**
+	 * Send the apply commands for the configuration <code>prefix</code>
+	 * and the given activities to <code>handler</code>
+	 */
+	void add(const std::string &prefix, command::ActivitySet activities,
+			pSequenceCommandHandler handler);
+
+	/**
+	 * Find the handler of a command received on <code>topic</code>
+	 *
+	 * @param id set to the sequence command of the topic when a handler
+	 *        is found
+	 * @return the handler, or null if nobody subscribed to the
+	 *         sequence command and activity
+	 */
+	pSequenceCommandHandler find(const std::string &topic,
+			command::Activity activity, command::SequenceCommand &id) const;
+
+	/**
+	 * Parse the activity property of a sequence command message
+	 *
+	 * @return false if it isn't an activity
+	 */
+	static bool parseActivity(const std::string &name,
+			command::Activity &activity);
+
+	/**
+	 * Whether the activity is one of the set
+	 */
+	static bool includes(command::ActivitySet activities,
+			command::Activity activity);
+
+private:
+	static const size_t COMMANDS = command::ENGINEERING + 1;
+	static const size_t ACTIVITIES = command::CANCEL + 1;
+
+	typedef std::array<pSequenceCommandHandler, ACTIVITIES> Handlers;
+
+	static void add(Handlers &handlers, command::ActivitySet activities,
+			pSequenceCommandHandler handler);
+
+	Handlers _commands[COMMANDS];
+
+	/**
+	 * Handlers of the apply commands, by prefix
+	 */
+	std::unordered_map<std::string, Handlers> _applies;
+
+	/**
+	 * Sequence command of each topic
+	 */
+	std::unordered_map<std::string, command::SequenceCommand> _topics;
+
+	/**
+	 * Topic names of the apply commands start with this
+	 */
+	std::string _applyTopicPrefix;
+
+	/**
+	 * Subscriptions may come while commands are received
+	 */
+	mutable std::mutex _lock;
+};
+
+}
+
+#endif /* COMMANDROUTINGTABLE_H_ */
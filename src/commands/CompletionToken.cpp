@@ -0,0 +1,29 @@
+#include <giapi/CompletionToken.h>
+#include "CompletionTokenImpl.h"
+
+namespace giapi {
+
+CompletionToken::CompletionToken() {
+}
+
+CompletionToken::~CompletionToken() {
+}
+
+pCompletionToken CompletionToken::create() {
+	pCompletionToken token(new CompletionTokenImpl());
+	return token;
+}
+
+pCompletionToken CompletionToken::completed() {
+	pCompletionToken token = create();
+	token->complete();
+	return token;
+}
+
+pCompletionToken CompletionToken::failed(const std::string &message) {
+	pCompletionToken token = create();
+	token->fail(message);
+	return token;
+}
+
+}
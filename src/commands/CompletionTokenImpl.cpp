@@ -0,0 +1,67 @@
+#include "CompletionTokenImpl.h"
+
+namespace giapi {
+
+/**
+ * Message posted for failures reported without one
+ */
+static const char * DEFAULT_FAILURE_MESSAGE = "Actions failed";
+
+CompletionTokenImpl::CompletionTokenImpl() {
+}
+
+CompletionTokenImpl::~CompletionTokenImpl() {
+}
+
+bool CompletionTokenImpl::complete() {
+	return resolve(HandlerResponse::create(HandlerResponse::COMPLETED));
+}
+
+bool CompletionTokenImpl::fail(const std::string &message) {
+	return resolve(HandlerResponse::createError(message.empty()
+			? DEFAULT_FAILURE_MESSAGE : message));
+}
+
+bool CompletionTokenImpl::isResolved() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _response.get() != 0;
+}
+
+bool CompletionTokenImpl::resolve(pHandlerResponse response) {
+	Listener listener;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (_response.get() != 0) {
+			return false;
+		}
+		_response = response;
+		listener.swap(_listener);
+	}
+	//outside the lock, the listener may take a while
+	if (listener) {
+		listener(response);
+	}
+	return true;
+}
+
+pHandlerResponse CompletionTokenImpl::getResponse() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _response;
+}
+
+void CompletionTokenImpl::setListener(const Listener &listener) {
+	pHandlerResponse response;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (_response.get() == 0) {
+			_listener = listener;
+			return;
+		}
+		response = _response;
+	}
+	if (listener) {
+		listener(response);
+	}
+}
+
+}
@@ -0,0 +1,68 @@
+#ifndef COMPLETIONTOKENIMPL_H_
+#define COMPLETIONTOKENIMPL_H_
+
+#include <functional>
+#include <mutex>
+#include <string>
+
+#include <giapi/CompletionToken.h>
+#include <giapi/HandlerResponse.h>
+
+namespace giapi {
+
+/**
+ * The completion token handed out by CompletionToken::create(). When
+ * resolved, it keeps the response to post to the GMP and hands it to
+ * its listener.
+ */
+class CompletionTokenImpl: public CompletionToken {
+public:
+	/**
+	 * Called once, with the COMPLETED or ERROR response, when the token
+	 * is resolved
+	 */
+	typedef std::function<void(pHandlerResponse)> Listener;
+
+	CompletionTokenImpl();
+
+	virtual ~CompletionTokenImpl();
+
+	virtual bool complete();
+
+	virtual bool fail(const std::string &message);
+
+	virtual bool isResolved() const;
+
+	/**
+	 * Resolve the token with <code>response</code>, unless it was
+	 * resolved already
+	 *
+	 * @return false if the token was resolved already
+	 */
+	bool resolve(pHandlerResponse response);
+
+	/**
+	 * The response the token was resolved with, null until then
+	 */
+	pHandlerResponse getResponse() const;
+
+	/**
+	 * Set the listener of the token, replacing the previous one. If the
+	 * token is resolved already, the listener is called right away, on
+	 * the calling thread; otherwise it's called on the thread that
+	 * resolves the token.
+	 */
+	void setListener(const Listener &listener);
+
+private:
+	mutable std::mutex _lock;
+	pHandlerResponse _response;
+	Listener _listener;
+
+	CompletionTokenImpl(const CompletionTokenImpl &);
+	CompletionTokenImpl & operator=(const CompletionTokenImpl &);
+};
+
+}
+
+#endif /* COMPLETIONTOKENIMPL_H_ */
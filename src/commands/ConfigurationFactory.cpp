@@ -1,7 +1,94 @@
 #include "ConfigurationFactory.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+
 namespace giapi {
 
+/**
+ * Types a value can be parsed as
+ */
+static const unsigned char DOUBLE_TYPE = 1;
+static const unsigned char INT_TYPE = 2;
+static const unsigned char BOOL_TYPE = 4;
+
+/**
+ * Value of the keys that are not in the configuration
+ */
+static const std::string EMPTY_VALUE;
+
+/**
+ * Whether there is nothing but blanks from <code>end</code> on
+ */
+static bool isParsed(const char *text, const char *end) {
+	if (end == text) {
+		return false;
+	}
+	while (isspace(static_cast<unsigned char>(*end))) {
+		end++;
+	}
+	return *end == '\0';
+}
+
+ConfigurationImpl::Value::Value(std::string text) :
+	text(std::move(text)), valid(0), doubleValue(0), intValue(0),
+			boolValue(false) {
+	const char *start = this->text.c_str();
+	char *end;
+	errno = 0;
+	doubleValue = strtod(start, &end);
+	if (isParsed(start, end) && errno != ERANGE) {
+		valid |= DOUBLE_TYPE;
+	}
+
+	errno = 0;
+	long number = strtol(start, &end, 10);
+	if (isParsed(start, end) && errno != ERANGE && number >= INT_MIN
+			&& number <= INT_MAX) {
+		intValue = static_cast<int>(number);
+		valid |= INT_TYPE;
+	}
+
+	std::string word(this->text);
+	std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+	if (word == "true" || word == "yes" || word == "on" || word == "1") {
+		boolValue = true;
+		valid |= BOOL_TYPE;
+	} else if (word == "false" || word == "no" || word == "off" || word
+			== "0") {
+		valid |= BOOL_TYPE;
+	}
+}
+
+bool ConfigurationImpl::Value::asDouble(double &value) const {
+	if (valid & DOUBLE_TYPE) {
+		value = doubleValue;
+		return true;
+	}
+	return false;
+}
+
+bool ConfigurationImpl::Value::asInt(int &value) const {
+	if (valid & INT_TYPE) {
+		value = intValue;
+		return true;
+	}
+	return false;
+}
+
+bool ConfigurationImpl::Value::asBool(bool &value) const {
+	if (valid & BOOL_TYPE) {
+		value = boolValue;
+		return true;
+	}
+	return false;
+}
+
 ConfigurationImpl::ConfigurationImpl() {
 
 }
@@ -10,27 +97,78 @@ ConfigurationImpl::~ConfigurationImpl() {
 
 }
 
-vector<std::string> ConfigurationImpl::getKeys() const {
-	std::vector<std::string> keys(_configMap.size());
-
-	StringStringMap::const_iterator iter;
-	iter = _configMap.begin();
-	for (int i = 0; iter != _configMap.end(); ++iter, ++i) {
-		keys[i] = iter->first;
-	}
-	return keys;
+const vector<std::string> & ConfigurationImpl::getKeys() const {
+	return _keys;
 }
 
 int ConfigurationImpl::getSize() const {
-	return _configMap.size();
+	return _keys.size();
 }
 
-const std::string ConfigurationImpl::getValue(const std::string &key) {
-	return _configMap[key];
+const std::string & ConfigurationImpl::getValue(const std::string &key) const {
+	const Value *value = find(key);
+	return value != NULL ? value->text : EMPTY_VALUE;
+}
+
+bool ConfigurationImpl::getDouble(const std::string &key, double &value) const {
+	const Value *entry = find(key);
+	return entry != NULL && entry->asDouble(value);
+}
+
+bool ConfigurationImpl::getInt(const std::string &key, int &value) const {
+	const Value *entry = find(key);
+	return entry != NULL && entry->asInt(value);
+}
+
+bool ConfigurationImpl::getBool(const std::string &key, bool &value) const {
+	const Value *entry = find(key);
+	return entry != NULL && entry->asBool(value);
 }
 
 void ConfigurationImpl::setValue(const std::string &key, const std::string &value) {
-	_configMap[key] = value;
+	std::vector<std::string>::iterator it = std::lower_bound(_keys.begin(),
+			_keys.end(), key);
+	size_t position = it - _keys.begin();
+	if (it != _keys.end() && *it == key) {
+		_values[position] = Value(value);
+		return;
+	}
+	_keys.insert(it, key);
+	_values.insert(_values.begin() + position, Value(value));
+}
+
+void ConfigurationImpl::read(const cms::MapMessage *message)
+		throw (cms::CMSException) {
+	_keys = message->getMapNames();
+	_values.clear();
+
+	//the names usually come sorted already
+	if (!std::is_sorted(_keys.begin(), _keys.end())) {
+		std::sort(_keys.begin(), _keys.end());
+	}
+
+	_values.reserve(_keys.size());
+	for (std::vector<std::string>::const_iterator it = _keys.begin(); it
+			!= _keys.end(); ++it) {
+		_values.push_back(Value(message->getString(*it)));
+	}
+}
+
+const ConfigurationImpl::Value * ConfigurationImpl::find(
+		const std::string &key) const {
+	//keys handed out by getKeys() give their position away
+	std::less_equal<const std::string *> notAfter;
+	if (!_keys.empty() && notAfter(&_keys.front(), &key) && notAfter(&key,
+			&_keys.back())) {
+		return &_values[&key - &_keys.front()];
+	}
+
+	std::vector<std::string>::const_iterator it = std::lower_bound(
+			_keys.begin(), _keys.end(), key);
+	if (it == _keys.end() || *it != key) {
+		return NULL;
+	}
+	return &_values[it - _keys.begin()];
 }
 
 
@@ -48,4 +186,14 @@ pConfiguration ConfigurationFactory::getConfiguration() {
 	return config;
 }
 
+pConfiguration ConfigurationFactory::getConfiguration(
+		const cms::MapMessage *message) throw (cms::CMSException) {
+
+	ConfigurationImpl *config = new ConfigurationImpl();
+	pConfiguration result(config);
+	config->read(message);
+
+	return result;
+}
+
 }
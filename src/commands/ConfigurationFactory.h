@@ -1,14 +1,25 @@
 #ifndef CONFIGURATIONFACTORY_H_
 #define CONFIGURATIONFACTORY_H_
 
+#include <cms/CMSException.h>
+#include <cms/MapMessage.h>
+
 #include <giapi/Configuration.h>
-#include <util/giapiMaps.h>
 
 
 
 
 namespace giapi {
 
+/**
+ * Configuration kept in two sorted vectors, one with the keys and one
+ * with the values, so looking a key up is a binary search and the keys
+ * are handed out without copying them.
+ * <p/>
+ * Each value is parsed as every type when it is set, so the typed
+ * accessors only copy the result, and reading the configuration from
+ * several threads at once is safe.
+ */
 class ConfigurationImpl : public Configuration {
 public:
 
@@ -18,21 +29,28 @@ public:
 	 *
 	 * @param key the name of the parameter whose value we need to retrieve
 	 *
-	 * @return the value associated to the given key or <code>NULL</code>
+	 * @return the value associated to the given key or an empty string
 	 *         if there is no value associated for the key in the current
 	 *         configuration.
 	 */
-	virtual const std::string getValue(const std::string & key);
+	virtual const std::string & getValue(const std::string & key) const;
 
 	/**
-	 * Return the keys contained in the configuration. If the configuration
-	 * does not contain any key, a reference to an empty vector is returned.
+	 * Return the keys contained in the configuration, sorted. If the
+	 * configuration does not contain any key, a reference to an empty
+	 * vector is returned.
 	 *
 	 * @return reference to a vector of strings representing the keys
 	 *         contained in the configuration. An empty list is returned
 	 *         if no keys are present.
 	 */
-	virtual vector<std::string> getKeys() const;
+	virtual const vector<std::string> & getKeys() const;
+
+	virtual bool getDouble(const std::string & key, double & value) const;
+
+	virtual bool getInt(const std::string & key, int & value) const;
+
+	virtual bool getBool(const std::string & key, bool & value) const;
 
 	/**
 	 * Return the number of parameters contained in this configuration.
@@ -48,18 +66,52 @@ public:
 	 */
 	virtual void setValue(const std::string & key, const std::string & value);
 
+	/**
+	 * Replace the contents of the configuration with the entries of the
+	 * message, taking each one once
+	 */
+	void read(const cms::MapMessage *message) throw (cms::CMSException);
+
 	ConfigurationImpl();
 	virtual ~ConfigurationImpl();
 
 private:
 	/**
-	 * Type definition for the hash_table that will map strings to
-	 * values in the configuration
+	 * A value and what it was parsed into
 	 */
-	typedef unordered_map<std::string, std::string, hash<std::string>, util::eqstr>
-			StringStringMap;
+	struct Value {
+		/**
+		 * Parse the text as each type
+		 */
+		explicit Value(std::string text = std::string());
+
+		bool asDouble(double &value) const;
+		bool asInt(int &value) const;
+		bool asBool(bool &value) const;
+
+		std::string text;
+
+		/**
+		 * Types the text is a valid value of
+		 */
+		unsigned char valid;
 
-	StringStringMap _configMap;
+		double doubleValue;
+		int intValue;
+		bool boolValue;
+	};
+
+	/**
+	 * Return the value of the key, or null if there is none. Keys
+	 * that are elements of getKeys() are found without searching.
+	 */
+	const Value * find(const std::string &key) const;
+
+	/**
+	 * Keys, sorted, and the value of each, at the same position
+	 */
+	std::vector<std::string> _keys;
+	std::vector<Value> _values;
 
 };
 
@@ -68,6 +120,13 @@ class ConfigurationFactory {
 public:
 	static pConfiguration getConfiguration();
 
+	/**
+	 * Build a configuration with the entries of a sequence command
+	 * message
+	 */
+	static pConfiguration getConfiguration(const cms::MapMessage *message)
+			throw (cms::CMSException);
+
 	virtual ~ConfigurationFactory();
 private:
 	ConfigurationFactory();
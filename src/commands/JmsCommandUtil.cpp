@@ -1,6 +1,9 @@
 #include "JmsCommandUtil.h"
 #include "LogCommandUtil.h"
 #include <gmp/JmsUtil.h>
+#include <util/PropertiesUtil.h>
+
+#include <cstdlib>
 
 
 namespace giapi {
@@ -9,8 +12,31 @@ log4cxx::LoggerPtr JmsCommandUtil::logger(log4cxx::Logger::getLogger("giapi.JmsC
 
 pJmsCommandUtil JmsCommandUtil::INSTANCE(static_cast<JmsCommandUtil *>(0));
 
+/**
+ * Configuration key with the number of threads the handlers run on
+ */
+static const char * DISPATCH_THREADS_PROPERTY = "gmp.command.dispatch.threads";
+
+/**
+ * Configuration key to receive all the sequence commands through one
+ * consumer
+ */
+static const char * MULTIPLEX_PROPERTY = "gmp.command.multiplex";
+
 JmsCommandUtil::JmsCommandUtil() throw (CommunicationException) {
 	_completionInfoProducer = gmp::CompletionInfoProducer::create();
+
+	util::PropertiesUtil &properties = util::PropertiesUtil::Instance();
+	int threads = atoi(properties.getProperty(DISPATCH_THREADS_PROPERTY).c_str());
+	if (threads > 0) {
+		LOG4CXX_INFO(logger, "Running sequence command handlers on " << threads << " threads");
+		_dispatcher.reset(new util::OrderedExecutor(threads, "command dispatch"));
+	}
+
+	if (properties.getProperty(MULTIPLEX_PROPERTY) == "true") {
+		LOG4CXX_INFO(logger, "Receiving all the sequence commands through a single consumer");
+		_multiplexer = MultiplexedCommandConsumer::create(_dispatcher);
+	}
 }
 
 JmsCommandUtil::~JmsCommandUtil() {
@@ -39,9 +65,13 @@ int JmsCommandUtil::subscribeApply(const std::string & prefix,
 
 	if (LogCommandUtil::Instance()->subscribeApply(prefix, activities, handler)
 			!= giapi::status::ERROR) {
+		if (_multiplexer.get() != 0) {
+			_multiplexer->subscribe(prefix, activities, handler);
+			return giapi::status::OK;
+		}
 		//Create a consumer for this prefix and activities
 		pSequenceCommandConsumer consumer =
-			SequenceCommandConsumer::create(prefix, activities, handler);
+			SequenceCommandConsumer::create(prefix, activities, handler, _dispatcher);
 
 		//store this consumer....
 		ActivityHolder * holder = _commandHolderMap[ gmp::JmsUtil::getTopic(prefix)];
@@ -62,9 +92,13 @@ int JmsCommandUtil::subscribeSequenceCommand(command::SequenceCommand id,
 
 	if (LogCommandUtil::Instance()->subscribeSequenceCommand(id, activities, handler)
 			!= giapi::status::ERROR) {
+		if (_multiplexer.get() != 0) {
+			_multiplexer->subscribe(id, activities, handler);
+			return giapi::status::OK;
+		}
 		//Create a consumer for this sequence commands and activities.
 		pSequenceCommandConsumer consumer =
-				SequenceCommandConsumer::create(id, activities, handler);
+				SequenceCommandConsumer::create(id, activities, handler, _dispatcher);
 		//Store this consumer for the associated sequence command/activities;
 		//use that info to control future registers to the same sequence command
 		//and destroy consumers that are no longer in
@@ -11,9 +11,11 @@
 #include <giapi/giapiexcept.h>
 
 #include "SequenceCommandConsumer.h"
+#include "MultiplexedCommandConsumer.h"
 #include "CompletionInfoProducer.h"
 
 #include <util/giapiMaps.h>
+#include <util/OrderedExecutor.h>
 
 namespace giapi {
 
@@ -91,6 +93,16 @@ private:
 /**
  * Implements the Command Util Interface using JMS as the underlying
  * communication mechanism
+ * <p/>
+ * Handlers run on the JMS delivery thread of their consumer, unless
+ * the <code>gmp.command.dispatch.threads</code> property sets the size
+ * of a pool of threads shared by all the sequence command consumers to
+ * run them (see SequenceCommandConsumer).
+ * <p/>
+ * Each subscription gets its own consumer, with its own session, unless
+ * <code>gmp.command.multiplex</code> is <code>true</code>. Then all the
+ * sequence commands are received by a single MultiplexedCommandConsumer,
+ * which hands them to the handlers in process.
  */
 class JmsCommandUtil;
 
@@ -136,6 +148,18 @@ private:
 	 */
 	gmp::pCompletionInfoProducer _completionInfoProducer;
 
+	/**
+	 * Threads the handlers run on. Null if they run on the delivery
+	 * threads of the consumers
+	 */
+	util::pOrderedExecutor _dispatcher;
+
+	/**
+	 * Consumer of all the sequence commands. Null if each subscription
+	 * has its own consumer
+	 */
+	pMultiplexedCommandConsumer _multiplexer;
+
 };
 
 }
@@ -0,0 +1,115 @@
+#include "MultiplexedCommandConsumer.h"
+
+#include <cms/MapMessage.h>
+#include <cms/Topic.h>
+
+#include <giapi/Configuration.h>
+#include <gmp/GMPKeys.h>
+#include <gmp/JmsUtil.h>
+
+#include "ConfigurationFactory.h"
+
+namespace giapi {
+
+log4cxx::LoggerPtr MultiplexedCommandConsumer::logger(log4cxx::Logger::getLogger(
+		"giapi.MultiplexedCommandConsumer"));
+
+MultiplexedCommandConsumer::MultiplexedCommandConsumer(
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) {
+	try {
+		_connectionManager = gmp::ConnectionManager::Instance();
+
+		//create an auto-acknowledged session
+		_session = _connectionManager->createSession();
+
+		//every sequence command topic, apply prefixes included
+		const std::string topic = gmp::GMPKeys::GMP_SEQUENCE_COMMAND_PREFIX + ">";
+		_destination = pDestination(_session->createTopic(topic));
+
+		LOG4CXX_DEBUG(logger, "Starting consumer for topic " << topic);
+		_consumer = pMessageConsumer(_session->createConsumer(_destination.get()));
+
+		_dispatcher = pCommandDispatcher(new CommandDispatcher(_session, dispatcher));
+
+		_consumer->setMessageListener(this);
+	} catch (CMSException& e) {
+		//clean any resources that might have been allocated
+		cleanup();
+		throw CommunicationException("Trouble initializing sequence command consumer: " + e.getMessage());
+	}
+}
+
+MultiplexedCommandConsumer::~MultiplexedCommandConsumer() throw () {
+	LOG4CXX_DEBUG(logger, "Destroying Multiplexed Command Consumer");
+	cleanup();
+}
+
+pMultiplexedCommandConsumer MultiplexedCommandConsumer::create(
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) {
+	pMultiplexedCommandConsumer consumer(new MultiplexedCommandConsumer(
+			dispatcher));
+	return consumer;
+}
+
+void MultiplexedCommandConsumer::subscribe(command::SequenceCommand id,
+		command::ActivitySet activities, pSequenceCommandHandler handler) {
+	_routes.add(id, activities, handler);
+}
+
+void MultiplexedCommandConsumer::subscribe(const std::string &prefix,
+		command::ActivitySet activities, pSequenceCommandHandler handler) {
+	_routes.add(prefix, activities, handler);
+}
+
+void MultiplexedCommandConsumer::onMessage(const Message *message) throw () {
+
+	try {
+		const MapMessage* mapMessage = dynamic_cast<const MapMessage*> (message);
+		const Topic* topic = dynamic_cast<const Topic*> (message->getCMSDestination());
+		if (mapMessage == NULL || topic == NULL) {
+			return;
+		}
+
+		command::Activity activity;
+		if (!CommandRoutingTable::parseActivity(mapMessage->getStringProperty(
+				gmp::GMPKeys::GMP_ACTIVITY_PROP), activity)) {
+			return;
+		}
+
+		//what the selectors used to filter out
+		command::SequenceCommand sequenceCommand;
+		pSequenceCommandHandler handler = _routes.find(topic->getTopicName(),
+				activity, sequenceCommand);
+		if (handler.get() == 0) {
+			return;
+		}
+
+		int actionId = mapMessage->getIntProperty(gmp::GMPKeys::GMP_ACTIONID_PROP);
+
+		LOG4CXX_DEBUG(logger, "Received Sequence command (" << actionId << "): " << topic->getTopicName() << " Activity : " << activity);
+
+		//build a configuration object
+		pConfiguration config = ConfigurationFactory::getConfiguration(mapMessage);
+
+		_dispatcher->dispatch(topic->getTopicName(), handler, actionId,
+				sequenceCommand, activity, config, message->getCMSReplyTo());
+
+	} catch (CMSException& e) {
+		e.printStackTrace();
+	}
+}
+
+void MultiplexedCommandConsumer::cleanup() {
+	try {
+		if (_consumer.get() != 0) _consumer->close();
+	} catch (CMSException& e) {e.printStackTrace();}
+
+	//the commands still being handled reply through the session
+	if (_dispatcher.get() != 0) _dispatcher->close();
+
+	try {
+		if (_session.get() != 0) _session->close();
+	} catch (CMSException& e) {e.printStackTrace();}
+}
+
+}
@@ -0,0 +1,114 @@
+#ifndef MULTIPLEXEDCOMMANDCONSUMER_H_
+#define MULTIPLEXEDCOMMANDCONSUMER_H_
+
+#include <string>
+#include <tr1/memory>
+
+#include <cms/MessageListener.h>
+#include <cms/Session.h>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+#include <giapi/SequenceCommandHandler.h>
+#include <gmp/ConnectionManager.h>
+#include <util/JmsSmartPointers.h>
+#include <util/OrderedExecutor.h>
+
+#include "CommandDispatcher.h"
+#include "CommandRoutingTable.h"
+
+namespace giapi {
+
+using namespace cms;
+
+class MultiplexedCommandConsumer;
+typedef std::tr1::shared_ptr<MultiplexedCommandConsumer>
+		pMultiplexedCommandConsumer;
+
+/**
+ * Receives all the sequence commands through a single session and a
+ * single consumer on the sequence command topics, and hands each one to
+ * the handler subscribed to its sequence command, activity or apply
+ * prefix.
+ * <p/>
+ * It replaces the SequenceCommandConsumer objects, each with its own
+ * session, delivery thread and broker subscription filtered by a
+ * selector, when there are many subscriptions. The routing happens in
+ * process through a CommandRoutingTable.
+ * <p/>
+ * Like a SequenceCommandConsumer, it hands the commands to their handler
+ * through a CommandDispatcher: handlers run on the delivery thread,
+ * unless a dispatcher is given, and their response is sent back as soon
+ * as they return.
+ */
+class MultiplexedCommandConsumer : public MessageListener {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Start receiving the sequence commands
+	 *
+	 * @param dispatcher the threads the handlers run on. If not given,
+	 * the handlers run on the delivery thread
+	 */
+	static pMultiplexedCommandConsumer create(util::pOrderedExecutor dispatcher =
+			util::pOrderedExecutor()) throw (CommunicationException);
+
+	/**
+	 * Destructor. Cleans up all the resources instantiated by this consumer
+	 */
+	virtual ~MultiplexedCommandConsumer() throw ();
+
+	/**
+	 * Hand the commands for the sequence command <code>id</code> and
+	 * the given activities to <code>handler</code>
+	 */
+	void subscribe(command::SequenceCommand id,
+			command::ActivitySet activities, pSequenceCommandHandler handler);
+
+	/**
+	 * Hand the apply commands for the configuration <code>prefix</code>
+	 * and the given activities to <code>handler</code>
+	 */
+	void subscribe(const std::string &prefix, command::ActivitySet activities,
+			pSequenceCommandHandler handler);
+
+	/**
+	 * Invoked by the JMS whenever a new message is received
+	 */
+	virtual void onMessage(const Message *message) throw ();
+
+private:
+	MultiplexedCommandConsumer(util::pOrderedExecutor dispatcher)
+			throw (CommunicationException);
+
+	/**
+	 * Close and destroy associated JMS resources used by this consumer
+	 */
+	void cleanup();
+
+	CommandRoutingTable _routes;
+
+	gmp::pConnectionManager _connectionManager;
+	pSession _session;
+
+	/**
+	 * Wildcard topic of all the sequence commands
+	 */
+	pDestination _destination;
+	pMessageConsumer _consumer;
+
+	/**
+	 * Runs the handlers and replies to the commands
+	 */
+	pCommandDispatcher _dispatcher;
+};
+
+}
+
+#endif /* MULTIPLEXEDCOMMANDCONSUMER_H_ */
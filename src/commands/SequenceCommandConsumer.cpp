@@ -13,6 +13,7 @@
 
 
 
+
 using namespace decaf::lang;
 
 
@@ -21,7 +22,9 @@ log4cxx::LoggerPtr SequenceCommandConsumer::logger(log4cxx::Logger::getLogger("g
 
 SequenceCommandConsumer::SequenceCommandConsumer(command::SequenceCommand id,
 		command::ActivitySet activities,
-		pSequenceCommandHandler handler) throw (CommunicationException) {
+		pSequenceCommandHandler handler,
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) :
+	_executor(dispatcher) {
 	_sequenceCommand = id;
 	init( JmsUtil::getTopic(id), activities, handler );
 
@@ -29,7 +32,9 @@ SequenceCommandConsumer::SequenceCommandConsumer(command::SequenceCommand id,
 
 SequenceCommandConsumer::SequenceCommandConsumer(const std::string & prefix,
 		command::ActivitySet activities,
-		pSequenceCommandHandler handler) throw (CommunicationException) {
+		pSequenceCommandHandler handler,
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) :
+	_executor(dispatcher) {
     _sequenceCommand = giapi::command::APPLY;
 	init( JmsUtil::getTopic(prefix), activities, handler );
 
@@ -41,6 +46,7 @@ void SequenceCommandConsumer::init(
 		pSequenceCommandHandler handler) throw (CommunicationException) {
 
 	_handler = handler;
+	_topic = topic;
 
 	try {
 
@@ -58,6 +64,8 @@ void SequenceCommandConsumer::init(
 		// Create a MessageConsumer from the Session to the Topic or Queue
 		_consumer = pMessageConsumer(_session->createConsumer( _destination.get(), selector ));
 
+		_dispatcher = pCommandDispatcher(new CommandDispatcher(_session, _executor));
+
 		_consumer->setMessageListener( this );
 	} catch (CMSException& e) {
 		//clean any resources that might have been allocated
@@ -76,20 +84,22 @@ SequenceCommandConsumer::~SequenceCommandConsumer() throw (){
 
 pSequenceCommandConsumer SequenceCommandConsumer::create(
 		command::SequenceCommand id, command::ActivitySet activities,
-		pSequenceCommandHandler handler) throw (CommunicationException) {
+		pSequenceCommandHandler handler,
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) {
 
 	pSequenceCommandConsumer consumer(new SequenceCommandConsumer(id,
-			activities, handler));
+			activities, handler, dispatcher));
 	return consumer;
 }
 
 
 pSequenceCommandConsumer SequenceCommandConsumer::create(
 		const std::string &prefix, command::ActivitySet activities,
-		pSequenceCommandHandler handler) throw (CommunicationException) {
+		pSequenceCommandHandler handler,
+		util::pOrderedExecutor dispatcher) throw (CommunicationException) {
 
 	pSequenceCommandConsumer consumer(new SequenceCommandConsumer(prefix,
-			activities, handler));
+			activities, handler, dispatcher));
 	return consumer;
 }
 
@@ -102,8 +112,6 @@ void SequenceCommandConsumer::onMessage(const Message* message) throw (){
 		const MapMessage* mapMessage =
 		dynamic_cast< const MapMessage* >( message );
 
-		std::vector< std::string > names = mapMessage->getMapNames();
-
 		//get the Action Id
 		int actionId = mapMessage->getIntProperty(GMPKeys::GMP_ACTIONID_PROP);
 		//get the activity Id;
@@ -112,47 +120,16 @@ void SequenceCommandConsumer::onMessage(const Message* message) throw (){
 		LOG4CXX_DEBUG(logger, "Received Sequence command (" << actionId << "): " << JmsUtil::getTopic(_sequenceCommand) << " Activity : " << mapMessage->getStringProperty(GMPKeys::GMP_ACTIVITY_PROP) );
 
 		//build a configuration object
-		pConfiguration config = ConfigurationFactory::getConfiguration();
-
-		for (std::vector< std:: string>::iterator i = names.begin(); i != names.end(); i++) {
-			config->setValue((*i), (mapMessage->getString(*i)));
-		}
-
-		pHandlerResponse response = _handler->handle(actionId, _sequenceCommand, activity, config);
-
-		LOG4CXX_DEBUG(logger, "Replying to sequence command:(" << actionId << "): " << JmsUtil::getHandlerResponse(response));
+		pConfiguration config = ConfigurationFactory::getConfiguration(mapMessage);
 
-		const Destination* destination = message->getCMSReplyTo();
-
-		if (destination == NULL) {
-			LOG4CXX_ERROR(logger, "Invalid destination received. Can't reply to request");
-			return;
-		}
-
-		pMessageProducer producer = pMessageProducer(_session->createProducer(destination));
-
-		MapMessage *reply = _session->createMapMessage();
-
-		JmsUtil::makeHandlerResponseMsg(reply, response);
-
-		producer->send(reply);
-
-		//delete allocated objects
-		delete reply;
-
-		//TODO: If I destroy this destination, the program exits.... :/
-		//Probably is destroyed as part of destroying the message, handled directly by the JMS provider.
-		//Confirm!
-		//delete destination;
-		//Close the producer used to reply
-		producer->close();
+		_dispatcher->dispatch(_topic, _handler, actionId, _sequenceCommand,
+				activity, config, message->getCMSReplyTo());
 
 	} catch (CMSException& e) {
 		e.printStackTrace();
 	}
 }
 
-
 std::string SequenceCommandConsumer::buildSelector(command::ActivitySet activities) {
 	std::string selector = GMPKeys::GMP_ACTIVITY_PROP + " IN ('";
 
@@ -201,6 +178,9 @@ void SequenceCommandConsumer::cleanup() {
 		if( _consumer.get() != 0 ) _consumer->close();
 	} catch (CMSException& e) {e.printStackTrace();}
 
+	//the commands still being handled reply through the session
+	if( _dispatcher.get() != 0 ) _dispatcher->close();
+
 	try {
 		if( _session.get() != 0 ) _session->close();
 	} catch (CMSException& e) {e.printStackTrace();}
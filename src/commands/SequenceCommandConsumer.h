@@ -17,6 +17,10 @@
 #include <log4cxx/logger.h>
 #include <tr1/memory>
 
+#include <util/OrderedExecutor.h>
+
+#include "CommandDispatcher.h"
+
 using namespace gmp;
 
 namespace giapi {
@@ -41,6 +45,16 @@ typedef std::tr1::shared_ptr<SequenceCommandConsumer> pSequenceCommandConsumer;
  * will react, processing the sequence command and invoking
  * the appropriate SequenceCommandHandler specified through
  * the CommandUtil::subscribeSequenceCommand() method in the GIAPI
+ * <p/>
+ * The handler is invoked on the JMS delivery thread of the consumer,
+ * unless a dispatcher is given. Then the handler runs on one of the
+ * threads of the dispatcher, so a handler that takes its time doesn't
+ * hold up the commands received after it, like a CANCEL. Commands for
+ * the same sequence command or apply prefix are still handled in the
+ * order they arrive, but a CANCEL and the commands for other sequence
+ * commands may be handled at the same time, so the handler must be
+ * thread-safe. Either way, the
+ * response of the handler is sent back as soon as it returns.
  *
  * @see CommandUtil::subscribeSequenceCommand()
  */
@@ -65,10 +79,13 @@ public:
 	 * the client implementation of a SequenceCommandHandler object that will
 	 * be invoked when this consumer receives the selected SequenceCommand and
 	 * Activity.
+	 * @param dispatcher the threads the handler runs on. If not given,
+	 * the handler runs on the JMS delivery thread of the consumer.
 	 */
 	static pSequenceCommandConsumer create(command::SequenceCommand id,
 			command::ActivitySet activities,
-			pSequenceCommandHandler handler) throw (CommunicationException);
+			pSequenceCommandHandler handler,
+			util::pOrderedExecutor dispatcher = util::pOrderedExecutor()) throw (CommunicationException);
 
 	/**
 	 * Static factory to construct a sequence command consumer for
@@ -89,10 +106,13 @@ public:
 	 * the client implementation of a SequenceCommandHandler object that will
 	 * be invoked when this consumer receives the selected SequenceCommand and
 	 * Activity.
+	 * @param dispatcher the threads the handler runs on. If not given,
+	 * the handler runs on the JMS delivery thread of the consumer.
 	 */
 	static pSequenceCommandConsumer create(const std::string & prefix,
 			command::ActivitySet activities,
-			pSequenceCommandHandler handler) throw (CommunicationException);
+			pSequenceCommandHandler handler,
+			util::pOrderedExecutor dispatcher = util::pOrderedExecutor()) throw (CommunicationException);
 
 	/**
 	 * Destructor. Cleans up all the resources instantiated by this consumer
@@ -119,10 +139,12 @@ private:
 	 * the client implementation of a SequenceCommandHandler object that will
 	 * be invoked when this consumer receives the selected SequenceCommand and
 	 * Activity.
+	 * @param dispatcher the threads the handler runs on, if any
 	 */
 	SequenceCommandConsumer(command::SequenceCommand id,
 			command::ActivitySet activities,
-			pSequenceCommandHandler handler) throw (CommunicationException);
+			pSequenceCommandHandler handler,
+			util::pOrderedExecutor dispatcher = util::pOrderedExecutor()) throw (CommunicationException);
 
 	 /**
 	 * Special constructor for the Apply Sequence Command Consumer.
@@ -139,10 +161,12 @@ private:
 	 * the client implementation of a SequenceCommandHandler object that will
 	 * be invoked when this consumer receives the selected SequenceCommand and
 	 * Activity.
+	 * @param dispatcher the threads the handler runs on, if any
 	 */
 	SequenceCommandConsumer(const std::string & prefix,
 			command::ActivitySet activities,
-			pSequenceCommandHandler handler) throw (CommunicationException);
+			pSequenceCommandHandler handler,
+			util::pOrderedExecutor dispatcher = util::pOrderedExecutor()) throw (CommunicationException);
 
 	/**
 	 * Takes care of the initialization of a SequenceCommandConsumer
@@ -179,6 +203,16 @@ private:
 	 */
 	pMessageConsumer _consumer;
 
+	/**
+	 * Threads the handler runs on. Null to run it on the delivery thread
+	 */
+	util::pOrderedExecutor _executor;
+
+	/**
+	 * Runs the handler and replies to the commands
+	 */
+	pCommandDispatcher _dispatcher;
+
 	/**
 	 * The handler to be invoked when a sequence command is received
 	 */
@@ -188,6 +222,12 @@ private:
 	 * The sequence command that is handled by this consumer
 	 */
 	command::SequenceCommand _sequenceCommand;
+
+	/**
+	 * The topic of the sequence command or apply prefix. The commands
+	 * received on it are handled in order
+	 */
+	std::string _topic;
 	
 	/**
 	 * The connection manager
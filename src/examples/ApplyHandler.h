@@ -75,8 +75,8 @@ public:
 			giapi::command::Activity activity, giapi::pConfiguration config) {
 
 		if (config != NULL) {
-			std::vector<std::string> keys = config->getKeys();
-			std::vector<std::string>::iterator it = keys.begin();
+			const std::vector<std::string> &keys = config->getKeys();
+			std::vector<std::string>::const_iterator it = keys.begin();
 			printf("Configuration\n");
 			for (; it < keys.end(); it++) {
 				std::cout << "{" << *it << " : " << config->getValue(*it)
@@ -31,8 +31,8 @@ public:
     {
         // Print the configuration if it was sent
         if (config != NULL && config->getSize() > 0) {
-			std::vector<std::string> keys = config->getKeys();
-			std::vector<std::string>::iterator it = keys.begin();
+			const std::vector<std::string> &keys = config->getKeys();
+			std::vector<std::string>::const_iterator it = keys.begin();
 			printf("Configuration\n");
 			for (; it < keys.end(); it++) {
 				std::cout << "{" << *it << " : " << config->getValue(*it)
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <signal.h>
 #include <sys/time.h>
+#include <vector>
 
 #include <decaf/util/concurrent/CountDownLatch.h>
 
@@ -40,27 +41,34 @@ int main(int argc, char **argv) {
 		signal(SIGINT, terminate);
         
 		decaf::util::concurrent::CountDownLatch lock(1);
+        //names and handles are built once, outside of the loop
+        std::vector<StatusHandle<int> > statusHandles;
+        std::vector<StatusHandle<int> > alarmHandles;
+        std::vector<std::string> alarmNames;
+        std::vector<std::string> healthNames;
         for(int j=0;j<nVars;j++){
             std::ostringstream oss;
             oss<<j;
             StatusUtil::createStatusItem("gpi:status"+oss.str(), type::INT);
             StatusUtil::createAlarmStatusItem("gpi:alarm"+oss.str(), type::INT);
             StatusUtil::createHealthStatusItem("gpi:health"+oss.str());
+            statusHandles.push_back(StatusUtil::getHandle<int>("gpi:status"+oss.str()));
+            alarmHandles.push_back(StatusUtil::getHandle<int>("gpi:alarm"+oss.str()));
+            alarmNames.push_back("gpi:alarm"+oss.str());
+            healthNames.push_back("gpi:health"+oss.str());
         }
 	
         timer.startTimer();
 		for (int i = 0; i < nReps; i++) {
             for(int j=0;j<nVars;j++){
-                std::ostringstream oss;
-                oss<<j;
-                StatusUtil::setValueAsInt("gpi:status"+oss.str(), i);
-                StatusUtil::setValueAsInt("gpi:alarm"+oss.str(), nReps-i);
+                statusHandles[j].set(i);
+                alarmHandles[j].set(nReps-i);
                 if(i%2==0){//alternate between alarm and no alarm, and between warning and good.
-                    StatusUtil::setAlarm("gpi:alarm"+oss.str(),giapi::alarm::ALARM_FAILURE,giapi::alarm::ALARM_CAUSE_HI,"Alarm message here!");
-                    StatusUtil::setHealth("gpi:health"+oss.str(),giapi::health::WARNING);
+                    StatusUtil::setAlarm(alarmNames[j],giapi::alarm::ALARM_FAILURE,giapi::alarm::ALARM_CAUSE_HI,"Alarm message here!");
+                    StatusUtil::setHealth(healthNames[j],giapi::health::WARNING);
                 }else{
-                    StatusUtil::setAlarm("gpi:alarm"+oss.str(),giapi::alarm::ALARM_OK,giapi::alarm::ALARM_CAUSE_OK,"");
-                    StatusUtil::setHealth("gpi:health"+oss.str(),giapi::health::GOOD);
+                    StatusUtil::setAlarm(alarmNames[j],giapi::alarm::ALARM_OK,giapi::alarm::ALARM_CAUSE_OK,"");
+                    StatusUtil::setHealth(healthNames[j],giapi::health::GOOD);
                 }
             }
             StatusUtil::postStatus();
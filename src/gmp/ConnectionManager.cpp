@@ -40,6 +40,10 @@ ConnectionManager::~ConnectionManager() {
 
 }
 
+int ConnectionManager::getGeneration() const {
+	return _generation.get();
+}
+
 void ConnectionManager::registerOperation(giapi_error_handler op) {
 	_errorHandlersFunctions.insert(op);
 }
@@ -77,6 +81,9 @@ void ConnectionManager::startup() throw (GmpException) {
 
 		_connection->setExceptionListener(this);
 
+		//objects created from a previous connection are now stale
+		_generation.incrementAndGet();
+
 	} catch (CMSException& e) {
 		throw GmpException("Problem connecting to GMP. " + e.getMessage());
 	}
@@ -9,6 +9,7 @@
 #include <cms/Session.h>
 #include <cms/ExceptionListener.h>
 #include <activemq/util/Config.h>
+#include <decaf/util/concurrent/atomic/AtomicInteger.h>
 
 #include <gmp/JmsUtil.h>
 #include <giapi/giapiexcept.h>
@@ -76,6 +77,16 @@ public:
 	virtual ~ConnectionManager();
 
 
+	/**
+	 * Return the number of times the connection to the broker has
+	 * been established. The value changes every time the connection
+	 * manager reconnects, so clients can tell when the JMS objects
+	 * they created from an older connection must be discarded.
+	 *
+	 * @return the current connection generation
+	 */
+	int getGeneration() const;
+
 	void registerOperation(giapi_error_handler  op);
 
 	void registerHandler(pGiapiErrorHandler handler);
@@ -92,6 +103,12 @@ private:
 	 */
 	pConnection _connection;
 
+	/**
+	 * Number of successful connections to the broker. Updated from
+	 * the exception listener thread when reconnecting
+	 */
+	decaf::util::concurrent::atomic::AtomicInteger _generation;
+
 	std::set<giapi_error_handler> _errorHandlersFunctions;
 
 	std::set<pGiapiErrorHandler> _errorHandlerObjects;
@@ -54,6 +54,7 @@ const std::string GMPKeys::GMP_SERVICES_LOG_DESTINATION = GMP_PREFIX + GMP_SEPAR
 const std::string GMPKeys::GMP_SERVICES_LOG_LEVEL = "LEVEL";
 
 const std::string GMPKeys::GMP_STATUS_DESTINATION_PREFIX = GMP_PREFIX + GMP_SEPARATOR + "STATUS" + GMP_SEPARATOR;
+const std::string GMPKeys::GMP_STATUS_BATCH_DESTINATION = GMP_PREFIX + GMP_SEPARATOR + "STATUS_BATCH";
 
 const std::string GMPKeys::GMP_GEMINI_EPICS_REQUEST_DESTINATION = GMP_PREFIX + GMP_SEPARATOR + "EPICS_REQUEST_DESTINATION";
 const std::string GMPKeys::GMP_GEMINI_EPICS_CHANNEL_PROPERTY = "EPICS_CHANNEL";
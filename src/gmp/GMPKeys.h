@@ -77,6 +77,7 @@ public:
 
 	//Status
 	const static std::string GMP_STATUS_DESTINATION_PREFIX;
+	const static std::string GMP_STATUS_BATCH_DESTINATION;
 
 	//Gemini Service Keys - EPICS Monitoring
 	const static std::string GMP_EPICS_TOPIC_PREFIX;
@@ -22,26 +22,31 @@ int AlarmStatusItem::setAlarmState(alarm::Severity severity,
 		return giapi::status::ERROR;
 	}
 
-	//If the values haven't changed since last time, we don't mark
-	// the status as dirty. Return immediately
-	if (_initialized) {
-		if (severity == _severity && cause == _cause && (message == _message)) {
-			return giapi::status::OK;
+	{
+		util::SeqLockWriteGuard guard(_lock);
+
+		//If the values haven't changed since last time, we don't mark
+		// the status as dirty. Return immediately
+		if (_initialized) {
+			if (severity == _severity && cause == _cause && (message == _message)) {
+				return giapi::status::OK;
+			}
+		} else {
+			_initialized = true;
 		}
-	} else {
-		_initialized = true;
-	}
 
-	_severity = severity;
-	//if the severity is NO_ALARM, the other arguments aren't considered
-	if (_severity == alarm::ALARM_OK) {
-		_cause = alarm::ALARM_CAUSE_OK;
-		_message.clear();
-	} else {
-		_cause = cause;
-		_message = message;
+		_severity = severity;
+		//if the severity is NO_ALARM, the other arguments aren't considered
+		if (_severity == alarm::ALARM_OK) {
+			_cause = alarm::ALARM_CAUSE_OK;
+			_message.clear();
+		} else {
+			_cause = cause;
+			_message = message;
+		}
+		_mark(); //mark the status item as dirty and set the timestamp
 	}
-	_mark(); //mark the status item as dirty and set the timestamp
+	_notify();
 
 	return giapi::status::OK;
 }
@@ -56,6 +61,21 @@ void AlarmStatusItem::clearAlarmState() {
 	}
 }
 
+void AlarmStatusItem::getAlarmState(alarm::Severity &severity,
+		alarm::Cause &cause, std::string &message) const {
+	//the message is copied, so this holds the lock
+	util::SeqLockWriteGuard guard(_lock);
+	severity = _severity;
+	cause = _cause;
+	message = _message;
+}
+
+void AlarmStatusItem::readChange(StatusChange &change) const {
+	StatusItem::readChange(change);
+	change.isAlarm = true;
+	getAlarmState(change.severity, change.cause, change.message);
+}
+
 const std::string & AlarmStatusItem::getMessage() const {
 	return _message;
 }
@@ -68,6 +88,10 @@ alarm::Cause AlarmStatusItem::getCause() const {
 	return _cause;
 }
 
+bool AlarmStatusItem::isUrgent() const {
+	return true;
+}
+
 void AlarmStatusItem::accept(StatusVisitor & visitor) {
 	visitor.visitAlarmItem(this);
 }
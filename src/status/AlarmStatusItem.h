@@ -63,6 +63,14 @@ public:
 	 */
 	void clearAlarmState();
 
+	/**
+	 * Copy the severity, cause and message of the alarm. The three
+	 * of them are consistent even if the alarm is being set by
+	 * another thread.
+	 */
+	void getAlarmState(alarm::Severity &severity, alarm::Cause &cause,
+			std::string &message) const;
+
 	/**
 	 * Return the (optional) message associated
 	 * to the alarm item. If no message is defined
@@ -87,12 +95,22 @@ public:
 	 */
 	alarm::Cause getCause() const;
 
+	/**
+	 * Alarms overtake the rest of the status
+	 */
+	virtual bool isUrgent() const;
 
 	/**
 	 * The accept interface for the visitor pattern
 	 */
 	void accept(StatusVisitor &);
 
+protected:
+	/**
+	 * Add the alarm state to the change
+	 */
+	virtual void readChange(StatusChange &change) const;
+
 };
 }
 
@@ -0,0 +1,220 @@
+#include "ArrayStatusItem.h"
+
+#include <cstring>
+#include <typeinfo>
+
+#include <endian.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr ArrayStatusItem::logger(log4cxx::Logger::getLogger(
+		"giapi.ArrayStatusItem"));
+
+/**
+ * Store a value at <code>out</code> in network byte order
+ */
+static void toNetwork(int value, unsigned char *out) {
+	uint32_t bits = htobe32((uint32_t) value);
+	memcpy(out, &bits, sizeof(bits));
+}
+
+static void toNetwork(float value, unsigned char *out) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = htobe32(bits);
+	memcpy(out, &bits, sizeof(bits));
+}
+
+static void toNetwork(double value, unsigned char *out) {
+	uint64_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	bits = htobe64(bits);
+	memcpy(out, &bits, sizeof(bits));
+}
+
+/**
+ * Copy the elements [first, first + count) into <code>bytes</code>
+ * in network byte order
+ */
+template<class T> static void copyToNetwork(const std::vector<T> &values,
+		size_t first, size_t count, std::vector<unsigned char> &bytes) {
+	bytes.resize(count * sizeof(T));
+	for (size_t i = 0; i < count; i++) {
+		toNetwork(values[first + i], &bytes[i * sizeof(T)]);
+	}
+}
+
+ArrayStatusItem::ArrayStatusItem(const std::string &name,
+		const type::Type type, size_t length, bool rangeUpdates) :
+	StatusItem(name, type), _length(length), _rangeUpdates(rangeUpdates),
+			_changedBegin(0), _changedEnd(length) {
+	switch (type) {
+	case type::INT:
+		_intValues.resize(length, 0);
+		break;
+	case type::DOUBLE:
+		_doubleValues.resize(length, 0.0);
+		break;
+	case type::FLOAT:
+		_floatValues.resize(length, 0.0f);
+		break;
+	default:
+		LOG4CXX_WARN(logger, "Arrays of this type are not supported: " << name);
+		break;
+	}
+}
+
+ArrayStatusItem::~ArrayStatusItem() {
+}
+
+bool ArrayStatusItem::isSupported(const type::Type type) {
+	return type == type::INT || type == type::DOUBLE || type == type::FLOAT;
+}
+
+size_t ArrayStatusItem::getLength() const {
+	return _length;
+}
+
+bool ArrayStatusItem::isRangeUpdates() const {
+	return _rangeUpdates;
+}
+
+template<class T> int ArrayStatusItem::_setValues(std::vector<T> &storage,
+		size_t offset, const T *values, size_t count) {
+	//the storage for the wrong type is empty
+	if (offset > storage.size() || count > storage.size() - offset) {
+		LOG4CXX_WARN(logger, "Can't set " << count << " values at " << offset
+				<< " in the array status item : " << *this);
+		return status::ERROR;
+	}
+	util::SeqLockWriteGuard guard(_lock);
+	//find the range that actually changes
+	size_t begin = 0;
+	while (begin < count && storage[offset + begin] == values[begin]) {
+		begin++;
+	}
+	if (begin == count) {
+		LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
+		return status::OK;
+	}
+	size_t end = count;
+	while (storage[offset + end - 1] == values[end - 1]) {
+		end--;
+	}
+	std::copy(values + begin, values + end, storage.begin() + offset + begin);
+
+	if (_changedBegin == _changedEnd) {
+		_changedBegin = offset + begin;
+		_changedEnd = offset + end;
+	} else {
+		_changedBegin = std::min(_changedBegin, offset + begin);
+		_changedEnd = std::max(_changedEnd, offset + end);
+	}
+	_mark();
+	return status::OK;
+}
+
+int ArrayStatusItem::setValues(size_t offset, const int *values, size_t count) {
+	return _setValues(_intValues, offset, values, count);
+}
+
+int ArrayStatusItem::setValues(size_t offset, const double *values,
+		size_t count) {
+	return _setValues(_doubleValues, offset, values, count);
+}
+
+int ArrayStatusItem::setValues(size_t offset, const float *values,
+		size_t count) {
+	return _setValues(_floatValues, offset, values, count);
+}
+
+template<class T> void ArrayStatusItem::_readValues(
+		const std::vector<T> &storage, T *values, long64 &timestamp) const {
+	if (storage.size() != _length) {
+		throw std::bad_cast();
+	}
+	unsigned int seq;
+	do {
+		seq = _lock.readBegin();
+		std::copy(storage.begin(), storage.end(), values);
+		timestamp = _time;
+	} while (_lock.readRetry(seq));
+}
+
+void ArrayStatusItem::readValues(int *values, long64 &timestamp) const {
+	_readValues(_intValues, values, timestamp);
+}
+
+void ArrayStatusItem::readValues(double *values, long64 &timestamp) const {
+	_readValues(_doubleValues, values, timestamp);
+}
+
+void ArrayStatusItem::readValues(float *values, long64 &timestamp) const {
+	_readValues(_floatValues, values, timestamp);
+}
+
+size_t ArrayStatusItem::readChanged(std::vector<unsigned char> &bytes,
+		size_t &first, long64 &timestamp) const {
+	//excludes the writers, so the range and the elements match
+	util::SeqLockWriteGuard guard(_lock);
+	size_t count;
+	if (_rangeUpdates) {
+		first = _changedBegin;
+		count = _changedEnd - _changedBegin;
+	} else {
+		first = 0;
+		count = _length;
+	}
+	timestamp = _time;
+
+	switch (getStatusType()) {
+	case type::INT:
+		copyToNetwork(_intValues, first, count, bytes);
+		break;
+	case type::DOUBLE:
+		copyToNetwork(_doubleValues, first, count, bytes);
+		break;
+	case type::FLOAT:
+		copyToNetwork(_floatValues, first, count, bytes);
+		break;
+	default:
+		bytes.clear();
+		count = 0;
+		break;
+	}
+	return count;
+}
+
+void ArrayStatusItem::acknowledgePost(unsigned long updates) {
+	util::SeqLockWriteGuard guard(_lock);
+	//changed after it was serialized, keep the whole range
+	if (getUpdateCount() == updates) {
+		_changedBegin = _changedEnd = 0;
+	}
+}
+
+int ArrayStatusItem::setValueAsInt(int value) {
+	LOG4CXX_WARN(logger, "Can't set a single value in the array status item : " << *this);
+	return status::ERROR;
+}
+
+int ArrayStatusItem::setValueAsString(const std::string &value) {
+	LOG4CXX_WARN(logger, "Can't set a single value in the array status item : " << *this);
+	return status::ERROR;
+}
+
+int ArrayStatusItem::setValueAsDouble(double value) {
+	LOG4CXX_WARN(logger, "Can't set a single value in the array status item : " << *this);
+	return status::ERROR;
+}
+
+int ArrayStatusItem::setValueAsFloat(float value) {
+	LOG4CXX_WARN(logger, "Can't set a single value in the array status item : " << *this);
+	return status::ERROR;
+}
+
+void ArrayStatusItem::accept(StatusVisitor &visitor) {
+	visitor.visitArrayItem(this);
+}
+
+}
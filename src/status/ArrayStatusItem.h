@@ -0,0 +1,150 @@
+#ifndef ARRAYSTATUSITEM_H_
+#define ARRAYSTATUSITEM_H_
+
+#include <vector>
+
+#include <status/StatusItem.h>
+#include <status/StatusVisitor.h>
+#include <giapi/giapi.h>
+
+namespace giapi {
+
+/**
+ * An Array Status Item holds a fixed number of values of the same
+ * type, like a thermal profile, that are published together as a
+ * single status item.
+ * <p/>
+ * The storage for the values is allocated when the item is created.
+ * Updates copy the new values into it, and only the elements that
+ * actually changed make the item dirty. The item keeps track of the
+ * range of elements changed since it was last posted, so it can
+ * be published either whole or as that range alone.
+ * <p/>
+ * Only type::INT, type::DOUBLE and type::FLOAT arrays are supported.
+ * The scalar setters always fail on an array status item.
+ */
+class ArrayStatusItem : public StatusItem {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+private:
+	size_t _length; //number of elements
+	bool _rangeUpdates; //publish only the changed elements
+
+	//storage for the elements. Only the one that matches the type is used
+	std::vector<int> _intValues;
+	std::vector<double> _doubleValues;
+	std::vector<float> _floatValues;
+
+	//elements changed since the last acknowledged post, end excluded
+	size_t _changedBegin;
+	size_t _changedEnd;
+
+	template<class T> int _setValues(std::vector<T> &storage, size_t offset,
+			const T *values, size_t count);
+
+	template<class T> void _readValues(const std::vector<T> &storage,
+			T *values, long64 &timestamp) const;
+
+public:
+	/**
+	 * Constructor. Initializes the status item with the
+	 * given (unique) <code>name</name>. The status item will store
+	 * <code>length</code> values of the given <code>type</code>, all
+	 * of them initially zero.
+	 *
+	 * @param rangeUpdates if true, each post carries only the
+	 *        elements changed since the previous one. Otherwise each
+	 *        post carries the whole array.
+	 */
+	ArrayStatusItem(const std::string &name, const type::Type type,
+			size_t length, bool rangeUpdates = false);
+
+	virtual ~ArrayStatusItem();
+
+	/**
+	 * Return true if arrays of the given type are supported
+	 */
+	static bool isSupported(const type::Type type);
+
+	/**
+	 * Return the number of elements in the array
+	 */
+	size_t getLength() const;
+
+	/**
+	 * Return true if posts carry only the changed elements
+	 */
+	bool isRangeUpdates() const;
+
+	/**
+	 * Copy <code>count</code> values into the array, starting at
+	 * element <code>offset</code>. The item is marked dirty only if
+	 * any of the elements changed.
+	 *
+	 * @return giapi::status::OK if the values were set,
+	 *         giapi::status::ERROR if the type of the values is not the
+	 *         type of the array, or if the range doesn't fit in it.
+	 */
+	int setValues(size_t offset, const int *values, size_t count);
+	int setValues(size_t offset, const double *values, size_t count);
+	int setValues(size_t offset, const float *values, size_t count);
+
+	/**
+	 * Copy all the elements of the array, and its timestamp, into
+	 * <code>values</code>, which must have room for getLength()
+	 * elements. The copy is consistent even if other threads update
+	 * the array concurrently.
+	 *
+	 * @throws bad_cast exception if the item doesn't store
+	 *         values of the requested type
+	 */
+	void readValues(int *values, long64 &timestamp) const;
+	void readValues(double *values, long64 &timestamp) const;
+	void readValues(float *values, long64 &timestamp) const;
+
+	/**
+	 * Copy the elements to publish into <code>bytes</code>, in network
+	 * byte order. The elements are the ones changed since the last
+	 * acknowledged post if the item does range updates, or all of them
+	 * otherwise. Until a post is acknowledged, that is all of them.
+	 * <p/>
+	 * Reading doesn't modify the item, so the same post can be
+	 * serialized more than once, and a failed post is sent again with
+	 * the same elements.
+	 *
+	 * @param bytes where the elements are stored. Resized as needed
+	 * @param first set to the index of the first element copied
+	 * @param timestamp set to the timestamp of the item
+	 *
+	 * @return the number of elements copied
+	 */
+	size_t readChanged(std::vector<unsigned char> &bytes, size_t &first,
+			long64 &timestamp) const;
+
+	/**
+	 * Forget the changed elements, unless the array changed again
+	 * after <code>updates</code> changes
+	 */
+	virtual void acknowledgePost(unsigned long updates);
+
+	/**
+	 * Arrays have no scalar value. These always return
+	 * giapi::status::ERROR
+	 */
+	virtual int setValueAsInt(int value);
+	virtual int setValueAsString(const std::string &value);
+	virtual int setValueAsDouble(double value);
+	virtual int setValueAsFloat(float value);
+
+	/**
+	 * The accept interface for the visitor pattern
+	 */
+	void accept(StatusVisitor &visitor);
+};
+
+}
+
+#endif /*ARRAYSTATUSITEM_H_*/
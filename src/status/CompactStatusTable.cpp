@@ -0,0 +1,314 @@
+#include "CompactStatusTable.h"
+
+#include <cstring>
+#include <sys/time.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr CompactStatusTable::logger(log4cxx::Logger::getLogger(
+		"giapi.CompactStatusTable"));
+
+/**
+ * Size of the blocks the names are copied into
+ */
+static const size_t NAME_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * FNV-1a, for the name index
+ */
+static uint32_t hashName(const char *name, size_t length) {
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < length; i++) {
+		hash ^= (unsigned char) name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+CompactStatusTable::CompactStatusTable(size_t capacity) throw (GiapiException) :
+	_capacity(capacity), _size(0), _indexSize(2 * capacity),
+			_nameCursor(0), _nameBlockFree(0), _extraBytes(0) {
+	if (capacity == 0) {
+		throw GiapiException("Compact status table needs at least one item");
+	}
+	_names.reset(new const char *[capacity]);
+	_kinds.reset(new uint8_t[capacity]);
+	_types.reset(new uint8_t[capacity]);
+	_values.reset(new Value[capacity]);
+	_timestamps.reset(new long64[capacity]);
+	_alarms.reset(new AlarmState *[capacity]);
+	_locks.reset(new util::SeqLock[capacity]);
+	size_t words = (capacity + 63) / 64;
+	_changed.reset(new std::atomic<uint64_t>[words]);
+	for (size_t w = 0; w < words; w++) {
+		_changed[w] = 0;
+	}
+	_index.reset(new std::atomic<int32_t>[_indexSize]);
+	for (size_t i = 0; i < _indexSize; i++) {
+		_index[i] = -1;
+	}
+}
+
+CompactStatusTable::~CompactStatusTable() {
+	size_t size = _size.load();
+	for (size_t id = 0; id < size; id++) {
+		if (_types[id] == type::STRING) {
+			delete _values[id].stringValue;
+		}
+		delete _alarms[id];
+	}
+}
+
+int CompactStatusTable::create(const std::string &name,
+		StatusItemSpec::Kind kind, type::Type type) {
+	if (kind == StatusItemSpec::HEALTH) {
+		type = type::INT;
+	}
+	if (type != type::INT && type != type::DOUBLE && type != type::FLOAT
+			&& type != type::STRING) {
+		LOG4CXX_WARN(logger, "Can't create status item " << name
+				<< ", the type is not supported");
+		return -1;
+	}
+
+	std::lock_guard<std::mutex> guard(_createLock);
+	size_t id = _size.load(std::memory_order_relaxed);
+	if (id == _capacity) {
+		LOG4CXX_WARN(logger, "Compact status table is full, can't create " << name);
+		return -1;
+	}
+	size_t bucket = hashName(name.c_str(), name.size()) % _indexSize;
+	for (;; bucket = (bucket + 1) % _indexSize) {
+		int32_t existing = _index[bucket].load(std::memory_order_relaxed);
+		if (existing < 0) {
+			break;
+		}
+		if (name.compare(_names[existing]) == 0) {
+			return -1;
+		}
+	}
+
+	_names[id] = intern(name);
+	_kinds[id] = kind;
+	_types[id] = type;
+	if (type == type::STRING) {
+		_values[id].stringValue = new std::string();
+		_extraBytes += sizeof(std::string);
+	} else {
+		_values[id].doubleValue = 0;
+	}
+	_alarms[id] = 0;
+	if (kind == StatusItemSpec::ALARM) {
+		_alarms[id] = new AlarmState();
+		_alarms[id]->severity = alarm::ALARM_OK;
+		_alarms[id]->cause = alarm::ALARM_CAUSE_OK;
+		_extraBytes += sizeof(AlarmState);
+	}
+	//initially, the items are changed, and the timestamp is now
+	_timestamps[id] = now();
+	_changed[id / 64].fetch_or(1ull << (id % 64), std::memory_order_release);
+
+	//publish the entry, then its name
+	_size.store(id + 1, std::memory_order_release);
+	_index[bucket].store(id, std::memory_order_release);
+	return id;
+}
+
+int CompactStatusTable::find(const std::string &name) const {
+	size_t bucket = hashName(name.c_str(), name.size()) % _indexSize;
+	for (;; bucket = (bucket + 1) % _indexSize) {
+		int32_t id = _index[bucket].load(std::memory_order_acquire);
+		if (id < 0) {
+			return -1;
+		}
+		if (name.compare(_names[id]) == 0) {
+			return id;
+		}
+	}
+}
+
+const char * CompactStatusTable::intern(const std::string &name) {
+	size_t length = name.size() + 1;
+	if (length > _nameBlockFree) {
+		size_t blockSize = length > NAME_BLOCK_SIZE ? length : NAME_BLOCK_SIZE;
+		_nameBlocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+		_nameCursor = _nameBlocks.back().get();
+		_nameBlockFree = blockSize;
+		_extraBytes += blockSize;
+	}
+	char *copy = _nameCursor;
+	memcpy(copy, name.c_str(), length);
+	_nameCursor += length;
+	_nameBlockFree -= length;
+	return copy;
+}
+
+bool CompactStatusTable::beginWrite(int id, type::Type type) {
+	if (id < 0 || (size_t) id >= _size.load(std::memory_order_acquire)
+			|| _types[id] != type) {
+		return false;
+	}
+	_locks[id].writeLock();
+	return true;
+}
+
+void CompactStatusTable::endWrite(int id, bool changed) {
+	if (changed) {
+		_timestamps[id] = now();
+	}
+	_locks[id].writeUnlock();
+	if (changed) {
+		_changed[id / 64].fetch_or(1ull << (id % 64), std::memory_order_release);
+	}
+}
+
+int CompactStatusTable::setValue(int id, int value) {
+	if (!beginWrite(id, type::INT)) {
+		return status::ERROR;
+	}
+	bool changed = _values[id].intValue != value;
+	_values[id].intValue = value;
+	endWrite(id, changed);
+	return status::OK;
+}
+
+int CompactStatusTable::setValue(int id, double value) {
+	if (!beginWrite(id, type::DOUBLE)) {
+		return status::ERROR;
+	}
+	bool changed = _values[id].doubleValue != value;
+	_values[id].doubleValue = value;
+	endWrite(id, changed);
+	return status::OK;
+}
+
+int CompactStatusTable::setValue(int id, float value) {
+	if (!beginWrite(id, type::FLOAT)) {
+		return status::ERROR;
+	}
+	bool changed = _values[id].floatValue != value;
+	_values[id].floatValue = value;
+	endWrite(id, changed);
+	return status::OK;
+}
+
+int CompactStatusTable::setValue(int id, const std::string &value) {
+	if (!beginWrite(id, type::STRING)) {
+		return status::ERROR;
+	}
+	bool changed = *_values[id].stringValue != value;
+	*_values[id].stringValue = value;
+	endWrite(id, changed);
+	return status::OK;
+}
+
+int CompactStatusTable::setAlarm(int id, alarm::Severity severity,
+		alarm::Cause cause, const std::string &message) {
+	if (cause == alarm::ALARM_CAUSE_OTHER && message.empty()) {
+		return status::ERROR;
+	}
+	if (id < 0 || (size_t) id >= _size.load(std::memory_order_acquire)
+			|| _alarms[id] == 0) {
+		return status::ERROR;
+	}
+	_locks[id].writeLock();
+	AlarmState &state = *_alarms[id];
+	bool changed = state.severity != severity || state.cause != cause
+			|| state.message != message;
+	state.severity = severity;
+	state.cause = cause;
+	state.message = message;
+	endWrite(id, changed);
+	return status::OK;
+}
+
+int CompactStatusTable::clearAlarm(int id) {
+	return setAlarm(id, alarm::ALARM_OK, alarm::ALARM_CAUSE_OK);
+}
+
+int CompactStatusTable::setHealth(int id, health::Health health) {
+	if (id < 0 || (size_t) id >= _size.load(std::memory_order_acquire)
+			|| _kinds[id] != StatusItemSpec::HEALTH) {
+		return status::ERROR;
+	}
+	return setValue(id, (int) health);
+}
+
+void CompactStatusTable::read(int id, Record &record) const {
+	record.name = _names[id];
+	record.kind = (StatusItemSpec::Kind) _kinds[id];
+	record.type = (type::Type) _types[id];
+	if (record.type == type::STRING || _alarms[id] != 0) {
+		//the strings can change under a reader, so they are
+		//copied holding the lock
+		util::SeqLockWriteGuard guard(_locks[id]);
+		if (record.type == type::STRING) {
+			record.stringValue = *_values[id].stringValue;
+		} else {
+			record.doubleValue = _values[id].doubleValue;
+		}
+		if (_alarms[id] != 0) {
+			record.severity = _alarms[id]->severity;
+			record.cause = _alarms[id]->cause;
+			record.message = _alarms[id]->message;
+		}
+		record.timestamp = _timestamps[id];
+		return;
+	}
+	unsigned int seq;
+	do {
+		seq = _locks[id].readBegin();
+		record.doubleValue = _values[id].doubleValue;
+		record.timestamp = _timestamps[id];
+	} while (_locks[id].readRetry(seq));
+}
+
+void CompactStatusTable::takeChanged(std::vector<int> &ids) {
+	size_t words = (_size.load(std::memory_order_acquire) + 63) / 64;
+	for (size_t w = 0; w < words; w++) {
+		if (_changed[w].load(std::memory_order_relaxed) == 0) {
+			continue;
+		}
+		uint64_t bits = _changed[w].exchange(0, std::memory_order_acquire);
+		while (bits != 0) {
+			int bit = __builtin_ctzll(bits);
+			ids.push_back(w * 64 + bit);
+			bits &= bits - 1;
+		}
+	}
+}
+
+void CompactStatusTable::markChanged(const std::vector<int> &ids) {
+	for (std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+		_changed[*it / 64].fetch_or(1ull << (*it % 64), std::memory_order_release);
+	}
+}
+
+bool CompactStatusTable::isUrgent(int id) const {
+	return _kinds[id] != StatusItemSpec::BASIC;
+}
+
+size_t CompactStatusTable::getSize() const {
+	return _size.load();
+}
+
+size_t CompactStatusTable::getCapacity() const {
+	return _capacity;
+}
+
+size_t CompactStatusTable::getMemoryUsage() const {
+	size_t perItem = sizeof(const char *) + 2 * sizeof(uint8_t)
+			+ sizeof(Value) + sizeof(long64) + sizeof(AlarmState *)
+			+ sizeof(util::SeqLock);
+	return sizeof(CompactStatusTable) + _capacity * perItem + (_capacity
+			+ 63) / 64 * sizeof(uint64_t) + _indexSize * sizeof(int32_t)
+			+ _extraBytes.load();
+}
+
+long64 CompactStatusTable::now() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return ((long64) tv.tv_sec) * 1000 + tv.tv_usec / 1000;
+}
+
+}
@@ -0,0 +1,259 @@
+#ifndef COMPACTSTATUSTABLE_H_
+#define COMPACTSTATUSTABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+#include <giapi/StatusUtil.h>
+#include <util/SeqLock.h>
+
+namespace giapi {
+
+class CompactStatusTable;
+typedef std::tr1::shared_ptr<CompactStatusTable> pCompactStatusTable;
+
+/**
+ * Status items stored column by column, for instruments with tens of
+ * thousands of them.
+ * <p/>
+ * A status item here is not an object but an id, the index of its
+ * entry in a set of arrays: one for the names, one for the types,
+ * one for the values, one for the timestamps, and so on. The names
+ * are interned, copied once into large blocks. Only string values and
+ * alarm states, which are rare, live in their own allocations.
+ * <p/>
+ * Changed items are tracked in a bitmap with one bit per id, so
+ * finding what to post means walking the bitmap a word at a time,
+ * skipping 64 clean items per compare.
+ * <p/>
+ * The capacity is fixed when the table is built, so the arrays never
+ * move and any number of threads can set values while others read
+ * them. Each entry is protected by its own sequence lock.
+ */
+class CompactStatusTable {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * A copy of the data of one status item
+	 */
+	struct Record {
+		const char *name;
+		StatusItemSpec::Kind kind;
+		type::Type type;
+		union {
+			int intValue;
+			float floatValue;
+			double doubleValue;
+		};
+		std::string stringValue;
+		long64 timestamp;
+		/**
+		 * Alarm state, only for alarm status items
+		 */
+		alarm::Severity severity;
+		alarm::Cause cause;
+		std::string message;
+	};
+
+	/**
+	 * Build a table that holds up to <code>capacity</code> status items
+	 *
+	 * @throws GiapiException if the capacity is zero
+	 */
+	explicit CompactStatusTable(size_t capacity) throw (GiapiException);
+
+	virtual ~CompactStatusTable();
+
+	/**
+	 * Create a status item.
+	 *
+	 * @param kind what the status item holds besides its value. Health
+	 *        status items hold health::Health values, and ignore
+	 *        <code>type</code>.
+	 *
+	 * @return the id of the new status item, or -1 if the table is
+	 *         full, the type is not supported, or there is already an
+	 *         item with the same name
+	 */
+	int create(const std::string &name, StatusItemSpec::Kind kind,
+			type::Type type);
+
+	/**
+	 * Return the id of the named status item, or -1 if there is none
+	 */
+	int find(const std::string &name) const;
+
+	/**
+	 * Set the value of the status item. It's marked as changed unless
+	 * the value is the same it already had.
+	 *
+	 * @return giapi::status::OK if the value was set,
+	 *         giapi::status::ERROR if the id is not valid or the item
+	 *         doesn't hold values of this type
+	 */
+	int setValue(int id, int value);
+	int setValue(int id, double value);
+	int setValue(int id, float value);
+	int setValue(int id, const std::string &value);
+
+	/**
+	 * Set the alarm state of an alarm status item
+	 *
+	 * @return giapi::status::ERROR if the id is not an alarm status
+	 *         item, or the cause is alarm::ALARM_CAUSE_OTHER with no
+	 *         message
+	 */
+	int setAlarm(int id, alarm::Severity severity, alarm::Cause cause,
+			const std::string &message = std::string());
+
+	/**
+	 * Clear the alarm state of an alarm status item
+	 */
+	int clearAlarm(int id);
+
+	/**
+	 * Set the health of a health status item
+	 */
+	int setHealth(int id, health::Health health);
+
+	/**
+	 * Copy the data of the status item. The copy is consistent even if
+	 * other threads are setting the item.
+	 */
+	void read(int id, Record &record) const;
+
+	/**
+	 * Return true for alarm and health status items, which are posted
+	 * ahead of the rest
+	 */
+	bool isUrgent(int id) const;
+
+	/**
+	 * Collect the ids of the items changed since the last call, in id
+	 * order, and mark them as not changed.
+	 *
+	 * @param ids where the ids are appended
+	 */
+	void takeChanged(std::vector<int> &ids);
+
+	/**
+	 * Mark the given items as changed again, when they couldn't be
+	 * posted
+	 */
+	void markChanged(const std::vector<int> &ids);
+
+	/**
+	 * Number of status items in the table
+	 */
+	size_t getSize() const;
+
+	/**
+	 * Maximum number of status items in the table
+	 */
+	size_t getCapacity() const;
+
+	/**
+	 * Bytes of memory used by the table, including the names, string
+	 * values and alarm states allocated so far
+	 */
+	size_t getMemoryUsage() const;
+
+private:
+	/**
+	 * The value of an entry. Strings keep their own allocation
+	 */
+	union Value {
+		int intValue;
+		float floatValue;
+		double doubleValue;
+		std::string *stringValue;
+	};
+
+	struct AlarmState {
+		alarm::Severity severity;
+		alarm::Cause cause;
+		std::string message;
+	};
+
+	/**
+	 * Store the name in the name blocks, returning the copy
+	 */
+	const char * intern(const std::string &name);
+
+	/**
+	 * Lock the entry for writing, if <code>id</code> is a valid
+	 * entry of the given type
+	 */
+	bool beginWrite(int id, type::Type type);
+
+	/**
+	 * Stamp the entry, mark it as changed and release it
+	 */
+	void endWrite(int id, bool changed);
+
+	/**
+	 * Current time, in milliseconds since the epoch
+	 */
+	static long64 now();
+
+	size_t _capacity;
+	std::atomic<size_t> _size;
+
+	/**
+	 * The columns, indexed by id
+	 */
+	std::unique_ptr<const char *[]> _names;
+	std::unique_ptr<uint8_t[]> _kinds;
+	std::unique_ptr<uint8_t[]> _types;
+	std::unique_ptr<Value[]> _values;
+	std::unique_ptr<long64[]> _timestamps;
+	std::unique_ptr<AlarmState *[]> _alarms;
+	std::unique_ptr<util::SeqLock[]> _locks;
+
+	/**
+	 * One bit per id, set when the item changes
+	 */
+	std::unique_ptr<std::atomic<uint64_t>[]> _changed;
+
+	/**
+	 * Open addressing hash index from names to ids, twice as large
+	 * as the capacity. Free buckets hold -1.
+	 */
+	std::unique_ptr<std::atomic<int32_t>[]> _index;
+	size_t _indexSize;
+
+	/**
+	 * Blocks holding the interned names, where the next name goes
+	 * and the free space left in the last block. Only used while creating items, holding _createLock
+	 */
+	std::vector<std::unique_ptr<char[]> > _nameBlocks;
+	char *_nameCursor;
+	size_t _nameBlockFree;
+
+	/**
+	 * Bytes allocated for names, string values and alarm states
+	 */
+	std::atomic<size_t> _extraBytes;
+
+	std::mutex _createLock;
+
+	CompactStatusTable(const CompactStatusTable &);
+	CompactStatusTable & operator=(const CompactStatusTable &);
+};
+
+}
+
+#endif /* COMPACTSTATUSTABLE_H_ */
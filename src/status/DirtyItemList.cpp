@@ -0,0 +1,57 @@
+#include "DirtyItemList.h"
+#include "StatusItem.h"
+
+namespace giapi {
+
+DirtyItemList::DirtyItemList() :
+	_pushed(0), _head(0) {
+}
+
+DirtyItemList::~DirtyItemList() {
+	//unlink whatever is left, so the items can be queued elsewhere
+	while (pop() != 0)
+		;
+}
+
+void DirtyItemList::push(StatusItem *item) {
+	if (item->_queued.exchange(true)) {
+		return; //already in the list
+	}
+	StatusItem *top = _pushed.load(std::memory_order_relaxed);
+	do {
+		item->_nextDirty = top;
+	} while (!_pushed.compare_exchange_weak(top, item,
+			std::memory_order_release, std::memory_order_relaxed));
+}
+
+StatusItem * DirtyItemList::pop() {
+	std::lock_guard<std::mutex> guard(_popLock);
+	if (_head == 0) {
+		//take over the pushed items, reversing them to get
+		//the oldest one first
+		StatusItem *item = _pushed.exchange(0, std::memory_order_acquire);
+		while (item != 0) {
+			StatusItem *next = item->_nextDirty;
+			item->_nextDirty = _head;
+			_head = item;
+			item = next;
+		}
+	}
+
+	StatusItem *item = _head;
+	if (item == 0) {
+		return 0;
+	}
+	_head = item->_nextDirty;
+	item->_nextDirty = 0;
+	//from now on the item can be queued again
+	item->_queued.store(false);
+	return item;
+}
+
+bool DirtyItemList::isEmpty() const {
+	std::lock_guard<std::mutex> guard(_popLock);
+	return _head == 0 && _pushed.load() == 0;
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef DIRTYITEMLIST_H_
+#define DIRTYITEMLIST_H_
+
+#include <atomic>
+#include <mutex>
+
+namespace giapi {
+
+class StatusItem;
+
+/**
+ * An intrusive FIFO list of the status items that have changed since
+ * the last time they were posted.
+ *
+ * The items are linked through a pointer they hold themselves, so
+ * queueing an item never allocates memory, and an item is present
+ * at most once in the list no matter how many times it changes
+ * before it gets posted.
+ *
+ * Any number of threads can push items concurrently without
+ * blocking. Pushed items go to a lock-free stack that pop() takes
+ * over as a whole and reverses, so items are still returned in the
+ * order they were pushed.
+ */
+class DirtyItemList {
+public:
+	DirtyItemList();
+	virtual ~DirtyItemList();
+
+	/**
+	 * Append the item at the end of the list. Nothing is
+	 * done if the item is already in the list.
+	 */
+	void push(StatusItem *item);
+
+	/**
+	 * Remove the oldest item in the list and return it.
+	 *
+	 * @return the oldest item in the list or NULL if the
+	 *         list is empty
+	 */
+	StatusItem * pop();
+
+	/**
+	 * Return true if there are no items in the list
+	 */
+	bool isEmpty() const;
+
+private:
+	/**
+	 * Items pushed since the last time pop() took them over,
+	 * newest first
+	 */
+	std::atomic<StatusItem *> _pushed;
+
+	/**
+	 * Items taken over by pop(), oldest first. Only accessed
+	 * holding _popLock
+	 */
+	StatusItem *_head;
+
+	mutable std::mutex _popLock;
+};
+
+}
+
+#endif /* DIRTYITEMLIST_H_ */
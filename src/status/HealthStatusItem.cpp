@@ -19,6 +19,10 @@ int HealthStatusItem::setHealth(health::Health health) {
 
 }
 
+bool HealthStatusItem::isUrgent() const {
+	return true;
+}
+
 void HealthStatusItem::accept(StatusVisitor & visitor) {
 	visitor.visitHealthItem(this);
 }
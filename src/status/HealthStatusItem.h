@@ -37,6 +37,11 @@ public:
 	 */
 	int setHealth(const health::Health health);
 
+	/**
+	 * Health changes overtake the rest of the status
+	 */
+	virtual bool isUrgent() const;
+
 	/**
 	 * The accept interface for the visitor pattern
 	 */
@@ -1,50 +1,106 @@
 #include "KvPair.h"
-#include <giapi/giapi.h>
+#include <typeinfo>
 
 namespace giapi {
 
-KvPair::KvPair(const std::string & name) {
+KvPair::KvPair(const std::string & name) :
+	_hasValue(false), _valueType(type::INT) {
 	_name = name;
+	_value.doubleValue = 0.0;
 }
 
 KvPair::~KvPair() {
 }
 
+void KvPair::initValue(const type::Type type) {
+	_hasValue = true;
+	_valueType = type;
+	switch (type) {
+	case type::BOOLEAN:
+		_value.boolValue = false;
+		break;
+	case type::DOUBLE:
+		_value.doubleValue = 0.0;
+		break;
+	case type::FLOAT:
+		_value.floatValue = 0.0f;
+		break;
+	case type::INT:
+		_value.intValue = 0;
+		break;
+	case type::BYTE:
+		_value.byteValue = 0;
+		break;
+	case type::SHORT:
+		_value.shortValue = 0;
+		break;
+	case type::STRING:
+		_stringValue.reserve(STRING_RESERVE);
+		_stringValue.assign(" ");
+		break;
+	}
+}
+
+bool KvPair::hasValue(const type::Type type) const {
+	return _hasValue && _valueType == type;
+}
+
 int KvPair::setValueAsInt(int value) {
-	_value = value;
+	_hasValue = true;
+	_valueType = type::INT;
+	_value.intValue = value;
 	return status::OK;
 }
 
 int KvPair::setValueAsString(const std::string &value) {
-	_value = value;
+	_hasValue = true;
+	_valueType = type::STRING;
+	//reuses the current buffer when possible
+	_stringValue.assign(value);
 	return status::OK;
 }
 
 int KvPair::setValueAsDouble(double value) {
-	_value = value;
+	_hasValue = true;
+	_valueType = type::DOUBLE;
+	_value.doubleValue = value;
 	return status::OK;
 }
 
 int KvPair::setValueAsFloat(float value) {
-	_value = value;
+	_hasValue = true;
+	_valueType = type::FLOAT;
+	_value.floatValue = value;
 	return status::OK;
 }
 
 
 int KvPair::getValueAsInt() const {
-	return boost::any_cast<int>(_value);
+	if (!hasValue(type::INT)) {
+		throw std::bad_cast();
+	}
+	return _value.intValue;
 }
 
-const std::string KvPair::getValueAsString() const {
-	return boost::any_cast<std::string>(_value);
+const std::string & KvPair::getValueAsString() const {
+	if (!hasValue(type::STRING)) {
+		throw std::bad_cast();
+	}
+	return _stringValue;
 }
 
 double KvPair::getValueAsDouble() const {
-	return boost::any_cast<double>(_value);
+	if (!hasValue(type::DOUBLE)) {
+		throw std::bad_cast();
+	}
+	return _value.doubleValue;
 }
 
 float KvPair::getValueAsFloat() const {
-	return boost::any_cast<float>(_value);
+	if (!hasValue(type::FLOAT)) {
+		throw std::bad_cast();
+	}
+	return _value.floatValue;
 }
 
 
@@ -52,29 +108,36 @@ const std::string & KvPair::getName() const {
 	return _name;
 }
 
-const std::type_info& KvPair::getType() const {
-	return _value.type();
-}
-
 std::ostream& operator<< (std::ostream& os, const KvPair& pair) {
 
 	os << "[name = " << pair.getName() << ", value = ";
-	const std::type_info& typeInfo = pair.getType();
 
-	if (typeInfo == typeid(int)) {
-		os << pair.getValueAsInt();
-	}
-	if (typeInfo == typeid(std::string)) {
-		os << pair.getValueAsString();
-	}
-	if (typeInfo == typeid(double)) {
-		os << pair.getValueAsDouble();
-	}
-	if (typeInfo == typeid(float)) {
-		os << pair.getValueAsFloat();
-	}
-	if (typeInfo == typeid(void)) {
+	if (!pair._hasValue) {
 		os << "void";
+	} else {
+		switch (pair._valueType) {
+		case type::INT:
+			os << pair._value.intValue;
+			break;
+		case type::STRING:
+			os << pair._stringValue;
+			break;
+		case type::DOUBLE:
+			os << pair._value.doubleValue;
+			break;
+		case type::FLOAT:
+			os << pair._value.floatValue;
+			break;
+		case type::BOOLEAN:
+			os << pair._value.boolValue;
+			break;
+		case type::BYTE:
+			os << (int) pair._value.byteValue;
+			break;
+		case type::SHORT:
+			os << pair._value.shortValue;
+			break;
+		}
 	}
 
 	os << "]";
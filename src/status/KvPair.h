@@ -1,8 +1,8 @@
 #ifndef KVPAIR_H_
 #define KVPAIR_H_
-#include <boost/any.hpp>
+#include <giapi/giapi.h>
 
-#include <typeinfo>
+#include <string>
 #include <ostream>
 /**
  * A class that holds a key associated to a value.
@@ -11,19 +11,58 @@ namespace giapi {
 
 class KvPair {
 private:
+	/**
+	 * Strings up to this size are stored without further allocations
+	 * once the pair is initialized
+	 */
+	static const size_t STRING_RESERVE = 64;
 protected:
 	KvPair(const std::string &name);
-	boost::any _value;
+
+	/**
+	 * Whether a value has been stored in this pair
+	 */
+	bool _hasValue;
+
+	/**
+	 * Type of the value stored in this pair. Defined by the last
+	 * value stored in the object.
+	 */
+	type::Type _valueType;
+
+	/**
+	 * Storage for the numeric values. The member in use
+	 * is selected by _valueType
+	 */
+	union {
+		bool boolValue;
+		int intValue;
+		float floatValue;
+		double doubleValue;
+		unsigned char byteValue;
+		unsigned short shortValue;
+	} _value;
+
+	/**
+	 * Storage for type::STRING values. Its buffer is kept
+	 * across updates, so setting a new value doesn't allocate
+	 * memory unless the value is longer than any previous one.
+	 */
+	std::string _stringValue;
+
 	std::string _name;
 
 	/**
-	 * Returns the type information associated to the
-	 * value stored in this pair. The type information
-	 * is defined based on the last value stored in the object.
-	 * If the value has not been set, the type of the stored
-	 * item is void.
+	 * Set the value to the zero value of the given type. For
+	 * type::STRING values, reserves the string storage as well.
+	 */
+	void initValue(const type::Type type);
+
+	/**
+	 * Returns true if a value of the given type is
+	 * stored in this pair
 	 */
-	const std::type_info & getType() const;
+	bool hasValue(const type::Type type) const;
 public:
 	virtual ~KvPair();
 	const std::string & getName() const;
@@ -113,7 +152,7 @@ public:
 	 *
 	 * @throws bad_cast exception if the stored item is not a string
 	 */
-	const std::string getValueAsString() const;
+	const std::string & getValueAsString() const;
 
 
 	/**
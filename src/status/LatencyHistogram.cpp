@@ -0,0 +1,44 @@
+#include "LatencyHistogram.h"
+
+namespace giapi {
+
+LatencyHistogram::LatencyHistogram() :
+	_count(0), _total(0), _max(0) {
+	for (int i = 0; i < BUCKETS; i++) {
+		_buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void LatencyHistogram::record(Clock::duration elapsed) {
+	long long ns =
+			std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	unsigned long long nanoseconds = ns > 0 ? ns : 0;
+
+	//bucket i holds [2^(i-1), 2^i) microseconds
+	unsigned long long micros = nanoseconds / 1000;
+	int bucket = micros == 0 ? 0 : 64 - __builtin_clzll(micros);
+	if (bucket >= BUCKETS) {
+		bucket = BUCKETS - 1;
+	}
+	_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+	unsigned long long max = _max.load(std::memory_order_relaxed);
+	while (nanoseconds > max && !_max.compare_exchange_weak(max, nanoseconds,
+			std::memory_order_relaxed)) {
+	}
+}
+
+void LatencyHistogram::read(LatencyStatistics &stats) const {
+	stats.count = _count.load(std::memory_order_relaxed);
+	double total = _total.load(std::memory_order_relaxed) / 1000.0;
+	stats.meanLatency = stats.count > 0 ? total / stats.count : 0;
+	stats.maxLatency = _max.load(std::memory_order_relaxed) / 1000.0;
+	stats.buckets.resize(BUCKETS);
+	for (int i = 0; i < BUCKETS; i++) {
+		stats.buckets[i] = _buckets[i].load(std::memory_order_relaxed);
+	}
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <atomic>
+#include <chrono>
+
+#include <giapi/StatusUtil.h>
+
+namespace giapi {
+
+/**
+ * Counts how long an operation takes, in power of two buckets of
+ * microseconds. Recording is a few relaxed atomic operations, so it
+ * can be left on in the paths that post status; readers get counters
+ * that are each up to date, though not necessarily consistent with
+ * each other while operations are recorded.
+ */
+class LatencyHistogram {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * Number of buckets. The last one starts at about 4 seconds
+	 */
+	static const int BUCKETS = 24;
+
+	LatencyHistogram();
+
+	/**
+	 * Count an operation that took <code>elapsed</code>
+	 */
+	void record(Clock::duration elapsed);
+
+	/**
+	 * Count an operation that started at <code>start</code> and
+	 * ends now
+	 */
+	void recordSince(Clock::time_point start) {
+		record(Clock::now() - start);
+	}
+
+	/**
+	 * Copy the counters
+	 */
+	void read(LatencyStatistics &stats) const;
+
+private:
+	std::atomic<unsigned long> _buckets[BUCKETS];
+	std::atomic<unsigned long> _count;
+	/**
+	 * Total and maximum time, in nanoseconds
+	 */
+	std::atomic<unsigned long long> _total;
+	std::atomic<unsigned long long> _max;
+
+	LatencyHistogram(const LatencyHistogram &);
+	LatencyHistogram & operator=(const LatencyHistogram &);
+};
+
+}
+
+#endif /* LATENCYHISTOGRAM_H_ */
@@ -3,6 +3,8 @@
 #include <giapi/giapi.h>
 #include "AlarmStatusItem.h"
 #include "HealthStatusItem.h"
+#include "ArrayStatusItem.h"
+#include "TransactionLog.h"
 
 namespace giapi {
 
@@ -10,13 +12,26 @@ log4cxx::LoggerPtr StatusDatabase::logger(log4cxx::Logger::getLogger("giapi.Stat
 
 pStatusDatabase StatusDatabase::INSTANCE(new StatusDatabase());
 
-StatusDatabase::StatusDatabase() {
+StatusDatabase::StatusDatabase() :
+	_started(std::chrono::steady_clock::now()), _unknownItems(0) {
 }
 
 StatusDatabase::~StatusDatabase() {
 	LOG4CXX_DEBUG(logger, "Cleaning database...");	
+	//items could outlive the database, stop tracking them first
+	while (_dirtyItems.pop() != 0)
+		;
+	while (_urgentItems.pop() != 0)
+		;
+	for (std::vector<pStatusItem>::iterator it = _statusItemList.begin(); it
+			!= _statusItemList.end(); ++it) {
+		(*it)->setDirtyList(0);
+		(*it)->setObservers(0);
+	}
 	_statusItemList.clear();
-	_map.clear();
+	for (size_t i = 0; i < NUM_SHARDS; i++) {
+		_shards[i].map.clear();
+	}
 }
 
 pStatusDatabase StatusDatabase::Instance() {
@@ -25,17 +40,15 @@ pStatusDatabase StatusDatabase::Instance() {
 
 int StatusDatabase::createStatusItem(const std::string & name, const type::Type type) {
 
-	if (getStatusItem(name).get() != 0) {
+	LOG4CXX_DEBUG(logger, "Creating a Status Item for " << name);
+	//make a new status item and store it in the map.
+	pStatusItem item(new StatusItem(name, type));
+	if (!registerItem(item)) {
 		//status item already present.
 		LOG4CXX_DEBUG(logger, "StatusDatabase::createStatusItem. A status item "
 				" with the name " << name << " already created. No action");
 		return status::ERROR;
 	}
-	LOG4CXX_DEBUG(logger, "Creating a Status Item for " << name);
-	//make a new status item and store it in the map.
-	pStatusItem item(new StatusItem(name, type));
-	_map[name] = item;
-	_statusItemList.push_back(item);
 	return status::OK;
 
 }
@@ -43,37 +56,115 @@ int StatusDatabase::createStatusItem(const std::string & name, const type::Type
 int StatusDatabase::createAlarmStatusItem(const std::string &name,
 		const type::Type type) {
 
-	if (getStatusItem(name).get() != 0) {
+	LOG4CXX_DEBUG(logger, "Creating an Alarm Status Item for " << name);
+	//make a new status item and store it in the map.
+	pStatusItem item(new AlarmStatusItem(name, type));
+	if (!registerItem(item)) {
 		//status item already present.
 		LOG4CXX_DEBUG(logger, "StatusDatabase::createAlarmStatusItem. A status item "
 				" with the name " << name << " already created. No action");
 		return status::ERROR;
 	}
-	LOG4CXX_DEBUG(logger, "Creating an Alarm Status Item for " << name);
-	//make a new status item and store it in the map.
-	pStatusItem item(new AlarmStatusItem(name, type));
-	_map[name] = item;
-	_statusItemList.push_back(item);
 	return status::OK;
 }
 
 int StatusDatabase::createHealthStatusItem(const std::string & name) {
 
-	if (getStatusItem(name).get() != 0) {
+	LOG4CXX_DEBUG(logger, "Creating a Health Status Item for " << name);
+	//make a new status item and store it in the map.
+	pStatusItem item(new HealthStatusItem(name));
+	if (!registerItem(item)) {
 		//status item already present.
 		LOG4CXX_DEBUG(logger, "StatusDatabase::createHealthStatusItem. A status item "
 				" with the name " << name << " already created. No action");
 		return status::ERROR;
 	}
+	return status::OK;
+}
 
-	LOG4CXX_DEBUG(logger, "Creating a Health Status Item for " << name);
-	//make a new status item and store it in the map.
-	pStatusItem item(new HealthStatusItem(name));
-	_map[name] = item;
-	_statusItemList.push_back(item);
+int StatusDatabase::createArrayStatusItem(const std::string &name,
+		const type::Type type, size_t length, bool rangeUpdates) {
+
+	LOG4CXX_DEBUG(logger, "Creating an Array Status Item for " << name);
+	if (!ArrayStatusItem::isSupported(type) || length == 0) {
+		LOG4CXX_WARN(logger, "Can't create array status item " << name
+				<< ", the type is not supported or the length is zero");
+		return status::ERROR;
+	}
+	pStatusItem item(new ArrayStatusItem(name, type, length, rangeUpdates));
+	if (!registerItem(item)) {
+		//status item already present.
+		LOG4CXX_DEBUG(logger, "StatusDatabase::createArrayStatusItem. A status item "
+				" with the name " << name << " already created. No action");
+		return status::ERROR;
+	}
 	return status::OK;
 }
 
+int StatusDatabase::createStatusItems(const std::vector<StatusItemSpec> &items) {
+	//build the items, grouped by shard
+	std::vector<pStatusItem> created(items.size());
+	std::vector<std::vector<size_t> > byShard(NUM_SHARDS);
+	for (size_t i = 0; i < items.size(); i++) {
+		const StatusItemSpec &spec = items[i];
+		switch (spec.kind) {
+		case StatusItemSpec::ALARM:
+			created[i].reset(new AlarmStatusItem(spec.name, spec.type));
+			break;
+		case StatusItemSpec::HEALTH:
+			created[i].reset(new HealthStatusItem(spec.name));
+			break;
+		default:
+			created[i].reset(new StatusItem(spec.name, spec.type));
+			break;
+		}
+		byShard[std::hash<std::string>()(spec.name) % NUM_SHARDS].push_back(i);
+	}
+
+	//store them, locking each shard once
+	int result = status::OK;
+	for (size_t s = 0; s < NUM_SHARDS; s++) {
+		if (byShard[s].empty()) {
+			continue;
+		}
+		Shard &shard = _shards[s];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		shard.map.reserve(shard.map.size() + byShard[s].size());
+		for (std::vector<size_t>::const_iterator it = byShard[s].begin(); it
+				!= byShard[s].end(); ++it) {
+			pStatusItem &item = created[*it];
+			if (!shard.map.insert(StringStatusMap::value_type(item->getName(),
+					item)).second) {
+				LOG4CXX_DEBUG(logger, "StatusDatabase::createStatusItems. A status item "
+						" with the name " << item->getName() << " already created. No action");
+				item.reset();
+				result = status::ERROR;
+			}
+		}
+	}
+
+	//keep the creation order in the list
+	{
+		std::lock_guard<std::mutex> guard(_itemsLock);
+		_statusItemList.reserve(_statusItemList.size() + items.size());
+		for (std::vector<pStatusItem>::const_iterator it = created.begin(); it
+				!= created.end(); ++it) {
+			if (it->get() != 0) {
+				_statusItemList.push_back(*it);
+			}
+		}
+	}
+	for (std::vector<pStatusItem>::const_iterator it = created.begin(); it
+			!= created.end(); ++it) {
+		if (it->get() != 0) {
+			_observers.attach(it->get());
+			(*it)->setDirtyList(getDirtyList(it->get()));
+		}
+	}
+	LOG4CXX_DEBUG(logger, "Created " << items.size() << " status items");
+	return result;
+}
+
 int StatusDatabase::setHealth(const std::string &name, const health::Health health) {
 	pStatusItem statusItem = getStatusItem(name);
 	if (statusItem.get() == 0) {
@@ -89,7 +180,10 @@ int StatusDatabase::setHealth(const std::string &name, const health::Health heal
 	}
 
 	//set the values in the alarm item
-	return healthStatusItem->setHealth(health);
+	return TransactionLog::applyOrStage(statusItem, statusItem->getStatusType(),
+			[healthStatusItem, health] {
+				return healthStatusItem->setHealth(health);
+			});
 }
 
 int StatusDatabase::setStatusValueAsInt(const std::string & name, int value) {
@@ -97,7 +191,44 @@ int StatusDatabase::setStatusValueAsInt(const std::string & name, int value) {
 	if (statusItem.get() == 0) {
 		return status::ERROR;
 	}
-	return statusItem->setValueAsInt(value);
+	return TransactionLog::applyOrStage(statusItem, type::INT, [statusItem, value] {
+		return statusItem->setValueAsInt(value);
+	});
+}
+
+/**
+ * Set the values of the named array status item, if there is one
+ */
+template<class T> static int setArrayValues(const pStatusItem &statusItem,
+		size_t offset, const T *values, size_t count) {
+	ArrayStatusItem *arrayItem = dynamic_cast<ArrayStatusItem*> (statusItem.get());
+	if (arrayItem == 0) {
+		return status::ERROR;
+	}
+	if (TransactionLog::current() == 0) {
+		return arrayItem->setValues(offset, values, count);
+	}
+	//the caller's buffer may be reused before the commit
+	std::vector<T> copy(values, values + count);
+	return TransactionLog::applyOrStage(statusItem, statusItem->getStatusType(),
+			[arrayItem, offset, copy] {
+				return arrayItem->setValues(offset, copy.data(), copy.size());
+			});
+}
+
+int StatusDatabase::setStatusArrayValues(const std::string &name,
+		size_t offset, const int *values, size_t count) {
+	return setArrayValues(getStatusItem(name), offset, values, count);
+}
+
+int StatusDatabase::setStatusArrayValues(const std::string &name,
+		size_t offset, const double *values, size_t count) {
+	return setArrayValues(getStatusItem(name), offset, values, count);
+}
+
+int StatusDatabase::setStatusArrayValues(const std::string &name,
+		size_t offset, const float *values, size_t count) {
+	return setArrayValues(getStatusItem(name), offset, values, count);
 }
 
 int StatusDatabase::setStatusValueAsString(const std::string & name, const std::string & value) {
@@ -105,7 +236,9 @@ int StatusDatabase::setStatusValueAsString(const std::string & name, const std::
 	if (statusItem.get() == 0) {
 		return status::ERROR;
 	}
-	return statusItem->setValueAsString(value);
+	return TransactionLog::applyOrStage(statusItem, type::STRING, [statusItem, value] {
+		return statusItem->setValueAsString(value);
+	});
 }
 
 int StatusDatabase::setStatusValueAsDouble(const std::string & name, double value) {
@@ -113,7 +246,9 @@ int StatusDatabase::setStatusValueAsDouble(const std::string & name, double valu
 	if (statusItem.get() == 0) {
 		return status::ERROR;
 	}
-	return statusItem->setValueAsDouble(value);
+	return TransactionLog::applyOrStage(statusItem, type::DOUBLE, [statusItem, value] {
+		return statusItem->setValueAsDouble(value);
+	});
 }
 
 int StatusDatabase::setStatusValueAsFloat(const std::string & name, float value) {
@@ -121,7 +256,9 @@ int StatusDatabase::setStatusValueAsFloat(const std::string & name, float value)
 	if (statusItem.get() == 0) {
 		return status::ERROR;
 	}
-	return statusItem->setValueAsFloat(value);
+	return TransactionLog::applyOrStage(statusItem, type::FLOAT, [statusItem, value] {
+		return statusItem->setValueAsFloat(value);
+	});
 }
 
 
@@ -129,7 +266,14 @@ pStatusItem StatusDatabase::getStatusItem(const std::string & name) {
 	if (name.empty()) {
 		return pStatusItem((StatusItem *)0); //NULL
 	}
-	return _map[name];
+	Shard &shard = getShard(name);
+	std::lock_guard<std::mutex> guard(shard.lock);
+	StringStatusMap::const_iterator it = shard.map.find(name);
+	if (it == shard.map.end()) {
+		_unknownItems.fetch_add(1, std::memory_order_relaxed);
+		return pStatusItem((StatusItem *)0); //NULL
+	}
+	return it->second;
 }
 
 int StatusDatabase::setAlarm(const std::string &name, const alarm::Severity severity,
@@ -148,8 +292,15 @@ int StatusDatabase::setAlarm(const std::string &name, const alarm::Severity seve
 		return status::ERROR;
 	}
 
-	//set the values in the alarm item
-	return alarmStatusItem->setAlarmState(severity, cause, message);
+	//set the values in the alarm item. A missing message
+	//is reported now rather than on commit
+	if (cause == alarm::ALARM_CAUSE_OTHER && message.empty()) {
+		return alarmStatusItem->setAlarmState(severity, cause, message);
+	}
+	return TransactionLog::applyOrStage(statusItem, statusItem->getStatusType(),
+			[alarmStatusItem, severity, cause, message] {
+				return alarmStatusItem->setAlarmState(severity, cause, message);
+			});
 }
 
 int StatusDatabase::clearAlarm(const std::string &name) {
@@ -167,14 +318,110 @@ int StatusDatabase::clearAlarm(const std::string &name) {
 	}
 
 	//set the values in the alarm item
-	alarmStatusItem->clearAlarmState();
-	return status::OK;
+	return TransactionLog::applyOrStage(statusItem, statusItem->getStatusType(),
+			[alarmStatusItem] {
+				alarmStatusItem->clearAlarmState();
+				return (int) status::OK;
+			});
 }
 
-const std::vector<pStatusItem>& StatusDatabase::getStatusItems() {
+std::vector<pStatusItem> StatusDatabase::getStatusItems() {
+	std::lock_guard<std::mutex> guard(_itemsLock);
 	return _statusItemList;
 }
 
+void StatusDatabase::getStatistics(StatusStatistics &stats) {
+	stats.elapsed = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - _started).count();
+	stats.unknownItems = _unknownItems.load(std::memory_order_relaxed);
+	stats.updates = 0;
+
+	std::vector<pStatusItem> items = getStatusItems();
+	stats.items.resize(items.size());
+	for (size_t i = 0; i < items.size(); i++) {
+		StatusItemStatistics &item = stats.items[i];
+		item.name = items[i]->getName();
+		item.updates = items[i]->getUpdateCount();
+		item.posts = items[i]->getPostCount();
+		item.postRate = stats.elapsed > 0 ? item.posts / stats.elapsed : 0;
+		stats.updates += item.updates;
+	}
+}
+
+StatusDatabase::Shard & StatusDatabase::getShard(const std::string &name) {
+	return _shards[std::hash<std::string>()(name) % NUM_SHARDS];
+}
+
+bool StatusDatabase::registerItem(pStatusItem item) {
+	Shard &shard = getShard(item->getName());
+	{
+		std::lock_guard<std::mutex> guard(shard.lock);
+		if (!shard.map.insert(StringStatusMap::value_type(item->getName(),
+				item)).second) {
+			return false;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> guard(_itemsLock);
+		_statusItemList.push_back(item);
+	}
+	_observers.attach(item.get());
+	//new items are dirty, so this queues them as well
+	item->setDirtyList(getDirtyList(item.get()));
+	return true;
+}
+
+int StatusDatabase::addObserver(const std::string &pattern,
+		const StatusObserver &observer, bool async) {
+	int id = _observers.add(pattern, observer, async);
+	if (id == status::ERROR) {
+		return status::ERROR;
+	}
+	//items created from now on are attached as they are registered.
+	//Attaching again the ones in this copy is harmless
+	std::vector<pStatusItem> items = getStatusItems();
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		_observers.attach(it->get());
+	}
+	return id;
+}
+
+int StatusDatabase::removeObserver(int id) {
+	if (_observers.remove(id) == status::ERROR) {
+		return status::ERROR;
+	}
+	std::vector<pStatusItem> items = getStatusItems();
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		_observers.attach(it->get());
+	}
+	return status::OK;
+}
+
+DirtyItemList * StatusDatabase::getDirtyList(const StatusItem *item) {
+	return item->isUrgent() ? &_urgentItems : &_dirtyItems;
+}
+
+pStatusItem StatusDatabase::nextDirtyItem() {
+	StatusItem *item = _urgentItems.pop();
+	if (item == 0) {
+		item = _dirtyItems.pop();
+	}
+	if (item == 0) {
+		return pStatusItem((StatusItem *)0); //NULL
+	}
+	return item->shared_from_this();
+}
+
+pStatusItem StatusDatabase::nextUrgentItem() {
+	StatusItem *item = _urgentItems.pop();
+	if (item == 0) {
+		return pStatusItem((StatusItem *)0); //NULL
+	}
+	return item->shared_from_this();
+}
+
 
 
 }
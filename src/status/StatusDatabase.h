@@ -1,17 +1,23 @@
 #ifndef STATUSDATABASE_H_
 #define STATUSDATABASE_H_
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
 #include <vector>
+#include <mutex>
 
 #include <log4cxx/logger.h>
 
 #include <giapi/giapi.h>
 #include <giapi/giapiexcept.h>
+#include <giapi/StatusUtil.h>
 
 #include <util/giapiMaps.h>
 #include <tr1/memory>
 
 #include "StatusItem.h"
+#include "DirtyItemList.h"
+#include "StatusObservers.h"
 
 namespace giapi {
 
@@ -24,6 +30,11 @@ typedef std::tr1::shared_ptr<StatusDatabase> pStatusDatabase;
 /**
  * The status database is a repository of all the status items in the system.
  * Provides mechanisms to handle different operation over the stored items
+ * <p/>
+ * The database can be used from several threads. Items are spread over
+ * a fixed number of shards by the hash of their name, each one with its
+ * own lock, so lookups of different items seldom contend. Lookups never
+ * modify the database.
  */
 class StatusDatabase {
 	/**
@@ -38,14 +49,76 @@ class StatusDatabase {
 	typedef std::unordered_map<const std::string, pStatusItem,  std::hash<std::string>, util::eqstr >
 			StringStatusMap;
 
+	/**
+	 * Number of shards the status items are spread over
+	 */
+	static const size_t NUM_SHARDS = 32;
+
+	/**
+	 * A portion of the name to status item map
+	 */
+	struct Shard {
+		std::mutex lock;
+		StringStatusMap map;
+	};
+
 private:
-	StringStatusMap _map;
+	Shard _shards[NUM_SHARDS];
+
+	/**
+	 * All the status items, in creation order. Protected by _itemsLock
+	 */
 	std::vector<pStatusItem> _statusItemList;
+	std::mutex _itemsLock;
+
+	/**
+	 * The items that changed since the last time they were posted.
+	 * Urgent items, like alarms and health, have their own list so
+	 * they don't wait behind the rest.
+	 */
+	DirtyItemList _dirtyItems;
+	DirtyItemList _urgentItems;
+
+	/**
+	 * Return the dirty list the item belongs to
+	 */
+	DirtyItemList * getDirtyList(const StatusItem *item);
+
+	/**
+	 * The observers of the status items
+	 */
+	StatusObservers _observers;
+
+	/**
+	 * When the database was created, the start of the statistics
+	 */
+	std::chrono::steady_clock::time_point _started;
+
+	/**
+	 * Lookups of names that are not in the database. Relaxed
+	 * counter, only touched in the error path
+	 */
+	std::atomic<unsigned long> _unknownItems;
+
 	static pStatusDatabase INSTANCE;
 	/**
 	 * Private constructor
 	 */
 	StatusDatabase();
+
+	/**
+	 * Return the shard the given status item name belongs to
+	 */
+	Shard & getShard(const std::string &name);
+
+	/**
+	 * Store a newly created item in the database and start
+	 * tracking its changes.
+	 *
+	 * @return true if the item was stored, false if there is
+	 *         an item with the same name already.
+	 */
+	bool registerItem(pStatusItem item);
 public:
 	/**
 	 * Get the unique instance of the database
@@ -98,6 +171,35 @@ public:
 	 */
 	int createHealthStatusItem(const std::string &name);
 
+	/**
+	 * Create several status items in one pass. The storage for all
+	 * of them is reserved first, and each shard is locked once.
+	 *
+	 * @param items the status items to create, in order
+	 *
+	 * @return giapi::status::OK if all the items were created,
+	 *         giapi::status::ERROR if there was already a status item
+	 *         with the name of any of them. The rest are created anyway.
+	 */
+	int createStatusItems(const std::vector<StatusItemSpec> &items);
+
+	/**
+	 * Create an array status item
+	 *
+	 * @param name Name of the array status item
+	 * @param type Type of the elements. Only type::INT, type::DOUBLE
+	 *        and type::FLOAT are supported
+	 * @param length Number of elements in the array
+	 * @param rangeUpdates Publish only the changed elements
+	 *
+	 * @return giapi::status::OK if the item was successfully created,
+	 *         giapi::status::ERROR if the type is not supported, the
+	 *         length is zero, or there was already a status item with
+	 *         the same name
+	 */
+	int createArrayStatusItem(const std::string &name, const type::Type type,
+			size_t length, bool rangeUpdates);
+
 	/**
 	 * Set the health value for the given health status item
 	 *
@@ -134,6 +236,22 @@ public:
 	 */
 	int setStatusValueAsInt(const std::string &name, int value);
 
+	/**
+	 * Copy <code>count</code> values into the given array status item,
+	 * starting at element <code>offset</code>
+	 *
+	 * @return giapi::status::OK if the values were set correctly
+	 *         giapi::status::ERROR if there is no array status item
+	 *         associated to the <code>name</code>, the type of the
+	 *         values doesn't match, or the range doesn't fit in the array
+	 */
+	int setStatusArrayValues(const std::string &name, size_t offset,
+			const int *values, size_t count);
+	int setStatusArrayValues(const std::string &name, size_t offset,
+			const double *values, size_t count);
+	int setStatusArrayValues(const std::string &name, size_t offset,
+			const float *values, size_t count);
+
 	/**
 	 * Set the value of the given status item to the provided
 	 * string value.
@@ -236,7 +354,57 @@ public:
 	 */
 	pStatusItem getStatusItem(const std::string &name);
 
-	const std::vector<pStatusItem>& getStatusItems();
+	/**
+	 * Return a copy of the list of status items in the
+	 * database, in creation order.
+	 */
+	std::vector<pStatusItem> getStatusItems();
+
+	/**
+	 * Register an observer and attach it to the status items whose
+	 * name matches the pattern, including those created from now on.
+	 *
+	 * @return the id of the observer, or giapi::status::ERROR if it
+	 *         can't be registered
+	 * @see StatusUtil::addObserver()
+	 */
+	int addObserver(const std::string &pattern, const StatusObserver &observer,
+			bool async);
+
+	/**
+	 * Unregister an observer and detach it from its status items
+	 *
+	 * @return giapi::status::ERROR if there is no such observer
+	 */
+	int removeObserver(int id);
+
+	/**
+	 * Remove the oldest status item from the list of items that have
+	 * been marked dirty since they were last returned by this method.
+	 * Only the items that changed are visited, so draining this list
+	 * costs O(dirty) rather than O(items).
+	 * <p/>
+	 * Urgent items (see StatusItem::isUrgent()) come first, then the
+	 * rest, each in the order they became dirty. The caller must
+	 * still check StatusItem::isChanged(), since the item could have
+	 * been posted individually after it was queued.
+	 *
+	 * @return the oldest dirty status item, or NULL if there is none
+	 */
+	pStatusItem nextDirtyItem();
+
+	/**
+	 * Like nextDirtyItem(), but only for the urgent items
+	 *
+	 * @return the oldest dirty urgent item, or NULL if there is none
+	 */
+	pStatusItem nextUrgentItem();
+
+	/**
+	 * Fill in the counters of the status items, and those of the
+	 * database. The senders are left for the caller.
+	 */
+	void getStatistics(StatusStatistics &stats);
 
 	virtual ~StatusDatabase();
 
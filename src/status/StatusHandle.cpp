@@ -0,0 +1,55 @@
+#include <giapi/StatusHandle.h>
+
+#include "StatusItem.h"
+#include "TransactionLog.h"
+#include <status/senders/StatusSenderFactory.h>
+
+namespace giapi {
+
+template<class T> StatusHandle<T>::StatusHandle() {
+}
+
+template<class T> StatusHandle<T>::StatusHandle(
+		const std::tr1::shared_ptr<StatusItem> &item) :
+	_item(item) {
+}
+
+template<class T> bool StatusHandle<T>::isValid() const {
+	return _item.get() != 0;
+}
+
+template<class T> const std::string & StatusHandle<T>::getName() const {
+	static const std::string EMPTY;
+	if (_item.get() == 0) {
+		return EMPTY;
+	}
+	return _item->getName();
+}
+
+template<class T> int StatusHandle<T>::set(const T &value) {
+	if (_item.get() == 0) {
+		return status::ERROR;
+	}
+	//the type was checked when the handle was created. Staged
+	//changes keep their own reference to the item
+	StatusItem *item = _item.get();
+	return TransactionLog::applyOrStage(_item, _item->getStatusType(),
+			[item, value] {
+				return item->storeValue(value);
+			});
+}
+
+template<class T> int StatusHandle<T>::post() throw (GiapiException) {
+	if (_item.get() == 0) {
+		return status::ERROR;
+	}
+	pStatusSender sender = StatusSenderFactory::Instance()->getStatusSender();
+	return sender->postStatusItem(_item);
+}
+
+template class StatusHandle<int> ;
+template class StatusHandle<double> ;
+template class StatusHandle<float> ;
+template class StatusHandle<std::string> ;
+
+}
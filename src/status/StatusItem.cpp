@@ -1,47 +1,103 @@
 #include "StatusItem.h"
+#include "StatusObservers.h"
 
 #include <giapi/giapi.h>
 #include <giapi/giapiexcept.h>
 
 #include <sys/time.h>
+#include <cmath>
 
 namespace giapi {
 
 log4cxx::LoggerPtr StatusItem::logger(log4cxx::Logger::getLogger("giapi.StatusItem"));
 
+thread_local long64 StatusItem::t_commitTime = 0;
+thread_local std::vector<StatusItem *> *StatusItem::t_committed = 0;
+thread_local const StatusItem *StatusItem::t_commitItem = 0;
+
 StatusItem::StatusItem(const std::string &name, const type::Type type) :
-	KvPair(name) {
+	KvPair(name), _dirtyList(0), _nextDirty(0), _queued(false), _pending(false),
+			_absoluteDeadband(0), _relativeDeadband(0), _deadbandReference(0),
+			_minPostInterval(0), _lastPostTime(0), _postScheduled(false), _observers(0), _updates(0), _posts(0) {
 	_mark(); //initially, the items are dirty, and the timestamp is now.
+	_updates.store(0, std::memory_order_relaxed); //not a change
 	_type = type;
-	//initial values for each type:
-	switch (_type) {
-	case type::BOOLEAN:
-		_value = false;
-		break;
-	case type::DOUBLE:
-		_value = 0.0;
-		break;
-	case type::FLOAT:
-		_value = (float)0.0;
-		break;
-	case type::INT:
-		_value = 0;
-		break;
-	case type::BYTE:
-		_value = (unsigned char)0;
-		break;
-	case type::SHORT:
-		_value = (unsigned short)0;
-		break;
-	case type::STRING:
-		_value = std::string(" ");
-		break;
-	}
+	//initial values for each type
+	initValue(_type);
 }
 
 StatusItem::~StatusItem() {
 }
 
+/**
+ * Access to the value stored in the pair for each type, bypassing
+ * the type checks of the StatusItem setters
+ */
+static bool sameValue(const KvPair &pair, int value) {
+	return value == pair.getValueAsInt();
+}
+
+static bool sameValue(const KvPair &pair, double value) {
+	return value == pair.getValueAsDouble();
+}
+
+static bool sameValue(const KvPair &pair, float value) {
+	return value == pair.getValueAsFloat();
+}
+
+static int storeInPair(KvPair &pair, int value) {
+	return pair.KvPair::setValueAsInt(value);
+}
+
+static int storeInPair(KvPair &pair, double value) {
+	return pair.KvPair::setValueAsDouble(value);
+}
+
+static int storeInPair(KvPair &pair, float value) {
+	return pair.KvPair::setValueAsFloat(value);
+}
+
+template<class T> int StatusItem::storeValue(const T &value) {
+	{
+		util::SeqLockWriteGuard guard(_lock);
+		//Figure out if this is a new value. If they are the same, return immediately
+		if (hasValue(_type) && sameValue(*this, value)) {
+			LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
+			return status::OK;
+		}
+		if (_withinDeadband(value)) {
+			LOG4CXX_DEBUG(logger, "Value within deadband. Won't mark as dirty. Item " << *this);
+			return storeInPair(*this, value);
+		}
+		//set the value
+		_mark();
+		_deadbandReference = value;
+		storeInPair(*this, value);
+	}
+	_notify();
+	return status::OK;
+}
+
+template<> int StatusItem::storeValue(const std::string &value) {
+	{
+		util::SeqLockWriteGuard guard(_lock);
+		//Figure out if this is a new value. If they are the same, return immediately
+		if (hasValue(_type) && (value == getValueAsString())) {
+			LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
+			return status::OK;
+		}
+
+		_mark();
+		KvPair::setValueAsString(value);
+	}
+	_notify();
+	return status::OK;
+}
+
+template int StatusItem::storeValue<int>(const int &);
+template int StatusItem::storeValue<double>(const double &);
+template int StatusItem::storeValue<float>(const float &);
+
 int StatusItem::setValueAsInt(int value) {
 
 	//If the type is not integer, return error.
@@ -49,14 +105,7 @@ int StatusItem::setValueAsInt(int value) {
 		LOG4CXX_WARN(logger, "Can't set an int value in the status item : " << *this);
 		return status::ERROR;
 	}
-	//Figure out if this is a new value. If they are the same, return immediately
-	if (!_value.empty() && value == getValueAsInt()) {
-		LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
-		return status::OK;
-	}
-	//set the value
-	_mark();
-	return KvPair::setValueAsInt(value);
+	return storeValue(value);
 }
 
 int StatusItem::setValueAsString(const std::string &value) {
@@ -66,14 +115,7 @@ int StatusItem::setValueAsString(const std::string &value) {
 		LOG4CXX_WARN(logger, "Can't set a string value in the status item : " << *this);
 		return status::ERROR;
 	}
-	//Figure out if this is a new value. If they are the same, return immediately
-	if (!_value.empty() && (value == getValueAsString())) {
-		LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
-		return status::OK;
-	}
-
-	_mark();
-	return KvPair::setValueAsString(value);
+	return storeValue(value);
 }
 
 int StatusItem::setValueAsDouble(double value) {
@@ -83,14 +125,7 @@ int StatusItem::setValueAsDouble(double value) {
 		LOG4CXX_WARN(logger, "Can't set a double value in the status item : " << *this);
 		return status::ERROR;
 	}
-	//Figure out if this is a new value. If they are the same, return immediately
-	if (!_value.empty() && value == getValueAsDouble()) {
-		LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
-		return status::OK;
-	}
-	//set the value
-	_mark();
-	return KvPair::setValueAsDouble(value);
+	return storeValue(value);
 }
 
 int StatusItem::setValueAsFloat(float value) {
@@ -99,16 +134,7 @@ int StatusItem::setValueAsFloat(float value) {
 		LOG4CXX_WARN(logger, "Can't set a float value in the status item : " << *this);
 		return status::ERROR;
 	}
-
-	//Figure out if this is a new value. If they are the same, return immediately
-	if (!_value.empty() && value == getValueAsFloat()) {
-		LOG4CXX_DEBUG(logger, "Values match. Won't mark as dirty. Item " << *this);
-		return status::OK;
-	}
-	//set the value
-	_mark();
-	return KvPair::setValueAsFloat(value);
-
+	return storeValue(value);
 }
 
 
@@ -117,7 +143,142 @@ bool StatusItem::isChanged() const {
 }
 
 void StatusItem::clearChanged() {
-	_changedFlag = false;
+	_changedFlag.store(false);
+}
+
+bool StatusItem::takeChanged() {
+	return _changedFlag.exchange(false);
+}
+
+void StatusItem::readValue(int &value, long64 &timestamp) const {
+	unsigned int seq;
+	do {
+		seq = _lock.readBegin();
+		value = getValueAsInt();
+		timestamp = _time;
+	} while (_lock.readRetry(seq));
+}
+
+void StatusItem::readValue(double &value, long64 &timestamp) const {
+	unsigned int seq;
+	do {
+		seq = _lock.readBegin();
+		value = getValueAsDouble();
+		timestamp = _time;
+	} while (_lock.readRetry(seq));
+}
+
+void StatusItem::readValue(float &value, long64 &timestamp) const {
+	unsigned int seq;
+	do {
+		seq = _lock.readBegin();
+		value = getValueAsFloat();
+		timestamp = _time;
+	} while (_lock.readRetry(seq));
+}
+
+void StatusItem::readValue(std::string &value, long64 &timestamp) const {
+	//the string storage can change under a reader, so
+	//strings are copied holding the lock
+	util::SeqLockWriteGuard guard(_lock);
+	value = getValueAsString();
+	timestamp = _time;
+}
+
+bool StatusItem::markPending() {
+	return !_pending.exchange(true);
+}
+
+void StatusItem::clearPending() {
+	_pending.store(false);
+}
+
+void StatusItem::requeue() {
+	if (_dirtyList != 0 && _changedFlag) {
+		_dirtyList->push(this);
+	}
+}
+
+void StatusItem::retryPost() {
+	_changedFlag = true;
+	if (_dirtyList != 0) {
+		_dirtyList->push(this);
+	}
+}
+
+void StatusItem::setPublishPolicy(const PublishPolicy &policy) {
+	util::SeqLockWriteGuard guard(_lock);
+	_absoluteDeadband = policy.absoluteDeadband;
+	_relativeDeadband = policy.relativeDeadband;
+	_minPostInterval = policy.maxRate > 0 ? (long64) std::ceil(1000.0
+			/ policy.maxRate) : 0;
+}
+
+PublishPolicy StatusItem::getPublishPolicy() const {
+	util::SeqLockWriteGuard guard(_lock);
+	PublishPolicy policy;
+	policy.absoluteDeadband = _absoluteDeadband;
+	policy.relativeDeadband = _relativeDeadband;
+	long64 interval = _minPostInterval;
+	policy.maxRate = interval > 0 ? 1000.0 / interval : 0;
+	return policy;
+}
+
+void StatusItem::acknowledgePost(unsigned long updates) {
+}
+
+unsigned long StatusItem::getUpdateCount() const {
+	return _updates.load(std::memory_order_relaxed);
+}
+
+unsigned long StatusItem::getPostCount() const {
+	return _posts.load(std::memory_order_relaxed);
+}
+
+bool StatusItem::reservePost(long64 now, long64 &due) {
+	long64 interval = _minPostInterval.load(std::memory_order_relaxed);
+	if (interval == 0) {
+		return true;
+	}
+	long64 last = _lastPostTime.load();
+	while (last == 0 || now - last >= interval) {
+		if (_lastPostTime.compare_exchange_weak(last, now)) {
+			return true;
+		}
+	}
+	due = last + interval;
+	return false;
+}
+
+bool StatusItem::markScheduled() {
+	return !_postScheduled.exchange(true);
+}
+
+void StatusItem::clearScheduled() {
+	_postScheduled.store(false);
+}
+
+void StatusItem::setDirtyList(DirtyItemList *list) {
+	_dirtyList = list;
+	if (_dirtyList != 0 && _changedFlag) {
+		_dirtyList->push(this);
+	}
+}
+
+void StatusItem::setObservers(const StatusObserverList *observers) {
+	_observers.store(observers, std::memory_order_release);
+}
+
+void StatusItem::beginCommit(long64 timestamp,
+		std::vector<StatusItem *> *committed, const StatusItem *item) {
+	t_commitTime = timestamp;
+	t_committed = committed;
+	t_commitItem = item;
+}
+
+void StatusItem::endCommit() {
+	t_committed = 0;
+	t_commitItem = 0;
 }
 
 /////PROTECTED METHODS
@@ -125,6 +286,15 @@ void StatusItem::clearChanged() {
 void StatusItem::_mark() {
 
 	_changedFlag = true;
+	//writers hold the lock, no need for an atomic increment
+	_updates.store(_updates.load(std::memory_order_relaxed) + 1,
+			std::memory_order_relaxed);
+	if (t_committed != 0 && t_commitItem == this) {
+		//part of a transaction, posted with the rest of it
+		_time = t_commitTime;
+		t_committed->push_back(this);
+		return;
+	}
 	struct timeval tv;
 	if (gettimeofday(&tv, NULL) == 0) {
 		//convert the structure to milliseconds
@@ -133,8 +303,61 @@ void StatusItem::_mark() {
 	} else {
 		LOG4CXX_WARN(logger, "Can't set timestamp on status item " << *this);
 	}
+	if (_dirtyList != 0) {
+		_dirtyList->push(this);
+	}
+}
+
+void StatusItem::_notifyObservers() {
+	const StatusObserverList *observers = _observers.load(
+			std::memory_order_acquire);
+	if (observers == 0) {
+		return;
+	}
+	StatusChange change;
+	readChange(change);
+	observers->notify(change);
+}
+
+void StatusItem::readChange(StatusChange &change) const {
+	change.name = getName().c_str();
+	change.type = _type;
+	switch (_type) {
+	case type::INT:
+		readValue(change.intValue, change.timestamp);
+		break;
+	case type::DOUBLE:
+		readValue(change.doubleValue, change.timestamp);
+		break;
+	case type::FLOAT:
+		readValue(change.floatValue, change.timestamp);
+		break;
+	case type::STRING:
+		readValue(change.stringValue, change.timestamp);
+		break;
+	default:
+		change.timestamp = getTimestamp();
+	}
 }
 
+bool StatusItem::_withinDeadband(double value) const {
+	if (_absoluteDeadband <= 0 && _relativeDeadband <= 0) {
+		return false;
+	}
+	if (!hasValue(_type) || _changedFlag) {
+		//nothing published yet, or the reference value is
+		//still waiting to be posted
+		return false;
+	}
+	double delta = std::fabs(value - _deadbandReference);
+	return (_absoluteDeadband > 0 && delta <= _absoluteDeadband)
+			|| (_relativeDeadband > 0 && delta <= _relativeDeadband
+					* std::fabs(_deadbandReference));
+}
+
+bool StatusItem::isUrgent() const {
+	return false;
+}
 
 void StatusItem::accept(StatusVisitor &visitor) {
 	visitor.visitStatusItem(this);
@@ -145,8 +368,18 @@ const type::Type StatusItem::getStatusType() const {
 }
 
 const long64 StatusItem::getTimestamp() const {
-	return _time;
+	long64 timestamp;
+	unsigned int seq;
+	do {
+		seq = _lock.readBegin();
+		timestamp = _time;
+	} while (_lock.readRetry(seq));
+	return timestamp;
 }
 
+void StatusItem::setTimestamp(long64 timestamp) {
+	util::SeqLockWriteGuard guard(_lock);
+	_time = timestamp;
 }
 
+}
@@ -2,36 +2,110 @@
 #define STATUSITEM_H_
 #include <log4cxx/logger.h>
 #include <giapi/giapi.h>
+#include <giapi/StatusUtil.h>
 #include <tr1/memory>
+#include <atomic>
+#include <vector>
+#include <util/SeqLock.h>
 #include "StatusVisitor.h"
 #include "KvPair.h"
+#include "DirtyItemList.h"
 
 namespace giapi {
 
+class StatusObserverList;
+
 /**
  * A Status Item is a Key-Value pair that holds a value representing
  * the state of a specific subsytem component at any given time.
  *
+ * Status items can be updated from several threads. Writers serialize
+ * on a per-item sequence lock; readers of numeric values don't block
+ * and use readValue() to get a consistent value and timestamp pair.
  */
-class StatusItem : public KvPair {
+class StatusItem : public KvPair,
+		public std::tr1::enable_shared_from_this<StatusItem> {
 	/**
 	 * Logging facility
 	 */
 	static log4cxx::LoggerPtr logger;
+
+	friend class DirtyItemList;
 private:
-	bool _changedFlag; //Set when attribute is changed
-	long64 _time; //timestamp
+	std::atomic<bool> _changedFlag; //Set when attribute is changed
 	type::Type _type; //Type of the values stored in this status item
+
+	DirtyItemList *_dirtyList; //list where this item is queued when dirty
+	StatusItem *_nextDirty; //next item in the dirty list
+	std::atomic<bool> _queued; //true while this item is linked in the dirty list
+	std::atomic<bool> _pending; //true while queued by an asynchronous sender
+
+	double _absoluteDeadband; //changes within the deadbands don't mark the item
+	double _relativeDeadband;
+	double _deadbandReference; //value set the last time the item was marked
+	std::atomic<long64> _minPostInterval; //milliseconds between posts, 0 for no limit
+	std::atomic<long64> _lastPostTime; //monotonic milliseconds of the last post
+	std::atomic<bool> _postScheduled; //true while waiting for the interval to expire
+	std::atomic<const StatusObserverList *> _observers; //NULL if nobody observes the item
+	std::atomic<unsigned long> _updates; //times the item was marked, for the statistics
+	std::atomic<unsigned long> _posts; //times the item was dispatched by a sender
+
+	/**
+	 * Return true if <code>value</code> is within the deadbands of the
+	 * item, in which case the item is not marked dirty. Invoked holding
+	 * the write lock.
+	 */
+	bool _withinDeadband(double value) const;
+
+	/**
+	 * Timestamp and collected items of the transaction being
+	 * committed by this thread, if any
+	 */
+	static thread_local long64 t_commitTime;
+	static thread_local std::vector<StatusItem *> *t_committed;
+	static thread_local const StatusItem *t_commitItem;
 protected:
+	/**
+	 * Protects the value and timestamp of the item. Every
+	 * modification is done holding its write lock.
+	 */
+	mutable util::SeqLock _lock;
+
+	long64 _time; //timestamp
+
 	/**
 	 * Mark the item as "dirty", allowing it to be sent. It
-	 * also registers the timestamp when the item becomes dirty.
+	 * also registers the timestamp when the item becomes dirty,
+	 * and queues the item in the dirty list, if any.
 	 * </p>
 	 * This method is used internally by the implementation,
-	 * in particular the setValue* methods.
+	 * in particular the setValue* methods, holding the write lock.
+	 * <p/>
+	 * While a transaction is committed, the item gets the timestamp
+	 * of the transaction and is collected for it instead of queued.
 	 */
 	void _mark();
 
+	/**
+	 * Deliver the current state of the item to its observers, if
+	 * it has any. Invoked by the setters after marking the item,
+	 * once the write lock is released.
+	 */
+	void _notify() {
+		if (_observers.load(std::memory_order_acquire) != 0) {
+			_notifyObservers();
+		}
+	}
+
+	/**
+	 * Copy the state of the item into the change delivered to the
+	 * observers. Alarm items add their alarm state.
+	 */
+	virtual void readChange(StatusChange &change) const;
+
+private:
+	void _notifyObservers();
+
 public:
 	/**
 	 * Constructor. Initializes the status item with the
@@ -94,6 +168,17 @@ public:
 	 */
 	virtual int setValueAsFloat(float value);
 
+	/**
+	 * Set the value of the item, without checking its type. The
+	 * setValueAs* methods check the type and end up here. Used
+	 * directly by the callers that already know the type of the
+	 * item, like the status handles. Defined for int, double, float
+	 * and std::string values.
+	 *
+	 * @return giapi::status::OK
+	 */
+	template<class T> int storeValue(const T &value);
+
 	/**
 	 * Return true if the status item is changed since last time
 	 * it was initialized
@@ -105,6 +190,142 @@ public:
 	 */
 	void clearChanged();
 
+	/**
+	 * Mark the status item as "clean", returning true if it
+	 * was changed. Only one of several threads racing to post
+	 * the same item gets true.
+	 */
+	bool takeChanged();
+
+	/**
+	 * Read the value and the timestamp of the item. The pair
+	 * is consistent even if other threads update the item
+	 * concurrently.
+	 *
+	 * @throws bad_cast exception if the item doesn't store
+	 *         values of the requested type
+	 */
+	void readValue(int &value, long64 &timestamp) const;
+	void readValue(double &value, long64 &timestamp) const;
+	void readValue(float &value, long64 &timestamp) const;
+	void readValue(std::string &value, long64 &timestamp) const;
+
+	/**
+	 * Flag the item as waiting in the queue of an asynchronous
+	 * sender, so it is queued only once no matter how many times
+	 * it's posted before being sent.
+	 *
+	 * @return true if the item was not flagged already
+	 */
+	bool markPending();
+
+	/**
+	 * Clear the flag set by markPending()
+	 */
+	void clearPending();
+
+	/**
+	 * Append the item to its dirty list again, if it is still
+	 * changed. Used when a post can't handle the item right now.
+	 */
+	void requeue();
+
+	/**
+	 * The post of the item failed: mark it changed again and append
+	 * it to its dirty list, so the next post sends it
+	 */
+	void retryPost();
+
+	/**
+	 * Set the deadbands and the maximum post rate of the item
+	 */
+	void setPublishPolicy(const PublishPolicy &policy);
+
+	/**
+	 * Return the deadbands and the maximum post rate of the item
+	 */
+	PublishPolicy getPublishPolicy() const;
+
+	/**
+	 * Count a dispatch of the item by a status sender
+	 */
+	void countPost() {
+		_posts.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/**
+	 * Return the times the item changed since it was created
+	 */
+	unsigned long getUpdateCount() const;
+
+	/**
+	 * Return the times the item was dispatched by a status sender
+	 */
+	unsigned long getPostCount() const;
+
+	/**
+	 * A status sender dispatched the item successfully, as it was
+	 * after <code>updates</code> changes (see getUpdateCount()).
+	 * Items that publish only what changed since their last post
+	 * forget those changes here, unless the item changed again
+	 * since. Does nothing by default.
+	 */
+	virtual void acknowledgePost(unsigned long updates);
+
+	/**
+	 * Check the maximum post rate of the item. If the item can be
+	 * posted at <code>now</code>, record it as the time of the last
+	 * post and return true. Otherwise return false and store in
+	 * <code>due</code> when the item can be posted.
+	 *
+	 * @param now current time, in milliseconds of a monotonic clock
+	 */
+	bool reservePost(long64 now, long64 &due);
+
+	/**
+	 * Flag the item as scheduled to be posted when its post interval
+	 * expires, so it is scheduled only once.
+	 *
+	 * @return true if the item was not flagged already
+	 */
+	bool markScheduled();
+
+	/**
+	 * Clear the flag set by markScheduled()
+	 */
+	void clearScheduled();
+
+	/**
+	 * Associate the item to the list that keeps track of the
+	 * dirty items. From now on, every time the item is marked dirty
+	 * it is appended to the list. If the item is already dirty,
+	 * it is queued immediately.
+	 */
+	void setDirtyList(DirtyItemList *list);
+
+	/**
+	 * Set the observers notified when the item changes, or NULL if
+	 * there are none. The list must outlive the item, or be replaced
+	 * before it is destroyed.
+	 */
+	void setObservers(const StatusObserverList *observers);
+
+	/**
+	 * Start applying a change of a transaction to <code>item</code>
+	 * on this thread. Until the next call or endCommit(), the item
+	 * gets <code>timestamp</code> when it's marked dirty, and is
+	 * appended to <code>committed</code> instead of its dirty list, so
+	 * it can be posted with the rest of the transaction. Other items
+	 * marked meanwhile, like by an observer, are handled as usual.
+	 */
+	static void beginCommit(long64 timestamp,
+			std::vector<StatusItem *> *committed, const StatusItem *item);
+
+	/**
+	 * Stop collecting the items marked by this thread
+	 */
+	static void endCommit();
+
 	/**
 	 * Return the status type (type of the value in this status item)
 	 * for this status item
@@ -117,12 +338,28 @@ public:
 	 */
 	const long64 getTimestamp() const;
 
+	/**
+	 * Replace the timestamp of this status item. Used when the value
+	 * was set somewhere else, like another process, and the original
+	 * time must be kept.
+	 */
+	void setTimestamp(long64 timestamp);
+
+	/**
+	 * Return true if the item is posted ahead of the rest of the
+	 * status, like alarms and health. Urgent items are queued in
+	 * their own dirty list, drained first.
+	 */
+	virtual bool isUrgent() const;
+
 	/**
 	 * The accept interface for the visitor pattern
 	 */
 	virtual void accept(StatusVisitor &);
 };
 
+template<> int StatusItem::storeValue(const std::string &value);
+
 typedef std::tr1::shared_ptr<StatusItem> pStatusItem;
  
 }
@@ -0,0 +1,136 @@
+#include "StatusManifest.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace giapi {
+
+log4cxx::LoggerPtr StatusManifest::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusManifest"));
+
+/**
+ * Strip the whitespace around a string
+ */
+static std::string trim(const std::string &s) {
+	static const char *SPACES = " \t\r\n";
+	size_t begin = s.find_first_not_of(SPACES);
+	if (begin == std::string::npos) {
+		return std::string();
+	}
+	return s.substr(begin, s.find_last_not_of(SPACES) - begin + 1);
+}
+
+static bool parseType(const std::string &name, type::Type &type) {
+	if (name == "INT") {
+		type = type::INT;
+	} else if (name == "DOUBLE") {
+		type = type::DOUBLE;
+	} else if (name == "FLOAT") {
+		type = type::FLOAT;
+	} else if (name == "STRING") {
+		type = type::STRING;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+StatusManifest::StatusManifest() {
+}
+
+int StatusManifest::read(const std::string &path,
+		std::vector<StatusItemSpec> &items) {
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file) {
+		LOG4CXX_WARN(logger, "Can't open status manifest " << path);
+		return status::ERROR;
+	}
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	return parse(contents.str(), items);
+}
+
+int StatusManifest::parse(const std::string &contents,
+		std::vector<StatusItemSpec> &items) {
+	std::vector<StatusItemSpec> found;
+	//a rough guess, good enough to avoid most reallocations
+	found.reserve(contents.size() / 128);
+
+	bool inItem = false;
+	StatusItemSpec::Kind kind = StatusItemSpec::BASIC;
+	std::string name, typeName;
+	std::string *text = 0; //where the text of the current element goes
+	size_t textBegin = 0;
+	size_t pos = 0;
+
+	while ((pos = contents.find('<', pos)) != std::string::npos) {
+		if (contents.compare(pos, 4, "<!--") == 0) {
+			size_t end = contents.find("-->", pos);
+			if (end == std::string::npos) {
+				LOG4CXX_WARN(logger, "Unterminated comment in status manifest");
+				return status::ERROR;
+			}
+			pos = end + 3;
+			continue;
+		}
+		size_t end = contents.find('>', pos);
+		if (end == std::string::npos) {
+			LOG4CXX_WARN(logger, "Status manifest ends in the middle of a tag");
+			return status::ERROR;
+		}
+		if (contents[pos + 1] == '?' || contents[pos + 1] == '!') {
+			pos = end + 1;
+			continue;
+		}
+
+		bool closing = contents[pos + 1] == '/';
+		bool empty = contents[end - 1] == '/';
+		size_t nameBegin = pos + (closing ? 2 : 1);
+		size_t nameEnd = contents.find_first_of(" \t\r\n/>", nameBegin);
+		std::string tag = contents.substr(nameBegin, nameEnd - nameBegin);
+
+		if (tag == "SimpleChannel" || tag == "AlarmChannel" || tag
+				== "HealthChannel") {
+			if (!closing && !empty) {
+				inItem = true;
+				kind = tag == "SimpleChannel" ? StatusItemSpec::BASIC : tag
+						== "AlarmChannel" ? StatusItemSpec::ALARM
+						: StatusItemSpec::HEALTH;
+				name.clear();
+				typeName.clear();
+			} else if (closing && inItem) {
+				inItem = false;
+				type::Type type = type::INT;
+				if (name.empty()) {
+					LOG4CXX_WARN(logger, "Status manifest has a " << tag
+							<< " without giapiname");
+					return status::ERROR;
+				}
+				if (kind != StatusItemSpec::HEALTH && !parseType(typeName, type)) {
+					LOG4CXX_WARN(logger, "Status item " << name
+							<< " has an unknown type '" << typeName << "'");
+					return status::ERROR;
+				}
+				found.push_back(StatusItemSpec(name, kind, type));
+			}
+		} else if (inItem && (tag == "giapiname" || tag == "type")) {
+			if (!closing && !empty) {
+				text = tag == "giapiname" ? &name : &typeName;
+				textBegin = end + 1;
+			} else if (closing && text != 0) {
+				*text = trim(contents.substr(textBegin, pos - textBegin));
+				text = 0;
+			}
+		}
+		pos = end + 1;
+	}
+
+	if (inItem) {
+		LOG4CXX_WARN(logger, "Status manifest ends in the middle of an item");
+		return status::ERROR;
+	}
+	items.insert(items.end(), found.begin(), found.end());
+	return status::OK;
+}
+
+}
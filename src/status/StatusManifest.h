@@ -0,0 +1,58 @@
+#ifndef STATUSMANIFEST_H_
+#define STATUSMANIFEST_H_
+
+#include <string>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/StatusUtil.h>
+
+namespace giapi {
+
+/**
+ * Reads the list of status items an instrument publishes from a
+ * manifest file, so they can be created in one go.
+ * <p/>
+ * The manifest uses the format of the GIAPI to EPICS channel mapping
+ * (see src/examples/stresstest.xml): one SimpleChannel, AlarmChannel or
+ * HealthChannel element per status item, with the name in a giapiname
+ * element and the type in a type element. Any other element is skipped.
+ * This is not a general XML parser: comments, processing instructions
+ * and attributes are ignored, and no entities are expanded.
+ */
+class StatusManifest {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Read the status items listed in the given file.
+	 *
+	 * @param path the manifest file
+	 * @param items where the items found are appended, in the order
+	 *        they appear in the file
+	 *
+	 * @return giapi::status::OK if the whole file was read,
+	 *         giapi::status::ERROR if it can't be read or an item is
+	 *         incomplete or has an unknown type. Nothing is appended
+	 *         to <code>items</code> in that case.
+	 */
+	static int read(const std::string &path, std::vector<StatusItemSpec> &items);
+
+	/**
+	 * Same as read(), taking the contents of the manifest instead of
+	 * a file name
+	 */
+	static int parse(const std::string &contents,
+			std::vector<StatusItemSpec> &items);
+
+private:
+	StatusManifest();
+};
+
+}
+
+#endif /* STATUSMANIFEST_H_ */
@@ -0,0 +1,141 @@
+#include "StatusObservers.h"
+
+#include <exception>
+
+#include <giapi/giapi.h>
+#include "StatusItem.h"
+
+namespace giapi {
+
+log4cxx::LoggerPtr StatusObserverList::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusObserverList"));
+
+log4cxx::LoggerPtr StatusObservers::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusObservers"));
+
+StatusObserverList::StatusObserverList(const std::vector<pEntry> &entries,
+		util::Executor *executor) :
+	_entries(entries), _executor(executor) {
+}
+
+void StatusObserverList::notify(const StatusChange &change) const {
+	for (std::vector<pEntry>::const_iterator it = _entries.begin(); it
+			!= _entries.end(); ++it) {
+		const pEntry &entry = *it;
+		if (!entry->active.load(std::memory_order_relaxed)) {
+			continue;
+		}
+		if (entry->async) {
+			_executor->execute([entry, change] {
+				if (entry->active.load(std::memory_order_relaxed)) {
+					entry->callback(change);
+				}
+			});
+			continue;
+		}
+		try {
+			entry->callback(change);
+		} catch (std::exception &e) {
+			LOG4CXX_WARN(logger, "Observer " << entry->id << " of "
+					<< change.name << " failed: " << e.what());
+		} catch (...) {
+			LOG4CXX_WARN(logger, "Observer " << entry->id << " of "
+					<< change.name << " failed");
+		}
+	}
+}
+
+StatusObservers::StatusObservers() :
+	_nextId(1) {
+}
+
+StatusObservers::~StatusObservers() {
+	if (_executor.get() != 0) {
+		_executor->shutdown();
+	}
+}
+
+int StatusObservers::add(const std::string &pattern,
+		const StatusObserver &observer, bool async) {
+	if (pattern.empty() || !observer) {
+		return status::ERROR;
+	}
+	StatusObserverList::pEntry entry(new StatusObserverList::Entry());
+	entry->pattern = pattern;
+	entry->callback = observer;
+	entry->async = async;
+	entry->active = true;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	if (async && _executor.get() == 0) {
+		_executor.reset(new util::Executor(1, "status observers"));
+	}
+	entry->id = _nextId++;
+	_entries.push_back(entry);
+	LOG4CXX_DEBUG(logger, "Observer " << entry->id << " added for " << pattern);
+	return entry->id;
+}
+
+int StatusObservers::remove(int id) {
+	std::lock_guard<std::mutex> guard(_lock);
+	for (std::vector<StatusObserverList::pEntry>::iterator it =
+			_entries.begin(); it != _entries.end(); ++it) {
+		if ((*it)->id == id) {
+			(*it)->active = false;
+			_entries.erase(it);
+			return status::OK;
+		}
+	}
+	return status::ERROR;
+}
+
+void StatusObservers::attach(StatusItem *item) {
+	const char *name = item->getName().c_str();
+	std::vector<int> ids;
+	std::vector<StatusObserverList::pEntry> matching;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	for (std::vector<StatusObserverList::pEntry>::const_iterator it =
+			_entries.begin(); it != _entries.end(); ++it) {
+		if (matches((*it)->pattern.c_str(), name)) {
+			ids.push_back((*it)->id);
+			matching.push_back(*it);
+		}
+	}
+	if (ids.empty()) {
+		item->setObservers(0);
+		return;
+	}
+	std::unique_ptr<StatusObserverList> &list = _lists[ids];
+	if (list.get() == 0) {
+		list.reset(new StatusObserverList(matching, _executor.get()));
+	}
+	item->setObservers(list.get());
+}
+
+bool StatusObservers::matches(const char *pattern, const char *name) {
+	//where to resume after the last '*' if the rest doesn't match
+	const char *star = 0;
+	const char *resume = 0;
+	while (*name != '\0') {
+		if (*pattern == '*') {
+			star = ++pattern;
+			resume = name;
+		} else if (*pattern == '?' || *pattern == *name) {
+			++pattern;
+			++name;
+		} else if (star != 0) {
+			//let the '*' take one more character
+			pattern = star;
+			name = ++resume;
+		} else {
+			return false;
+		}
+	}
+	while (*pattern == '*') {
+		++pattern;
+	}
+	return *pattern == '\0';
+}
+
+}
@@ -0,0 +1,143 @@
+#ifndef STATUSOBSERVERS_H_
+#define STATUSOBSERVERS_H_
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/StatusUtil.h>
+#include <util/Executor.h>
+
+namespace giapi {
+
+class StatusItem;
+
+/**
+ * The observers of one status item, resolved from their patterns when
+ * the item was attached. Lists are never modified once built, so the
+ * items read them without locks; changing the observers of an item
+ * means giving it another list.
+ */
+class StatusObserverList {
+public:
+	/**
+	 * An observer, as registered
+	 */
+	struct Entry {
+		int id;
+		std::string pattern;
+		StatusObserver callback;
+		bool async;
+		/**
+		 * Cleared when the observer is removed, for the lists and
+		 * notifications that still refer to it
+		 */
+		std::atomic<bool> active;
+	};
+	typedef std::shared_ptr<Entry> pEntry;
+
+	StatusObserverList(const std::vector<pEntry> &entries,
+			util::Executor *executor);
+
+	/**
+	 * Deliver the change to the observers of the list. Inline
+	 * observers are called right away, asynchronous ones are queued
+	 * on the executor.
+	 */
+	void notify(const StatusChange &change) const;
+
+private:
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+	std::vector<pEntry> _entries;
+	util::Executor *_executor;
+};
+
+/**
+ * The observers registered through StatusUtil::addObserver().
+ * <p/>
+ * Patterns are matched when an observer is added and when a status
+ * item is attached, never when items change: each item keeps a pointer
+ * to the list of its observers, or NULL if it has none. Items with the
+ * same observers share the list. Lists stay alive as long as the
+ * registry, because items may be notifying through an old list while
+ * they get a new one.
+ */
+class StatusObservers {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	StatusObservers();
+
+	/**
+	 * Wait for the pending asynchronous notifications. Items must be
+	 * detached before the registry is destroyed.
+	 */
+	virtual ~StatusObservers();
+
+	/**
+	 * Register an observer. Items already created must be attached
+	 * again to see it.
+	 *
+	 * @return the id of the observer, or giapi::status::ERROR if the
+	 *         pattern is empty or the observer is not set
+	 */
+	int add(const std::string &pattern, const StatusObserver &observer,
+			bool async);
+
+	/**
+	 * Unregister an observer. Items must be attached again to stop
+	 * carrying it.
+	 *
+	 * @return giapi::status::ERROR if there is no such observer
+	 */
+	int remove(int id);
+
+	/**
+	 * Give the item the list of the observers whose pattern matches
+	 * its name
+	 */
+	void attach(StatusItem *item);
+
+	/**
+	 * Return true if <code>name</code> matches the glob
+	 * <code>pattern</code>: '*' matches any sequence of characters,
+	 * '?' any single character.
+	 */
+	static bool matches(const char *pattern, const char *name);
+
+private:
+	std::vector<StatusObserverList::pEntry> _entries;
+
+	/**
+	 * Lists built so far, by the ids of their observers
+	 */
+	std::map<std::vector<int>, std::unique_ptr<StatusObserverList> > _lists;
+
+	int _nextId;
+
+	/**
+	 * Runs the asynchronous observers. Started with the first one.
+	 */
+	std::unique_ptr<util::Executor> _executor;
+
+	std::mutex _lock;
+
+	StatusObservers(const StatusObservers &);
+	StatusObservers & operator=(const StatusObservers &);
+};
+
+}
+
+#endif /* STATUSOBSERVERS_H_ */
@@ -0,0 +1,29 @@
+#include <giapi/StatusTransaction.h>
+#include <giapi/StatusUtil.h>
+
+namespace giapi {
+
+StatusTransaction::StatusTransaction() {
+	_open = StatusUtil::beginTransaction() == status::OK;
+}
+
+StatusTransaction::~StatusTransaction() {
+	if (_open) {
+		StatusUtil::abortTransaction();
+	}
+}
+
+bool StatusTransaction::isOpen() const {
+	return _open;
+}
+
+int StatusTransaction::commit() throw (GiapiException) {
+	if (!_open) {
+		return status::ERROR;
+	}
+	//closed even if the post fails
+	_open = false;
+	return StatusUtil::commitTransaction();
+}
+
+}
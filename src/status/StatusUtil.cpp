@@ -1,9 +1,24 @@
 #include "StatusDatabase.h"
+#include "StatusManifest.h"
+#include "ArrayStatusItem.h"
+#include "TransactionLog.h"
+#include "CompactStatusTable.h"
 
 #include <giapi/StatusUtil.h>
 #include <status/senders/StatusSender.h>
 
 #include <status/senders/StatusSenderFactory.h>
+#include <status/senders/AsyncStatusSender.h>
+#include <status/senders/SharedStatusSender.h>
+#include <status/senders/AutoPoster.h>
+#include <status/senders/JournalStatusSender.h>
+#include <status/senders/CompositeStatusSender.h>
+#include <status/journal/StatusReplayer.h>
+
+#include <atomic>
+#include <fstream>
+#include <map>
+#include <mutex>
 
 namespace giapi {
 
@@ -22,6 +37,412 @@ int StatusUtil::postStatus() throw (GiapiException) {
 	return sender->postStatus();
 }
 
+int StatusUtil::setPublishPolicy(const std::string &name,
+		const PublishPolicy &policy) {
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem(name);
+	if (item.get() == 0) {
+		return status::ERROR;
+	}
+	if (policy.absoluteDeadband < 0 || policy.relativeDeadband < 0
+			|| policy.maxRate < 0) {
+		return status::ERROR;
+	}
+	if ((item->getStatusType() == type::STRING || dynamic_cast<ArrayStatusItem *> (
+			item.get()) != 0) && (policy.absoluteDeadband > 0
+			|| policy.relativeDeadband > 0)) {
+		return status::ERROR;
+	}
+	item->setPublishPolicy(policy);
+	return status::OK;
+}
+
+int StatusUtil::beginTransaction() {
+	return TransactionLog::begin();
+}
+
+int StatusUtil::commitTransaction() throw (GiapiException) {
+	return TransactionLog::commit();
+}
+
+void StatusUtil::abortTransaction() {
+	TransactionLog::abort();
+}
+
+int StatusUtil::setBatchPost(bool batch) throw (GiapiException) {
+	pStatusSender sender = StatusSenderFactory::Instance()->getStatusSender();
+	sender->setBatchMode(batch);
+	return status::OK;
+}
+
+int StatusUtil::setAsyncPost(bool async) throw (GiapiException) {
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	//keep the batch mode selected so far
+	bool batch = factory->getStatusSender()->isBatchMode();
+	factory->setDefaultSenderType(async ? StatusSenderFactory::ASYNC_JMS_SENDER
+			: StatusSenderFactory::JMS_SENDER);
+	factory->getStatusSender()->setBatchMode(batch);
+	return status::OK;
+}
+
+int StatusUtil::startAutoPost(long periodMs) throw (GiapiException) {
+	return StatusSenderFactory::Instance()->getAutoPoster().start(periodMs);
+}
+
+int StatusUtil::stopAutoPost() {
+	StatusSenderFactory::Instance()->getAutoPoster().stop();
+	return status::OK;
+}
+
+int StatusUtil::setAutoPostPeriod(const std::string &name, long periodMs) {
+	return setAutoPostGroup(name, std::vector<std::string>(1, name), periodMs);
+}
+
+int StatusUtil::setAutoPostGroup(const std::string &group,
+		const std::vector<std::string> &items, long periodMs) {
+	return StatusSenderFactory::Instance()->getAutoPoster().setGroup(group,
+			items, periodMs);
+}
+
+int StatusUtil::getAutoPostStatistics(AutoPostStatistics &stats,
+		const std::string &group) {
+	return StatusSenderFactory::Instance()->getAutoPoster().getStatistics(
+			group, stats);
+}
+
+int StatusUtil::attachSharedStatus(const std::string &segment, int capacity)
+		throw (GiapiException) {
+	if (capacity <= 0) {
+		return status::ERROR;
+	}
+	pSharedStatusTable table(new SharedStatusTable(segment, capacity));
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	factory->setStatusSender(StatusSenderFactory::SHARED_SENDER, pStatusSender(
+			new SharedStatusSender(table)));
+	factory->setDefaultSenderType(StatusSenderFactory::SHARED_SENDER);
+	return status::OK;
+}
+
+/**
+ * The sender recording the posts in a journal, if any
+ */
+static std::mutex journalLock;
+static pStatusSender journalSender;
+
+int StatusUtil::startJournal(const std::string &path, bool publish)
+		throw (GiapiException) {
+	stopJournal();
+	pStatusJournal journal(new StatusJournal(path));
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	std::lock_guard<std::mutex> guard(journalLock);
+	if (!publish) {
+		bool batch = factory->getStatusSender()->isBatchMode();
+		journalSender = pStatusSender(new JournalStatusSender(journal));
+		journalSender->setBatchMode(batch);
+		factory->setStatusSender(StatusSenderFactory::JOURNAL_SENDER,
+				journalSender);
+		factory->setDefaultSenderType(StatusSenderFactory::JOURNAL_SENDER);
+		return status::OK;
+	}
+
+	//the asynchronous and shared senders publish through the JMS sender
+	StatusSenderFactory::StatusSenderType type = factory->getDefaultSenderType();
+	if (type == StatusSenderFactory::ASYNC_JMS_SENDER || type
+			== StatusSenderFactory::SHARED_SENDER) {
+		type = StatusSenderFactory::JMS_SENDER;
+	}
+	pStatusSender sender = factory->getStatusSender(type);
+	AbstractStatusSender *recorder =
+			dynamic_cast<AbstractStatusSender *> (sender.get());
+	if (recorder == 0) {
+		return status::ERROR;
+	}
+	recorder->setJournal(journal);
+	journalSender = sender;
+	return status::OK;
+}
+
+int StatusUtil::stopJournal() {
+	std::lock_guard<std::mutex> guard(journalLock);
+	if (journalSender.get() == 0) {
+		return status::OK;
+	}
+	if (dynamic_cast<JournalStatusSender *> (journalSender.get()) != 0) {
+		//the posts were only recorded. Back to the GMP
+		pStatusSenderFactory factory = StatusSenderFactory::Instance();
+		if (factory->getDefaultSenderType()
+				== StatusSenderFactory::JOURNAL_SENDER) {
+			factory->setDefaultSenderType(StatusSenderFactory::JMS_SENDER);
+		}
+		factory->setStatusSender(StatusSenderFactory::JOURNAL_SENDER,
+				pStatusSender());
+	}
+	static_cast<AbstractStatusSender *> (journalSender.get())->setJournal(
+			pStatusJournal());
+	journalSender.reset();
+	return status::OK;
+}
+
+int StatusUtil::replayJournal(const std::string &path, double speed)
+		throw (GiapiException) {
+	StatusReplayer replayer(path, StatusSenderFactory::Instance()->getStatusSender());
+	return replayer.replay(speed);
+}
+
+/**
+ * The status table of the process, and the same table for the setters,
+ * which don't take a lock. The table is never replaced once created
+ */
+static pCompactStatusTable statusTable;
+static std::atomic<CompactStatusTable *> currentTable(0);
+static std::mutex statusTableLock;
+
+int StatusUtil::createStatusTable(size_t capacity) throw (GiapiException) {
+	std::lock_guard<std::mutex> guard(statusTableLock);
+	if (statusTable.get() != 0) {
+		return status::ERROR;
+	}
+	statusTable.reset(new CompactStatusTable(capacity));
+	currentTable.store(statusTable.get(), std::memory_order_release);
+	return status::OK;
+}
+
+int StatusUtil::createTableItem(const std::string &name,
+		StatusItemSpec::Kind kind, type::Type type) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	int id = table->create(name, kind, type);
+	return id < 0 ? status::ERROR : id;
+}
+
+int StatusUtil::findTableItem(const std::string &name) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	int id = table->find(name);
+	return id < 0 ? status::ERROR : id;
+}
+
+/**
+ * Set a value in the status table, if there is one
+ */
+template<class T> static int setTableValue(int id, const T &value) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	return table->setValue(id, value);
+}
+
+int StatusUtil::setTableValue(int id, int value) {
+	return giapi::setTableValue(id, value);
+}
+
+int StatusUtil::setTableValue(int id, double value) {
+	return giapi::setTableValue(id, value);
+}
+
+int StatusUtil::setTableValue(int id, float value) {
+	return giapi::setTableValue(id, value);
+}
+
+int StatusUtil::setTableValue(int id, const std::string &value) {
+	return giapi::setTableValue(id, value);
+}
+
+int StatusUtil::setTableAlarm(int id, alarm::Severity severity,
+		alarm::Cause cause, const std::string &message) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	return table->setAlarm(id, severity, cause, message);
+}
+
+int StatusUtil::clearTableAlarm(int id) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	return table->clearAlarm(id);
+}
+
+int StatusUtil::setTableHealth(int id, health::Health health) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	return table->setHealth(id, health);
+}
+
+int StatusUtil::postStatusTable() throw (GiapiException) {
+	CompactStatusTable *table = currentTable.load(std::memory_order_acquire);
+	if (table == 0) {
+		return status::ERROR;
+	}
+	pStatusSender sender = StatusSenderFactory::Instance()->getStatusSender();
+	return sender->postTable(*table);
+}
+
+/**
+ * Return the asynchronous sender if it's the one in use, or
+ * NULL otherwise
+ */
+static AsyncStatusSender * getAsyncSender() {
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	if (factory->getDefaultSenderType() != StatusSenderFactory::ASYNC_JMS_SENDER) {
+		return 0;
+	}
+	return static_cast<AsyncStatusSender *> (factory->getStatusSender().get());
+}
+
+/**
+ * Return the composite sender if it's the one in use, or
+ * NULL otherwise
+ */
+static CompositeStatusSender * getCompositeSender() {
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	if (factory->getDefaultSenderType() != StatusSenderFactory::COMPOSITE_SENDER) {
+		return 0;
+	}
+	return static_cast<CompositeStatusSender *> (factory->getStatusSender().get());
+}
+
+int StatusUtil::flushStatus(long timeout) throw (GiapiException) {
+	AsyncStatusSender *sender = getAsyncSender();
+	if (sender != 0) {
+		return sender->flush(timeout) ? status::OK : status::ERROR;
+	}
+	CompositeStatusSender *composite = getCompositeSender();
+	if (composite != 0) {
+		return composite->flush(timeout) ? status::OK : status::ERROR;
+	}
+	return status::OK; //nothing is queued
+}
+
+int StatusUtil::getAsyncPostStatistics(AsyncPostStatistics &stats)
+		throw (GiapiException) {
+	AsyncStatusSender *sender = getAsyncSender();
+	if (sender == 0) {
+		return status::ERROR;
+	}
+	sender->getStatistics(stats);
+	return status::OK;
+}
+
+int StatusUtil::getSinkStatistics(std::vector<StatusSinkStatistics> &stats)
+		throw (GiapiException) {
+	CompositeStatusSender *sender = getCompositeSender();
+	if (sender == 0) {
+		return status::ERROR;
+	}
+	sender->getStatistics(stats);
+	return status::OK;
+}
+
+/**
+ * Names of the status sender types, as reported in the statistics
+ */
+static const char * SENDER_NAMES[] = { "log", "jms", "async", "shared",
+		"journal", "composite" };
+static_assert(sizeof(SENDER_NAMES) / sizeof(SENDER_NAMES[0])
+		== StatusSenderFactory::Elements, "a name for each sender type");
+
+int StatusUtil::getStatistics(StatusStatistics &stats) throw (GiapiException) {
+	StatusDatabase::Instance()->getStatistics(stats);
+
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	stats.senders.clear();
+	for (int type = 0; type < StatusSenderFactory::Elements; type++) {
+		pStatusSender sender = factory->findStatusSender(
+				(StatusSenderFactory::StatusSenderType) type);
+		//the asynchronous sender keeps statistics of its own
+		AbstractStatusSender *counted =
+				dynamic_cast<AbstractStatusSender *> (sender.get());
+		if (counted == 0) {
+			continue;
+		}
+		stats.senders.push_back(StatusSenderStatistics());
+		stats.senders.back().name = SENDER_NAMES[type];
+		counted->getPostStatistics(stats.senders.back());
+	}
+	return status::OK;
+}
+
+int StatusUtil::dumpStatistics(const std::string &path) throw (GiapiException) {
+	StatusStatistics stats;
+	getStatistics(stats);
+
+	std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+	if (!out) {
+		return status::ERROR;
+	}
+	out << "# status statistics after " << stats.elapsed << " s" << std::endl;
+	out << "updates " << stats.updates << std::endl;
+	out << "unknown-items " << stats.unknownItems << std::endl;
+	for (std::vector<StatusSenderStatistics>::const_iterator it =
+			stats.senders.begin(); it != stats.senders.end(); ++it) {
+		out << "sender " << it->name << " posts " << it->posts << " batches "
+				<< it->batches << " unchanged " << it->unchanged
+				<< " throttled " << it->throttled << " errors " << it->errors
+				<< " bytes " << it->bytes << " mean-us "
+				<< it->latency.meanLatency << " max-us "
+				<< it->latency.maxLatency << " buckets";
+		for (size_t i = 0; i < it->latency.buckets.size(); i++) {
+			out << " " << it->latency.buckets[i];
+		}
+		out << std::endl;
+	}
+	for (std::vector<StatusItemStatistics>::const_iterator it =
+			stats.items.begin(); it != stats.items.end(); ++it) {
+		out << "item " << it->name << " updates " << it->updates << " posts "
+				<< it->posts << " rate " << it->postRate << std::endl;
+	}
+	out.close();
+	return out ? status::OK : status::ERROR;
+}
+
+template<class T> StatusHandle<T> StatusUtil::getHandle(const std::string &name) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	pStatusItem item = database->getStatusItem(name);
+	if (item.get() == 0 || item->getStatusType() != StatusValueType<T>::TYPE
+			|| dynamic_cast<ArrayStatusItem *> (item.get()) != 0) {
+		return StatusHandle<T> ();
+	}
+	return StatusHandle<T> (item);
+}
+
+template StatusHandle<int> StatusUtil::getHandle<int>(const std::string &);
+template StatusHandle<double> StatusUtil::getHandle<double>(const std::string &);
+template StatusHandle<float> StatusUtil::getHandle<float>(const std::string &);
+template StatusHandle<std::string> StatusUtil::getHandle<std::string>(
+		const std::string &);
+
+template<class T> StatusHandle<T> * StatusUtil::resolveHandle(
+		const std::string &name) {
+	//keys are constants, so there are few handles. Items are never
+	//removed from the database, the handles stay valid
+	static std::mutex handlesLock;
+	static std::map<std::string, StatusHandle<T> > handles;
+
+	StatusHandle<T> handle = getHandle<T> (name);
+	if (!handle.isValid()) {
+		return 0;
+	}
+	std::lock_guard<std::mutex> guard(handlesLock);
+	return &handles.insert(std::make_pair(name, handle)).first->second;
+}
+
+template StatusHandle<int> * StatusUtil::resolveHandle<int>(const std::string &);
+template StatusHandle<double> * StatusUtil::resolveHandle<double>(
+		const std::string &);
+template StatusHandle<float> * StatusUtil::resolveHandle<float>(
+		const std::string &);
+template StatusHandle<std::string> * StatusUtil::resolveHandle<std::string>(
+		const std::string &);
+
 int StatusUtil::setValueAsInt(const std::string &name, int value) {
 	pStatusDatabase database = StatusDatabase::Instance();
 	return database->setStatusValueAsInt(name, value);
@@ -42,6 +463,24 @@ int StatusUtil::setValueAsFloat(const std::string &name, float value) {
 	return database->setStatusValueAsFloat(name, value);
 }
 
+int StatusUtil::setArrayValues(const std::string &name, size_t offset,
+		const int *values, size_t count) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->setStatusArrayValues(name, offset, values, count);
+}
+
+int StatusUtil::setArrayValues(const std::string &name, size_t offset,
+		const double *values, size_t count) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->setStatusArrayValues(name, offset, values, count);
+}
+
+int StatusUtil::setArrayValues(const std::string &name, size_t offset,
+		const float *values, size_t count) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->setStatusArrayValues(name, offset, values, count);
+}
+
 int StatusUtil::createStatusItem(const std::string &name, const type::Type type) {
 	pStatusDatabase database = StatusDatabase::Instance();
 	return database->createStatusItem(name, type);
@@ -57,6 +496,26 @@ int StatusUtil::createHealthStatusItem(const std::string &name) {
 	return database->createHealthStatusItem(name);
 }
 
+int StatusUtil::createArrayStatusItem(const std::string &name,
+		const type::Type type, size_t length, bool rangeUpdates) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->createArrayStatusItem(name, type, length, rangeUpdates);
+}
+
+int StatusUtil::createStatusItems(const std::vector<StatusItemSpec> &items) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->createStatusItems(items);
+}
+
+int StatusUtil::createStatusItems(const std::string &manifestPath) {
+	std::vector<StatusItemSpec> items;
+	if (StatusManifest::read(manifestPath, items) != status::OK) {
+		return status::ERROR;
+	}
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->createStatusItems(items);
+}
+
 int StatusUtil::setHealth(const std::string &name, const health::Health health) {
 	pStatusDatabase database = StatusDatabase::Instance();
 	return database->setHealth(name, health);
@@ -75,5 +534,16 @@ int StatusUtil::clearAlarm(const std::string & name) {
 	return database->clearAlarm(name);
 }
 
+int StatusUtil::addObserver(const std::string &pattern,
+		const StatusObserver &observer, bool async) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->addObserver(pattern, observer, async);
+}
+
+int StatusUtil::removeObserver(int id) {
+	pStatusDatabase database = StatusDatabase::Instance();
+	return database->removeObserver(id);
+}
+
 
 }
@@ -15,6 +15,7 @@ namespace giapi {
 class StatusItem;
 class AlarmStatusItem;
 class HealthStatusItem;
+class ArrayStatusItem;
 
 /**
  * Visitor to apply the visitor pattern over Status Items, allowing
@@ -39,6 +40,11 @@ public:
 	 */
 	virtual void visitHealthItem(HealthStatusItem * item) throw (std::exception) = 0;
 
+	/**
+	 * Defines an operation over Array Status items
+	 */
+	virtual void visitArrayItem(ArrayStatusItem * item) throw (std::exception) = 0;
+
 protected:
 	StatusVisitor();
 
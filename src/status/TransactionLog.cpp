@@ -0,0 +1,146 @@
+#include "TransactionLog.h"
+
+#include <memory>
+#include <unordered_set>
+
+#include <sys/time.h>
+
+#include <status/senders/StatusSenderFactory.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr TransactionLog::logger(log4cxx::Logger::getLogger(
+		"giapi.TransactionLog"));
+
+thread_local TransactionLog *TransactionLog::t_current = 0;
+
+/**
+ * Current time in milliseconds, as used in the status item timestamps
+ */
+static long64 currentTime() {
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return ((long long) tv.tv_sec) * 1000 + (long long) tv.tv_usec / 1000;
+}
+
+/**
+ * Collects the items changed by a transaction while it's committed,
+ * and stops collecting when it goes out of scope, even if a change
+ * throws
+ */
+class CommitScope {
+public:
+	CommitScope(std::vector<StatusItem *> *committed) :
+		_timestamp(currentTime()), _committed(committed) {
+	}
+
+	~CommitScope() {
+		StatusItem::endCommit();
+	}
+
+	/**
+	 * Collect the changes to <code>item</code> from now on
+	 */
+	void apply(const StatusItem *item) {
+		StatusItem::beginCommit(_timestamp, _committed, item);
+	}
+
+private:
+	long64 _timestamp;
+	std::vector<StatusItem *> *_committed;
+};
+
+TransactionLog::TransactionLog() {
+}
+
+int TransactionLog::begin() {
+	if (t_current != 0) {
+		LOG4CXX_WARN(logger, "A status transaction is already open in this thread");
+		return status::ERROR;
+	}
+	t_current = new TransactionLog();
+	return status::OK;
+}
+
+void TransactionLog::abort() {
+	delete t_current;
+	t_current = 0;
+}
+
+TransactionLog * TransactionLog::current() {
+	return t_current;
+}
+
+void TransactionLog::stage(const pStatusItem &item,
+		const std::function<int()> &change) {
+	Change staged;
+	staged.item = item;
+	staged.apply = change;
+	_changes.push_back(staged);
+}
+
+int TransactionLog::commit() throw (GiapiException) {
+	//closed first, so the changes below are applied for real
+	std::unique_ptr<TransactionLog> transaction(t_current);
+	t_current = 0;
+	if (transaction.get() == 0) {
+		LOG4CXX_WARN(logger, "No status transaction open in this thread");
+		return status::ERROR;
+	}
+	std::vector<Change> &changes = transaction->_changes;
+
+	//apply everything with the same timestamp, collecting
+	//the items that actually changed
+	int result = status::OK;
+	std::vector<StatusItem *> committed;
+	committed.reserve(changes.size());
+	{
+		CommitScope scope(&committed);
+		for (std::vector<Change>::iterator it = changes.begin(); it
+				!= changes.end(); ++it) {
+			scope.apply(it->item.get());
+			if (it->apply() != status::OK) {
+				result = status::ERROR;
+			}
+		}
+	}
+	if (committed.empty()) {
+		return result;
+	}
+
+	std::unordered_set<StatusItem *> changed(committed.begin(),
+			committed.end());
+	std::vector<pStatusItem> items;
+	items.reserve(changed.size());
+	for (std::vector<Change>::iterator it = changes.begin(); it
+			!= changes.end(); ++it) {
+		//each item once, in the order it was first changed
+		if (changed.erase(it->item.get()) > 0) {
+			items.push_back(it->item);
+		}
+	}
+
+	try {
+		pStatusSender sender =
+				StatusSenderFactory::Instance()->getStatusSender();
+		if (sender->postStatusGroup(items) != status::OK) {
+			retry(items);
+			result = status::ERROR;
+		}
+	} catch (GiapiException &) {
+		retry(items);
+		throw;
+	}
+	return result;
+}
+
+void TransactionLog::retry(const std::vector<pStatusItem> &items) {
+	//not in the dirty list, and marked clean by the post. Put them
+	//back for the next post
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		(*it)->retryPost();
+	}
+}
+
+}
@@ -0,0 +1,116 @@
+#ifndef TRANSACTIONLOG_H_
+#define TRANSACTIONLOG_H_
+
+#include <functional>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+/**
+ * The changes to status items staged by a thread between
+ * StatusUtil::beginTransaction() and StatusUtil::commitTransaction().
+ * <p/>
+ * Nothing is modified while a change is staged. The commit applies all
+ * the changes, in order, with the same timestamp, and posts the items
+ * that changed in a single message, so the GMP never sees some of them
+ * updated and some not.
+ * <p/>
+ * Each thread has its own transaction, if any. Changes made by other
+ * threads are not affected.
+ */
+class TransactionLog {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Start a transaction on this thread.
+	 *
+	 * @return giapi::status::ERROR if the thread has one open already
+	 */
+	static int begin();
+
+	/**
+	 * Apply the staged changes and post the items that changed
+	 * together. The transaction is closed, even if it fails.
+	 *
+	 * @return giapi::status::OK if all the changes were applied and
+	 *         posted, giapi::status::ERROR if there is no transaction
+	 *         open or any of the changes failed. The rest of the changes
+	 *         are applied and posted anyway.
+	 *
+	 * @throws PostException if the post fails. The items stay pending
+	 *         for the next post, as they do when the post returns
+	 *         giapi::status::ERROR.
+	 */
+	static int commit() throw (GiapiException);
+
+	/**
+	 * Discard the staged changes and close the transaction
+	 */
+	static void abort();
+
+	/**
+	 * Return the transaction open on this thread, or 0
+	 */
+	static TransactionLog * current();
+
+	/**
+	 * Apply a change to a status item right away, or stage it if the
+	 * thread has a transaction open. Changes that store a value of the
+	 * wrong type are never staged, so the error is reported now.
+	 *
+	 * @param item the status item to change
+	 * @param type the type of value stored by the change
+	 * @param change applies the change, returning giapi::status::OK
+	 *        or giapi::status::ERROR like the setters
+	 */
+	template<class F> static int applyOrStage(const pStatusItem &item,
+			type::Type type, F change) {
+		TransactionLog *transaction = current();
+		if (transaction == 0 || item->getStatusType() != type) {
+			return change();
+		}
+		transaction->stage(item, change);
+		return status::OK;
+	}
+
+	/**
+	 * Stage a change to the given item, to be applied on commit
+	 */
+	void stage(const pStatusItem &item, const std::function<int()> &change);
+
+private:
+	struct Change {
+		pStatusItem item;
+		std::function<int()> apply;
+	};
+
+	std::vector<Change> _changes;
+
+	/**
+	 * Put the items of a failed post back in the dirty list
+	 */
+	static void retry(const std::vector<pStatusItem> &items);
+
+	/**
+	 * The transaction open on each thread
+	 */
+	static thread_local TransactionLog *t_current;
+
+	TransactionLog();
+	TransactionLog(const TransactionLog &);
+	TransactionLog & operator=(const TransactionLog &);
+};
+
+}
+
+#endif /* TRANSACTIONLOG_H_ */
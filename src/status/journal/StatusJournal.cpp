@@ -0,0 +1,251 @@
+#include "StatusJournal.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <status/StatusItem.h>
+#include <status/journal/StatusJournalWriter.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr StatusJournal::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusJournal"));
+
+/**
+ * Size of the first mapping of a new journal
+ */
+static const size_t INITIAL_LENGTH = 1 << 20;
+
+size_t StatusJournal::align(size_t length) {
+	return (length + 7) & ~((size_t) 7);
+}
+
+StatusJournal::StatusJournal(const std::string &path) throw (GiapiException) :
+	_path(path), _fd(-1), _base(0), _length(0), _end(HEADER_SIZE),
+			_nextId(0), _records(0) {
+	static_assert(sizeof(Header) <= HEADER_SIZE, "header too large");
+	static_assert(sizeof(ItemRecord) % 8 == 0, "item records not aligned");
+
+	_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+	if (_fd < 0) {
+		throw GiapiException("Can't open status journal " + path + ": "
+				+ strerror(errno));
+	}
+	struct stat st;
+	if (fstat(_fd, &st) != 0) {
+		std::string error(strerror(errno));
+		close(_fd);
+		throw GiapiException("Can't open status journal " + path + ": " + error);
+	}
+
+	try {
+		if (st.st_size == 0) {
+			if (ftruncate(_fd, INITIAL_LENGTH) != 0) {
+				throw GiapiException("Can't size status journal " + path + ": "
+						+ strerror(errno));
+			}
+			map(INITIAL_LENGTH);
+			new (header()) Header();
+			header()->magic = MAGIC;
+			header()->version = VERSION;
+			header()->end.store(HEADER_SIZE, std::memory_order_release);
+			LOG4CXX_INFO(logger, "Created status journal " << path);
+		} else {
+			if ((size_t) st.st_size < HEADER_SIZE) {
+				throw GiapiException("File " + path + " is not a status journal");
+			}
+			map(st.st_size);
+			if (header()->magic != MAGIC || header()->version != VERSION
+					|| header()->end.load() > _length) {
+				throw GiapiException("File " + path + " is not a status journal");
+			}
+			_end = header()->end.load();
+			loadNames();
+			header()->end.store(_end, std::memory_order_release);
+			LOG4CXX_INFO(logger, "Appending to status journal " << path);
+		}
+	} catch (GiapiException &) {
+		if (_base != 0) {
+			munmap(_base, _length);
+		}
+		close(_fd);
+		throw;
+	}
+}
+
+StatusJournal::~StatusJournal() {
+	if (_base != 0) {
+		munmap(_base, _length);
+	}
+	//drop the room reserved for records that never came
+	if (ftruncate(_fd, _end) != 0) {
+		LOG4CXX_WARN(logger, "Can't trim status journal " << _path << ": "
+				<< strerror(errno));
+	}
+	close(_fd);
+}
+
+int StatusJournal::append(StatusItem *item) {
+	std::lock_guard<std::mutex> guard(_lock);
+	StatusJournalWriter writer(_scratch);
+	item->accept(writer);
+	if (!writer.isWritten()) {
+		return status::ERROR;
+	}
+	return write(_scratch);
+}
+
+int StatusJournal::append(const JournalRecord &record) {
+	std::lock_guard<std::mutex> guard(_lock);
+	return write(record);
+}
+
+int StatusJournal::write(const JournalRecord &record) {
+	uint32_t id;
+	size_t length = align(sizeof(ItemRecord) + record.stringValue.size()
+			+ record.message.size());
+	if (!nameId(record.name, id) || !reserve(length)) {
+		return status::ERROR;
+	}
+
+	ItemRecord *item = reinterpret_cast<ItemRecord *> (_base + _end);
+	item->header.length = length;
+	item->header.type = ITEM_RECORD;
+	item->nameId = id;
+	item->kind = record.kind;
+	item->type = record.type;
+	item->severity = record.severity;
+	item->cause = record.cause;
+	item->timestamp = record.timestamp;
+	switch (record.type) {
+	case type::INT:
+		item->intValue = record.intValue;
+		break;
+	case type::FLOAT:
+		item->floatValue = record.floatValue;
+		break;
+	default:
+		item->doubleValue = record.doubleValue;
+		break;
+	}
+	item->stringLength = record.stringValue.size();
+	item->messageLength = record.message.size();
+	char *data = reinterpret_cast<char *> (item + 1);
+	memcpy(data, record.stringValue.data(), item->stringLength);
+	memcpy(data + item->stringLength, record.message.data(),
+			item->messageLength);
+
+	_end += length;
+	header()->end.store(_end, std::memory_order_release);
+	_records.fetch_add(1, std::memory_order_relaxed);
+	return status::OK;
+}
+
+size_t StatusJournal::getSize() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _end;
+}
+
+unsigned long StatusJournal::getRecordCount() const {
+	return _records.load(std::memory_order_relaxed);
+}
+
+const std::string & StatusJournal::getPath() const {
+	return _path;
+}
+
+bool StatusJournal::nameId(const std::string &name, uint32_t &id) {
+	std::unordered_map<std::string, uint32_t>::const_iterator it =
+			_names.find(name);
+	if (it != _names.end()) {
+		id = it->second;
+		return true;
+	}
+	size_t length = align(sizeof(NameRecord) + name.size());
+	if (!reserve(length)) {
+		return false;
+	}
+	NameRecord *record = reinterpret_cast<NameRecord *> (_base + _end);
+	record->header.length = length;
+	record->header.type = NAME_RECORD;
+	record->id = _nextId;
+	record->length = name.size();
+	memcpy(record + 1, name.data(), name.size());
+	_end += length;
+	header()->end.store(_end, std::memory_order_release);
+
+	id = _nextId++;
+	_names[name] = id;
+	return true;
+}
+
+bool StatusJournal::reserve(size_t length) {
+	if (_base == 0) {
+		return false; //a previous remap failed
+	}
+	if (_end + length <= _length) {
+		return true;
+	}
+	size_t newLength = _length * 2;
+	while (newLength < _end + length) {
+		newLength *= 2;
+	}
+	if (ftruncate(_fd, newLength) != 0) {
+		LOG4CXX_WARN(logger, "Can't grow status journal " << _path << ": "
+				<< strerror(errno));
+		return false;
+	}
+	munmap(_base, _length);
+	_base = 0;
+	_length = 0;
+	try {
+		map(newLength);
+	} catch (GiapiException &e) {
+		LOG4CXX_ERROR(logger, e.what());
+		return false;
+	}
+	return true;
+}
+
+void StatusJournal::map(size_t length) throw (GiapiException) {
+	void *base = mmap(0, length, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+	if (base == MAP_FAILED) {
+		throw GiapiException("Can't map status journal " + _path + ": "
+				+ strerror(errno));
+	}
+	_base = static_cast<char *> (base);
+	_length = length;
+}
+
+void StatusJournal::loadNames() {
+	size_t offset = HEADER_SIZE;
+	while (offset + sizeof(RecordHeader) <= _end) {
+		const RecordHeader *record =
+				reinterpret_cast<const RecordHeader *> (_base + offset);
+		if (record->length == 0 || offset + record->length > _end) {
+			break; //damaged, append after the last good record
+		}
+		if (record->type == NAME_RECORD) {
+			const NameRecord *name =
+					reinterpret_cast<const NameRecord *> (record);
+			_names[std::string(reinterpret_cast<const char *> (name + 1),
+					name->length)] = name->id;
+			if (name->id >= _nextId) {
+				_nextId = name->id + 1;
+			}
+		}
+		offset += record->length;
+	}
+	_end = offset;
+}
+
+StatusJournal::Header * StatusJournal::header() const {
+	return reinterpret_cast<Header *> (_base);
+}
+
+}
@@ -0,0 +1,245 @@
+#ifndef STATUSJOURNAL_H_
+#define STATUSJOURNAL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+#include <giapi/StatusUtil.h>
+
+namespace giapi {
+
+class StatusItem;
+
+class StatusJournal;
+typedef std::tr1::shared_ptr<StatusJournal> pStatusJournal;
+
+/**
+ * A posted status item, as stored in a journal
+ */
+struct JournalRecord {
+	std::string name;
+	StatusItemSpec::Kind kind;
+	type::Type type;
+	int intValue;
+	double doubleValue;
+	float floatValue;
+	std::string stringValue;
+	/**
+	 * Timestamp of the status item when it was posted, in
+	 * milliseconds since the epoch
+	 */
+	long64 timestamp;
+	/**
+	 * Alarm state, only for alarm status items
+	 */
+	alarm::Severity severity;
+	alarm::Cause cause;
+	std::string message;
+
+	JournalRecord() :
+		kind(StatusItemSpec::BASIC), type(type::INT), intValue(0),
+				doubleValue(0), floatValue(0), timestamp(0),
+				severity(alarm::ALARM_OK), cause(alarm::ALARM_CAUSE_OK) {
+	}
+};
+
+/**
+ * An append-only binary file with a record of every status item
+ * posted, used to replay the posts later. See StatusJournalReader and
+ * StatusReplayer.
+ * <p/>
+ * The file is memory mapped, so appending a record is a copy into the
+ * page cache with no system call; the mapping grows, doubling its
+ * size, when it fills up. The records survive a crash of the process,
+ * though not of the machine.
+ * <p/>
+ * Layout: a 64 byte header, holding the offset where the records end,
+ * followed by the records, each one 8 byte aligned. Names are stored
+ * once, in a name record that gives them an id; item records refer to
+ * the name by id. The end offset is updated after each record is
+ * complete, so a reader of a journal being written only sees whole
+ * records.
+ */
+class StatusJournal {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Open the journal at <code>path</code>. If the file is a journal
+	 * already, new records are appended to it; otherwise it is
+	 * created.
+	 *
+	 * @throws GiapiException if the file can't be created or mapped,
+	 *         or exists but is not a journal
+	 */
+	explicit StatusJournal(const std::string &path) throw (GiapiException);
+
+	/**
+	 * Unmap the journal, trimming the file to the records written
+	 */
+	virtual ~StatusJournal();
+
+	/**
+	 * Append the current state of the status item. Array status
+	 * items are not recorded.
+	 *
+	 * @return giapi::status::ERROR if the item couldn't be recorded
+	 */
+	int append(StatusItem *item);
+
+	/**
+	 * Append a record
+	 *
+	 * @return giapi::status::ERROR if the journal can't grow
+	 */
+	int append(const JournalRecord &record);
+
+	/**
+	 * Bytes used by the journal so far, header included
+	 */
+	size_t getSize() const;
+
+	/**
+	 * Number of item records appended through this object
+	 */
+	unsigned long getRecordCount() const;
+
+	const std::string & getPath() const;
+
+	/**
+	 * Layout of the file, shared with StatusJournalReader
+	 */
+	struct Header {
+		uint32_t magic;
+		uint32_t version;
+		std::atomic<uint64_t> end; //offset where the records end
+	};
+
+	struct RecordHeader {
+		uint32_t length; //of the whole record, aligned
+		uint8_t type;
+		uint8_t reserved[3];
+	};
+
+	struct NameRecord {
+		RecordHeader header;
+		uint32_t id;
+		uint32_t length; //followed by the characters of the name
+	};
+
+	struct ItemRecord {
+		RecordHeader header;
+		uint32_t nameId;
+		uint8_t kind;
+		uint8_t type;
+		uint8_t severity;
+		uint8_t cause;
+		int64_t timestamp;
+		union {
+			int32_t intValue;
+			float floatValue;
+			double doubleValue;
+		};
+		uint32_t stringLength; //followed by the string value
+		uint32_t messageLength; //and the alarm message
+	};
+
+	/**
+	 * Identifies a file with this layout
+	 */
+	static const uint32_t MAGIC = 0x47534A31; //"GSJ1"
+	static const uint32_t VERSION = 1;
+
+	/**
+	 * Size of the header, where the records begin
+	 */
+	static const size_t HEADER_SIZE = 64;
+
+	/**
+	 * Kinds of records
+	 */
+	enum RecordType {
+		NAME_RECORD = 1, ITEM_RECORD = 2
+	};
+
+	/**
+	 * Length of a record of <code>length</code> bytes, once aligned
+	 */
+	static size_t align(size_t length);
+
+private:
+	/**
+	 * Append a record, holding the lock
+	 */
+	int write(const JournalRecord &record);
+
+	/**
+	 * Return the id of the name, writing a name record the first
+	 * time it's seen
+	 */
+	bool nameId(const std::string &name, uint32_t &id);
+
+	/**
+	 * Make room for <code>length</code> more bytes, growing the
+	 * file and the mapping if needed
+	 */
+	bool reserve(size_t length);
+
+	/**
+	 * Map <code>length</code> bytes of the file
+	 */
+	void map(size_t length) throw (GiapiException);
+
+	/**
+	 * Load the names of an existing journal, so new records use
+	 * the same ids
+	 */
+	void loadNames();
+
+	Header *header() const;
+
+	std::string _path;
+	int _fd;
+	char *_base;
+	size_t _length;
+
+	/**
+	 * Where the next record goes. The header holds the same offset,
+	 * for readers
+	 */
+	size_t _end;
+
+	std::unordered_map<std::string, uint32_t> _names;
+	uint32_t _nextId;
+
+	/**
+	 * Reused to copy the status items being appended
+	 */
+	JournalRecord _scratch;
+
+	std::atomic<unsigned long> _records;
+
+	/**
+	 * Serializes the appends
+	 */
+	mutable std::mutex _lock;
+
+	StatusJournal(const StatusJournal &);
+	StatusJournal & operator=(const StatusJournal &);
+};
+
+}
+
+#endif /* STATUSJOURNAL_H_ */
@@ -0,0 +1,117 @@
+#include "StatusJournalReader.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace giapi {
+
+StatusJournalReader::StatusJournalReader(const std::string &path)
+		throw (GiapiException) :
+	_base(0), _length(0), _end(0), _offset(StatusJournal::HEADER_SIZE) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw GiapiException("Can't open status journal " + path + ": "
+				+ strerror(errno));
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t) st.st_size
+			< StatusJournal::HEADER_SIZE) {
+		close(fd);
+		throw GiapiException("File " + path + " is not a status journal");
+	}
+	_length = st.st_size;
+	void *base = mmap(0, _length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED) {
+		throw GiapiException("Can't map status journal " + path + ": "
+				+ strerror(errno));
+	}
+	_base = static_cast<const char *> (base);
+
+	const StatusJournal::Header *header =
+			reinterpret_cast<const StatusJournal::Header *> (_base);
+	if (header->magic != StatusJournal::MAGIC || header->version
+			!= StatusJournal::VERSION) {
+		munmap(const_cast<char *> (_base), _length);
+		throw GiapiException("File " + path + " is not a status journal");
+	}
+	_end = header->end.load(std::memory_order_acquire);
+	if (_end > _length) {
+		_end = _length;
+	}
+}
+
+StatusJournalReader::~StatusJournalReader() {
+	munmap(const_cast<char *> (_base), _length);
+}
+
+bool StatusJournalReader::next(JournalRecord &record) {
+	while (_offset + sizeof(StatusJournal::RecordHeader) <= _end) {
+		const StatusJournal::RecordHeader *header =
+				reinterpret_cast<const StatusJournal::RecordHeader *> (_base
+						+ _offset);
+		if (header->length == 0 || _offset + header->length > _end) {
+			_offset = _end; //damaged, nothing more can be read
+			return false;
+		}
+		_offset += header->length;
+
+		if (header->type == StatusJournal::NAME_RECORD) {
+			const StatusJournal::NameRecord *name =
+					reinterpret_cast<const StatusJournal::NameRecord *> (header);
+			if (name->id >= _names.size()) {
+				_names.resize(name->id + 1);
+			}
+			_names[name->id].assign(reinterpret_cast<const char *> (name + 1),
+					name->length);
+			continue;
+		}
+		if (header->type != StatusJournal::ITEM_RECORD) {
+			continue; //written by a later version
+		}
+
+		const StatusJournal::ItemRecord *item =
+				reinterpret_cast<const StatusJournal::ItemRecord *> (header);
+		if (item->nameId >= _names.size()) {
+			continue;
+		}
+		record.name = _names[item->nameId];
+		record.kind = static_cast<StatusItemSpec::Kind> (item->kind);
+		record.type = static_cast<type::Type> (item->type);
+		record.timestamp = item->timestamp;
+		record.intValue = 0;
+		record.floatValue = 0;
+		record.doubleValue = 0;
+		switch (record.type) {
+		case type::INT:
+			record.intValue = item->intValue;
+			break;
+		case type::FLOAT:
+			record.floatValue = item->floatValue;
+			break;
+		case type::DOUBLE:
+			record.doubleValue = item->doubleValue;
+			break;
+		default:
+			break;
+		}
+		const char *data = reinterpret_cast<const char *> (item + 1);
+		record.stringValue.assign(data, item->stringLength);
+		record.message.assign(data + item->stringLength, item->messageLength);
+		record.severity = static_cast<alarm::Severity> (item->severity);
+		record.cause = static_cast<alarm::Cause> (item->cause);
+		return true;
+	}
+	return false;
+}
+
+void StatusJournalReader::rewind() {
+	_offset = StatusJournal::HEADER_SIZE;
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef STATUSJOURNALREADER_H_
+#define STATUSJOURNALREADER_H_
+
+#include <string>
+#include <vector>
+#include <tr1/memory>
+
+#include <giapi/giapiexcept.h>
+#include <status/journal/StatusJournal.h>
+
+namespace giapi {
+
+class StatusJournalReader;
+typedef std::tr1::shared_ptr<StatusJournalReader> pStatusJournalReader;
+
+/**
+ * Reads back the records of a status journal, in the order they were
+ * appended. The journal is mapped read only, and may still be written
+ * by another process: only the records complete when the reader was
+ * opened are read.
+ */
+class StatusJournalReader {
+public:
+	/**
+	 * Open the journal at <code>path</code>
+	 *
+	 * @throws GiapiException if the file can't be read or is not a
+	 *         status journal
+	 */
+	explicit StatusJournalReader(const std::string &path) throw (GiapiException);
+
+	virtual ~StatusJournalReader();
+
+	/**
+	 * Copy the next item record into <code>record</code>.
+	 *
+	 * @return false if there are no more records
+	 */
+	bool next(JournalRecord &record);
+
+	/**
+	 * Go back to the first record
+	 */
+	void rewind();
+
+private:
+	const char *_base;
+	size_t _length;
+
+	/**
+	 * Where the records end, and where the next one starts
+	 */
+	size_t _end;
+	size_t _offset;
+
+	/**
+	 * The names read so far, by id
+	 */
+	std::vector<std::string> _names;
+
+	StatusJournalReader(const StatusJournalReader &);
+	StatusJournalReader & operator=(const StatusJournalReader &);
+};
+
+}
+
+#endif /* STATUSJOURNALREADER_H_ */
@@ -0,0 +1,69 @@
+#include "StatusJournalWriter.h"
+
+namespace giapi {
+
+StatusJournalWriter::StatusJournalWriter(JournalRecord &record) :
+	_record(record), _written(false) {
+}
+
+StatusJournalWriter::~StatusJournalWriter() {
+}
+
+bool StatusJournalWriter::isWritten() const {
+	return _written;
+}
+
+void StatusJournalWriter::visitStatusItem(StatusItem *item)
+		throw (std::exception) {
+	writeValue(item, StatusItemSpec::BASIC);
+	_record.severity = alarm::ALARM_OK;
+	_record.cause = alarm::ALARM_CAUSE_OK;
+	_record.message.clear();
+}
+
+void StatusJournalWriter::visitAlarmItem(AlarmStatusItem *item)
+		throw (std::exception) {
+	writeValue(item, StatusItemSpec::ALARM);
+	item->getAlarmState(_record.severity, _record.cause, _record.message);
+}
+
+void StatusJournalWriter::visitHealthItem(HealthStatusItem *item)
+		throw (std::exception) {
+	writeValue(item, StatusItemSpec::HEALTH);
+	_record.severity = alarm::ALARM_OK;
+	_record.cause = alarm::ALARM_CAUSE_OK;
+	_record.message.clear();
+}
+
+void StatusJournalWriter::visitArrayItem(ArrayStatusItem *item)
+		throw (std::exception) {
+	_written = false;
+}
+
+void StatusJournalWriter::writeValue(StatusItem *item,
+		StatusItemSpec::Kind kind) {
+	_record.name = item->getName();
+	_record.kind = kind;
+	_record.type = item->getStatusType();
+	_record.stringValue.clear();
+	_written = true;
+	switch (_record.type) {
+	case type::INT:
+		item->readValue(_record.intValue, _record.timestamp);
+		break;
+	case type::DOUBLE:
+		item->readValue(_record.doubleValue, _record.timestamp);
+		break;
+	case type::FLOAT:
+		item->readValue(_record.floatValue, _record.timestamp);
+		break;
+	case type::STRING:
+		item->readValue(_record.stringValue, _record.timestamp);
+		break;
+	default:
+		_written = false;
+		break;
+	}
+}
+
+}
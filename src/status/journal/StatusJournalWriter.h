@@ -0,0 +1,57 @@
+#ifndef STATUSJOURNALWRITER_H_
+#define STATUSJOURNALWRITER_H_
+
+#include <status/StatusVisitor.h>
+#include <status/StatusItem.h>
+#include <status/AlarmStatusItem.h>
+#include <status/HealthStatusItem.h>
+#include <status/ArrayStatusItem.h>
+#include <status/journal/StatusJournal.h>
+
+namespace giapi {
+
+/**
+ * This visitor copies the name, value and alarm state of the status
+ * items into a journal record.
+ */
+class StatusJournalWriter : public StatusVisitor {
+private:
+	/**
+	 * The record that will be filled in by this visitor
+	 */
+	JournalRecord &_record;
+
+	/**
+	 * Whether the last status item visited fits in a record
+	 */
+	bool _written;
+
+	/**
+	 * Copy the name, value and timestamp, common to all the status items
+	 */
+	void writeValue(StatusItem *item, StatusItemSpec::Kind kind);
+
+public:
+	StatusJournalWriter(JournalRecord &record);
+	virtual ~StatusJournalWriter();
+
+	/**
+	 * Return true if the record was filled in
+	 */
+	bool isWritten() const;
+
+	void visitStatusItem(StatusItem * item) throw (std::exception);
+
+	void visitAlarmItem(AlarmStatusItem * item) throw (std::exception);
+
+	void visitHealthItem(HealthStatusItem * item) throw (std::exception);
+
+	/**
+	 * Arrays are not recorded. Nothing is written
+	 */
+	void visitArrayItem(ArrayStatusItem * item) throw (std::exception);
+};
+
+}
+
+#endif /* STATUSJOURNALWRITER_H_ */
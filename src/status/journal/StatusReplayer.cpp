@@ -0,0 +1,98 @@
+#include "StatusReplayer.h"
+
+#include <chrono>
+#include <thread>
+
+#include <status/AlarmStatusItem.h>
+#include <status/HealthStatusItem.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr StatusReplayer::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusReplayer"));
+
+StatusReplayer::StatusReplayer(const std::string &path, pStatusSender sender)
+		throw (GiapiException) :
+	_reader(path), _sender(sender) {
+}
+
+StatusReplayer::~StatusReplayer() {
+}
+
+int StatusReplayer::replay(double speed) throw (PostException) {
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start = Clock::now();
+	long64 firstTimestamp = 0;
+	int posted = 0;
+
+	JournalRecord record;
+	_reader.rewind();
+	while (_reader.next(record)) {
+		if (posted == 0) {
+			firstTimestamp = record.timestamp;
+		} else if (speed > 0) {
+			std::chrono::duration<double, std::milli> offset(
+					(record.timestamp - firstTimestamp) / speed);
+			std::this_thread::sleep_until(start
+					+ std::chrono::duration_cast<Clock::duration>(offset));
+		}
+
+		pStatusItem item = getItem(record);
+		_sender->postStatusItem(item);
+		posted++;
+	}
+	LOG4CXX_DEBUG(logger, "Replayed " << posted << " status records");
+	return posted;
+}
+
+pStatusItem StatusReplayer::getItem(const JournalRecord &record) {
+	pStatusItem &item = _items[record.name];
+	if (item.get() == 0 || item->getStatusType() != record.type) {
+		item = makeItem(record);
+	}
+	apply(item.get(), record);
+	if (!item->isChanged()) {
+		//posted with the same value it had already. Only a new
+		//item, which starts dirty, gets posted again
+		item = makeItem(record);
+		apply(item.get(), record);
+	}
+	item->setTimestamp(record.timestamp);
+	return item;
+}
+
+void StatusReplayer::apply(StatusItem *item, const JournalRecord &record) {
+	switch (record.type) {
+	case type::INT:
+		item->setValueAsInt(record.intValue);
+		break;
+	case type::DOUBLE:
+		item->setValueAsDouble(record.doubleValue);
+		break;
+	case type::FLOAT:
+		item->setValueAsFloat(record.floatValue);
+		break;
+	case type::STRING:
+		item->setValueAsString(record.stringValue);
+		break;
+	default:
+		break;
+	}
+	AlarmStatusItem *alarmItem = dynamic_cast<AlarmStatusItem *> (item);
+	if (alarmItem != 0) {
+		alarmItem->setAlarmState(record.severity, record.cause, record.message);
+	}
+}
+
+pStatusItem StatusReplayer::makeItem(const JournalRecord &record) {
+	switch (record.kind) {
+	case StatusItemSpec::ALARM:
+		return pStatusItem(new AlarmStatusItem(record.name, record.type));
+	case StatusItemSpec::HEALTH:
+		return pStatusItem(new HealthStatusItem(record.name));
+	default:
+		return pStatusItem(new StatusItem(record.name, record.type));
+	}
+}
+
+}
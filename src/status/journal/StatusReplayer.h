@@ -0,0 +1,80 @@
+#ifndef STATUSREPLAYER_H_
+#define STATUSREPLAYER_H_
+
+#include <string>
+#include <unordered_map>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapiexcept.h>
+#include <status/StatusItem.h>
+#include <status/senders/StatusSender.h>
+#include <status/journal/StatusJournalReader.h>
+
+namespace giapi {
+
+/**
+ * Posts the records of a status journal again through a status sender,
+ * reproducing a recorded load without the processes that produced it.
+ * <p/>
+ * The replayer keeps its own status items, one per name in the journal,
+ * outside the status database, so replaying doesn't disturb the status
+ * items of the process. Each record sets the value, alarm state and
+ * original timestamp of its item, which is then posted.
+ */
+class StatusReplayer {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a replayer of the journal at <code>path</code>
+	 *
+	 * @param sender where the records are posted
+	 *
+	 * @throws GiapiException if the journal can't be read
+	 */
+	StatusReplayer(const std::string &path, pStatusSender sender)
+			throw (GiapiException);
+
+	virtual ~StatusReplayer();
+
+	/**
+	 * Post all the records of the journal.
+	 *
+	 * @param speed how fast the records are posted compared to the
+	 *        time between them when they were recorded: 1 keeps the
+	 *        original pace, 10 is ten times faster. Zero or less posts
+	 *        them as fast as possible.
+	 *
+	 * @return the number of records posted
+	 */
+	int replay(double speed = 1.0) throw (PostException);
+
+	/**
+	 * Build a status item of the kind and type of the record
+	 */
+	static pStatusItem makeItem(const JournalRecord &record);
+
+	/**
+	 * Set the value and alarm state of the record in the item
+	 */
+	static void apply(StatusItem *item, const JournalRecord &record);
+
+private:
+	/**
+	 * Return the status item the record is applied to, created the
+	 * first time its name is seen
+	 */
+	pStatusItem getItem(const JournalRecord &record);
+
+	StatusJournalReader _reader;
+	pStatusSender _sender;
+	std::unordered_map<std::string, pStatusItem> _items;
+};
+
+}
+
+#endif /* STATUSREPLAYER_H_ */
@@ -0,0 +1,13 @@
+
+# Add inputs and outputs from these tool invocations to the build variables 
+OBJS += $(patsubst %.cpp,%.o,$(wildcard ./src/status/journal/*.cpp))
+
+CPP_DEPS += $(patsubst %.cpp,%.d,$(wildcard ./src/status/journal/*.cpp))
+
+# Each subdirectory must supply rules for building sources it contributes
+src/status/journal/%.o: ../src/status/journal/%.cpp
+	@echo 'Building file: $<'
+	@echo 'Invoking $(OS) C++ Compiler'
+	$(CXX) $(INC_DIRS) -O3 -Wall -c -fmessage-length=0 -MMD -MP -MF"../$(@:%.o=%.d)" -MT"../$(@:%.o=%.d)" -o"../$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' ' 
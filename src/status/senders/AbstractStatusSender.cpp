@@ -13,10 +13,13 @@ namespace giapi {
 log4cxx::LoggerPtr AbstractStatusSender::logger(log4cxx::Logger::getLogger(
 		"giapi.AbstractStatusSender"));
 
-AbstractStatusSender::AbstractStatusSender() {
+AbstractStatusSender::AbstractStatusSender() :
+	_batchMode(false), _posts(0), _batches(0), _unchanged(0), _throttled(0),
+			_errors(0), _bytes(0) {
 }
 
 AbstractStatusSender::~AbstractStatusSender() {
+	stopScheduledPosts();
 }
 
 int AbstractStatusSender::postStatus(const std::string &name) const
@@ -29,20 +32,258 @@ int AbstractStatusSender::postStatus(const std::string &name) const
 		return status::ERROR;
 	}
 
+	std::lock_guard<std::mutex> guard(_postLock);
 	return doPost(statusItem);
 }
 
+int AbstractStatusSender::postStatusItem(const pStatusItem &item) const
+		throw (PostException) {
+	std::lock_guard<std::mutex> guard(_postLock);
+	return doPost(item);
+}
+
+int AbstractStatusSender::postStatusItems(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	std::lock_guard<std::mutex> guard(_postLock);
+	if (!_batchMode) {
+		int result = status::OK;
+		for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+				!= items.end(); ++it) {
+			//items that didn't change are not an error here
+			if ((*it)->isChanged() && doPost(*it) != status::OK) {
+				result = status::ERROR;
+			}
+		}
+		return result;
+	}
+
+	std::vector<pStatusItem> dirtyItems;
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		if ((*it)->isChanged() && !throttle(*it) && (*it)->takeChanged()) {
+			dirtyItems.push_back(*it);
+		}
+	}
+	if (dirtyItems.empty()) {
+		return status::OK;
+	}
+	return dispatchBatch(dirtyItems);
+}
+
+int AbstractStatusSender::postStatusGroup(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	std::lock_guard<std::mutex> guard(_postLock);
+	std::vector<pStatusItem> dirtyItems;
+	dirtyItems.reserve(items.size());
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		if ((*it)->takeChanged()) {
+			dirtyItems.push_back(*it);
+		}
+	}
+	if (dirtyItems.empty()) {
+		return status::OK;
+	}
+	return dispatchBatch(dirtyItems);
+}
+
+int AbstractStatusSender::postTable(CompactStatusTable &table) const
+		throw (PostException) {
+	std::lock_guard<std::mutex> guard(_postLock);
+	return dispatchTable(table);
+}
+
 int AbstractStatusSender::postStatus() const throw (PostException) {
-	//get the status items
-	const std::vector<pStatusItem> items =
-			StatusDatabase::Instance()->getStatusItems();
-	//and post the ones that haven't changed. Clear their status
+	StatusDatabase *db = StatusDatabase::Instance().get();
+	pStatusItem item;
+	std::lock_guard<std::mutex> guard(_postLock);
+	if (!_batchMode) {
+		//post only the items that changed since the last post. Items
+		//still in the dirty list if a post fails stay there for the
+		//next attempt
+		while ((item = db->nextDirtyItem()).get() != 0) {
+			doPost(item);
+		}
+		return status::OK;
+	}
+
+	//batch mode. Collect the dirty items, marking them clean,
+	//and dispatch all of them together. The urgent ones go first,
+	//in a batch of their own, so they don't wait for the rest to
+	//be serialized and sent
+	int result = status::OK;
+	std::vector<pStatusItem> dirtyItems;
+	while ((item = db->nextUrgentItem()).get() != 0) {
+		collect(item, dirtyItems);
+	}
+	if (!dirtyItems.empty()) {
+		result = dispatchBatch(dirtyItems);
+		dirtyItems.clear();
+	}
+
+	while ((item = db->nextDirtyItem()).get() != 0) {
+		collect(item, dirtyItems);
+	}
+	if (!dirtyItems.empty() && dispatchBatch(dirtyItems) != status::OK) {
+		result = status::ERROR;
+	}
+	return result;
+}
+
+void AbstractStatusSender::collect(const pStatusItem &item,
+		std::vector<pStatusItem> &dirtyItems) const {
+	//skip the ones posted individually after they were queued,
+	//and the ones that have to wait for their post interval
+	if (item->isChanged() && !throttle(item) && item->takeChanged()) {
+		dirtyItems.push_back(item);
+	}
+}
+
+int AbstractStatusSender::postBatch(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	int result = status::OK;
 	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
 			!= items.end(); ++it) {
-		pStatusItem item = *it;
-		doPost(item);
+		if (postStatus(*it) != status::OK) {
+			result = status::ERROR;
+		}
 	}
-	return status::OK;
+	return result;
+}
+
+int AbstractStatusSender::postTableBatch(const CompactStatusTable &table,
+		const std::vector<int> &ids) const throw (PostException) {
+	LOG4CXX_WARN(logger, "Status tables can't be posted by this sender, "
+			<< ids.size() << " items not posted");
+	return status::ERROR;
+}
+
+void AbstractStatusSender::setBatchMode(bool batch) {
+	LOG4CXX_DEBUG(logger, "Batch mode " << (batch ? "enabled" : "disabled"));
+	_batchMode = batch;
+}
+
+bool AbstractStatusSender::isBatchMode() const {
+	return _batchMode;
+}
+
+void AbstractStatusSender::setJournal(pStatusJournal journal) {
+	std::lock_guard<std::mutex> guard(_postLock);
+	_journal = journal;
+}
+
+pStatusJournal AbstractStatusSender::getJournal() const {
+	std::lock_guard<std::mutex> guard(_postLock);
+	return _journal;
+}
+
+void AbstractStatusSender::record(const pStatusItem &item) const {
+	if (_journal.get() != 0) {
+		_journal->append(item.get());
+	}
+}
+
+void AbstractStatusSender::record(const std::vector<pStatusItem> &items) const {
+	if (_journal.get() == 0) {
+		return;
+	}
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		_journal->append(it->get());
+	}
+}
+
+int AbstractStatusSender::dispatch(const pStatusItem &item) const
+		throw (PostException) {
+	record(item);
+	unsigned long updates = item->getUpdateCount();
+	LatencyHistogram::Clock::time_point start = LatencyHistogram::Clock::now();
+	int result;
+	try {
+		result = postStatus(item);
+	} catch (PostException &) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		_latency.recordSince(start);
+		throw;
+	}
+	_latency.recordSince(start);
+	if (result != status::OK) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		return result;
+	}
+	_posts.fetch_add(1, std::memory_order_relaxed);
+	item->countPost();
+	item->acknowledgePost(updates);
+	return result;
+}
+
+int AbstractStatusSender::dispatchBatch(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	record(items);
+	_updateCounts.clear();
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		_updateCounts.push_back((*it)->getUpdateCount());
+	}
+	LatencyHistogram::Clock::time_point start = LatencyHistogram::Clock::now();
+	int result;
+	try {
+		result = postBatch(items);
+	} catch (PostException &) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		_latency.recordSince(start);
+		throw;
+	}
+	_latency.recordSince(start);
+	if (result != status::OK) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		return result;
+	}
+	_batches.fetch_add(1, std::memory_order_relaxed);
+	_posts.fetch_add(items.size(), std::memory_order_relaxed);
+	for (size_t i = 0; i < items.size(); i++) {
+		items[i]->countPost();
+		items[i]->acknowledgePost(_updateCounts[i]);
+	}
+	return result;
+}
+
+int AbstractStatusSender::dispatchTable(CompactStatusTable &table) const
+		throw (PostException) {
+	_tableIds.clear();
+	table.takeChanged(_tableIds);
+	if (_tableIds.empty()) {
+		return status::OK;
+	}
+	LatencyHistogram::Clock::time_point start = LatencyHistogram::Clock::now();
+	int result;
+	try {
+		result = postTableBatch(table, _tableIds);
+	} catch (PostException &) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		_latency.recordSince(start);
+		table.markChanged(_tableIds);
+		throw;
+	}
+	_latency.recordSince(start);
+	if (result != status::OK) {
+		_errors.fetch_add(1, std::memory_order_relaxed);
+		table.markChanged(_tableIds);
+		return result;
+	}
+	_batches.fetch_add(1, std::memory_order_relaxed);
+	_posts.fetch_add(_tableIds.size(), std::memory_order_relaxed);
+	return result;
+}
+
+void AbstractStatusSender::getPostStatistics(StatusSenderStatistics &stats) const {
+	stats.posts = _posts.load(std::memory_order_relaxed);
+	stats.batches = _batches.load(std::memory_order_relaxed);
+	stats.unchanged = _unchanged.load(std::memory_order_relaxed);
+	stats.throttled = _throttled.load(std::memory_order_relaxed);
+	stats.errors = _errors.load(std::memory_order_relaxed);
+	stats.bytes = _bytes.load(std::memory_order_relaxed);
+	_latency.read(stats.latency);
 }
 
 int AbstractStatusSender::doPost(pStatusItem statusItem) const throw (PostException) {
@@ -51,12 +292,52 @@ int AbstractStatusSender::doPost(pStatusItem statusItem) const throw (PostExcept
 
 	//value hasn't changed since last post, return immediately.
 	if (!statusItem->isChanged()) {
+		_unchanged.fetch_add(1, std::memory_order_relaxed);
+		return status::ERROR;
+	}
+
+	//posted too recently. It goes out when the interval expires
+	if (throttle(statusItem)) {
+		return status::OK;
+	}
+
+	//mark clean, so it can be posted again
+	if (!statusItem->takeChanged()) {
+		_unchanged.fetch_add(1, std::memory_order_relaxed);
 		return status::ERROR;
 	}
 
-	statusItem->clearChanged(); //mark clean, so it can be posted again
 	//Post It. Invoke an specific post mechanism delegated to implementors
-	return postStatus(statusItem);
+	return dispatch(statusItem);
+}
+
+bool AbstractStatusSender::throttle(const pStatusItem &item) const {
+	long64 due;
+	if (item->reservePost(PostScheduler::now(), due)) {
+		return false;
+	}
+	if (item->markScheduled()) {
+		std::lock_guard<std::mutex> guard(_schedulerLock);
+		if (_scheduler.get() == 0) {
+			_scheduler.reset(new PostScheduler(this));
+		}
+		_scheduler->schedule(item, due);
+	}
+	_throttled.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void AbstractStatusSender::stopScheduledPosts() {
+	std::tr1::shared_ptr<PostScheduler> scheduler;
+	{
+		//not held while stopping, the scheduler thread
+		//may need it to finish a post
+		std::lock_guard<std::mutex> guard(_schedulerLock);
+		scheduler = _scheduler;
+	}
+	if (scheduler.get() != 0) {
+		scheduler->stop();
+	}
 }
 
 }
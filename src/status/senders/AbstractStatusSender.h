@@ -5,13 +5,20 @@
 #ifndef ABSTRACTSTATUSSENDER_H_
 #define ABSTRACTSTATUSSENDER_H_
 
+#include <atomic>
 #include <cstdarg>
+#include <vector>
+#include <mutex>
 #include <log4cxx/logger.h>
 
 #include <giapi/giapiexcept.h>
 
 #include <status/senders/StatusSender.h>
+#include <status/senders/PostScheduler.h>
 #include <status/StatusItem.h>
+#include <status/CompactStatusTable.h>
+#include <status/LatencyHistogram.h>
+#include <status/journal/StatusJournal.h>
 
 
 
@@ -29,6 +36,8 @@ namespace giapi {
  * class will mark them as "clean", so no new posts will be done on the same
  * item unless it changes its value.
  *
+ * Posts can be requested from several threads; they are dispatched to
+ * the implementors one at a time.
  */
 class AbstractStatusSender : public StatusSender {
 public:
@@ -38,7 +47,9 @@ public:
 	/**
 	 * Post all the dirty items. Look for the dirty items in
 	 * the internal database that holds all the status information,
-	 * and post them
+	 * and post them, urgent items like alarms first. In batch mode,
+	 * the dirty items are handed over together to postBatch(), in
+	 * two batches if there are urgent items
 	 */
 	virtual int postStatus() const throw (PostException);
 
@@ -49,6 +60,57 @@ public:
 	 */
 	virtual int postStatus(const std::string &name) const throw (PostException);
 
+	/**
+	 * Post the given status item if it has been modified since the
+	 * last time it was posted.
+	 */
+	virtual int postStatusItem(const pStatusItem &item) const
+			throw (PostException);
+
+	/**
+	 * Post the given status items that have been modified since
+	 * the last time they were posted. In batch mode they are
+	 * handed over together to postBatch()
+	 */
+	virtual int postStatusItems(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Post the given status items that have been modified since
+	 * the last time they were posted, together through postBatch()
+	 */
+	virtual int postStatusGroup(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Post the changed items of the table together through
+	 * postTableBatch()
+	 */
+	virtual int postTable(CompactStatusTable &table) const
+			throw (PostException);
+
+	virtual void setBatchMode(bool batch);
+
+	virtual bool isBatchMode() const;
+
+	/**
+	 * Record every status item posted by this sender in the given
+	 * journal, right before it's dispatched. An empty pointer stops
+	 * recording.
+	 */
+	void setJournal(pStatusJournal journal);
+
+	/**
+	 * Return the journal the posts are recorded in, if any
+	 */
+	pStatusJournal getJournal() const;
+
+	/**
+	 * Copy the counters of the posts done by this sender. The name
+	 * is left for the caller to fill in.
+	 */
+	void getPostStatistics(StatusSenderStatistics &stats) const;
+
 protected:
 	/**
 	 * This abstract post method must be implemented to perform
@@ -62,6 +124,45 @@ protected:
 	 */
 	virtual int postStatus(pStatusItem item) const throw (PostException) = 0;
 
+	/**
+	 * Post several status items at once. Used in batch mode, where
+	 * all the dirty items found by postStatus() are dispatched together.
+	 * The items are already marked as "clean" when this method
+	 * is invoked.
+	 *
+	 * The default implementation posts each item individually.
+	 * Implementors can override it to pack all the items in a single
+	 * message.
+	 */
+	virtual int postBatch(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Post the given items of a compact status table at once. The
+	 * items are already marked as not changed when this method is
+	 * invoked.
+	 *
+	 * The default implementation returns giapi::status::ERROR, since
+	 * the items of a table are not StatusItem objects. Implementors
+	 * that can send them override it.
+	 */
+	virtual int postTableBatch(const CompactStatusTable &table,
+			const std::vector<int> &ids) const throw (PostException);
+
+	/**
+	 * Stop posting the items deferred by their maximum post rate.
+	 * Implementors must invoke it in their destructor, since the
+	 * deferred posts use postStatus(pStatusItem).
+	 */
+	void stopScheduledPosts();
+
+	/**
+	 * Count the bytes of a serialized post, for the statistics
+	 */
+	void countBytes(unsigned long bytes) const {
+		_bytes.fetch_add(bytes, std::memory_order_relaxed);
+	}
+
 private:
 	/**
 	 * An internal method that will validate whether the status item has
@@ -70,6 +171,91 @@ private:
 	 * implementing classes of the postStatus(StatusItem *item) method.
 	 */
 	int doPost(pStatusItem item) const throw (PostException);
+
+	/**
+	 * Check the maximum post rate of the item. If it was posted
+	 * too recently, schedule the post for when the interval
+	 * expires and return true.
+	 */
+	bool throttle(const pStatusItem &item) const;
+
+	/**
+	 * Add the item to the batch being collected by postStatus(),
+	 * marking it clean, if it needs to be posted now
+	 */
+	void collect(const pStatusItem &item,
+			std::vector<pStatusItem> &dirtyItems) const;
+
+	/**
+	 * Record the items about to be dispatched, if there is a
+	 * journal. Invoked holding the post lock.
+	 */
+	void record(const pStatusItem &item) const;
+	void record(const std::vector<pStatusItem> &items) const;
+
+	/**
+	 * Record the item or items and hand them over to postStatus() or
+	 * postBatch(), counting the post and its latency. Invoked holding
+	 * the post lock.
+	 */
+	int dispatch(const pStatusItem &item) const throw (PostException);
+	int dispatchBatch(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Hand the changed items of a table over to postTableBatch(),
+	 * counting the post and its latency, and mark them as changed
+	 * again if they are not sent. Invoked holding the post lock.
+	 */
+	int dispatchTable(CompactStatusTable &table) const throw (PostException);
+
+	/**
+	 * Update counts of the items of the batch being dispatched, taken
+	 * before they are serialized. Protected by the post lock
+	 */
+	mutable std::vector<unsigned long> _updateCounts;
+
+	/**
+	 * Ids of the table items being dispatched. Protected by the post
+	 * lock
+	 */
+	mutable std::vector<int> _tableIds;
+
+	/**
+	 * Where the posts are recorded. Protected by the post lock
+	 */
+	pStatusJournal _journal;
+
+	/**
+	 * Whether the dirty items are posted together in a batch
+	 */
+	bool _batchMode;
+
+	/**
+	 * Serializes the posts, since implementors are not
+	 * required to be thread safe
+	 */
+	mutable std::mutex _postLock;
+
+	/**
+	 * Posts the items deferred by their maximum rate. Created the
+	 * first time a post is deferred
+	 */
+	mutable std::tr1::shared_ptr<PostScheduler> _scheduler;
+	mutable std::mutex _schedulerLock;
+
+	/**
+	 * Statistics. Mostly updated holding the post lock, so relaxed
+	 * atomics are enough, and cost no more than plain counters.
+	 */
+	mutable std::atomic<unsigned long> _posts;
+	mutable std::atomic<unsigned long> _batches;
+	mutable std::atomic<unsigned long> _unchanged;
+	mutable std::atomic<unsigned long> _throttled;
+	mutable std::atomic<unsigned long> _errors;
+	mutable std::atomic<unsigned long> _bytes;
+	mutable LatencyHistogram _latency;
+
 	/*
 	 * Logging facility
 	 */
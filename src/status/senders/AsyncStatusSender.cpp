@@ -0,0 +1,237 @@
+#include "AsyncStatusSender.h"
+
+#include <chrono>
+#include <exception>
+
+#include <status/StatusDatabase.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr AsyncStatusSender::logger(log4cxx::Logger::getLogger(
+		"giapi.AsyncStatusSender"));
+
+/**
+ * Maximum number of items handed over to the delegate at once
+ */
+static const size_t MAX_ITEMS_PER_SEND = 256;
+
+/**
+ * How long the publisher thread sleeps before looking at the
+ * queue again if nobody wakes it up
+ */
+static const long IDLE_WAIT_MS = 100;
+
+AsyncStatusSender::AsyncStatusSender(pStatusSender delegate, size_t capacity) :
+	_delegate(delegate), _queue(capacity), _urgentQueue(URGENT_CAPACITY),
+			_enqueued(0), _processed(0),
+			_sent(0), _dropped(0), _coalesced(0), _running(true) {
+	_publisher = std::thread(&AsyncStatusSender::run, this);
+}
+
+AsyncStatusSender::~AsyncStatusSender() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_running = false;
+	}
+	_itemsQueued.notify_one();
+	_publisher.join();
+}
+
+int AsyncStatusSender::postStatus() const throw (PostException) {
+	StatusDatabase *db = StatusDatabase::Instance().get();
+	std::vector<pStatusItem> overflow;
+	pStatusItem item;
+	while ((item = db->nextDirtyItem()).get() != 0) {
+		if (!item->isChanged()) {
+			continue; //posted individually after it was queued
+		}
+		if (!enqueue(item)) {
+			overflow.push_back(item);
+		}
+	}
+	signal();
+
+	//back to the dirty list, so the next post tries again. Not
+	//done in the loop above or we would find them again there
+	for (std::vector<pStatusItem>::iterator it = overflow.begin(); it
+			!= overflow.end(); ++it) {
+		(*it)->requeue();
+	}
+	return overflow.empty() ? status::OK : status::ERROR;
+}
+
+int AsyncStatusSender::postStatus(const std::string &name) const
+		throw (PostException) {
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem(name);
+	if (item.get() == 0) {
+		LOG4CXX_WARN(logger, "No status item found for " << name << ". Not posting");
+		return status::ERROR;
+	}
+	return postStatusItem(item);
+}
+
+int AsyncStatusSender::postStatusItem(const pStatusItem &item) const
+		throw (PostException) {
+	if (item.get() == 0 || !item->isChanged()) {
+		return status::ERROR;
+	}
+	if (!enqueue(item)) {
+		item->requeue();
+		return status::ERROR;
+	}
+	signal();
+	return status::OK;
+}
+
+int AsyncStatusSender::postStatusItems(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	int result = status::OK;
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		if ((*it)->isChanged() && !enqueue(*it)) {
+			(*it)->requeue();
+			result = status::ERROR;
+		}
+	}
+	signal();
+	return result;
+}
+
+int AsyncStatusSender::postStatusGroup(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	return _delegate->postStatusGroup(items);
+}
+
+int AsyncStatusSender::postTable(CompactStatusTable &table) const
+		throw (PostException) {
+	return _delegate->postTable(table);
+}
+
+void AsyncStatusSender::setBatchMode(bool batch) {
+	_delegate->setBatchMode(batch);
+}
+
+bool AsyncStatusSender::isBatchMode() const {
+	return _delegate->isBatchMode();
+}
+
+bool AsyncStatusSender::flush(long timeout) const {
+	unsigned long target = _enqueued.load();
+	std::unique_lock<std::mutex> lock(_lock);
+	if (timeout <= 0) {
+		_itemsProcessed.wait(lock, [this, target] {
+			return _processed.load() >= target;
+		});
+		return true;
+	}
+	return _itemsProcessed.wait_for(lock, std::chrono::milliseconds(timeout),
+			[this, target] {
+				return _processed.load() >= target;
+			});
+}
+
+void AsyncStatusSender::getStatistics(AsyncPostStatistics &stats) const {
+	stats.queueDepth = _queue.size() + _urgentQueue.size();
+	stats.sent = _sent.load(std::memory_order_relaxed);
+	stats.dropped = _dropped.load(std::memory_order_relaxed);
+	stats.coalesced = _coalesced.load(std::memory_order_relaxed);
+}
+
+bool AsyncStatusSender::enqueue(const pStatusItem &item) const {
+	if (!item->markPending()) {
+		//already waiting in the queue, it will go out with
+		//its latest value
+		_coalesced.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	util::BoundedQueue<pStatusItem> &queue = item->isUrgent() ? _urgentQueue
+			: _queue;
+	if (!queue.offer(item)) {
+		item->clearPending();
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	_enqueued.fetch_add(1);
+	return true;
+}
+
+void AsyncStatusSender::signal() const {
+	//taking the lock makes sure the publisher is either sleeping or
+	//about to check the queue again, so the notification isn't lost
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+	}
+	_itemsQueued.notify_one();
+}
+
+void AsyncStatusSender::take(util::BoundedQueue<pStatusItem> &queue,
+		std::vector<pStatusItem> &items) {
+	pStatusItem item;
+	while (items.size() < MAX_ITEMS_PER_SEND && queue.poll(item)) {
+		//clear the flag before sending, so changes made from
+		//now on queue the item again
+		item->clearPending();
+		items.push_back(item);
+	}
+}
+
+void AsyncStatusSender::run() {
+	std::vector<pStatusItem> items;
+	items.reserve(MAX_ITEMS_PER_SEND);
+	std::vector<unsigned long> posts;
+	posts.reserve(MAX_ITEMS_PER_SEND);
+	for (;;) {
+		//the urgent items go out first, and on their own
+		take(_urgentQueue, items);
+		if (items.empty()) {
+			take(_queue, items);
+		}
+
+		if (items.empty()) {
+			std::unique_lock<std::mutex> lock(_lock);
+			if (!_running && _queue.size() == 0 && _urgentQueue.size() == 0) {
+				break;
+			}
+			_itemsQueued.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS),
+					[this] {
+						return _queue.size() > 0 || _urgentQueue.size() > 0
+								|| !_running;
+					});
+			continue;
+		}
+
+		//the delegate skips items that can't go out now, like the
+		//ones kept by their maximum post rate, so only the items it
+		//dispatched count as sent
+		posts.clear();
+		for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+				!= items.end(); ++it) {
+			posts.push_back((*it)->getPostCount());
+		}
+		try {
+			_delegate->postStatusItems(items);
+		} catch (PostException &e) {
+			LOG4CXX_WARN(logger, "Problem posting status: " << e.what());
+		} catch (std::exception &e) {
+			LOG4CXX_ERROR(logger, "Unexpected error posting status: " << e.what());
+		} catch (...) {
+			LOG4CXX_ERROR(logger, "Unknown error posting status");
+		}
+		unsigned long sent = 0;
+		for (size_t i = 0; i < items.size(); i++) {
+			if (items[i]->getPostCount() != posts[i]) {
+				sent++;
+			}
+		}
+		_sent.fetch_add(sent, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			_processed.fetch_add(items.size());
+		}
+		_itemsProcessed.notify_all();
+		items.clear();
+	}
+}
+
+}
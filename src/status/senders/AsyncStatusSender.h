@@ -0,0 +1,192 @@
+#ifndef ASYNCSTATUSSENDER_H_
+#define ASYNCSTATUSSENDER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapiexcept.h>
+#include <giapi/StatusUtil.h>
+#include <status/senders/StatusSender.h>
+#include <status/StatusItem.h>
+#include <util/BoundedQueue.h>
+
+namespace giapi {
+
+/**
+ * A Status Sender that posts from a background thread.
+ * <p/>
+ * Posting only queues the dirty items and returns, so callers never
+ * wait for the underlying communication mechanism. A publisher thread
+ * takes the queued items and hands them over to another StatusSender,
+ * the delegate, which does the actual send.
+ * <p/>
+ * The queue keeps a reference to the items, not their values, so the
+ * latest value wins: an item that changes several times before the
+ * publisher gets to it is queued once and sent once, with its most
+ * recent value. Those extra posts are counted as coalesced.
+ * <p/>
+ * The queue is bounded and never blocks. When it's full the item is
+ * counted as dropped and left dirty, so the next postStatus() picks
+ * it up again.
+ * <p/>
+ * Urgent items, like alarms and health, have a queue of their own.
+ * The publisher thread empties it before taking anything else, and
+ * sends its items on their own, so an alarm waits at most for the
+ * send in progress, never for the bulk of the status.
+ */
+class AsyncStatusSender : public StatusSender {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Default number of items the queue can hold
+	 */
+	static const size_t DEFAULT_CAPACITY = 8192;
+
+	/**
+	 * Number of urgent items the queue can hold
+	 */
+	static const size_t URGENT_CAPACITY = 1024;
+
+	/**
+	 * Build a sender that posts through <code>delegate</code> from
+	 * its own publisher thread.
+	 *
+	 * @param delegate the status sender that does the actual send
+	 * @param capacity number of items the queue can hold. Rounded up
+	 *        to a power of two.
+	 */
+	AsyncStatusSender(pStatusSender delegate, size_t capacity =
+			DEFAULT_CAPACITY);
+
+	/**
+	 * Send whatever is queued and stop the publisher thread
+	 */
+	virtual ~AsyncStatusSender();
+
+	/**
+	 * Queue all the dirty items to be sent by the publisher thread
+	 */
+	virtual int postStatus() const throw (PostException);
+
+	/**
+	 * Queue the given status item, if it's dirty, to be sent by the
+	 * publisher thread.
+	 *
+	 * @return giapi::status::ERROR if there is no such status item
+	 *         or if it hasn't changed since it was last posted.
+	 */
+	virtual int postStatus(const std::string &name) const
+			throw (PostException);
+
+	virtual int postStatusItem(const pStatusItem &item) const
+			throw (PostException);
+
+	virtual int postStatusItems(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Groups are not queued: they are handed over to the delegate
+	 * right away, so they go out in one message
+	 */
+	virtual int postStatusGroup(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Tables are not queued either, the delegate posts them right away
+	 */
+	virtual int postTable(CompactStatusTable &table) const
+			throw (PostException);
+
+	/**
+	 * Batch mode applies to the delegate, that is, to each group
+	 * of items the publisher thread sends at once
+	 */
+	virtual void setBatchMode(bool batch);
+
+	virtual bool isBatchMode() const;
+
+	/**
+	 * Wait until all the items queued before this call have been
+	 * sent.
+	 *
+	 * @param timeout maximum time to wait, in milliseconds. Zero
+	 *        waits for as long as needed.
+	 *
+	 * @return true if the items were sent, false if the timeout
+	 *         expired first
+	 */
+	bool flush(long timeout = 0) const;
+
+	/**
+	 * Fill <code>stats</code> with the counters of this sender
+	 */
+	void getStatistics(AsyncPostStatistics &stats) const;
+
+private:
+	/**
+	 * Queue an item that needs to be sent.
+	 *
+	 * @return false if the queue is full
+	 */
+	bool enqueue(const pStatusItem &item) const;
+
+	/**
+	 * Wake up the publisher thread
+	 */
+	void signal() const;
+
+	/**
+	 * Main loop of the publisher thread
+	 */
+	void run();
+
+	pStatusSender _delegate;
+
+	mutable util::BoundedQueue<pStatusItem> _queue;
+	mutable util::BoundedQueue<pStatusItem> _urgentQueue;
+
+	/**
+	 * Take up to MAX_ITEMS_PER_SEND items from the queue
+	 */
+	static void take(util::BoundedQueue<pStatusItem> &queue,
+			std::vector<pStatusItem> &items);
+
+	/**
+	 * Counters. Items are enqueued by the posting threads and
+	 * processed, whether they needed a send or not, by the
+	 * publisher thread
+	 */
+	mutable std::atomic<unsigned long> _enqueued;
+	mutable std::atomic<unsigned long> _processed;
+	mutable std::atomic<unsigned long> _sent;
+	mutable std::atomic<unsigned long> _dropped;
+	mutable std::atomic<unsigned long> _coalesced;
+
+	std::atomic<bool> _running;
+
+	/**
+	 * Used only to put the publisher thread to sleep while there
+	 * is nothing to send, and flush() callers while they wait
+	 */
+	mutable std::mutex _lock;
+	mutable std::condition_variable _itemsQueued;
+	mutable std::condition_variable _itemsProcessed;
+
+	std::thread _publisher;
+
+	AsyncStatusSender(const AsyncStatusSender &);
+	AsyncStatusSender & operator=(const AsyncStatusSender &);
+};
+
+}
+
+#endif /* ASYNCSTATUSSENDER_H_ */
@@ -0,0 +1,288 @@
+#include "AutoPoster.h"
+
+#include <status/StatusDatabase.h>
+#include <status/senders/StatusSenderFactory.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr AutoPoster::logger(log4cxx::Logger::getLogger(
+		"giapi.AutoPoster"));
+
+/**
+ * Milliseconds in a clock duration
+ */
+static double toMillis(std::chrono::steady_clock::duration duration) {
+	return std::chrono::duration_cast<std::chrono::duration<double,
+			std::milli> >(duration).count();
+}
+
+AutoPoster::AutoPoster(StatusSenderFactory *factory) :
+	_factory(factory), _running(false), _generation(0) {
+}
+
+AutoPoster::~AutoPoster() {
+	stop();
+	if (_retired.joinable()) {
+		//destroyed from a post, the thread can't wait for itself
+		if (_retired.get_id() == std::this_thread::get_id()) {
+			_retired.detach();
+		} else {
+			_retired.join();
+		}
+	}
+}
+
+int AutoPoster::start(long periodMs) {
+	if (periodMs <= 0) {
+		return status::ERROR;
+	}
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		Clock::time_point now = Clock::now();
+		_default.period = std::chrono::milliseconds(periodMs);
+		_default.next = now + _default.period;
+		if (_running) {
+			_changed.notify_one();
+			return status::OK;
+		}
+		//the groups start counting now too
+		for (std::map<std::string, Schedule>::iterator it = _groups.begin(); it
+				!= _groups.end(); ++it) {
+			it->second.next = now + it->second.period;
+		}
+		_running = true;
+		_thread = std::thread(&AutoPoster::run, this, ++_generation);
+	}
+	LOG4CXX_INFO(logger, "Posting status every " << periodMs << " ms");
+	return status::OK;
+}
+
+void AutoPoster::stop() {
+	std::thread thread;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_running) {
+			return;
+		}
+		_running = false;
+		_generation++;
+		thread.swap(_thread);
+	}
+	_changed.notify_all();
+	if (thread.get_id() != std::this_thread::get_id()) {
+		thread.join();
+		return;
+	}
+
+	//stopped from a post, the thread can't wait for itself. It leaves
+	//its loop once the post returns, even if started again meanwhile,
+	//and is joined by the next stop or the destructor
+	std::thread retired;
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		retired.swap(_retired);
+		_retired.swap(thread);
+	}
+	if (retired.joinable()) {
+		retired.join();
+	}
+}
+
+bool AutoPoster::isRunning() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _running;
+}
+
+int AutoPoster::setGroup(const std::string &group,
+		const std::vector<std::string> &items, long periodMs) {
+	if (group.empty() || periodMs < 0) {
+		return status::ERROR;
+	}
+	std::vector<pStatusItem> resolved;
+	resolved.reserve(items.size());
+	for (std::vector<std::string>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		pStatusItem item = StatusDatabase::Instance()->getStatusItem(*it);
+		if (item.get() == 0) {
+			LOG4CXX_WARN(logger, "No status item " << *it << " for the auto post group " << group);
+			return status::ERROR;
+		}
+		resolved.push_back(item);
+	}
+
+	std::lock_guard<std::mutex> guard(_lock);
+	std::map<std::string, Schedule>::iterator existing = _groups.find(group);
+	for (std::vector<pStatusItem>::const_iterator it = resolved.begin(); it
+			!= resolved.end(); ++it) {
+		if (_grouped.count(it->get()) > 0) {
+			bool ours = false;
+			if (existing != _groups.end()) {
+				const std::vector<pStatusItem> &current = existing->second.items;
+				for (size_t i = 0; i < current.size() && !ours; i++) {
+					ours = current[i] == *it;
+				}
+			}
+			if (!ours) {
+				LOG4CXX_WARN(logger, "Status item " << (*it)->getName()
+						<< " is already in another auto post group");
+				return status::ERROR;
+			}
+		}
+	}
+
+	if (existing != _groups.end()) {
+		//pending items of the old group go back to the dirty list,
+		//the default post left them out
+		for (std::vector<pStatusItem>::const_iterator it =
+				existing->second.items.begin(); it
+				!= existing->second.items.end(); ++it) {
+			_grouped.erase(it->get());
+			(*it)->requeue();
+		}
+		_groups.erase(existing);
+	}
+	if (periodMs == 0) {
+		return status::OK;
+	}
+
+	Schedule &schedule = _groups[group];
+	schedule.items = resolved;
+	schedule.period = std::chrono::milliseconds(periodMs);
+	schedule.next = Clock::now() + schedule.period;
+	for (std::vector<pStatusItem>::const_iterator it = resolved.begin(); it
+			!= resolved.end(); ++it) {
+		_grouped.insert(it->get());
+	}
+	_changed.notify_one();
+	return status::OK;
+}
+
+int AutoPoster::getStatistics(const std::string &group,
+		AutoPostStatistics &stats) const {
+	std::lock_guard<std::mutex> guard(_lock);
+	if (group.empty()) {
+		stats = _default.stats;
+		return status::OK;
+	}
+	std::map<std::string, Schedule>::const_iterator it = _groups.find(group);
+	if (it == _groups.end()) {
+		return status::ERROR;
+	}
+	stats = it->second.stats;
+	return status::OK;
+}
+
+void AutoPoster::run(unsigned long generation) {
+	std::unique_lock<std::mutex> lock(_lock);
+	while (_generation == generation) {
+		//find the schedule that posts first
+		Schedule *due = &_default;
+		for (std::map<std::string, Schedule>::iterator it = _groups.begin(); it
+				!= _groups.end(); ++it) {
+			if (it->second.next < due->next) {
+				due = &it->second;
+			}
+		}
+		if (Clock::now() < due->next) {
+			_changed.wait_until(lock, due->next);
+			continue; //the schedules may have changed
+		}
+
+		//post without holding the lock. The schedule can be removed
+		//meanwhile, so it's looked up again afterwards
+		bool all = due == &_default;
+		std::string name;
+		std::vector<pStatusItem> items;
+		if (!all) {
+			for (std::map<std::string, Schedule>::iterator it =
+					_groups.begin(); it != _groups.end(); ++it) {
+				if (&it->second == due) {
+					name = it->first;
+				}
+			}
+			items = due->items;
+		}
+		Clock::time_point start = Clock::now();
+		lock.unlock();
+		post(items, all);
+		Clock::time_point end = Clock::now();
+		lock.lock();
+		if (_generation != generation) {
+			break; //stopped from the post, the schedules aren't ours
+		}
+
+		if (all) {
+			reschedule(_default, start, end);
+		} else {
+			std::map<std::string, Schedule>::iterator it = _groups.find(name);
+			if (it != _groups.end()) {
+				reschedule(it->second, start, end);
+			}
+		}
+	}
+}
+
+void AutoPoster::post(const std::vector<pStatusItem> &items, bool all) {
+	try {
+		pStatusSender sender = _factory->getStatusSender();
+		if (!all) {
+			sender->postStatusItems(items);
+			return;
+		}
+		bool grouped;
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			grouped = !_grouped.empty();
+		}
+		if (!grouped) {
+			sender->postStatus();
+			return;
+		}
+
+		//take the dirty items, leaving out the ones in groups. Those
+		//stay changed, and are posted by their group
+		StatusDatabase *db = StatusDatabase::Instance().get();
+		std::vector<pStatusItem> dirty;
+		pStatusItem item;
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			while ((item = db->nextDirtyItem()).get() != 0) {
+				if (_grouped.count(item.get()) == 0) {
+					dirty.push_back(item);
+				}
+			}
+		}
+		if (!dirty.empty()) {
+			sender->postStatusItems(dirty);
+		}
+	} catch (GiapiException &e) {
+		LOG4CXX_WARN(logger, "Problem posting status: " << e.what());
+	}
+}
+
+void AutoPoster::reschedule(Schedule &schedule, Clock::time_point start,
+		Clock::time_point end) {
+	AutoPostStatistics &stats = schedule.stats;
+	double jitter = toMillis(start - schedule.next);
+	stats.posts++;
+	schedule.totalJitter += jitter;
+	stats.meanJitter = schedule.totalJitter / stats.posts;
+	if (jitter > stats.maxJitter) {
+		stats.maxJitter = jitter;
+	}
+	double postTime = toMillis(end - start);
+	if (postTime > stats.maxPostTime) {
+		stats.maxPostTime = postTime;
+	}
+
+	//the next post time is counted from the scheduled one, not from
+	//now, so the delays don't add up. Posts already missed are skipped
+	schedule.next += schedule.period;
+	if (schedule.next <= end) {
+		long missed = (end - schedule.next) / schedule.period + 1;
+		stats.overruns += missed;
+		schedule.next += missed * schedule.period;
+	}
+}
+
+}
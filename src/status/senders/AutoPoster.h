@@ -0,0 +1,168 @@
+#ifndef AUTOPOSTER_H_
+#define AUTOPOSTER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/StatusUtil.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+class StatusSenderFactory;
+
+/**
+ * Posts the dirty status items periodically, from its own thread, so
+ * instruments don't need a thread of their own calling postStatus().
+ * <p/>
+ * By default all the dirty items are posted at the same period. Some
+ * items can be given a period of their own by putting them in a group.
+ * The items of a group are posted only at the period of the group,
+ * and always together.
+ * <p/>
+ * Posts are scheduled on a monotonic clock, at fixed times from the
+ * start, so a late post doesn't delay the following ones. If a post
+ * takes longer than the period, the posts that should have happened
+ * in the meantime are skipped and counted as overruns.
+ * <p/>
+ * The posts go through the default status sender of the factory, so
+ * they use the usual dirty tracking, batch mode, maximum post rate and
+ * asynchronous mode.
+ */
+class AutoPoster {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a poster that sends through the default status sender
+	 * of <code>factory</code>. It doesn't post until started.
+	 */
+	explicit AutoPoster(StatusSenderFactory *factory);
+
+	/**
+	 * Stop posting
+	 */
+	virtual ~AutoPoster();
+
+	/**
+	 * Start posting all the dirty items not in a group every
+	 * <code>periodMs</code> milliseconds. If already started, only
+	 * the period changes.
+	 *
+	 * @return giapi::status::ERROR if the period is not positive
+	 */
+	int start(long periodMs);
+
+	/**
+	 * Stop posting. The configured groups are kept.
+	 */
+	void stop();
+
+	/**
+	 * Return true while posting
+	 */
+	bool isRunning() const;
+
+	/**
+	 * Post the given items every <code>periodMs</code> milliseconds,
+	 * instead of at the default period. A group with the same name is
+	 * replaced. A period of zero removes the group.
+	 *
+	 * @return giapi::status::ERROR if any of the items doesn't exist or
+	 *         is in another group, or if the period is negative
+	 */
+	int setGroup(const std::string &group,
+			const std::vector<std::string> &items, long periodMs);
+
+	/**
+	 * Copy the statistics of the given group, or the default period
+	 * if the name is empty
+	 *
+	 * @return giapi::status::ERROR if there is no such group
+	 */
+	int getStatistics(const std::string &group, AutoPostStatistics &stats) const;
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * A set of items posted at the same period. The default one has
+	 * no name and no items: it takes the dirty items not in a group
+	 */
+	struct Schedule {
+		Schedule() :
+			period(Clock::duration::zero()), stats(), totalJitter(0) {
+		}
+
+		std::vector<pStatusItem> items;
+		Clock::duration period;
+		Clock::time_point next;
+		AutoPostStatistics stats;
+		double totalJitter;
+	};
+
+	/**
+	 * Main loop of the poster thread, until stopped or started again
+	 * with a new thread
+	 */
+	void run(unsigned long generation);
+
+	/**
+	 * Post the items of the schedule
+	 */
+	void post(const std::vector<pStatusItem> &items, bool all);
+
+	/**
+	 * Update the statistics and the next post time of the schedule,
+	 * after a post started at <code>start</code> and ended at
+	 * <code>end</code>
+	 */
+	static void reschedule(Schedule &schedule, Clock::time_point start,
+			Clock::time_point end);
+
+	StatusSenderFactory *_factory;
+
+	Schedule _default;
+	std::map<std::string, Schedule> _groups;
+
+	/**
+	 * The items in any group, left out of the default post
+	 */
+	std::unordered_set<const StatusItem *> _grouped;
+
+	bool _running;
+
+	/**
+	 * Incremented on each start and stop, so a thread stopped from its
+	 * own post doesn't keep running after a new start
+	 */
+	unsigned long _generation;
+
+	mutable std::mutex _lock;
+	std::condition_variable _changed;
+	std::thread _thread;
+
+	/**
+	 * The thread that was stopped from its own post, joined later
+	 */
+	std::thread _retired;
+
+	AutoPoster(const AutoPoster &);
+	AutoPoster & operator=(const AutoPoster &);
+};
+
+}
+
+#endif /* AUTOPOSTER_H_ */
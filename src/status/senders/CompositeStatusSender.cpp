@@ -0,0 +1,113 @@
+#include "CompositeStatusSender.h"
+
+#include <chrono>
+
+#include <status/journal/StatusJournalWriter.h>
+#include <status/journal/StatusReplayer.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr CompositeStatusSender::logger(log4cxx::Logger::getLogger(
+		"giapi.CompositeStatusSender"));
+
+CompositeStatusSender::CompositeStatusSender() {
+}
+
+CompositeStatusSender::~CompositeStatusSender() {
+	stopScheduledPosts();
+	//each sink drains its queue as it stops
+	_sinks.clear();
+}
+
+void CompositeStatusSender::addSink(const std::string &name,
+		pStatusSender sender, StatusSink::OverflowPolicy policy,
+		size_t capacity) {
+	pStatusSink sink(new StatusSink(name, sender, policy, capacity));
+	sink->setBatchMode(isBatchMode());
+	_sinks.push_back(sink);
+	LOG4CXX_INFO(logger, "Publishing status to sink " << name);
+}
+
+size_t CompositeStatusSender::getSinkCount() const {
+	return _sinks.size();
+}
+
+void CompositeStatusSender::setBatchMode(bool batch) {
+	AbstractStatusSender::setBatchMode(batch);
+	for (std::vector<pStatusSink>::const_iterator it = _sinks.begin(); it
+			!= _sinks.end(); ++it) {
+		(*it)->setBatchMode(batch);
+	}
+}
+
+bool CompositeStatusSender::flush(long timeout) {
+	std::chrono::steady_clock::time_point deadline =
+			std::chrono::steady_clock::now() + std::chrono::milliseconds(
+					timeout);
+	for (std::vector<pStatusSink>::const_iterator it = _sinks.begin(); it
+			!= _sinks.end(); ++it) {
+		long left = 0;
+		if (timeout > 0) {
+			left = std::chrono::duration_cast<std::chrono::milliseconds>(
+					deadline - std::chrono::steady_clock::now()).count();
+			if (left <= 0) {
+				return false;
+			}
+		}
+		if (!(*it)->flush(left)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CompositeStatusSender::getStatistics(
+		std::vector<StatusSinkStatistics> &stats) const {
+	stats.resize(_sinks.size());
+	for (size_t i = 0; i < _sinks.size(); i++) {
+		_sinks[i]->getStatistics(stats[i]);
+	}
+}
+
+int CompositeStatusSender::postStatus(pStatusItem item) const
+		throw (PostException) {
+	StatusJournalWriter writer(_snapshot);
+	item->accept(writer);
+	if (!writer.isWritten()) {
+		LOG4CXX_WARN(logger, "Array status items can't be published to several sinks: "
+				<< item->getName());
+		return status::ERROR;
+	}
+
+	std::vector<pStatusItem> *mirrors = 0;
+	int result = status::OK;
+	for (size_t i = 0; i < _sinks.size(); i++) {
+		pStatusItem copy;
+		if (_sinks[i]->getPolicy() == StatusSink::COALESCE) {
+			if (mirrors == 0) {
+				mirrors = &_mirrors[item.get()];
+				mirrors->resize(_sinks.size());
+			}
+			pStatusItem &mirror = (*mirrors)[i];
+			if (mirror.get() == 0 || mirror->getName() != _snapshot.name) {
+				//new item, or a new one at the address of a deleted one
+				mirror = StatusReplayer::makeItem(_snapshot);
+			}
+			StatusReplayer::apply(mirror.get(), _snapshot);
+			if (!mirror->isChanged()) {
+				continue; //the same value the sink has already
+			}
+			copy = mirror;
+		} else {
+			copy = StatusReplayer::makeItem(_snapshot);
+			StatusReplayer::apply(copy.get(), _snapshot);
+		}
+		copy->setTimestamp(_snapshot.timestamp);
+		if (!_sinks[i]->offer(copy)) {
+			result = status::ERROR;
+		}
+	}
+	return result;
+}
+
+}
@@ -0,0 +1,109 @@
+#ifndef COMPOSITESTATUSSENDER_H_
+#define COMPOSITESTATUSSENDER_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapiexcept.h>
+#include <giapi/StatusUtil.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/StatusSink.h>
+#include <status/journal/StatusJournal.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+/**
+ * A Status Sender that publishes every post to several sinks, like the
+ * GMP and a local journal, at the same time.
+ * <p/>
+ * Each sink is another status sender with its own queue and thread
+ * (see StatusSink), so a slow sink never holds up the others. Posting
+ * only copies the status item and queues it for each sink.
+ * <p/>
+ * Sinks need their own copy of the status items, since posting an item
+ * marks it clean: sinks with the COALESCE policy get one copy per item,
+ * updated by each post, while the other sinks get a new copy with the
+ * value of each post. Array status items can't be copied and are not
+ * published.
+ */
+class CompositeStatusSender : public AbstractStatusSender {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	CompositeStatusSender();
+
+	/**
+	 * Send whatever the sinks have queued and stop them
+	 */
+	virtual ~CompositeStatusSender();
+
+	/**
+	 * Publish the posts through <code>sender</code> as well. Sinks
+	 * must be added before anything is posted.
+	 *
+	 * @param name identifies the sink in the statistics
+	 */
+	void addSink(const std::string &name, pStatusSender sender,
+			StatusSink::OverflowPolicy policy, size_t capacity =
+					StatusSink::DEFAULT_CAPACITY);
+
+	/**
+	 * Number of sinks
+	 */
+	size_t getSinkCount() const;
+
+	/**
+	 * Batch mode applies to the senders of the sinks, that is, to
+	 * each group of items a sink sends at once
+	 */
+	virtual void setBatchMode(bool batch);
+
+	/**
+	 * Wait until all the sinks have handed over what was queued before
+	 * this call.
+	 *
+	 * @param timeout maximum time to wait, in milliseconds. Zero
+	 *        waits for as long as needed.
+	 *
+	 * @return false if the timeout expired first
+	 */
+	bool flush(long timeout = 0);
+
+	/**
+	 * Fill <code>stats</code> with the counters of each sink
+	 */
+	void getStatistics(std::vector<StatusSinkStatistics> &stats) const;
+
+protected:
+	/**
+	 * Queue a copy of the item for each sink
+	 */
+	virtual int postStatus(pStatusItem item) const throw (PostException);
+
+private:
+	std::vector<pStatusSink> _sinks;
+
+	/**
+	 * Copies of the status items for the COALESCE sinks, one per
+	 * sink, by original item. Only used while posting, which is
+	 * serialized
+	 */
+	mutable std::unordered_map<const StatusItem *, std::vector<pStatusItem> >
+			_mirrors;
+
+	/**
+	 * Value of the item being posted. Only used while posting
+	 */
+	mutable JournalRecord _snapshot;
+};
+
+}
+
+#endif /* COMPOSITESTATUSSENDER_H_ */
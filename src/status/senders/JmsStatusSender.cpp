@@ -11,17 +11,13 @@ namespace giapi {
 log4cxx::LoggerPtr JmsStatusSender::logger(log4cxx::Logger::getLogger(
 		"giapi.JmsStatusSender"));
 
-JmsStatusSender::JmsStatusSender() throw (CommunicationException) {
+JmsStatusSender::JmsStatusSender() throw (CommunicationException) :
+	_generation(0) {
 	LOG4CXX_DEBUG(logger, "Constructing JMS Status sender");
 	try {
 		_connectionManager = ConnectionManager::Instance();
-		//create an auto-acknowledged session
-		_session = _connectionManager->createSession();
-
-		//Instantiate the message producer
-		_producer = pMessageProducer(_session->createProducer(NULL));
-                _producer->setDeliveryMode(DeliveryMode::NON_PERSISTENT);
-                _producer->setTimeToLive(10 * 1000);
+		_generation = _connectionManager->getGeneration();
+		openSession();
 	} catch (CMSException& e) {
 		//clean any resources that might have been allocated
 		cleanup();
@@ -33,6 +29,7 @@ JmsStatusSender::JmsStatusSender() throw (CommunicationException) {
 
 JmsStatusSender::~JmsStatusSender() {
 	LOG4CXX_DEBUG(logger, "Destroying JMS Status sender");
+	stopScheduledPosts();
 	cleanup();
 }
 
@@ -43,6 +40,8 @@ int JmsStatusSender::postStatus(pStatusItem statusItem) const
 	BytesMessage *msg = NULL;
 
 	try {
+		checkConnection();
+
 		//create a bytes message
 		msg = _session->createBytesMessage();
 
@@ -50,14 +49,9 @@ int JmsStatusSender::postStatus(pStatusItem statusItem) const
 		StatusSerializerVisitor serializer(msg);
 		statusItem->accept(serializer);
 
-		//Create the destination...
-		//We will use a topic to send the status to the JMS Broker
-		Destination * destination = _session->createTopic(
-				GMPKeys::GMP_STATUS_DESTINATION_PREFIX + statusItem->getName());
-		//and dispatch the message
-		_producer->send(destination, msg);
-
-		delete destination;
+		//and dispatch the message to the item's topic
+		send(getDestination(*statusItem), msg, statusItem->isUrgent());
+		countBytes(msg->getBodyLength());
 
 	} catch (CMSException &ex) {
 		LOG4CXX_WARN(logger, "Problem posting status: " + ex.getMessage());
@@ -71,7 +65,127 @@ int JmsStatusSender::postStatus(pStatusItem statusItem) const
 	return giapi::status::OK;
 }
 
-void JmsStatusSender::cleanup() {
+int JmsStatusSender::postBatch(const std::vector<pStatusItem> &items) const
+		throw (PostException) {
+	LOG4CXX_DEBUG(logger, "Post batch of " << items.size() << " Status Items");
+
+	BytesMessage *msg = NULL;
+
+	try {
+		checkConnection();
+		msg = _session->createBytesMessage();
+
+		//all the items go in the same message
+		StatusSerializerVisitor serializer(msg);
+		serializer.writeBatch(items);
+
+		bool urgent = false;
+		for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+				!= items.end() && !urgent; ++it) {
+			urgent = (*it)->isUrgent();
+		}
+		send(_batchDestination.get(), msg, urgent);
+		countBytes(msg->getBodyLength());
+
+	} catch (CMSException &ex) {
+		LOG4CXX_WARN(logger, "Problem posting status batch: " + ex.getMessage());
+		if (msg != NULL)
+			delete msg;
+		throw PostException("Problem posting status batch : " + ex.getMessage());
+	}
+
+	if (msg != NULL) delete msg;
+	return giapi::status::OK;
+}
+
+int JmsStatusSender::postTableBatch(const CompactStatusTable &table,
+		const std::vector<int> &ids) const throw (PostException) {
+	LOG4CXX_DEBUG(logger, "Post batch of " << ids.size() << " table Status Items");
+
+	BytesMessage *msg = NULL;
+
+	try {
+		checkConnection();
+		msg = _session->createBytesMessage();
+
+		StatusSerializerVisitor serializer(msg);
+		serializer.writeBatch(table, ids);
+
+		//the batch goes ahead if any of its items would on its own
+		bool urgent = false;
+		for (std::vector<int>::const_iterator it = ids.begin(); it
+				!= ids.end() && !urgent; ++it) {
+			urgent = table.isUrgent(*it);
+		}
+		send(_batchDestination.get(), msg, urgent);
+		countBytes(msg->getBodyLength());
+
+	} catch (CMSException &ex) {
+		LOG4CXX_WARN(logger, "Problem posting status table: " + ex.getMessage());
+		if (msg != NULL)
+			delete msg;
+		throw PostException("Problem posting status table : " + ex.getMessage());
+	}
+
+	if (msg != NULL) delete msg;
+	return giapi::status::OK;
+}
+
+void JmsStatusSender::send(const Destination *destination, Message *msg,
+		bool urgent) const throw (CMSException) {
+	if (urgent) {
+		_producer->send(destination, msg, DeliveryMode::NON_PERSISTENT,
+				URGENT_PRIORITY, TIME_TO_LIVE);
+	} else {
+		_producer->send(destination, msg);
+	}
+}
+
+void JmsStatusSender::openSession() const throw (CMSException) {
+	//create an auto-acknowledged session
+	_session = _connectionManager->createSession();
+
+	//Instantiate the message producer
+	_producer = pMessageProducer(_session->createProducer(NULL));
+	_producer->setDeliveryMode(DeliveryMode::NON_PERSISTENT);
+	_producer->setTimeToLive(TIME_TO_LIVE);
+
+	_batchDestination = pDestination(_session->createTopic(
+			GMPKeys::GMP_STATUS_BATCH_DESTINATION));
+}
+
+void JmsStatusSender::checkConnection() const throw (CMSException) {
+	//objects created from a previous connection can't be used
+	int generation = _connectionManager->getGeneration();
+	if (generation == _generation) {
+		return;
+	}
+	LOG4CXX_INFO(logger, "Reconnected to the broker, opening a new status session");
+	cleanup();
+	openSession();
+	//only once the session is open, or the next post tries again
+	_generation = generation;
+}
+
+void JmsStatusSender::invalidateDestinations() const {
+	LOG4CXX_DEBUG(logger, "Discarding " << _destinations.size() << " cached destinations");
+	_destinations.clear();
+}
+
+Destination * JmsStatusSender::getDestination(const StatusItem &item) const
+		throw (CMSException) {
+	pDestination &destination = _destinations[item.getName()];
+	if (destination.get() == 0) {
+		//We will use a topic to send the status to the JMS Broker
+		destination = pDestination(_session->createTopic(
+				GMPKeys::GMP_STATUS_DESTINATION_PREFIX + item.getName()));
+	}
+	return destination.get();
+}
+
+void JmsStatusSender::cleanup() const {
+	//the destinations belong to the session being closed
+	_destinations.clear();
 	// Close open resources.
 	try {
 		if (_producer.get() != 0)
@@ -8,11 +8,15 @@
 #include <status/StatusItem.h>
 #include <status/AlarmStatusItem.h>
 #include <status/HealthStatusItem.h>
+#include <status/CompactStatusTable.h>
 
 #include <cms/Session.h>
 #include <cms/Destination.h>
 #include <cms/MessageProducer.h>
 
+#include <unordered_map>
+#include <string>
+
 #include <util/JmsSmartPointers.h>
 #include <gmp/ConnectionManager.h>
 
@@ -34,28 +38,109 @@ class JmsStatusSender: public AbstractStatusSender {
 		HEALTH_OFFSET = 20
 	};
 
+	/**
+	 * JMS priority of the urgent status items, like alarms and
+	 * health. The rest go with the default priority, 4
+	 */
+	static const int URGENT_PRIORITY = 9;
+
+	/**
+	 * Milliseconds the status messages are kept by the broker
+	 */
+	static const long long TIME_TO_LIVE = 10 * 1000;
+
 public:
 	JmsStatusSender() throw (CommunicationException);
 	virtual ~JmsStatusSender();
+
+	/**
+	 * Discard the cached status item destinations. They will be
+	 * created again the next time each item is posted. This happens
+	 * automatically when the connection manager reconnects to the
+	 * broker, along with a new session and producer.
+	 */
+	void invalidateDestinations() const;
+
 protected:
 	virtual int postStatus(pStatusItem item) const throw (PostException);
 
+	/**
+	 * Pack all the items in a single message and send it to the
+	 * status batch destination in the GMP
+	 */
+	virtual int postBatch(const std::vector<pStatusItem> &items) const
+			throw (PostException);
+
+	/**
+	 * Pack the items of the table in a single message and send it to
+	 * the status batch destination in the GMP, like postBatch()
+	 */
+	virtual int postTableBatch(const CompactStatusTable &table,
+			const std::vector<int> &ids) const throw (PostException);
+
 private:
+	/**
+	 * The topic of each status item posted so far, keyed by the name
+	 * of the item. Not by the item itself: the composite sender and
+	 * the journal replayer post copies that come and go, and a new
+	 * copy may reuse the address of an old one.
+	 */
+	typedef std::unordered_map<std::string, pDestination> DestinationCache;
+
+	mutable DestinationCache _destinations;
+
+	/**
+	 * Connection generation the session, the producer and the cached
+	 * destinations belong to
+	 */
+	mutable int _generation;
+
+	/**
+	 * Create the session, the producer and the batch destination
+	 * from the current connection
+	 */
+	void openSession() const throw (CMSException);
+
+	/**
+	 * Replace the session and everything created from it if the
+	 * connection manager reconnected since they were created
+	 */
+	void checkConnection() const throw (CMSException);
+
+	/**
+	 * Get the destination for the given status item, creating it
+	 * if it's not in the cache yet.
+	 */
+	Destination * getDestination(const StatusItem &item) const
+			throw (CMSException);
+
+	/**
+	 * Send the message, with a higher priority if it carries urgent
+	 * status items
+	 */
+	void send(const Destination *destination, Message *msg, bool urgent) const
+			throw (CMSException);
+
 	/**
 	 * The JMS Session associated to this producer.
 	 */
-	pSession _session;
+	mutable pSession _session;
 
 	/**
 	 * The virtual channel to where this producer will send messages to
 	 */
 	pDestination _destination;
 
+	/**
+	 * The topic where batches of status items are sent to
+	 */
+	mutable pDestination _batchDestination;
+
 	/**
 	 * The message producer in charge of sending requests down to
 	 * the GMP. Runs on its own session
 	 */
-	pMessageProducer _producer;
+	mutable pMessageProducer _producer;
 	
 	/**
 	 * The connection manager associated to this sender
@@ -65,7 +150,7 @@ private:
 	/**
 	 * Close open resources and destroy connections
 	 */
-	void cleanup();
+	void cleanup() const;
 
 };
 
@@ -0,0 +1,22 @@
+#include "JournalStatusSender.h"
+
+namespace giapi {
+
+log4cxx::LoggerPtr JournalStatusSender::logger(log4cxx::Logger::getLogger(
+		"giapi.JournalStatusSender"));
+
+JournalStatusSender::JournalStatusSender(pStatusJournal journal) {
+	setJournal(journal);
+}
+
+JournalStatusSender::~JournalStatusSender() {
+	stopScheduledPosts();
+	LOG4CXX_DEBUG(logger, "Destroying Journal Status Sender");
+}
+
+int JournalStatusSender::postStatus(pStatusItem item) const
+		throw (PostException) {
+	return status::OK;
+}
+
+}
@@ -0,0 +1,44 @@
+#ifndef JOURNALSTATUSSENDER_H_
+#define JOURNALSTATUSSENDER_H_
+
+#include <log4cxx/logger.h>
+#include <giapi/giapiexcept.h>
+
+#include <status/senders/AbstractStatusSender.h>
+#include <status/journal/StatusJournal.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+/**
+ * A Status Sender that only records the posts in a status journal.
+ * Nothing is sent to the GMP, so it can stand in for the JMS sender
+ * where there is no broker, like in benchmarks, and the journal can be
+ * replayed afterwards.
+ * <p/>
+ * Any other sender derived from AbstractStatusSender can record its
+ * posts as well, with setJournal().
+ */
+class JournalStatusSender : public AbstractStatusSender {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a sender that records the posts in <code>journal</code>
+	 */
+	JournalStatusSender(pStatusJournal journal);
+	virtual ~JournalStatusSender();
+
+protected:
+	/**
+	 * The item was recorded already. Nothing else to do
+	 */
+	virtual int postStatus(pStatusItem item) const throw (PostException);
+};
+
+}
+
+#endif /* JOURNALSTATUSSENDER_H_ */
@@ -13,6 +13,7 @@ LogStatusSender::LogStatusSender() {
 }
 
 LogStatusSender::~LogStatusSender() {
+	stopScheduledPosts();
 	LOG4CXX_DEBUG(logger, "Destroying LogStatus Sender");
 }
 
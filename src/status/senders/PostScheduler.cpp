@@ -0,0 +1,76 @@
+#include "PostScheduler.h"
+
+#include <chrono>
+
+#include <status/senders/StatusSender.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr PostScheduler::logger(log4cxx::Logger::getLogger(
+		"giapi.PostScheduler"));
+
+PostScheduler::PostScheduler(const StatusSender *sender) :
+	_sender(sender), _running(true) {
+	_thread = std::thread(&PostScheduler::run, this);
+}
+
+PostScheduler::~PostScheduler() {
+	stop();
+}
+
+void PostScheduler::schedule(const pStatusItem &item, long64 due) {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_entries.push(Entry(due, item));
+	}
+	_changed.notify_one();
+}
+
+void PostScheduler::stop() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_running) {
+			return;
+		}
+		_running = false;
+	}
+	_changed.notify_one();
+	if (_thread.joinable()) {
+		_thread.join();
+	}
+}
+
+long64 PostScheduler::now() {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PostScheduler::run() {
+	std::unique_lock<std::mutex> lock(_lock);
+	while (_running) {
+		if (_entries.empty()) {
+			_changed.wait(lock);
+			continue;
+		}
+		long64 wait = _entries.top().first - now();
+		if (wait > 0) {
+			_changed.wait_for(lock, std::chrono::milliseconds(wait));
+			continue;
+		}
+
+		pStatusItem item = _entries.top().second;
+		_entries.pop();
+		lock.unlock();
+		item->clearScheduled();
+		try {
+			//posts the latest value, or schedules the item
+			//again if it was posted in the meantime
+			_sender->postStatusItem(item);
+		} catch (PostException &e) {
+			LOG4CXX_WARN(logger, "Problem posting status: " << e.what());
+		}
+		lock.lock();
+	}
+}
+
+}
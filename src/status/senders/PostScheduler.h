@@ -0,0 +1,94 @@
+#ifndef POSTSCHEDULER_H_
+#define POSTSCHEDULER_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+class StatusSender;
+
+/**
+ * Posts status items at a later time, from its own thread. Used to
+ * send the items whose maximum post rate deferred a post, once their
+ * post interval expires.
+ */
+class PostScheduler {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a scheduler that posts the items through
+	 * <code>sender</code>
+	 */
+	explicit PostScheduler(const StatusSender *sender);
+
+	/**
+	 * Stop the scheduler. Items not posted yet are discarded.
+	 */
+	virtual ~PostScheduler();
+
+	/**
+	 * Post the item at the given time
+	 *
+	 * @param due when to post the item, as returned by now()
+	 */
+	void schedule(const pStatusItem &item, long64 due);
+
+	/**
+	 * Stop the scheduler thread. Items not posted yet are
+	 * discarded.
+	 */
+	void stop();
+
+	/**
+	 * Current time in milliseconds, from a monotonic clock
+	 */
+	static long64 now();
+
+private:
+	typedef std::pair<long64, pStatusItem> Entry;
+
+	/**
+	 * Orders the entries so the earliest one is on top
+	 */
+	struct LaterFirst {
+		bool operator()(const Entry &a, const Entry &b) const {
+			return a.first > b.first;
+		}
+	};
+
+	/**
+	 * Main loop of the scheduler thread
+	 */
+	void run();
+
+	const StatusSender *_sender;
+
+	std::priority_queue<Entry, std::vector<Entry>, LaterFirst> _entries;
+
+	bool _running;
+
+	std::mutex _lock;
+	std::condition_variable _changed;
+	std::thread _thread;
+
+	PostScheduler(const PostScheduler &);
+	PostScheduler & operator=(const PostScheduler &);
+};
+
+}
+
+#endif /* POSTSCHEDULER_H_ */
@@ -0,0 +1,204 @@
+#include "SharedStatusSender.h"
+
+#include <chrono>
+
+#include <status/AlarmStatusItem.h>
+#include <status/ArrayStatusItem.h>
+#include <status/HealthStatusItem.h>
+#include <status/senders/StatusSenderFactory.h>
+#include <status/shared/SharedStatusWriter.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr SharedStatusSender::logger(log4cxx::Logger::getLogger(
+		"giapi.SharedStatusSender"));
+
+/**
+ * How often the publisher looks for new items in the table,
+ * in milliseconds
+ */
+static const long PUBLISH_PERIOD_MS = 5;
+
+/**
+ * How often the other processes check if the publisher is still
+ * there, in milliseconds
+ */
+static const long ELECTION_PERIOD_MS = 1000;
+
+SharedStatusSender::SharedStatusSender(pSharedStatusTable table,
+		pStatusSender publisher) :
+	_table(table), _publisher(publisher), _mirrors(table->getCapacity()),
+			_running(true) {
+	_thread = std::thread(&SharedStatusSender::run, this);
+}
+
+SharedStatusSender::~SharedStatusSender() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_running = false;
+	}
+	_stopped.notify_one();
+	_thread.join();
+	stopScheduledPosts();
+	//let another process take over
+	_table->resignPublisher();
+}
+
+void SharedStatusSender::setBatchMode(bool batch) {
+	AbstractStatusSender::setBatchMode(batch);
+	std::lock_guard<std::mutex> guard(_publishLock);
+	if (_publisher.get() != 0) {
+		_publisher->setBatchMode(batch);
+	}
+}
+
+int SharedStatusSender::postStatus(pStatusItem item) const
+		throw (PostException) {
+	if (dynamic_cast<ArrayStatusItem *> (item.get()) != 0) {
+		LOG4CXX_WARN(logger, "Array status items can't be shared: " << item->getName());
+		return status::ERROR;
+	}
+	int slot = getSlot(item.get());
+	if (slot < 0) {
+		return status::ERROR;
+	}
+	SharedStatusWriter writer(_table->beginWrite(slot));
+	item->accept(writer);
+	_table->endWrite(slot);
+	return status::OK;
+}
+
+int SharedStatusSender::publish() {
+	std::lock_guard<std::mutex> guard(_publishLock);
+	if (!_table->isPublisher()) {
+		return 0;
+	}
+
+	if (_publisher.get() == 0) {
+		//connect before taking the dirty slots, so they aren't
+		//lost if the connection fails
+		try {
+			_publisher = StatusSenderFactory::Instance()->getStatusSender(
+					StatusSenderFactory::JMS_SENDER);
+			_publisher->setBatchMode(isBatchMode());
+		} catch (GiapiException &e) {
+			LOG4CXX_WARN(logger, "Can't publish shared status items: " << e.what());
+			return 0;
+		}
+	}
+
+	std::vector<int> slots;
+	_table->takeDirtySlots(slots);
+	if (slots.empty()) {
+		return 0;
+	}
+
+	std::vector<pStatusItem> items;
+	items.reserve(slots.size());
+	SharedStatusData data;
+	for (std::vector<int>::const_iterator it = slots.begin(); it
+			!= slots.end(); ++it) {
+		_table->read(*it, data);
+		items.push_back(updateMirror(*it, data));
+	}
+
+	try {
+		if (_publisher->postStatusItems(items) == status::OK) {
+			return items.size();
+		}
+		LOG4CXX_WARN(logger, "Problem posting shared status items");
+	} catch (PostException &e) {
+		LOG4CXX_WARN(logger, "Problem posting shared status items: " << e.what());
+	}
+	//publish them again next time, even if the value stays the same
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		(*it)->retryPost();
+	}
+	_table->markDirty(slots);
+	return 0;
+}
+
+int SharedStatusSender::getSlot(StatusItem *item) const {
+	std::unordered_map<const StatusItem *, int>::const_iterator it =
+			_slots.find(item);
+	if (it != _slots.end()) {
+		return it->second;
+	}
+	int slot = _table->findSlot(item->getName(), SharedStatusWriter::kindOf(
+			item), item->getStatusType());
+	if (slot >= 0) {
+		_slots[item] = slot;
+	}
+	return slot;
+}
+
+pStatusItem SharedStatusSender::updateMirror(int slot,
+		const SharedStatusData &data) {
+	pStatusItem &mirror = _mirrors[slot];
+	type::Type type = (type::Type) data.type;
+
+	switch (data.kind) {
+	case SharedStatusData::ALARM: {
+		if (mirror.get() == 0) {
+			mirror.reset(new AlarmStatusItem(data.name, type));
+		}
+		AlarmStatusItem *alarmItem = static_cast<AlarmStatusItem *> (mirror.get());
+		alarmItem->setAlarmState((alarm::Severity) data.severity,
+				(alarm::Cause) data.cause, data.message);
+		break;
+	}
+	case SharedStatusData::HEALTH:
+		if (mirror.get() == 0) {
+			mirror.reset(new HealthStatusItem(data.name));
+		}
+		static_cast<HealthStatusItem *> (mirror.get())->setHealth(
+				(health::Health) data.intValue);
+		break;
+	default:
+		if (mirror.get() == 0) {
+			mirror.reset(new StatusItem(data.name, type));
+		}
+		break;
+	}
+
+	if (data.kind != SharedStatusData::HEALTH) {
+		switch (type) {
+		case type::INT:
+			mirror->setValueAsInt(data.intValue);
+			break;
+		case type::DOUBLE:
+			mirror->setValueAsDouble(data.doubleValue);
+			break;
+		case type::FLOAT:
+			mirror->setValueAsFloat(data.floatValue);
+			break;
+		case type::STRING:
+			mirror->setValueAsString(data.stringValue);
+			break;
+		default:
+			break;
+		}
+	}
+	//keep the time the value was set in the original process
+	mirror->setTimestamp(data.timestamp);
+	return mirror;
+}
+
+void SharedStatusSender::run() {
+	std::unique_lock<std::mutex> lock(_lock);
+	while (_running) {
+		lock.unlock();
+		bool publisher = _table->tryBecomePublisher();
+		if (publisher) {
+			publish();
+		}
+		lock.lock();
+		_stopped.wait_for(lock, std::chrono::milliseconds(publisher
+				? PUBLISH_PERIOD_MS : ELECTION_PERIOD_MS), [this] {
+			return !_running;
+		});
+	}
+}
+
+}
@@ -0,0 +1,122 @@
+#ifndef SHAREDSTATUSSENDER_H_
+#define SHAREDSTATUSSENDER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapiexcept.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/shared/SharedStatusTable.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+/**
+ * A Status Sender for instruments made of several processes. Posts
+ * store the status items in a shared memory table instead of sending
+ * them, so all the processes attached to the table can update status
+ * items with no broker connection of their own.
+ * <p/>
+ * One of the processes is elected as the publisher. Its sender takes
+ * the status items posted by any process from the table and sends them
+ * to the GMP through a JMS status sender. If the publisher process
+ * goes away, the sender of another process takes over.
+ */
+class SharedStatusSender : public AbstractStatusSender {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Build a sender that posts to the given table.
+	 *
+	 * @param table the shared status table
+	 * @param publisher the sender used to publish the items of the
+	 *        table, if this process is elected. If not provided, the
+	 *        JMS status sender is used.
+	 */
+	SharedStatusSender(pSharedStatusTable table, pStatusSender publisher =
+			pStatusSender());
+
+	virtual ~SharedStatusSender();
+
+	/**
+	 * Batch mode applies to the items published from the table
+	 */
+	virtual void setBatchMode(bool batch);
+
+	/**
+	 * If this process is the publisher, send the status items posted
+	 * to the table since the last time. Invoked periodically by the
+	 * publisher thread.
+	 *
+	 * @return the number of status items sent
+	 */
+	int publish();
+
+protected:
+	/**
+	 * Store the status item in the shared table
+	 */
+	virtual int postStatus(pStatusItem item) const throw (PostException);
+
+private:
+	/**
+	 * Return the slot of the item in the table, or -1 if it can't
+	 * be stored there
+	 */
+	int getSlot(StatusItem *item) const;
+
+	/**
+	 * Update the local copy of the status item in the given slot,
+	 * creating it if needed, and return it
+	 */
+	pStatusItem updateMirror(int slot, const SharedStatusData &data);
+
+	/**
+	 * Main loop of the publisher thread
+	 */
+	void run();
+
+	pSharedStatusTable _table;
+
+	/**
+	 * Slot of each status item posted by this process. Only
+	 * accessed while posting, which is serialized
+	 */
+	mutable std::unordered_map<const StatusItem *, int> _slots;
+
+	/**
+	 * Sends the items of the table to the GMP. Created when this
+	 * process is elected, so only the publisher connects to the broker
+	 */
+	pStatusSender _publisher;
+
+	/**
+	 * Local copy of the status items in the table, by slot,
+	 * holding the values last sent to the GMP
+	 */
+	std::vector<pStatusItem> _mirrors;
+
+	/**
+	 * Protects the publisher and the mirrors
+	 */
+	std::mutex _publishLock;
+
+	bool _running;
+	std::mutex _lock;
+	std::condition_variable _stopped;
+	std::thread _thread;
+};
+
+}
+
+#endif /* SHAREDSTATUSSENDER_H_ */
@@ -3,8 +3,13 @@
 #include <cstdarg>
 #include <giapi/giapiexcept.h>
 #include <tr1/memory>
+#include <vector>
 
 namespace giapi {
+
+class StatusItem;
+class CompactStatusTable;
+
 /**
  * This is the public status sender interface. These methods
  * are used by client programs to interact with the status sender.
@@ -44,6 +49,89 @@ public:
 	 */
 	virtual int postStatus(const std::string & name) const throw (PostException) = 0;
 
+	/**
+	 * Post the given status item to Gemini. Same as
+	 * postStatus(const std::string &), but the caller already holds
+	 * the status item, so no lookup is needed.
+	 *
+	 * @args   item The status item to be posted
+	 * @return giapi::status::OK if the post suceeds.
+	 *         giapi::status::ERROR if the item is NULL or it has not
+	 *         changed since the last time it was posted
+	 * @throws PostException in case there is a problem with the underlying
+	 *         mechanisms to execute the post.
+	 */
+	virtual int postStatusItem(const std::tr1::shared_ptr<StatusItem> &item) const
+			throw (PostException) = 0;
+
+	/**
+	 * Post the given status items to Gemini. Only the items that
+	 * changed since the last time they were posted are sent. In
+	 * batch mode they are sent together.
+	 *
+	 * @args   items The status items to be posted
+	 * @return giapi::status::OK if the post suceeds.
+	 *         giapi::status::ERROR if there is some error in the attempt
+	 *         to send
+	 * @throws PostException in case there is a problem with the underlying
+	 *         mechanisms to execute the post.
+	 */
+	virtual int postStatusItems(
+			const std::vector<std::tr1::shared_ptr<StatusItem> > &items) const
+			throw (PostException) = 0;
+
+	/**
+	 * Post the given status items together, in a single message,
+	 * whatever the batch mode. Used to publish the items of a
+	 * transaction as a consistent group. Items that didn't change
+	 * since the last time they were posted are left out, and the
+	 * maximum post rate of the items is not applied.
+	 *
+	 * @args   items The status items to be posted
+	 * @return giapi::status::OK if the post suceeds.
+	 *         giapi::status::ERROR if there is some error in the attempt
+	 *         to send
+	 * @throws PostException in case there is a problem with the underlying
+	 *         mechanisms to execute the post.
+	 */
+	virtual int postStatusGroup(
+			const std::vector<std::tr1::shared_ptr<StatusItem> > &items) const
+			throw (PostException) = 0;
+
+	/**
+	 * Post the items of the compact status table that changed since
+	 * the last time they were posted, together in a single message.
+	 * Items that can't be posted are marked as changed again, so the
+	 * next call retries them.
+	 *
+	 * @args   table The table whose changed items are posted
+	 * @return giapi::status::OK if the post suceeds, also when
+	 *         nothing changed.
+	 *         giapi::status::ERROR if there is some error in the
+	 *         attempt to send, or the sender can't post tables
+	 * @throws PostException in case there is a problem with the underlying
+	 *         mechanisms to execute the post.
+	 */
+	virtual int postTable(CompactStatusTable &table) const
+			throw (PostException) = 0;
+
+	/**
+	 * Select the way dirty items are dispatched by postStatus(). In
+	 * batch mode, all the dirty items found in a single call are packed
+	 * together and sent as one message. Otherwise (the default), each
+	 * dirty item is sent on its own.
+	 *
+	 * @param batch true to enable the batch mode, false to send
+	 *        each status item individually.
+	 */
+	virtual void setBatchMode(bool batch) = 0;
+
+	/**
+	 * Return true if this sender is dispatching dirty items in
+	 * batch mode.
+	 */
+	virtual bool isBatchMode() const = 0;
+
 	virtual ~StatusSender();
 
 protected:
@@ -7,6 +7,7 @@
 namespace giapi {
 
 class StatusSenderFactory;
+class AutoPoster;
 typedef std::tr1::shared_ptr<StatusSenderFactory> pStatusSenderFactory;
 
 /**
@@ -32,6 +33,29 @@ public:
 		 * to the Gemini Master Process (GMP).
 		 */
 		JMS_SENDER,
+		/**
+		 * An ASYNC_JMS_SENDER queues the posts and broadcasts them
+		 * to the GMP from a background thread, using a JMS_SENDER.
+		 */
+		ASYNC_JMS_SENDER,
+		/**
+		 * A SHARED_SENDER stores the posts in a shared memory table,
+		 * published to the GMP by one elected process. It must be
+		 * installed with setStatusSender() before use.
+		 */
+		SHARED_SENDER,
+		/**
+		 * A JOURNAL_SENDER records the posts in a status journal file,
+		 * with no GMP. It must be installed with setStatusSender()
+		 * before use.
+		 */
+		JOURNAL_SENDER,
+		/**
+		 * A COMPOSITE_SENDER publishes the posts to the sinks listed
+		 * in the gmp.status.sinks property, each one from its own
+		 * queue. It is the default sender when the property is set.
+		 */
+		COMPOSITE_SENDER,
 		/**
 		 * Auxiliary item to be used as the count of items in this
 		 * enumeration. Should not be used as a valid StatusSenderType!!
@@ -66,6 +90,43 @@ public:
 	 */
 	virtual pStatusSender getStatusSender(const StatusSenderType type) = 0;
 
+	/**
+	 * Install the StatusSender returned for <code>type</code>, for
+	 * the senders that need to be configured by the caller.
+	 *
+	 * @param type the Status Sender type
+	 * @param sender the StatusSender associated to the type
+	 */
+	virtual void setStatusSender(const StatusSenderType type,
+			pStatusSender sender) = 0;
+
+	/**
+	 * Return the StatusSender of the given <code>type</code> if it
+	 * was already created or installed, without creating it.
+	 *
+	 * @return the StatusSender, or an empty pointer
+	 */
+	virtual pStatusSender findStatusSender(const StatusSenderType type) const = 0;
+
+	/**
+	 * Select the StatusSender returned by getStatusSender(void)
+	 *
+	 * @param type the Status Sender type to use by default
+	 */
+	virtual void setDefaultSenderType(const StatusSenderType type) = 0;
+
+	/**
+	 * Return the type of the default StatusSender
+	 */
+	virtual StatusSenderType getDefaultSenderType() const = 0;
+
+	/**
+	 * Return the poster that posts the dirty status items periodically
+	 * through the default StatusSender. It lives as long as the
+	 * factory, and is stopped before the senders are released.
+	 */
+	virtual AutoPoster & getAutoPoster() = 0;
+
 	/**
 	 * Destructor.
 	 */
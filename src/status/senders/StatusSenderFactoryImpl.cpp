@@ -1,22 +1,65 @@
 #include "StatusSenderFactoryImpl.h"
 #include <status/senders/LogStatusSender.h>
 #include <status/senders/JmsStatusSender.h>
+#include <status/senders/AsyncStatusSender.h>
+#include <status/senders/CompositeStatusSender.h>
+#include <status/senders/JournalStatusSender.h>
+#include <util/PropertiesUtil.h>
+
+#include <cstdlib>
+#include <sstream>
 
 namespace giapi {
 
-StatusSenderFactoryImpl::StatusSenderFactoryImpl() {
+log4cxx::LoggerPtr StatusSenderFactoryImpl::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusSenderFactoryImpl"));
+
+/**
+ * Configuration keys of the composite sender
+ */
+static const char * SINKS_PROPERTY = "gmp.status.sinks";
+static const char * SINK_PROPERTY_PREFIX = "gmp.status.sink.";
+static const char * JOURNAL_PATH_PROPERTY = "gmp.status.journal.path";
+static const char * DEFAULT_JOURNAL_PATH = "status.journal";
+
+StatusSenderFactoryImpl::StatusSenderFactoryImpl() :
+	_defaultSender(DEFAULT_SENDER), _autoPoster(this) {
 	for (int i = 0; i < StatusSenderFactory::Elements; i++) {
 		senders[i] = pStatusSender((StatusSender *)0);
 	}
 }
 
+void StatusSenderFactoryImpl::configure() const {
+	//the factory is built during static initialization, too early
+	//to read the configuration
+	std::call_once(_configured, [this] {
+		if (!util::PropertiesUtil::Instance().getProperty(SINKS_PROPERTY).empty()) {
+			_defaultSender = COMPOSITE_SENDER;
+		}
+	});
+}
+
 StatusSenderFactoryImpl::~StatusSenderFactoryImpl() {
-	for (int i = 0; i < StatusSenderFactory::Elements; i++) {
-		senders[i] = pStatusSender((StatusSender *)0);
+	//no more periodic posts through the senders being released
+	_autoPoster.stop();
+	//the asynchronous sender goes first, since it posts through
+	//the others until it stops
+	pStatusSender released[StatusSenderFactory::Elements];
+	{
+		std::lock_guard<std::recursive_mutex> guard(_sendersLock);
+		for (int i = 0; i < StatusSenderFactory::Elements; i++) {
+			released[i].swap(senders[i]);
+		}
+	}
+	//released outside the lock, stopping a sender may wait for
+	//threads that look for the others
+	for (int i = StatusSenderFactory::Elements - 1; i >= 0; i--) {
+		released[i] = pStatusSender((StatusSender *)0);
 	}
 }
 
 pStatusSender StatusSenderFactoryImpl::getStatusSender(StatusSenderType type) {
+	std::lock_guard<std::recursive_mutex> guard(_sendersLock);
 	if (senders[type] == 0) {
 		switch (type) {
 		case LOG_SENDER:
@@ -25,16 +68,108 @@ pStatusSender StatusSenderFactoryImpl::getStatusSender(StatusSenderType type) {
 		case JMS_SENDER:
 			senders[type] = pStatusSender(new JmsStatusSender());
 			break;
+		case ASYNC_JMS_SENDER:
+			senders[type] = pStatusSender(new AsyncStatusSender(
+					getStatusSender(JMS_SENDER)));
+			break;
+		case COMPOSITE_SENDER:
+			senders[type] = makeCompositeSender();
+			break;
 		default:
-			//return the default sender
-			return getStatusSender();
+			//return the default sender, unless it is this one and it
+			//wasn't installed
+			return type == _defaultSender ? getStatusSender(DEFAULT_SENDER)
+					: getStatusSender();
 		}
 	}
 	return (senders[type]);
 }
 
+pStatusSender StatusSenderFactoryImpl::makeCompositeSender() {
+	util::PropertiesUtil &properties = util::PropertiesUtil::Instance();
+	CompositeStatusSender *composite = new CompositeStatusSender();
+	pStatusSender result(composite);
+
+	std::istringstream sinks(properties.getProperty(SINKS_PROPERTY));
+	std::string name;
+	while (std::getline(sinks, name, ',')) {
+		name.erase(0, name.find_first_not_of(" \t"));
+		name.erase(name.find_last_not_of(" \t") + 1);
+		if (name.empty()) {
+			continue;
+		}
+
+		pStatusSender sender;
+		if (name == "jms") {
+			sender = getStatusSender(JMS_SENDER);
+		} else if (name == "log") {
+			sender = getStatusSender(LOG_SENDER);
+		} else if (name == "journal") {
+			std::string path = properties.getProperty(JOURNAL_PATH_PROPERTY);
+			try {
+				sender = pStatusSender(new JournalStatusSender(pStatusJournal(
+						new StatusJournal(path.empty() ? DEFAULT_JOURNAL_PATH
+								: path))));
+			} catch (GiapiException &e) {
+				LOG4CXX_ERROR(logger, "Can't open the status journal: " << e.what());
+				continue;
+			}
+		} else {
+			LOG4CXX_WARN(logger, "Unknown status sink " << name << ", ignored");
+			continue;
+		}
+
+		std::string prefix = SINK_PROPERTY_PREFIX + name;
+		StatusSink::OverflowPolicy policy = StatusSink::COALESCE;
+		std::string value = properties.getProperty(prefix + ".policy");
+		if (!value.empty() && !StatusSink::parsePolicy(value, policy)) {
+			LOG4CXX_WARN(logger, "Unknown overflow policy " << value
+					<< " for status sink " << name << ", using coalesce");
+		}
+		size_t capacity = StatusSink::DEFAULT_CAPACITY;
+		value = properties.getProperty(prefix + ".capacity");
+		if (!value.empty() && atol(value.c_str()) > 0) {
+			capacity = atol(value.c_str());
+		}
+		composite->addSink(name, sender, policy, capacity);
+	}
+
+	if (composite->getSinkCount() == 0) {
+		LOG4CXX_WARN(logger, "No usable status sinks, publishing to the GMP");
+		composite->addSink("jms", getStatusSender(JMS_SENDER),
+				StatusSink::COALESCE);
+	}
+	return result;
+}
+
 pStatusSender StatusSenderFactoryImpl::getStatusSender() {
-	return getStatusSender(DEFAULT_SENDER);
+	configure();
+	return getStatusSender(_defaultSender);
+}
+
+void StatusSenderFactoryImpl::setStatusSender(StatusSenderType type,
+		pStatusSender sender) {
+	std::lock_guard<std::recursive_mutex> guard(_sendersLock);
+	senders[type] = sender;
+}
+
+pStatusSender StatusSenderFactoryImpl::findStatusSender(StatusSenderType type) const {
+	std::lock_guard<std::recursive_mutex> guard(_sendersLock);
+	return senders[type];
+}
+
+void StatusSenderFactoryImpl::setDefaultSenderType(StatusSenderType type) {
+	configure();
+	_defaultSender = type;
+}
+
+StatusSenderFactory::StatusSenderType StatusSenderFactoryImpl::getDefaultSenderType() const {
+	configure();
+	return _defaultSender;
+}
+
+AutoPoster & StatusSenderFactoryImpl::getAutoPoster() {
+	return _autoPoster;
 }
 
 }
@@ -2,6 +2,12 @@
 #define STATUSFACTORYIMPL_H_
 #include <status/senders/StatusSenderFactory.h>
 #include <status/senders/StatusSender.h>
+#include <status/senders/AutoPoster.h>
+
+#include <atomic>
+#include <mutex>
+
+#include <log4cxx/logger.h>
 
 namespace giapi {
 /**
@@ -10,8 +16,38 @@ namespace giapi {
  */
 class StatusSenderFactoryImpl : public StatusSenderFactory {
 private:
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
 	pStatusSender senders[StatusSenderFactory::Elements];
+	/**
+	 * Protects the senders, which are built on first use from any
+	 * thread: the asynchronous sender, the sinks and the automatic
+	 * post ask for them too. Recursive, since building a sender may
+	 * need another one
+	 */
+	mutable std::recursive_mutex _sendersLock;
 	static const StatusSenderType DEFAULT_SENDER = JMS_SENDER;
+	/**
+	 * Set from the configuration on first use
+	 */
+	mutable std::atomic<StatusSenderType> _defaultSender;
+	mutable std::once_flag _configured;
+	AutoPoster _autoPoster;
+
+	/**
+	 * Make the composite sender the default one if sinks are
+	 * configured
+	 */
+	void configure() const;
+
+	/**
+	 * Build the composite sender with the sinks listed in the
+	 * configuration
+	 */
+	pStatusSender makeCompositeSender();
 public:
 	/**
 	 * Default constructor
@@ -37,6 +73,16 @@ public:
 	 */
 	virtual pStatusSender getStatusSender(StatusSenderType type);
 
+	virtual void setStatusSender(StatusSenderType type, pStatusSender sender);
+
+	virtual pStatusSender findStatusSender(StatusSenderType type) const;
+
+	virtual void setDefaultSenderType(StatusSenderType type);
+
+	virtual StatusSenderType getDefaultSenderType() const;
+
+	virtual AutoPoster & getAutoPoster();
+
 };
 }
 
@@ -0,0 +1,205 @@
+#include "StatusSink.h"
+
+#include <exception>
+#include <vector>
+
+namespace giapi {
+
+log4cxx::LoggerPtr StatusSink::logger(log4cxx::Logger::getLogger(
+		"giapi.StatusSink"));
+
+/**
+ * Maximum number of items handed over to the sender at once
+ */
+static const size_t MAX_ITEMS_PER_SEND = 256;
+
+StatusSink::StatusSink(const std::string &name, pStatusSender sender,
+		OverflowPolicy policy, size_t capacity) :
+	_name(name), _sender(sender), _policy(policy), _capacity(capacity > 0
+			? capacity : 1), _running(true), _enqueued(0), _processed(0), _handed(0),
+			_sent(0), _dropped(0), _coalesced(0), _blocked(0),
+			_totalLatency(0), _maxLatency(0) {
+	_thread = std::thread(&StatusSink::run, this);
+}
+
+StatusSink::~StatusSink() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_running = false;
+	}
+	_notEmpty.notify_one();
+	_notFull.notify_all();
+	_thread.join();
+}
+
+bool StatusSink::offer(const pStatusItem &item) {
+	if (_policy == COALESCE && !item->markPending()) {
+		//still queued, it goes out with its latest value
+		_coalesced.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	std::unique_lock<std::mutex> lock(_lock);
+	if (_queue.size() >= _capacity) {
+		switch (_policy) {
+		case BLOCK:
+			_blocked.fetch_add(1, std::memory_order_relaxed);
+			_notFull.wait(lock, [this] {
+				return _queue.size() < _capacity || !_running;
+			});
+			break;
+		case DROP_OLDEST:
+			_queue.pop_front();
+			_processed++; //as far as flush() is concerned
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			break;
+		case COALESCE:
+			item->clearPending();
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+	}
+	Entry entry;
+	entry.item = item;
+	entry.queued = Clock::now();
+	_queue.push_back(entry);
+	_enqueued++;
+	lock.unlock();
+	_notEmpty.notify_one();
+	return true;
+}
+
+bool StatusSink::flush(long timeout) {
+	std::unique_lock<std::mutex> lock(_lock);
+	unsigned long target = _enqueued;
+	if (timeout <= 0) {
+		_processedChanged.wait(lock, [this, target] {
+			return _processed >= target;
+		});
+		return true;
+	}
+	return _processedChanged.wait_for(lock, std::chrono::milliseconds(timeout),
+			[this, target] {
+				return _processed >= target;
+			});
+}
+
+void StatusSink::getStatistics(StatusSinkStatistics &stats) const {
+	stats.name = _name;
+	stats.sent = _sent.load(std::memory_order_relaxed);
+	stats.dropped = _dropped.load(std::memory_order_relaxed);
+	stats.coalesced = _coalesced.load(std::memory_order_relaxed);
+	stats.blocked = _blocked.load(std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> guard(_lock);
+	stats.queueDepth = _queue.size();
+	stats.lag = _queue.empty() ? 0 : std::chrono::duration<double,
+			std::milli>(Clock::now() - _queue.front().queued).count();
+	stats.meanLatency = _handed > 0 ? _totalLatency / _handed : 0;
+	stats.maxLatency = _maxLatency;
+}
+
+void StatusSink::setBatchMode(bool batch) {
+	_sender->setBatchMode(batch);
+}
+
+const std::string & StatusSink::getName() const {
+	return _name;
+}
+
+StatusSink::OverflowPolicy StatusSink::getPolicy() const {
+	return _policy;
+}
+
+bool StatusSink::parsePolicy(const std::string &name, OverflowPolicy &policy) {
+	if (name == "block") {
+		policy = BLOCK;
+	} else if (name == "drop-oldest") {
+		policy = DROP_OLDEST;
+	} else if (name == "coalesce") {
+		policy = COALESCE;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void StatusSink::run() {
+	std::vector<pStatusItem> items;
+	items.reserve(MAX_ITEMS_PER_SEND);
+	std::vector<unsigned long> posts;
+	posts.reserve(MAX_ITEMS_PER_SEND);
+	for (;;) {
+		double latency = 0;
+		double maxLatency = 0;
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			_notEmpty.wait(lock, [this] {
+				return !_queue.empty() || !_running;
+			});
+			if (_queue.empty()) {
+				break; //stopped, and nothing left to send
+			}
+			Clock::time_point now = Clock::now();
+			while (items.size() < MAX_ITEMS_PER_SEND && !_queue.empty()) {
+				Entry &entry = _queue.front();
+				double waited = std::chrono::duration<double, std::milli>(now
+						- entry.queued).count();
+				latency += waited;
+				if (waited > maxLatency) {
+					maxLatency = waited;
+				}
+				items.push_back(entry.item);
+				_queue.pop_front();
+			}
+		}
+		_notFull.notify_all();
+
+		if (_policy == COALESCE) {
+			//changes made from now on queue the items again
+			for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+					!= items.end(); ++it) {
+				(*it)->clearPending();
+			}
+		}
+		//items are copies of their own, so a new post count means
+		//the sender sent them
+		posts.clear();
+		for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+				!= items.end(); ++it) {
+			posts.push_back((*it)->getPostCount());
+		}
+		try {
+			_sender->postStatusItems(items);
+		} catch (PostException &e) {
+			LOG4CXX_WARN(logger, "Problem posting status to sink " << _name
+					<< ": " << e.what());
+		} catch (std::exception &e) {
+			LOG4CXX_ERROR(logger, "Unexpected error posting status to sink "
+					<< _name << ": " << e.what());
+		} catch (...) {
+			LOG4CXX_ERROR(logger, "Unknown error posting status to sink " << _name);
+		}
+		unsigned long sent = 0;
+		for (size_t i = 0; i < items.size(); i++) {
+			if (items[i]->getPostCount() != posts[i]) {
+				sent++;
+			}
+		}
+		_sent.fetch_add(sent, std::memory_order_relaxed);
+
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			_processed += items.size();
+			_handed += items.size();
+			_totalLatency += latency;
+			if (maxLatency > _maxLatency) {
+				_maxLatency = maxLatency;
+			}
+		}
+		_processedChanged.notify_all();
+		items.clear();
+	}
+}
+
+}
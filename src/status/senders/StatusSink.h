@@ -0,0 +1,176 @@
+#ifndef STATUSSINK_H_
+#define STATUSSINK_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/StatusUtil.h>
+#include <status/senders/StatusSender.h>
+#include <status/StatusItem.h>
+
+namespace giapi {
+
+class StatusSink;
+typedef std::tr1::shared_ptr<StatusSink> pStatusSink;
+
+/**
+ * One of the destinations of a CompositeStatusSender: a status sender
+ * fed from its own bounded queue by its own thread, so it never waits
+ * for the other sinks and they never wait for it.
+ * <p/>
+ * What happens when the queue is full depends on the overflow policy
+ * of the sink.
+ */
+class StatusSink {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * What to do with a post when the queue is full
+	 */
+	enum OverflowPolicy {
+		/**
+		 * Wait for room in the queue. No post is lost, but a slow
+		 * sink slows down the posts
+		 */
+		BLOCK,
+		/**
+		 * Discard the oldest queued post to make room
+		 */
+		DROP_OLDEST,
+		/**
+		 * Queue each status item once. Posts of an item already
+		 * queued only update its value; new items are discarded
+		 * while the queue is full
+		 */
+		COALESCE
+	};
+
+	/**
+	 * Default number of posts the queue can hold
+	 */
+	static const size_t DEFAULT_CAPACITY = 8192;
+
+	/**
+	 * Start a sink that posts through <code>sender</code>
+	 *
+	 * @param name identifies the sink in the log and the statistics
+	 */
+	StatusSink(const std::string &name, pStatusSender sender,
+			OverflowPolicy policy, size_t capacity = DEFAULT_CAPACITY);
+
+	/**
+	 * Send whatever is queued and stop the thread
+	 */
+	virtual ~StatusSink();
+
+	/**
+	 * Queue a status item to be posted by the sink. With the
+	 * COALESCE policy the item is meant to be the same object for
+	 * every post of a status item; otherwise each post gets its
+	 * own copy.
+	 *
+	 * @return false if the item was discarded
+	 */
+	bool offer(const pStatusItem &item);
+
+	/**
+	 * Wait until everything queued before this call has been
+	 * handed over to the sender
+	 *
+	 * @param timeout milliseconds to wait at most, zero for as long
+	 *        as needed
+	 * @return false if the timeout expired first
+	 */
+	bool flush(long timeout = 0);
+
+	void getStatistics(StatusSinkStatistics &stats) const;
+
+	/**
+	 * Set the batch mode of the sender
+	 */
+	void setBatchMode(bool batch);
+
+	const std::string & getName() const;
+
+	OverflowPolicy getPolicy() const;
+
+	/**
+	 * Parse a policy as written in the configuration: "block",
+	 * "drop-oldest" or "coalesce".
+	 *
+	 * @return false if the name is not a policy
+	 */
+	static bool parsePolicy(const std::string &name, OverflowPolicy &policy);
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Entry {
+		pStatusItem item;
+		Clock::time_point queued;
+	};
+
+	/**
+	 * Main loop of the thread
+	 */
+	void run();
+
+	std::string _name;
+	pStatusSender _sender;
+	OverflowPolicy _policy;
+	size_t _capacity;
+
+	std::deque<Entry> _queue;
+	bool _running;
+
+	/**
+	 * Counters. Entries are taken and processed, whether the sender
+	 * needed to send them or not, by the thread
+	 */
+	unsigned long _enqueued;
+	unsigned long _processed;
+	/**
+	 * Entries handed over to the sender, sent or not. The latency
+	 * is averaged over them
+	 */
+	unsigned long _handed;
+	std::atomic<unsigned long> _sent;
+	std::atomic<unsigned long> _dropped;
+	std::atomic<unsigned long> _coalesced;
+	std::atomic<unsigned long> _blocked;
+
+	/**
+	 * Latency of the posts handed over so far, in milliseconds
+	 */
+	double _totalLatency;
+	double _maxLatency;
+
+	/**
+	 * Protects the queue and the counters that are not atomic
+	 */
+	mutable std::mutex _lock;
+	std::condition_variable _notEmpty;
+	std::condition_variable _notFull;
+	std::condition_variable _processedChanged;
+
+	std::thread _thread;
+
+	StatusSink(const StatusSink &);
+	StatusSink & operator=(const StatusSink &);
+};
+
+}
+
+#endif /* STATUSSINK_H_ */
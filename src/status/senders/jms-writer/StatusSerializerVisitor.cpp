@@ -17,6 +17,107 @@ StatusSerializerVisitor::~StatusSerializerVisitor() {
 
 }
 
+/**
+ * Code added to the offset of the record for each type of value,
+ * and the call that writes the value
+ */
+static int typeCode(int) {
+	return 0;
+}
+
+static int typeCode(double) {
+	return 1;
+}
+
+static int typeCode(float) {
+	return 2;
+}
+
+static int typeCode(const std::string &) {
+	return 3;
+}
+
+static void writeField(BytesMessage *msg, int value) throw (CMSException) {
+	msg->writeInt(value);
+}
+
+static void writeField(BytesMessage *msg, double value) throw (CMSException) {
+	msg->writeDouble(value);
+}
+
+static void writeField(BytesMessage *msg, float value) throw (CMSException) {
+	msg->writeFloat(value);
+}
+
+static void writeField(BytesMessage *msg, const std::string &value)
+		throw (CMSException) {
+	//writeUTF method doesn't work with an empty string.
+	//in that case, send one whitespace instead
+	static const std::string EMPTY_VALUE(" ");
+	msg->writeUTF(value.empty() ? EMPTY_VALUE : value);
+}
+
+/**
+ * Write the header of a status item with the given name, value and
+ * timestamp
+ */
+template<class T> static void writeRecord(BytesMessage *msg, int offset,
+		const std::string &name, const T &value, long64 timestamp)
+		throw (CMSException) {
+	msg->writeByte(offset + typeCode(value));
+	//the name now...
+	msg->writeUTF(name);
+	//and finally the value
+	writeField(msg, value);
+	//and then the timestamp
+	msg->writeLong(timestamp);
+}
+
+void StatusSerializerVisitor::writeBatch(const std::vector<pStatusItem> &items)
+		throw (CMSException) {
+	_msg->writeByte(BATCH_OFFSET);
+	//number of records in this message
+	_msg->writeInt(items.size());
+	for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+			!= items.end(); ++it) {
+		(*it)->accept(*this);
+	}
+}
+
+void StatusSerializerVisitor::writeBatch(const CompactStatusTable &table,
+		const std::vector<int> &ids) throw (CMSException) {
+	_msg->writeByte(BATCH_OFFSET);
+	_msg->writeInt(ids.size());
+	CompactStatusTable::Record record;
+	for (std::vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it) {
+		table.read(*it, record);
+		int offset = record.kind == StatusItemSpec::ALARM ? ALARM_OFFSET
+				: record.kind == StatusItemSpec::HEALTH ? HEALTH_OFFSET
+						: BASIC_OFFSET;
+		switch (record.type) {
+		case type::INT:
+			writeRecord(_msg, offset, record.name, record.intValue,
+					record.timestamp);
+			break;
+		case type::DOUBLE:
+			writeRecord(_msg, offset, record.name, record.doubleValue,
+					record.timestamp);
+			break;
+		case type::FLOAT:
+			writeRecord(_msg, offset, record.name, record.floatValue,
+					record.timestamp);
+			break;
+		default:
+			writeRecord(_msg, offset, record.name, record.stringValue,
+					record.timestamp);
+			break;
+		}
+		if (record.kind == StatusItemSpec::ALARM) {
+			writeAlarmState(record.severity, record.cause, record.message);
+		}
+	}
+}
+
 void StatusSerializerVisitor::visitStatusItem(StatusItem *item)
 		throw (CMSException) {
 	writeHeader(BASIC_OFFSET, item);
@@ -26,9 +127,16 @@ void StatusSerializerVisitor::visitAlarmItem(AlarmStatusItem * alarm)
 		throw (CMSException) {
 	writeHeader(ALARM_OFFSET, alarm);
 
-	alarm::Cause cause = alarm->getCause();
-	alarm::Severity severity = alarm->getSeverity();
+	alarm::Cause cause;
+	alarm::Severity severity;
+	std::string message;
+	alarm->getAlarmState(severity, cause, message);
+
+	writeAlarmState(severity, cause, message);
+}
 
+void StatusSerializerVisitor::writeAlarmState(alarm::Severity severity,
+		alarm::Cause cause, const std::string &message) throw (CMSException) {
 	//add severity to the message
 	switch (severity) {
 	case alarm::ALARM_OK:
@@ -64,13 +172,12 @@ void StatusSerializerVisitor::visitAlarmItem(AlarmStatusItem * alarm)
 	}
 
 	//check if there is any message for this alarm
-	if (!(alarm->getMessage().empty())) {
+	if (!message.empty()) {
 		_msg->writeBoolean(true); //there is a message
-		_msg->writeUTF(alarm->getMessage());
+		_msg->writeUTF(message);
 	} else {
 		_msg->writeBoolean(false); //no message
 	}
-
 }
 
 void StatusSerializerVisitor::visitHealthItem(HealthStatusItem * item)
@@ -78,56 +185,61 @@ void StatusSerializerVisitor::visitHealthItem(HealthStatusItem * item)
 	writeHeader(HEALTH_OFFSET, item);
 }
 
-void StatusSerializerVisitor::writeHeader(int offset, StatusItem *item)
+void StatusSerializerVisitor::visitArrayItem(ArrayStatusItem * item)
 		throw (CMSException) {
+	size_t first;
+	long64 timestamp;
+	size_t count = item->readChanged(_arrayBytes, first, timestamp);
 
-	const type::Type type = item->getStatusType();
-	std::string value;
-
-	switch (type) {
+	switch (item->getStatusType()) {
 	case type::INT:
-		_msg->writeByte(offset);
-		//the name now...
-		_msg->writeUTF(item->getName());
-		//and finally the value
-		_msg->writeInt(item->getValueAsInt());
-        //and then the timestamp
-        _msg->writeLong(item->getTimestamp());
+		_msg->writeByte(ARRAY_OFFSET);
 		break;
 	case type::DOUBLE:
-		_msg->writeByte(offset + 1);
-		//the name now...
-		_msg->writeUTF(item->getName());
-		//and finally the value
-		_msg->writeDouble(item->getValueAsDouble());
-        //and then the timestamp
-        _msg->writeLong(item->getTimestamp());
+		_msg->writeByte(ARRAY_OFFSET + 1);
 		break;
 	case type::FLOAT:
-		_msg->writeByte(offset + 2);
-		//the name now...
-		_msg->writeUTF(item->getName());
-		//and finally the value
-		_msg->writeFloat(item->getValueAsFloat());
-        //and then the timestamp
-        _msg->writeLong(item->getTimestamp());
+		_msg->writeByte(ARRAY_OFFSET + 2);
 		break;
+	default:
+		return;
+	}
+	_msg->writeUTF(item->getName());
+	_msg->writeInt(item->getLength());
+	_msg->writeInt(first);
+	_msg->writeInt(count);
+	//the elements are already in the byte order of the message
+	if (count > 0) {
+		_msg->writeBytes(&_arrayBytes[0], 0, _arrayBytes.size());
+	}
+	_msg->writeLong(timestamp);
+}
 
+template<class T> void StatusSerializerVisitor::writeValue(int offset,
+		StatusItem *item) throw (CMSException) {
+	//value and timestamp are read together, so they match even
+	//if the item is being updated by another thread
+	T value;
+	long64 timestamp;
+	item->readValue(value, timestamp);
+	writeRecord(_msg, offset, item->getName(), value, timestamp);
+}
+
+void StatusSerializerVisitor::writeHeader(int offset, StatusItem *item)
+		throw (CMSException) {
+
+	switch (item->getStatusType()) {
+	case type::INT:
+		writeValue<int> (offset, item);
+		break;
+	case type::DOUBLE:
+		writeValue<double> (offset, item);
+		break;
+	case type::FLOAT:
+		writeValue<float> (offset, item);
 		break;
 	case type::STRING:
-		_msg->writeByte(offset + 3);
-		//the name now...
-		_msg->writeUTF(item->getName());
-		//and finally the value
-	    value = item->getValueAsString();
-	    //writeUTF method doesn't work with an empty string.
-	    //in that case, send one whitespace instead
-		if (value == "") {
-			value = " ";
-		}
-		_msg->writeUTF(value);
-        //and then the timestamp
-        _msg->writeLong(item->getTimestamp());
+		writeValue<std::string> (offset, item);
 		break;
 	case type::BOOLEAN:
 		//TODO: Add the boolean handling when
@@ -141,8 +253,6 @@ void StatusSerializerVisitor::writeHeader(int offset, StatusItem *item)
 	case type::SHORT:
 		//TODO: Add the Byte handler when/if supported by the GIAPI
 		break;
-
-
 	}
 
 }
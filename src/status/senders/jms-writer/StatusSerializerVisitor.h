@@ -8,12 +8,15 @@
 #ifndef STATUSSERIALIZERVISITOR_H_
 #define STATUSSERIALIZERVISITOR_H_
 
+#include <vector>
 #include <log4cxx/logger.h>
 
 #include <status/StatusVisitor.h>
 #include <status/StatusItem.h>
 #include <status/AlarmStatusItem.h>
 #include <status/HealthStatusItem.h>
+#include <status/ArrayStatusItem.h>
+#include <status/CompactStatusTable.h>
 
 #include <cms/BytesMessage.h>
 #include <cms/CMSException.h>
@@ -36,6 +39,12 @@ private:
 	 */
 	BytesMessage * _msg;
 
+	/**
+	 * Scratch space for the elements of array status items, reused
+	 * for all the arrays serialized by this visitor
+	 */
+	std::vector<unsigned char> _arrayBytes;
+
 	/**
 	 * Offsets used to serialize the messages and distinguish
 	 * among the different types.
@@ -43,7 +52,9 @@ private:
 	enum Offsets {
 		BASIC_OFFSET = 0,
 		ALARM_OFFSET = 10,
-		HEALTH_OFFSET = 20
+		HEALTH_OFFSET = 20,
+		ARRAY_OFFSET = 30,
+		BATCH_OFFSET = 90
 	};
 
 	/**
@@ -55,10 +66,38 @@ private:
 	 */
 	void writeHeader(int offset, StatusItem *item) throw (CMSException);
 
+	/**
+	 * Write the header of an item that holds values of type T.
+	 * writeHeader() selects the one for the type of the item.
+	 */
+	template<class T> void writeValue(int offset, StatusItem *item)
+			throw (CMSException);
+
+	/**
+	 * Write the severity, cause and message of an alarm
+	 */
+	void writeAlarmState(alarm::Severity severity, alarm::Cause cause,
+			const std::string &message) throw (CMSException);
+
 public:
 	StatusSerializerVisitor(BytesMessage *msg);
 	virtual ~StatusSerializerVisitor();
 
+	/**
+	 * Serialize several status items into the JMS message. The
+	 * message starts with a batch marker and the number of records
+	 * that follow. Each record is coded exactly as if the status item
+	 * was sent on its own.
+	 */
+	void writeBatch(const std::vector<pStatusItem> &items) throw (CMSException);
+
+	/**
+	 * Write the given items of the table as a batch, in the same
+	 * format as the status items
+	 */
+	void writeBatch(const CompactStatusTable &table, const std::vector<int> &ids)
+			throw (CMSException);
+
 	/**
 	 * Serialize a Status Item into the JMS message
 	 */
@@ -73,6 +112,14 @@ public:
 	 * Serialize the Health into the JMS Message
 	 */
 	void visitHealthItem(HealthStatusItem * item) throw (CMSException);
+
+	/**
+	 * Serialize the Array Status Item into the JMS Message. After the
+	 * name come the length of the array, the index of the first element
+	 * in the message and the number of elements, then the elements
+	 * themselves, in a single block, and the timestamp.
+	 */
+	void visitArrayItem(ArrayStatusItem * item) throw (CMSException);
 };
 
 }
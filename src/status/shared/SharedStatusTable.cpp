@@ -0,0 +1,311 @@
+#include "SharedStatusTable.h"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <chrono>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace giapi {
+
+log4cxx::LoggerPtr SharedStatusTable::logger(log4cxx::Logger::getLogger(
+		"giapi.SharedStatusTable"));
+
+/**
+ * Identifies an initialized segment with this layout
+ */
+static const uint32_t MAGIC = 0x47535431; //"GST1"
+static const uint32_t VERSION = 1;
+
+/**
+ * How long to wait for another process to initialize the segment,
+ * in milliseconds
+ */
+static const int INIT_TIMEOUT_MS = 2000;
+
+struct SharedStatusTable::Header {
+	std::atomic<uint32_t> magic; //set last, once the segment is initialized
+	uint32_t version;
+	uint64_t capacity;
+	std::atomic<uint32_t> size;
+	std::atomic<int32_t> publisher; //pid of the publisher process, or 0
+};
+
+struct SharedStatusTable::Slot {
+	enum State {
+		FREE, CLAIMED, READY
+	};
+
+	std::atomic<uint32_t> state;
+	util::SeqLock lock;
+	SharedStatusData data;
+};
+
+/**
+ * Offset of the first slot, keeping the slots cache line aligned
+ */
+static size_t slotsOffset() {
+	return 64;
+}
+
+size_t SharedStatusTable::segmentLength(size_t capacity) {
+	return slotsOffset() + capacity * sizeof(Slot)
+			+ ((capacity + 63) / 64) * sizeof(uint64_t);
+}
+
+/**
+ * FNV-1a. Must give the same result in every process attached to
+ * the segment, which std::hash doesn't guarantee
+ */
+static uint32_t hashName(const std::string &name) {
+	uint32_t hash = 2166136261u;
+	for (std::string::const_iterator it = name.begin(); it != name.end(); ++it) {
+		hash ^= (unsigned char) *it;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+SharedStatusTable::SharedStatusTable(const std::string &name, size_t capacity)
+		throw (GiapiException) :
+	_name(name), _base(0), _length(0), _header(0), _slots(0), _dirty(0) {
+	static_assert(sizeof(Header) <= 64, "header doesn't fit before the slots");
+	attach(capacity);
+}
+
+SharedStatusTable::~SharedStatusTable() {
+	if (_base != 0) {
+		resignPublisher();
+		munmap(_base, _length);
+	}
+}
+
+void SharedStatusTable::remove(const std::string &name) {
+	shm_unlink(name.c_str());
+}
+
+void SharedStatusTable::attach(size_t capacity) throw (GiapiException) {
+	if (capacity == 0) {
+		throw GiapiException("Shared status table needs at least one slot");
+	}
+
+	bool creator = true;
+	int fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+	if (fd < 0 && errno == EEXIST) {
+		creator = false;
+		fd = shm_open(_name.c_str(), O_RDWR, 0666);
+	}
+	if (fd < 0) {
+		throw GiapiException("Can't open shared memory segment " + _name
+				+ ": " + strerror(errno));
+	}
+
+	if (creator) {
+		_length = segmentLength(capacity);
+		if (ftruncate(fd, _length) != 0) {
+			std::string error(strerror(errno));
+			close(fd);
+			shm_unlink(_name.c_str());
+			throw GiapiException("Can't size shared memory segment " + _name
+					+ ": " + error);
+		}
+	} else {
+		//wait for the creator to size and initialize the segment
+		struct stat st;
+		int waited = 0;
+		while ((fstat(fd, &st) != 0 || (size_t) st.st_size < slotsOffset())
+				&& waited < INIT_TIMEOUT_MS) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			waited += 10;
+		}
+		if ((size_t) st.st_size < slotsOffset()) {
+			close(fd);
+			throw GiapiException("Shared memory segment " + _name
+					+ " was never initialized");
+		}
+		_length = st.st_size;
+	}
+
+	_base = mmap(0, _length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (_base == MAP_FAILED) {
+		_base = 0;
+		throw GiapiException("Can't map shared memory segment " + _name + ": "
+				+ strerror(errno));
+	}
+	_header = static_cast<Header *> (_base);
+
+	if (creator) {
+		//the memory is zero filled. Build the objects on it
+		new (_header) Header();
+		_header->version = VERSION;
+		_header->capacity = capacity;
+		_header->size = 0;
+		_header->publisher = 0;
+		Slot *slots = reinterpret_cast<Slot *> (static_cast<char *> (_base)
+				+ slotsOffset());
+		for (size_t i = 0; i < capacity; i++) {
+			new (&slots[i]) Slot();
+			slots[i].state = Slot::FREE;
+		}
+		_header->magic.store(MAGIC, std::memory_order_release);
+		LOG4CXX_INFO(logger, "Created shared status segment " << _name
+				<< " with " << capacity << " slots");
+	} else {
+		int waited = 0;
+		while (_header->magic.load(std::memory_order_acquire) != MAGIC
+				&& waited < INIT_TIMEOUT_MS) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			waited += 10;
+		}
+		if (_header->magic.load(std::memory_order_acquire) != MAGIC
+				|| _header->version != VERSION || segmentLength(
+				_header->capacity) != _length) {
+			munmap(_base, _length);
+			_base = 0;
+			throw GiapiException("Shared memory segment " + _name
+					+ " has an unknown layout");
+		}
+		LOG4CXX_INFO(logger, "Attached to shared status segment " << _name);
+	}
+
+	_slots = reinterpret_cast<Slot *> (static_cast<char *> (_base)
+			+ slotsOffset());
+	_dirty = reinterpret_cast<std::atomic<uint64_t> *> (_slots
+			+ _header->capacity);
+}
+
+int SharedStatusTable::findSlot(const std::string &name,
+		SharedStatusData::Kind kind, type::Type type) {
+	if (name.empty() || name.size() > SharedStatusData::MAX_NAME_LENGTH) {
+		LOG4CXX_WARN(logger, "Can't store status item " << name
+				<< " in shared memory, the name is empty or too long");
+		return -1;
+	}
+
+	size_t capacity = getCapacity();
+	size_t start = hashName(name) % capacity;
+	for (size_t i = 0; i < capacity; i++) {
+		int index = (start + i) % capacity;
+		Slot &slot = _slots[index];
+		uint32_t state = slot.state.load(std::memory_order_acquire);
+
+		if (state == Slot::FREE && slot.state.compare_exchange_strong(state,
+				Slot::CLAIMED, std::memory_order_acquire)) {
+			memset(&slot.data, 0, sizeof(SharedStatusData));
+			name.copy(slot.data.name, SharedStatusData::MAX_NAME_LENGTH);
+			slot.data.kind = kind;
+			slot.data.type = type;
+			slot.state.store(Slot::READY, std::memory_order_release);
+			_header->size.fetch_add(1);
+			return index;
+		}
+
+		//another process is claiming the slot, wait for the name
+		while (state == Slot::CLAIMED) {
+			std::this_thread::yield();
+			state = slot.state.load(std::memory_order_acquire);
+		}
+
+		if (state == Slot::READY && name.compare(slot.data.name) == 0) {
+			if (slot.data.kind != kind || slot.data.type != type) {
+				LOG4CXX_WARN(logger, "Status item " << name
+						<< " is registered in shared memory with a different type");
+				return -1;
+			}
+			return index;
+		}
+	}
+	LOG4CXX_WARN(logger, "Shared status segment " << _name
+			<< " is full, can't store " << name);
+	return -1;
+}
+
+SharedStatusData & SharedStatusTable::beginWrite(int slot) {
+	Slot &s = slotAt(slot);
+	s.lock.writeLock();
+	return s.data;
+}
+
+void SharedStatusTable::endWrite(int slot) {
+	slotAt(slot).lock.writeUnlock();
+	_dirty[slot / 64].fetch_or(1ull << (slot % 64), std::memory_order_release);
+}
+
+void SharedStatusTable::read(int slot, SharedStatusData &data) const {
+	const Slot &s = slotAt(slot);
+	unsigned int seq;
+	do {
+		seq = s.lock.readBegin();
+		memcpy(&data, &s.data, sizeof(SharedStatusData));
+	} while (s.lock.readRetry(seq));
+}
+
+void SharedStatusTable::takeDirtySlots(std::vector<int> &slots) {
+	size_t words = (getCapacity() + 63) / 64;
+	for (size_t w = 0; w < words; w++) {
+		if (_dirty[w].load(std::memory_order_relaxed) == 0) {
+			continue;
+		}
+		uint64_t bits = _dirty[w].exchange(0, std::memory_order_acquire);
+		while (bits != 0) {
+			int bit = __builtin_ctzll(bits);
+			slots.push_back(w * 64 + bit);
+			bits &= bits - 1;
+		}
+	}
+}
+
+void SharedStatusTable::markDirty(const std::vector<int> &slots) {
+	for (std::vector<int>::const_iterator it = slots.begin(); it
+			!= slots.end(); ++it) {
+		_dirty[*it / 64].fetch_or(1ull << (*it % 64), std::memory_order_release);
+	}
+}
+
+bool SharedStatusTable::tryBecomePublisher() {
+	int32_t me = getpid();
+	int32_t current = _header->publisher.load();
+	if (current == me) {
+		return true;
+	}
+	//a process that is gone can't publish anymore
+	if (current != 0 && (kill(current, 0) == 0 || errno == EPERM)) {
+		return false;
+	}
+	if (_header->publisher.compare_exchange_strong(current, me)) {
+		LOG4CXX_INFO(logger, "Process " << me
+				<< " is now publishing the status items of " << _name);
+		return true;
+	}
+	return false;
+}
+
+bool SharedStatusTable::isPublisher() const {
+	return _header->publisher.load() == getpid();
+}
+
+void SharedStatusTable::resignPublisher() {
+	int32_t me = getpid();
+	_header->publisher.compare_exchange_strong(me, 0);
+}
+
+size_t SharedStatusTable::getCapacity() const {
+	return _header->capacity;
+}
+
+size_t SharedStatusTable::getSize() const {
+	return _header->size.load();
+}
+
+SharedStatusTable::Slot & SharedStatusTable::slotAt(int slot) const {
+	return _slots[slot];
+}
+
+}
@@ -0,0 +1,213 @@
+#ifndef SHAREDSTATUSTABLE_H_
+#define SHAREDSTATUSTABLE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <giapi/giapi.h>
+#include <giapi/giapiexcept.h>
+#include <util/SeqLock.h>
+
+namespace giapi {
+
+class SharedStatusTable;
+typedef std::tr1::shared_ptr<SharedStatusTable> pSharedStatusTable;
+
+/**
+ * The values of a status item, as stored in shared memory. Plain
+ * data only: it's copied as a whole by the readers.
+ */
+struct SharedStatusData {
+	/**
+	 * Maximum length of the status item names
+	 */
+	static const size_t MAX_NAME_LENGTH = 127;
+
+	/**
+	 * Maximum length of string values and alarm messages. Longer
+	 * ones are truncated
+	 */
+	static const size_t MAX_STRING_LENGTH = 255;
+
+	/**
+	 * The kind of status item
+	 */
+	enum Kind {
+		BASIC, ALARM, HEALTH
+	};
+
+	char name[MAX_NAME_LENGTH + 1];
+	int32_t kind;
+	int32_t type;
+	int32_t intValue;
+	double doubleValue;
+	float floatValue;
+	char stringValue[MAX_STRING_LENGTH + 1];
+	long64 timestamp;
+	int32_t severity;
+	int32_t cause;
+	char message[MAX_STRING_LENGTH + 1];
+};
+
+/**
+ * A table of status items in a named POSIX shared memory segment, so
+ * several processes can update the same status items.
+ * <p/>
+ * The layout is fixed: a header, followed by a fixed number of slots,
+ * followed by a bitmap with one bit per slot. A status item gets a
+ * slot the first time any process looks it up by name, and keeps it
+ * for the life of the segment.
+ * <p/>
+ * Writers store the value in the slot, protected by a sequence lock
+ * that lives in the slot itself, and set the bit of the slot in the
+ * bitmap. Readers never block. Among the processes attached to the
+ * segment, one is elected to take the dirty slots and publish them.
+ * <p/>
+ * A process that dies while holding the lock of a slot leaves that
+ * slot locked. The segment must be removed in that case.
+ */
+class SharedStatusTable {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	/**
+	 * Default number of slots in a new segment
+	 */
+	static const size_t DEFAULT_CAPACITY = 4096;
+
+	/**
+	 * Attach to the given shared memory segment, creating it if it
+	 * doesn't exist.
+	 *
+	 * @param name the name of the segment, like "/giapi-status"
+	 * @param capacity number of slots if the segment is created.
+	 *        Otherwise the capacity of the existing segment is used.
+	 *
+	 * @throws GiapiException if the segment can't be created or
+	 *         mapped, or if it was created by an incompatible version
+	 */
+	SharedStatusTable(const std::string &name, size_t capacity =
+			DEFAULT_CAPACITY) throw (GiapiException);
+
+	/**
+	 * Detach from the segment. The segment persists until it is
+	 * removed.
+	 */
+	virtual ~SharedStatusTable();
+
+	/**
+	 * Remove the named segment. Processes attached to it keep using
+	 * it until they detach.
+	 */
+	static void remove(const std::string &name);
+
+	/**
+	 * Return the slot of the given status item, claiming a free one
+	 * if the item doesn't have one yet.
+	 *
+	 * @return the index of the slot, or -1 if the table is full, the
+	 *         name is too long, or another process registered the
+	 *         item with a different kind or type.
+	 */
+	int findSlot(const std::string &name, SharedStatusData::Kind kind,
+			type::Type type);
+
+	/**
+	 * Acquire the lock of the slot and return its data, to be
+	 * modified in place. The name, kind and type must not be
+	 * modified. Must be followed by a call to endWrite().
+	 */
+	SharedStatusData & beginWrite(int slot);
+
+	/**
+	 * Release the lock of the slot and mark it dirty
+	 */
+	void endWrite(int slot);
+
+	/**
+	 * Copy the data of the slot. The copy is consistent even if
+	 * other processes are writing to the slot.
+	 */
+	void read(int slot, SharedStatusData &data) const;
+
+	/**
+	 * Collect the slots marked dirty since the last call and mark
+	 * them clean
+	 *
+	 * @param slots where the index of the dirty slots is appended
+	 */
+	void takeDirtySlots(std::vector<int> &slots);
+
+	/**
+	 * Mark the given slots dirty again, when they couldn't be
+	 * published
+	 */
+	void markDirty(const std::vector<int> &slots);
+
+	/**
+	 * Try to become the process that publishes the status items.
+	 * Succeeds if there is no publisher, or if the publisher process
+	 * is gone.
+	 *
+	 * @return true if this process is the publisher
+	 */
+	bool tryBecomePublisher();
+
+	/**
+	 * Return true if this process is the publisher
+	 */
+	bool isPublisher() const;
+
+	/**
+	 * Stop being the publisher, so another process can take over
+	 */
+	void resignPublisher();
+
+	/**
+	 * Number of slots in the table
+	 */
+	size_t getCapacity() const;
+
+	/**
+	 * Number of slots in use
+	 */
+	size_t getSize() const;
+
+private:
+	struct Header;
+	struct Slot;
+
+	/**
+	 * Map the segment, creating and initializing it if needed
+	 */
+	void attach(size_t capacity) throw (GiapiException);
+
+	Slot & slotAt(int slot) const;
+
+	/**
+	 * Size of a segment with the given number of slots
+	 */
+	static size_t segmentLength(size_t capacity);
+
+	std::string _name;
+	void *_base;
+	size_t _length;
+	Header *_header;
+	Slot *_slots;
+	std::atomic<uint64_t> *_dirty;
+
+	SharedStatusTable(const SharedStatusTable &);
+	SharedStatusTable & operator=(const SharedStatusTable &);
+};
+
+}
+
+#endif /* SHAREDSTATUSTABLE_H_ */
@@ -0,0 +1,79 @@
+#include "SharedStatusWriter.h"
+
+#include <cstring>
+
+namespace giapi {
+
+/**
+ * Copy a string into a fixed size buffer, truncating it if needed
+ */
+static void copyString(const std::string &value, char *buffer) {
+	size_t length = value.copy(buffer, SharedStatusData::MAX_STRING_LENGTH);
+	buffer[length] = '\0';
+}
+
+SharedStatusWriter::SharedStatusWriter(SharedStatusData &data) :
+	_data(data) {
+}
+
+SharedStatusWriter::~SharedStatusWriter() {
+}
+
+SharedStatusData::Kind SharedStatusWriter::kindOf(StatusItem *item) {
+	if (dynamic_cast<AlarmStatusItem *> (item) != 0) {
+		return SharedStatusData::ALARM;
+	}
+	if (dynamic_cast<HealthStatusItem *> (item) != 0) {
+		return SharedStatusData::HEALTH;
+	}
+	return SharedStatusData::BASIC;
+}
+
+void SharedStatusWriter::visitStatusItem(StatusItem *item) throw (std::exception) {
+	writeValue(item);
+}
+
+void SharedStatusWriter::visitAlarmItem(AlarmStatusItem *item)
+		throw (std::exception) {
+	writeValue(item);
+
+	alarm::Severity severity;
+	alarm::Cause cause;
+	std::string message;
+	item->getAlarmState(severity, cause, message);
+	_data.severity = severity;
+	_data.cause = cause;
+	copyString(message, _data.message);
+}
+
+void SharedStatusWriter::visitHealthItem(HealthStatusItem *item)
+		throw (std::exception) {
+	writeValue(item);
+}
+
+void SharedStatusWriter::visitArrayItem(ArrayStatusItem *item)
+		throw (std::exception) {
+}
+
+void SharedStatusWriter::writeValue(StatusItem *item) {
+	std::string stringValue;
+	switch (item->getStatusType()) {
+	case type::INT:
+		item->readValue(_data.intValue, _data.timestamp);
+		break;
+	case type::DOUBLE:
+		item->readValue(_data.doubleValue, _data.timestamp);
+		break;
+	case type::FLOAT:
+		item->readValue(_data.floatValue, _data.timestamp);
+		break;
+	case type::STRING:
+		item->readValue(stringValue, _data.timestamp);
+		copyString(stringValue, _data.stringValue);
+		break;
+	default:
+		break;
+	}
+}
+
+}
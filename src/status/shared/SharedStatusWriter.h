@@ -0,0 +1,53 @@
+#ifndef SHAREDSTATUSWRITER_H_
+#define SHAREDSTATUSWRITER_H_
+
+#include <status/StatusVisitor.h>
+#include <status/StatusItem.h>
+#include <status/AlarmStatusItem.h>
+#include <status/HealthStatusItem.h>
+#include <status/ArrayStatusItem.h>
+#include <status/shared/SharedStatusTable.h>
+
+namespace giapi {
+
+/**
+ * This visitor copies the value of the status items into their
+ * slot of the shared status table. The visitor takes as an argument
+ * the slot data, already locked for writing.
+ */
+class SharedStatusWriter : public StatusVisitor {
+private:
+	/**
+	 * The slot data that will be filled in by this visitor
+	 */
+	SharedStatusData &_data;
+
+	/**
+	 * Copy the value and timestamp, common to all the status items
+	 */
+	void writeValue(StatusItem *item);
+
+public:
+	SharedStatusWriter(SharedStatusData &data);
+	virtual ~SharedStatusWriter();
+
+	/**
+	 * Return the kind of slot the status item needs
+	 */
+	static SharedStatusData::Kind kindOf(StatusItem *item);
+
+	void visitStatusItem(StatusItem * item) throw (std::exception);
+
+	void visitAlarmItem(AlarmStatusItem * item) throw (std::exception);
+
+	void visitHealthItem(HealthStatusItem * item) throw (std::exception);
+
+	/**
+	 * Arrays don't fit in the slots. Nothing is written
+	 */
+	void visitArrayItem(ArrayStatusItem * item) throw (std::exception);
+};
+
+}
+
+#endif /* SHAREDSTATUSWRITER_H_ */
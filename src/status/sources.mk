@@ -1,5 +1,7 @@
 
 -include src/status/senders/sources.mk
+-include src/status/shared/sources.mk
+-include src/status/journal/sources.mk
 
 # Add inputs and outputs from these tool invocations to the build variables 
 OBJS += $(patsubst %.cpp,%.o,$(wildcard ./src/status/*.cpp))
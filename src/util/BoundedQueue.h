@@ -0,0 +1,142 @@
+#ifndef BOUNDEDQUEUE_H_
+#define BOUNDEDQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace giapi {
+
+namespace util {
+
+/**
+ * A fixed capacity FIFO queue that any number of threads can use
+ * concurrently without locks. Neither offer() nor poll() ever block:
+ * offer() fails when the queue is full and poll() fails when it
+ * is empty.
+ * <p/>
+ * Each slot carries a sequence number that tells producers and
+ * consumers whether it is free or holds a value for the current lap
+ * around the buffer (D. Vyukov's bounded queue).
+ * <p/>
+ * T must be cheap to copy; typically a pointer or a smart pointer.
+ */
+template<class T> class BoundedQueue {
+public:
+	/**
+	 * Build a queue able to hold at least <code>capacity</code>
+	 * elements. The capacity is rounded up to a power of two.
+	 */
+	explicit BoundedQueue(size_t capacity) :
+		_head(0), _tail(0) {
+		size_t size = 2;
+		while (size < capacity) {
+			size <<= 1;
+		}
+		_mask = size - 1;
+		_cells = std::vector<Cell>(size);
+		for (size_t i = 0; i < size; i++) {
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Add the value at the end of the queue.
+	 *
+	 * @return true if the value was added, false if the queue is full
+	 */
+	bool offer(const T &value) {
+		size_t pos = _tail.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell &cell = _cells[pos & _mask];
+			size_t seq = cell.sequence.load(std::memory_order_acquire);
+			long diff = (long) seq - (long) pos;
+			if (diff == 0) {
+				//the slot is free, try to claim it
+				if (_tail.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed)) {
+					cell.value = value;
+					cell.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				return false; //full
+			} else {
+				pos = _tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * Remove the first value in the queue.
+	 *
+	 * @return true if a value was stored in <code>value</code>, false
+	 *         if the queue is empty
+	 */
+	bool poll(T &value) {
+		size_t pos = _head.load(std::memory_order_relaxed);
+		for (;;) {
+			Cell &cell = _cells[pos & _mask];
+			size_t seq = cell.sequence.load(std::memory_order_acquire);
+			long diff = (long) seq - (long) (pos + 1);
+			if (diff == 0) {
+				if (_head.compare_exchange_weak(pos, pos + 1,
+						std::memory_order_relaxed)) {
+					value = cell.value;
+					cell.value = T(); //don't hold on to it
+					//free the slot for the next lap
+					cell.sequence.store(pos + _mask + 1,
+							std::memory_order_release);
+					return true;
+				}
+			} else if (diff < 0) {
+				return false; //empty
+			} else {
+				pos = _head.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	/**
+	 * Approximate number of elements in the queue
+	 */
+	size_t size() const {
+		size_t tail = _tail.load(std::memory_order_relaxed);
+		size_t head = _head.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	/**
+	 * Maximum number of elements in the queue
+	 */
+	size_t capacity() const {
+		return _mask + 1;
+	}
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T value;
+
+		Cell() :
+			sequence(0), value() {
+		}
+
+		Cell(const Cell &other) :
+			sequence(other.sequence.load()), value(other.value) {
+		}
+	};
+
+	std::vector<Cell> _cells;
+	size_t _mask;
+	std::atomic<size_t> _head;
+	std::atomic<size_t> _tail;
+
+	BoundedQueue(const BoundedQueue &);
+	BoundedQueue & operator=(const BoundedQueue &);
+};
+
+}
+}
+
+#endif /* BOUNDEDQUEUE_H_ */
@@ -0,0 +1,89 @@
+#include "Executor.h"
+
+#include <exception>
+
+namespace giapi {
+
+namespace util {
+
+log4cxx::LoggerPtr Executor::logger(log4cxx::Logger::getLogger(
+		"giapi.util.Executor"));
+
+Executor::Executor(size_t threads, const std::string &name) :
+	_name(name), _running(true) {
+	if (threads == 0) {
+		threads = 1;
+	}
+	_threads.reserve(threads);
+	for (size_t i = 0; i < threads; i++) {
+		_threads.push_back(std::thread(&Executor::run, this));
+	}
+}
+
+Executor::~Executor() {
+	shutdown();
+}
+
+bool Executor::execute(const Task &task) {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		if (!_running) {
+			return false;
+		}
+		_tasks.push_back(task);
+	}
+	_taskQueued.notify_one();
+	return true;
+}
+
+void Executor::shutdown() {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_running = false;
+	}
+	_taskQueued.notify_all();
+	for (std::vector<std::thread>::iterator it = _threads.begin(); it
+			!= _threads.end(); ++it) {
+		if (!it->joinable()) {
+			continue;
+		}
+		if (it->get_id() == std::this_thread::get_id()) {
+			it->detach(); //it finishes on its own once the queue is empty
+		} else {
+			it->join();
+		}
+	}
+}
+
+size_t Executor::getQueueSize() const {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _tasks.size();
+}
+
+void Executor::run() {
+	for (;;) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(_lock);
+			_taskQueued.wait(lock, [this] {
+				return !_tasks.empty() || !_running;
+			});
+			if (_tasks.empty()) {
+				break; //shut down, and nothing left to run
+			}
+			task.swap(_tasks.front());
+			_tasks.pop_front();
+		}
+		try {
+			task();
+		} catch (std::exception &e) {
+			LOG4CXX_WARN(logger, "Task of " << _name << " failed: " << e.what());
+		} catch (...) {
+			LOG4CXX_WARN(logger, "Task of " << _name << " failed");
+		}
+	}
+}
+
+}
+
+}
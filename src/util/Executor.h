@@ -0,0 +1,89 @@
+#ifndef EXECUTOR_H_
+#define EXECUTOR_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <log4cxx/logger.h>
+
+namespace giapi {
+
+namespace util {
+
+/**
+ * A fixed set of threads that run tasks in the order they are
+ * submitted. With a single thread, tasks never overlap and run one
+ * after the other, which makes it usable to deliver notifications
+ * in order away from the thread that produces them.
+ * <p/>
+ * Exceptions thrown by the tasks are logged and dropped, so a failing
+ * task never stops the threads.
+ */
+class Executor {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	typedef std::function<void()> Task;
+
+	/**
+	 * Start <code>threads</code> threads, at least one.
+	 *
+	 * @param name used to identify the executor in the log
+	 */
+	explicit Executor(size_t threads = 1, const std::string &name = "executor");
+
+	/**
+	 * Run the tasks still queued and stop the threads
+	 */
+	virtual ~Executor();
+
+	/**
+	 * Queue a task to be run by one of the threads.
+	 *
+	 * @return false if the executor is shut down, in which case the
+	 *         task is not run
+	 */
+	bool execute(const Task &task);
+
+	/**
+	 * Stop accepting tasks, run the ones already queued and wait for
+	 * the threads to finish. Called from a task, it doesn't wait for
+	 * the thread running it.
+	 */
+	void shutdown();
+
+	/**
+	 * Number of tasks waiting to run
+	 */
+	size_t getQueueSize() const;
+
+private:
+	/**
+	 * Main loop of the threads
+	 */
+	void run();
+
+	std::string _name;
+	std::deque<Task> _tasks;
+	bool _running;
+	mutable std::mutex _lock;
+	std::condition_variable _taskQueued;
+	std::vector<std::thread> _threads;
+
+	Executor(const Executor &);
+	Executor & operator=(const Executor &);
+};
+
+}
+
+}
+
+#endif /* EXECUTOR_H_ */
@@ -0,0 +1,73 @@
+#include "OrderedExecutor.h"
+
+#include <exception>
+
+namespace giapi {
+
+namespace util {
+
+log4cxx::LoggerPtr OrderedExecutor::logger(log4cxx::Logger::getLogger(
+		"giapi.util.OrderedExecutor"));
+
+OrderedExecutor::OrderedExecutor(size_t threads, const std::string &name) :
+	_threads(threads > 0 ? threads : 1), _executor(threads, name) {
+}
+
+OrderedExecutor::~OrderedExecutor() {
+	shutdown();
+}
+
+bool OrderedExecutor::execute(const std::string &key, const Task &task) {
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		std::unordered_map<std::string, std::deque<Task> >::iterator it =
+				_waiting.find(key);
+		if (it != _waiting.end()) {
+			//runs after the one of the key in the executor
+			it->second.push_back(task);
+			return true;
+		}
+		_waiting[key];
+	}
+	if (!_executor.execute(std::bind(&OrderedExecutor::run, this, key, task))) {
+		std::lock_guard<std::mutex> guard(_lock);
+		_waiting.erase(key);
+		return false;
+	}
+	return true;
+}
+
+void OrderedExecutor::shutdown() {
+	//the tasks waiting behind a key run on the thread of the key
+	_executor.shutdown();
+}
+
+size_t OrderedExecutor::getThreadCount() const {
+	return _threads;
+}
+
+void OrderedExecutor::run(const std::string &key, Task task) {
+	for (;;) {
+		try {
+			task();
+		} catch (std::exception &e) {
+			LOG4CXX_WARN(logger, "Task for " << key << " failed: " << e.what());
+		} catch (...) {
+			LOG4CXX_WARN(logger, "Task for " << key << " failed");
+		}
+
+		std::lock_guard<std::mutex> guard(_lock);
+		std::unordered_map<std::string, std::deque<Task> >::iterator it =
+				_waiting.find(key);
+		if (it->second.empty()) {
+			_waiting.erase(it);
+			return;
+		}
+		task.swap(it->second.front());
+		it->second.pop_front();
+	}
+}
+
+}
+
+}
@@ -0,0 +1,96 @@
+#ifndef ORDEREDEXECUTOR_H_
+#define ORDEREDEXECUTOR_H_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <tr1/memory>
+
+#include <log4cxx/logger.h>
+
+#include <util/Executor.h>
+
+namespace giapi {
+
+namespace util {
+
+class OrderedExecutor;
+typedef std::tr1::shared_ptr<OrderedExecutor> pOrderedExecutor;
+
+/**
+ * A pool of threads where each task comes with a key. Tasks with the
+ * same key run one after the other, in the order they are submitted;
+ * tasks with different keys run at the same time on different threads.
+ * <p/>
+ * Exceptions thrown by the tasks are logged and dropped, and the next
+ * task of the key runs anyway.
+ */
+class OrderedExecutor {
+	/**
+	 * Logging facility
+	 */
+	static log4cxx::LoggerPtr logger;
+
+public:
+	typedef Executor::Task Task;
+
+	/**
+	 * Start <code>threads</code> threads, at least one.
+	 *
+	 * @param name used to identify the executor in the log
+	 */
+	explicit OrderedExecutor(size_t threads = 1, const std::string &name =
+			"ordered executor");
+
+	/**
+	 * Run the tasks still queued and stop the threads
+	 */
+	virtual ~OrderedExecutor();
+
+	/**
+	 * Queue a task to run once the tasks submitted before with the same
+	 * key have finished.
+	 *
+	 * @return false if the executor is shut down, in which case the
+	 *         task is not run
+	 */
+	bool execute(const std::string &key, const Task &task);
+
+	/**
+	 * Stop accepting tasks, run the ones already queued and wait for
+	 * the threads to finish.
+	 */
+	void shutdown();
+
+	/**
+	 * Number of threads in the pool
+	 */
+	size_t getThreadCount() const;
+
+private:
+	/**
+	 * Run <code>task</code> and then the tasks queued behind it for the
+	 * same key, until there are none left
+	 */
+	void run(const std::string &key, Task task);
+
+	/**
+	 * Tasks waiting for the running task of their key, by key. A key is
+	 * in the map while one of its tasks is queued in the executor or
+	 * running.
+	 */
+	std::unordered_map<std::string, std::deque<Task> > _waiting;
+	std::mutex _lock;
+	size_t _threads;
+	Executor _executor;
+
+	OrderedExecutor(const OrderedExecutor &);
+	OrderedExecutor & operator=(const OrderedExecutor &);
+};
+
+}
+
+}
+
+#endif /* ORDEREDEXECUTOR_H_ */
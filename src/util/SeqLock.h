@@ -0,0 +1,117 @@
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+#include <atomic>
+#include <thread>
+
+namespace giapi {
+
+namespace util {
+
+/**
+ * A sequence lock. Writers serialize among themselves and bump a
+ * sequence number before and after modifying the protected data, so
+ * readers never block: they copy the data and retry if a writer was
+ * active in the meantime.
+ * <p/>
+ * The protected data must be plain values that can be copied while
+ * a writer modifies them (numbers, timestamps). Data that owns
+ * memory, like strings, must be read holding the write lock.
+ * <p/>
+ * Typical reader:
+ * <pre>
+ *   unsigned int seq;
+ *   do {
+ *       seq = lock.readBegin();
+ *       copy = data;
+ *   } while (lock.readRetry(seq));
+ * </pre>
+ */
+class SeqLock {
+public:
+	SeqLock() :
+		_seq(0) {
+	}
+
+	/**
+	 * Acquire the lock for writing. Spins while another writer
+	 * holds it.
+	 */
+	void writeLock() {
+		unsigned int seq = _seq.load(std::memory_order_relaxed);
+		for (;;) {
+			//an odd sequence means there is a writer already
+			if ((seq & 1) == 0 && _seq.compare_exchange_weak(seq, seq + 1,
+					std::memory_order_acquire, std::memory_order_relaxed)) {
+				break;
+			}
+			std::this_thread::yield();
+			seq = _seq.load(std::memory_order_relaxed);
+		}
+		//keep the data stores after the sequence update
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	/**
+	 * Release the write lock, publishing the modified data
+	 */
+	void writeUnlock() {
+		_seq.fetch_add(1, std::memory_order_release);
+	}
+
+	/**
+	 * Start a read. Waits until no writer is active and returns the
+	 * sequence number to validate the read with readRetry()
+	 */
+	unsigned int readBegin() const {
+		unsigned int seq = _seq.load(std::memory_order_acquire);
+		while ((seq & 1) != 0) {
+			std::this_thread::yield();
+			seq = _seq.load(std::memory_order_acquire);
+		}
+		return seq;
+	}
+
+	/**
+	 * Return true if a writer modified the data after readBegin()
+	 * returned <code>seq</code>, in which case the data read
+	 * must be discarded and read again.
+	 */
+	bool readRetry(unsigned int seq) const {
+		//keep the data loads before the sequence check
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return _seq.load(std::memory_order_relaxed) != seq;
+	}
+
+private:
+	std::atomic<unsigned int> _seq;
+
+	SeqLock(const SeqLock &);
+	SeqLock & operator=(const SeqLock &);
+};
+
+/**
+ * Holds the write lock of a SeqLock while in scope
+ */
+class SeqLockWriteGuard {
+public:
+	explicit SeqLockWriteGuard(SeqLock &lock) :
+		_lock(lock) {
+		_lock.writeLock();
+	}
+
+	~SeqLockWriteGuard() {
+		_lock.writeUnlock();
+	}
+
+private:
+	SeqLock &_lock;
+
+	SeqLockWriteGuard(const SeqLockWriteGuard &);
+	SeqLockWriteGuard & operator=(const SeqLockWriteGuard &);
+};
+
+}
+}
+
+#endif /* SEQLOCK_H_ */
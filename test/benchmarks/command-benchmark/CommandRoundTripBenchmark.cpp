@@ -0,0 +1,152 @@
+/*
+ * CommandRoundTripBenchmark.cpp
+ */
+
+#include "CommandRoundTripBenchmark.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <cms/MapMessage.h>
+#include <cms/MessageListener.h>
+
+#include <giapi/HandlerResponse.h>
+#include <giapi/SequenceCommandHandler.h>
+#include <gmp/ConnectionManager.h>
+#include <gmp/GMPKeys.h>
+#include <gmp/JmsUtil.h>
+#include <src/util/TimeUtil.h>
+
+namespace giapi {
+
+/**
+ * Accepts every command right away, so the round trip is all messaging
+ */
+class AcceptingHandler : public SequenceCommandHandler {
+public:
+	pHandlerResponse handle(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) {
+		return HandlerResponse::create(HandlerResponse::ACCEPTED);
+	}
+};
+
+/**
+ * Replies to the commands the way the sequence command consumer did
+ * before the reply producer was cached: a new producer for each reply,
+ * closed right after sending it.
+ */
+class PerReplyProducerConsumer : public MessageListener {
+public:
+	PerReplyProducerConsumer(const std::string &topic) {
+		_session = ConnectionManager::Instance()->createSession();
+		_destination = pDestination(_session->createTopic(topic));
+		_consumer = pMessageConsumer(_session->createConsumer(
+				_destination.get()));
+		_consumer->setMessageListener(this);
+	}
+
+	virtual ~PerReplyProducerConsumer() throw () {
+		_consumer->close();
+		_session->close();
+	}
+
+	void onMessage(const Message *message) throw () {
+		try {
+			pMessageProducer producer = pMessageProducer(
+					_session->createProducer(message->getCMSReplyTo()));
+			MapMessage *reply = _session->createMapMessage();
+			JmsUtil::makeHandlerResponseMsg(reply, HandlerResponse::create(
+					HandlerResponse::ACCEPTED));
+			producer->send(reply);
+			delete reply;
+			producer->close();
+		} catch (CMSException &e) {
+			e.printStackTrace();
+		}
+	}
+
+private:
+	pSession _session;
+	pDestination _destination;
+	pMessageConsumer _consumer;
+};
+
+/**
+ * Time to wait for each reply, in milliseconds
+ */
+static const int REPLY_TIMEOUT = 5000;
+
+CommandRoundTripBenchmark::CommandRoundTripBenchmark() {
+}
+
+CommandRoundTripBenchmark::~CommandRoundTripBenchmark() {
+}
+
+int CommandRoundTripBenchmark::getOps() {
+	return NUM_COMMANDS * 2;
+}
+
+void CommandRoundTripBenchmark::run() {
+	{
+		PerReplyProducerConsumer uncached(JmsUtil::getTopic(command::DATUM));
+		runCommands("Producer per reply", JmsUtil::getTopic(command::DATUM));
+	}
+
+	pSequenceCommandConsumer cached = SequenceCommandConsumer::create(
+			command::PARK, command::SET_PRESET_START_CANCEL, pSequenceCommandHandler(
+					new AcceptingHandler()));
+	runCommands("Cached reply producer", JmsUtil::getTopic(command::PARK));
+}
+
+void CommandRoundTripBenchmark::runCommands(const char *label,
+		const std::string &topic) {
+	pSession session = ConnectionManager::Instance()->createSession();
+	pDestination destination(session->createTopic(topic));
+	pMessageProducer producer(session->createProducer(destination.get()));
+	pDestination replyTo(session->createTemporaryQueue());
+	pMessageConsumer replies(session->createConsumer(replyTo.get()));
+
+	double total = 0;
+	double slowest = 0;
+	int lost = 0;
+	util::TimeUtil timer;
+	for (int i = 0; i < NUM_COMMANDS; i++) {
+		MapMessage *command = session->createMapMessage();
+		command->setIntProperty(GMPKeys::GMP_ACTIONID_PROP, i);
+		command->setStringProperty(GMPKeys::GMP_ACTIVITY_PROP,
+				GMPKeys::GMP_ACTIVITY_PRESET);
+		command->setCMSReplyTo(replyTo.get());
+
+		timer.startTimer();
+		producer->send(command);
+		Message *reply = replies->receive(REPLY_TIMEOUT);
+		timer.stopTimer();
+
+		if (reply == NULL) {
+			lost++;
+		} else {
+			double elapsed = timer.getElapsedTime(util::TimeUtil::USEC);
+			total += elapsed;
+			slowest = std::max(slowest, elapsed);
+			delete reply;
+		}
+		delete command;
+	}
+
+	replies->close();
+	producer->close();
+	session->close();
+
+	int received = NUM_COMMANDS - lost;
+	std::cout << std::endl << label << ": " << NUM_COMMANDS << " commands"
+			<< std::endl;
+	std::cout << "  usec/round trip  = " << (received > 0 ? total / received
+			: 0) << std::endl;
+	std::cout << "  slowest (usec)   = " << slowest << std::endl;
+	if (lost > 0) {
+		std::cout << "  replies lost     = " << lost << std::endl;
+	}
+}
+
+}
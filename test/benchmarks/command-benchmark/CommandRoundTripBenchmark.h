@@ -0,0 +1,47 @@
+/*
+ * CommandRoundTripBenchmark.h
+ */
+
+#ifndef COMMANDROUNDTRIPBENCHMARK_H_
+#define COMMANDROUNDTRIPBENCHMARK_H_
+
+#include <string>
+
+#include <benchmark/BenchmarkBase.h>
+#include <commands/SequenceCommandConsumer.h>
+
+namespace giapi {
+
+/**
+ * Measures the time from sending a sequence command to receiving the
+ * handler response, the latency the OCS sees. The sequence command
+ * consumer, which replies through a single producer, is compared with
+ * the previous behavior, where a producer was created and closed for
+ * every reply.
+ * <p/>
+ * Needs a broker, like the other benchmarks that go through the GMP.
+ */
+class CommandRoundTripBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::CommandRoundTripBenchmark, SequenceCommandConsumer, 1>{
+private:
+	static const int NUM_COMMANDS = 2000;
+
+	/**
+	 * Send NUM_COMMANDS commands to the topic, one at a time, waiting
+	 * for the reply to each, and report the time per round trip.
+	 */
+	void runCommands(const char *label, const std::string &topic);
+
+public:
+	CommandRoundTripBenchmark();
+	virtual ~CommandRoundTripBenchmark();
+
+	void run();
+
+	int getOps();
+};
+
+}
+
+#endif /* COMMANDROUNDTRIPBENCHMARK_H_ */
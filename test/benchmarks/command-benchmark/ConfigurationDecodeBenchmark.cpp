@@ -0,0 +1,110 @@
+/*
+ * ConfigurationDecodeBenchmark.cpp
+ */
+
+#include "ConfigurationDecodeBenchmark.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <activemq/commands/ActiveMQMapMessage.h>
+
+#include <src/util/TimeUtil.h>
+
+namespace giapi {
+
+/**
+ * The configuration as it was before: a hash map filled one entry at a
+ * time, handing out a new vector of keys and a copy of the value on
+ * every call
+ */
+class HashedConfiguration {
+public:
+	std::vector<std::string> getKeys() const {
+		std::vector<std::string> keys(_configMap.size());
+		int i = 0;
+		for (std::unordered_map<std::string, std::string>::const_iterator it =
+				_configMap.begin(); it != _configMap.end(); ++it, ++i) {
+			keys[i] = it->first;
+		}
+		return keys;
+	}
+
+	const std::string getValue(const std::string &key) {
+		return _configMap[key];
+	}
+
+	void setValue(const std::string &key, const std::string &value) {
+		_configMap[key] = value;
+	}
+
+private:
+	std::unordered_map<std::string, std::string> _configMap;
+};
+
+ConfigurationDecodeBenchmark::ConfigurationDecodeBenchmark() {
+}
+
+ConfigurationDecodeBenchmark::~ConfigurationDecodeBenchmark() {
+}
+
+int ConfigurationDecodeBenchmark::getOps() {
+	return NUM_DECODES * 2;
+}
+
+void ConfigurationDecodeBenchmark::run() {
+	activemq::commands::ActiveMQMapMessage message;
+	for (int i = 0; i < NUM_KEYS; i++) {
+		std::ostringstream key, value;
+		key << "gpi:apply.parameter" << i;
+		value << (i * 0.25);
+		message.setString(key.str(), value.str());
+	}
+
+	double sum = 0;
+	util::TimeUtil timer;
+	timer.startTimer();
+	for (int n = 0; n < NUM_DECODES; n++) {
+		HashedConfiguration config;
+		std::vector<std::string> names = message.getMapNames();
+		for (std::vector<std::string>::iterator i = names.begin(); i
+				!= names.end(); i++) {
+			config.setValue(*i, message.getString(*i));
+		}
+		std::vector<std::string> keys = config.getKeys();
+		for (std::vector<std::string>::iterator i = keys.begin(); i
+				!= keys.end(); i++) {
+			sum += atof(config.getValue(*i).c_str());
+		}
+	}
+	timer.stopTimer();
+	double hashed = timer.getElapsedTime(util::TimeUtil::USEC);
+
+	timer.startTimer();
+	for (int n = 0; n < NUM_DECODES; n++) {
+		pConfiguration config = ConfigurationFactory::getConfiguration(&message);
+		const std::vector<std::string> &keys = config->getKeys();
+		for (std::vector<std::string>::const_iterator i = keys.begin(); i
+				!= keys.end(); i++) {
+			double value;
+			if (config->getDouble(*i, value)) {
+				sum += value;
+			}
+		}
+	}
+	timer.stopTimer();
+	double sorted = timer.getElapsedTime(util::TimeUtil::USEC);
+
+	std::cout << std::endl << NUM_DECODES << " configurations of " << NUM_KEYS
+			<< " keys (checksum " << sum << ")" << std::endl;
+	std::cout << "  Hashed, usec/decode = " << (hashed / NUM_DECODES)
+			<< std::endl;
+	std::cout << "  Sorted, usec/decode = " << (sorted / NUM_DECODES)
+			<< std::endl;
+}
+
+}
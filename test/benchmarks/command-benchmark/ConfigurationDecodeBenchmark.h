@@ -0,0 +1,37 @@
+/*
+ * ConfigurationDecodeBenchmark.h
+ */
+
+#ifndef CONFIGURATIONDECODEBENCHMARK_H_
+#define CONFIGURATIONDECODEBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <commands/ConfigurationFactory.h>
+
+namespace giapi {
+
+/**
+ * Compares the time to decode a large apply configuration from its
+ * message, and to read every value as a number the way a handler
+ * would, with the sorted configuration against the previous hashed
+ * one, built key by key. Needs no broker.
+ */
+class ConfigurationDecodeBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::ConfigurationDecodeBenchmark, ConfigurationImpl, 1>{
+private:
+	static const int NUM_KEYS = 500;
+	static const int NUM_DECODES = 2000;
+
+public:
+	ConfigurationDecodeBenchmark();
+	virtual ~ConfigurationDecodeBenchmark();
+
+	void run();
+
+	int getOps();
+};
+
+}
+
+#endif /* CONFIGURATIONDECODEBENCHMARK_H_ */
@@ -0,0 +1,3 @@
+OBJS += $(patsubst %.cpp,%.o,$(wildcard ./command-benchmark/*.cpp))
+
+CPP_DEPS += $(patsubst %.cpp,%.d,$(wildcard ./command-benchmark/*.cpp))
@@ -1,5 +1,6 @@
 
 -include status-benchmark/sources.mk
+-include command-benchmark/sources.mk
 
 OBJS += $(patsubst %.cpp,%.o,$(wildcard ./*.cpp))
 
@@ -0,0 +1,54 @@
+/*
+ * AllocationCounter.cpp
+ */
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<long> allocations(0);
+
+void * countedAlloc(std::size_t size) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == 0) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+}
+
+void * operator new(std::size_t size) {
+	return countedAlloc(size);
+}
+
+void * operator new[](std::size_t size) {
+	return countedAlloc(size);
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+namespace benchmark {
+
+long AllocationCounter::getCount() {
+	return allocations.load(std::memory_order_relaxed);
+}
+
+}
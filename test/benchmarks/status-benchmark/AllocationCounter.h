@@ -0,0 +1,27 @@
+/*
+ * AllocationCounter.h
+ *
+ * Counts the calls to the global operator new made by the benchmark
+ * process, so benchmarks can report allocations per operation.
+ */
+
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+namespace benchmark {
+
+class AllocationCounter {
+public:
+	/**
+	 * Number of allocations done by any thread since the
+	 * process started
+	 */
+	static long getCount();
+
+private:
+	AllocationCounter();
+};
+
+}
+
+#endif /* ALLOCATIONCOUNTER_H_ */
@@ -0,0 +1,217 @@
+/*
+ * StatusAlarmLatencyBenchmark.cpp
+ */
+
+#include "StatusAlarmLatencyBenchmark.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <giapi/StatusUtil.h>
+#include <status/StatusDatabase.h>
+#include <status/senders/AsyncStatusSender.h>
+
+namespace giapi {
+
+typedef std::chrono::steady_clock Clock;
+
+static const char * ALARM_NAME = "gpi:bench:alarm";
+
+static std::string stormItemName(int item) {
+	char name[256];
+	sprintf(name, "gpi:bench:storm.%d", item);
+	return name;
+}
+
+/**
+ * A sender that spends a fixed time on each item, and notes when
+ * the alarm item goes out
+ */
+class CostlyStatusSender : public AbstractStatusSender {
+public:
+	explicit CostlyStatusSender(int costUs) :
+		_cost(std::chrono::microseconds(costUs)), _alarmSent(false) {
+		_alarm = StatusDatabase::Instance()->getStatusItem(ALARM_NAME).get();
+	}
+
+	virtual ~CostlyStatusSender() {
+		stopScheduledPosts();
+	}
+
+	using AbstractStatusSender::postStatus;
+
+	void setCost(int costUs) {
+		_cost = std::chrono::microseconds(costUs);
+	}
+
+	/**
+	 * Forget the last alarm sent
+	 */
+	void reset() {
+		_alarmSent.store(false);
+	}
+
+	/**
+	 * Return true, and when, if the alarm was sent since reset()
+	 */
+	bool alarmSent(Clock::time_point &when) const {
+		if (!_alarmSent.load()) {
+			return false;
+		}
+		when = _alarmTime;
+		return true;
+	}
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		send(item.get());
+		return status::OK;
+	}
+
+	int postBatch(const std::vector<pStatusItem> &items) const
+			throw (PostException) {
+		for (std::vector<pStatusItem>::const_iterator it = items.begin(); it
+				!= items.end(); ++it) {
+			send(it->get());
+		}
+		return status::OK;
+	}
+
+private:
+	void send(const StatusItem *item) const {
+		Clock::time_point end = Clock::now() + _cost;
+		while (Clock::now() < end) {
+		}
+		if (item == _alarm) {
+			_alarmTime = Clock::now();
+			_alarmSent.store(true);
+		}
+	}
+
+	Clock::duration _cost;
+	const StatusItem *_alarm;
+	mutable Clock::time_point _alarmTime;
+	mutable std::atomic<bool> _alarmSent;
+};
+
+/**
+ * Mark all the storm items dirty
+ */
+static void startStorm(int items, int round) {
+	for (int i = 0; i < items; i++) {
+		StatusUtil::setValueAsInt(stormItemName(i), round * items + i);
+	}
+}
+
+/**
+ * Raise or change the alarm, so it needs a post
+ */
+static void raiseAlarm(int round) {
+	StatusUtil::setAlarm(ALARM_NAME, round % 2 == 0 ? alarm::ALARM_WARNING
+			: alarm::ALARM_FAILURE, alarm::ALARM_CAUSE_HI);
+}
+
+static double millisecondsBetween(Clock::time_point start, Clock::time_point end) {
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+static void report(const char *mode, const std::vector<double> &alarm,
+		const std::vector<double> &storm) {
+	double alarmSum = 0, alarmMax = 0, stormSum = 0;
+	for (size_t i = 0; i < alarm.size(); i++) {
+		alarmSum += alarm[i];
+		if (alarm[i] > alarmMax) {
+			alarmMax = alarm[i];
+		}
+		stormSum += storm[i];
+	}
+	std::cout << "  " << mode << ": alarm latency mean "
+			<< alarmSum / alarm.size() << " ms, max " << alarmMax
+			<< " ms; whole storm " << stormSum / storm.size() << " ms"
+			<< std::endl;
+}
+
+StatusAlarmLatencyBenchmark::StatusAlarmLatencyBenchmark() {
+}
+
+StatusAlarmLatencyBenchmark::~StatusAlarmLatencyBenchmark() {
+}
+
+int StatusAlarmLatencyBenchmark::getOps() {
+	return 3 * ROUNDS * (STORM_ITEMS + 1);
+}
+
+void StatusAlarmLatencyBenchmark::run() {
+	std::cout << std::endl << STORM_ITEMS << " dirty items, " << SEND_COST_US
+			<< " us per item sent" << std::endl;
+	runSynchronous(false);
+	runSynchronous(true);
+	runAsynchronous();
+}
+
+void StatusAlarmLatencyBenchmark::runSynchronous(bool batch) {
+	CostlyStatusSender sender(0);
+	sender.setBatchMode(batch);
+	//whatever other benchmarks left dirty
+	sender.postStatus();
+	sender.setCost(SEND_COST_US);
+
+	std::vector<double> alarm, storm;
+	for (int round = 0; round < ROUNDS; round++) {
+		startStorm(STORM_ITEMS, round);
+		raiseAlarm(round);
+		sender.reset();
+		Clock::time_point start = Clock::now();
+		sender.postStatus();
+		Clock::time_point end = Clock::now();
+
+		Clock::time_point sent;
+		if (sender.alarmSent(sent)) {
+			alarm.push_back(millisecondsBetween(start, sent));
+			storm.push_back(millisecondsBetween(start, end));
+		}
+	}
+	report(batch ? "batch mode" : "item by item", alarm, storm);
+}
+
+void StatusAlarmLatencyBenchmark::runAsynchronous() {
+	CostlyStatusSender *delegate = new CostlyStatusSender(0);
+	AsyncStatusSender sender((pStatusSender(delegate)));
+	sender.postStatus();
+	sender.flush();
+	delegate->setCost(SEND_COST_US);
+
+	std::vector<double> alarm, storm;
+	for (int round = 0; round < ROUNDS; round++) {
+		startStorm(STORM_ITEMS, round);
+		Clock::time_point start = Clock::now();
+		sender.postStatus();
+		//the publisher is busy with the storm by now
+		raiseAlarm(round);
+		delegate->reset();
+		Clock::time_point raised = Clock::now();
+		sender.postStatus();
+		sender.flush();
+		Clock::time_point end = Clock::now();
+
+		Clock::time_point sent;
+		if (delegate->alarmSent(sent)) {
+			alarm.push_back(millisecondsBetween(raised, sent));
+			storm.push_back(millisecondsBetween(start, end));
+		}
+	}
+	report("asynchronous", alarm, storm);
+}
+
+void StatusAlarmLatencyBenchmark::setUp() {
+	for (int i = 0; i < STORM_ITEMS; i++) {
+		StatusUtil::createStatusItem(stormItemName(i), type::INT);
+	}
+	StatusUtil::createAlarmStatusItem(ALARM_NAME, type::INT);
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * StatusAlarmLatencyBenchmark.h
+ */
+
+#ifndef STATUSALARMLATENCYBENCHMARK_H_
+#define STATUSALARMLATENCYBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <status/senders/AbstractStatusSender.h>
+
+namespace giapi {
+
+/**
+ * Measures how long an alarm takes to go out while a storm of
+ * routine status items is waiting to be posted. Each round marks
+ * STORM_ITEMS items dirty, raises an alarm, and posts, through a
+ * sender that takes SEND_COST_US microseconds per item, as a JMS
+ * send would. The alarm latency is compared with the time it takes
+ * to post the whole storm, posting item by item, in batch mode, and
+ * through the asynchronous sender.
+ */
+class StatusAlarmLatencyBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::StatusAlarmLatencyBenchmark, AbstractStatusSender, 1>{
+private:
+	static const int STORM_ITEMS = 2000;
+	static const int ROUNDS = 20;
+	static const int SEND_COST_US = 20;
+
+	void runSynchronous(bool batch);
+	void runAsynchronous();
+
+public:
+	StatusAlarmLatencyBenchmark();
+	virtual ~StatusAlarmLatencyBenchmark();
+
+	void run();
+
+	void setUp();
+
+	int getOps();
+};
+
+}
+
+#endif /* STATUSALARMLATENCYBENCHMARK_H_ */
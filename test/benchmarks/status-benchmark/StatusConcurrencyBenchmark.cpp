@@ -0,0 +1,127 @@
+/*
+ * StatusConcurrencyBenchmark.cpp
+ */
+
+#include "StatusConcurrencyBenchmark.h"
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <giapi/StatusUtil.h>
+#include <src/util/TimeUtil.h>
+
+namespace giapi {
+
+static std::string itemName(int thread, int item) {
+	char name[256];
+	sprintf(name, "gpi:cc:mt.%d.%d", thread, item);
+	return name;
+}
+
+/**
+ * Update the items of the given thread
+ */
+static void writeItems(int thread, int items, int sets, bool byName) {
+	std::vector<std::string> names;
+	std::vector<StatusHandle<double> > handles;
+	for (int i = 0; i < items; i++) {
+		names.push_back(itemName(thread, i));
+		handles.push_back(StatusUtil::getHandle<double>(names.back()));
+	}
+	for (int i = 0; i < sets; i++) {
+		if (byName) {
+			StatusUtil::setValueAsDouble(names[i % items], i);
+		} else {
+			handles[i % items].set(i);
+		}
+	}
+}
+
+/**
+ * Drain the dirty items, reading their values, until told to stop
+ */
+static void drainItems(std::atomic<bool> *stop, long *reads) {
+	pStatusDatabase db = StatusDatabase::Instance();
+	double value;
+	long64 timestamp;
+	while (!stop->load()) {
+		pStatusItem item;
+		while ((item = db->nextDirtyItem()).get() != 0) {
+			if (item->takeChanged()) {
+				item->readValue(value, timestamp);
+				(*reads)++;
+			}
+		}
+		std::this_thread::yield();
+	}
+}
+
+StatusConcurrencyBenchmark::StatusConcurrencyBenchmark() {
+}
+
+StatusConcurrencyBenchmark::~StatusConcurrencyBenchmark() {
+}
+
+int StatusConcurrencyBenchmark::getOps() {
+	//each thread count is run by name and through handles
+	int ops = 0;
+	for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+		ops += 2 * threads * SETS_PER_THREAD;
+	}
+	return ops;
+}
+
+void StatusConcurrencyBenchmark::run() {
+	std::cout << std::endl << "Hardware threads: "
+			<< std::thread::hardware_concurrency() << std::endl;
+	for (int mode = 0; mode < 2; mode++) {
+		bool byName = (mode == 0);
+		std::cout << (byName ? "Set by name" : "Set by handle") << std::endl;
+		double base = 0;
+		for (int threads = 1; threads <= MAX_THREADS; threads *= 2) {
+			double rate = runWriters(threads, byName);
+			if (threads == 1) {
+				base = rate;
+			}
+			std::cout << "  " << threads << " threads: " << rate
+					<< " sets/second, speedup " << (rate / base) << std::endl;
+		}
+	}
+}
+
+double StatusConcurrencyBenchmark::runWriters(int threads, bool byName) {
+	std::atomic<bool> stop(false);
+	long reads = 0;
+	std::thread drainer(drainItems, &stop, &reads);
+
+	util::TimeUtil timer;
+	timer.startTimer();
+	std::vector<std::thread> writers;
+	for (int t = 0; t < threads; t++) {
+		writers.push_back(std::thread(writeItems, t, ITEMS_PER_THREAD,
+				SETS_PER_THREAD, byName));
+	}
+	for (int t = 0; t < threads; t++) {
+		writers[t].join();
+	}
+	timer.stopTimer();
+
+	stop.store(true);
+	drainer.join();
+
+	double elapsed = timer.getElapsedTime(util::TimeUtil::USEC) / 1000000.0;
+	return (double) threads * SETS_PER_THREAD / elapsed;
+}
+
+void StatusConcurrencyBenchmark::setUp() {
+	for (int t = 0; t < MAX_THREADS; t++) {
+		for (int i = 0; i < ITEMS_PER_THREAD; i++) {
+			StatusUtil::createStatusItem(itemName(t, i), type::DOUBLE);
+		}
+	}
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * StatusConcurrencyBenchmark.h
+ */
+
+#ifndef STATUSCONCURRENCYBENCHMARK_H_
+#define STATUSCONCURRENCYBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <status/StatusDatabase.h>
+
+namespace giapi {
+
+/**
+ * Measures how status updates scale with the number of writer
+ * threads. Every thread updates its own set of status items, while
+ * another thread keeps draining the dirty items and reading their
+ * values, as a poster would. Updates are done both by name and
+ * through status handles.
+ */
+class StatusConcurrencyBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::StatusConcurrencyBenchmark, StatusDatabase, 1>{
+private:
+	static const int MAX_THREADS = 8;
+	static const int ITEMS_PER_THREAD = 16;
+	static const int SETS_PER_THREAD = 200000;
+
+	/**
+	 * Run the writers with the given number of threads, and
+	 * return the number of sets per second
+	 */
+	double runWriters(int threads, bool byName);
+
+public:
+	StatusConcurrencyBenchmark();
+	virtual ~StatusConcurrencyBenchmark();
+
+	void run();
+
+	void setUp();
+
+	int getOps();
+};
+
+}
+
+#endif /* STATUSCONCURRENCYBENCHMARK_H_ */
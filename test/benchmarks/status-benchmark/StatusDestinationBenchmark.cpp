@@ -0,0 +1,111 @@
+/*
+ * StatusDestinationBenchmark.cpp
+ */
+
+#include "StatusDestinationBenchmark.h"
+#include "AllocationCounter.h"
+
+#include <iostream>
+#include <giapi/StatusUtil.h>
+#include <gmp/GMPKeys.h>
+#include <status/StatusDatabase.h>
+#include <status/senders/jms-writer/StatusSerializerVisitor.h>
+#include <src/util/TimeUtil.h>
+
+namespace giapi {
+
+/**
+ * The JMS status sender as it was before the destination cache. Every
+ * post builds the topic name and creates a new destination.
+ */
+class UncachedJmsStatusSender : public AbstractStatusSender {
+public:
+	UncachedJmsStatusSender() {
+		_session = ConnectionManager::Instance()->createSession();
+		_producer = pMessageProducer(_session->createProducer(NULL));
+		_producer->setDeliveryMode(DeliveryMode::NON_PERSISTENT);
+		_producer->setTimeToLive(10 * 1000);
+	}
+
+	virtual ~UncachedJmsStatusSender() {
+		_producer->close();
+		_session->close();
+	}
+
+protected:
+	int postStatus(pStatusItem statusItem) const throw (PostException) {
+		BytesMessage *msg = _session->createBytesMessage();
+		StatusSerializerVisitor serializer(msg);
+		statusItem->accept(serializer);
+
+		Destination * destination = _session->createTopic(
+				GMPKeys::GMP_STATUS_DESTINATION_PREFIX + statusItem->getName());
+		_producer->send(destination, msg);
+
+		delete destination;
+		delete msg;
+		return status::OK;
+	}
+
+private:
+	pSession _session;
+	pMessageProducer _producer;
+};
+
+static const std::string ITEM_NAME = "gpi:cc:destination.benchmark";
+
+StatusDestinationBenchmark::StatusDestinationBenchmark() {
+}
+
+StatusDestinationBenchmark::~StatusDestinationBenchmark() {
+}
+
+int StatusDestinationBenchmark::getOps() {
+	return NUM_POSTS * 2;
+}
+
+void StatusDestinationBenchmark::run() {
+	UncachedJmsStatusSender uncached;
+	runPosts("Uncached destination", uncached);
+
+	JmsStatusSender cached;
+	runPosts("Cached destination", cached);
+}
+
+void StatusDestinationBenchmark::runPosts(const char *label,
+		const StatusSender &sender) {
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem(ITEM_NAME);
+
+	//first post creates the cached destination, leave it out
+	item->setValueAsInt(-1);
+	sender.postStatus(ITEM_NAME);
+
+	long allocations = 0;
+	long setAllocations = 0;
+	util::TimeUtil timer;
+	timer.startTimer();
+	for (int i = 0; i < NUM_POSTS; i++) {
+		long before = benchmark::AllocationCounter::getCount();
+		item->setValueAsInt(i);
+		long afterSet = benchmark::AllocationCounter::getCount();
+		sender.postStatus(ITEM_NAME);
+		setAllocations += afterSet - before;
+		allocations += benchmark::AllocationCounter::getCount() - afterSet;
+	}
+	timer.stopTimer();
+
+	double elapsed = timer.getElapsedTime(util::TimeUtil::USEC);
+	std::cout << std::endl << label << ": " << NUM_POSTS << " posts"
+			<< std::endl;
+	std::cout << "  Allocations/set  = " << ((double) setAllocations / NUM_POSTS)
+			<< std::endl;
+	std::cout << "  Allocations/post = " << ((double) allocations / NUM_POSTS)
+			<< std::endl;
+	std::cout << "  usec/post        = " << (elapsed / NUM_POSTS) << std::endl;
+}
+
+void StatusDestinationBenchmark::setUp() {
+	StatusUtil::createStatusItem(ITEM_NAME, type::INT);
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * StatusDestinationBenchmark.h
+ */
+
+#ifndef STATUSDESTINATIONBENCHMARK_H_
+#define STATUSDESTINATIONBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <status/senders/JmsStatusSender.h>
+
+namespace giapi {
+
+/**
+ * Compares the allocations and time per post of the JMS status sender
+ * with its destination cache against the previous behavior, where the
+ * topic name and destination were created and destroyed on every post.
+ */
+class StatusDestinationBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::StatusDestinationBenchmark, JmsStatusSender, 1>{
+private:
+	static const int NUM_POSTS = 20000;
+
+	/**
+	 * Post the benchmark item NUM_POSTS times with the given sender,
+	 * reporting the allocations and time per post.
+	 */
+	void runPosts(const char *label, const StatusSender &sender);
+
+public:
+	StatusDestinationBenchmark();
+	virtual ~StatusDestinationBenchmark();
+
+	void run();
+
+	void setUp();
+
+	int getOps();
+};
+
+}
+
+#endif /* STATUSDESTINATIONBENCHMARK_H_ */
@@ -0,0 +1,126 @@
+/*
+ * StatusMemoryBenchmark.cpp
+ */
+
+#include "StatusMemoryBenchmark.h"
+
+#include <cstdio>
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <malloc.h>
+
+#include <giapi/StatusUtil.h>
+#include <status/CompactStatusTable.h>
+
+namespace giapi {
+
+/**
+ * Bytes of heap in use by the process
+ */
+static size_t heapInUse() {
+	return mallinfo2().uordblks;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double micros(Clock::duration duration) {
+	return std::chrono::duration_cast<std::chrono::duration<double,
+			std::micro> >(duration).count();
+}
+
+/**
+ * Name of the i-th item. Long enough to be allocated on the heap,
+ * like most real status item names
+ */
+static void itemName(char *name, const char *prefix, int i) {
+	sprintf(name, "gpi:%s:subsystem:item%d", prefix, i);
+}
+
+StatusMemoryBenchmark::StatusMemoryBenchmark() {
+}
+
+StatusMemoryBenchmark::~StatusMemoryBenchmark() {
+}
+
+int StatusMemoryBenchmark::getOps() {
+	return 2 * SCANS;
+}
+
+void StatusMemoryBenchmark::run() {
+	std::cout << std::endl;
+	runDatabase();
+	runTable();
+}
+
+void StatusMemoryBenchmark::runDatabase() {
+	StatusDatabase *db = StatusDatabase::Instance().get();
+	char name[256];
+	std::vector<StatusItemSpec> specs;
+	specs.reserve(ITEMS);
+	for (int i = 0; i < ITEMS; i++) {
+		itemName(name, "memory", i);
+		specs.push_back(StatusItemSpec(name, i % 10 == 0 ? StatusItemSpec::ALARM
+				: StatusItemSpec::BASIC, type::DOUBLE));
+	}
+	size_t before = heapInUse();
+	StatusUtil::createStatusItems(specs);
+	size_t used = heapInUse() - before;
+	//the new items are dirty
+	while (db->nextDirtyItem().get() != 0) {
+	}
+
+	std::vector<pStatusItem> items = db->getStatusItems();
+	std::vector<pStatusItem> changed;
+	changed.reserve(ITEMS / CHANGE_STRIDE);
+	Clock::duration scanTime = Clock::duration::zero();
+	for (int scan = 0; scan < SCANS; scan++) {
+		for (int i = scan % CHANGE_STRIDE; i < ITEMS; i += CHANGE_STRIDE) {
+			items[items.size() - ITEMS + i]->setValueAsDouble(scan + 1);
+		}
+		Clock::time_point start = Clock::now();
+		changed.clear();
+		pStatusItem item;
+		while ((item = db->nextDirtyItem()).get() != 0) {
+			if (item->takeChanged()) {
+				changed.push_back(item);
+			}
+		}
+		scanTime += Clock::now() - start;
+	}
+	std::cout << "Status database: " << (double) used / ITEMS
+			<< " bytes per item, " << micros(scanTime) / SCANS << " us per scan of "
+			<< changed.size() << " changed items" << std::endl;
+}
+
+void StatusMemoryBenchmark::runTable() {
+	char name[256];
+	size_t before = heapInUse();
+	CompactStatusTable *table = new CompactStatusTable(ITEMS);
+	for (int i = 0; i < ITEMS; i++) {
+		itemName(name, "compact", i);
+		table->create(name, i % 10 == 0 ? StatusItemSpec::ALARM
+				: StatusItemSpec::BASIC, type::DOUBLE);
+	}
+	size_t used = heapInUse() - before;
+	std::vector<int> ids;
+	table->takeChanged(ids);
+
+	Clock::duration scanTime = Clock::duration::zero();
+	for (int scan = 0; scan < SCANS; scan++) {
+		for (int i = scan % CHANGE_STRIDE; i < ITEMS; i += CHANGE_STRIDE) {
+			table->setValue(i, (double) scan + 1);
+		}
+		Clock::time_point start = Clock::now();
+		ids.clear();
+		table->takeChanged(ids);
+		scanTime += Clock::now() - start;
+	}
+	std::cout << "Compact table: " << (double) used / ITEMS
+			<< " bytes per item (" << (double) table->getMemoryUsage() / ITEMS
+			<< " counted by the table), " << micros(scanTime) / SCANS << " us per scan of " << ids.size()
+			<< " changed items" << std::endl;
+	delete table;
+}
+
+}
@@ -0,0 +1,46 @@
+/*
+ * StatusMemoryBenchmark.h
+ */
+
+#ifndef STATUSMEMORYBENCHMARK_H_
+#define STATUSMEMORYBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <status/StatusDatabase.h>
+
+namespace giapi {
+
+/**
+ * Compares the status database with the compact status table for a
+ * large instrument: heap used per status item, and time to find the
+ * changed items when a few of them changed
+ */
+class StatusMemoryBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::StatusMemoryBenchmark, StatusDatabase, 1>{
+private:
+	static const int ITEMS = 50000;
+
+	/**
+	 * Every how many items one is changed before each scan
+	 */
+	static const int CHANGE_STRIDE = 100;
+
+	static const int SCANS = 200;
+
+	void runDatabase();
+
+	void runTable();
+
+public:
+	StatusMemoryBenchmark();
+	virtual ~StatusMemoryBenchmark();
+
+	void run();
+
+	int getOps();
+};
+
+}
+
+#endif /* STATUSMEMORYBENCHMARK_H_ */
@@ -7,6 +7,9 @@
 
 #include "StatusPostBenchmark.h"
 
+#include <iostream>
+#include <src/util/TimeUtil.h>
+
 namespace giapi {
 
 StatusPostBenchmark::StatusPostBenchmark() {
@@ -59,6 +62,72 @@ void StatusPostBenchmark::run() {
 		StatusUtil::postStatus();
 	}
 
+	runTicks(false);
+	runTicks(true);
+	StatusUtil::setBatchPost(false);
+
+	runSetters();
+}
+
+/**
+ * Key of the item the setters are compared on
+ */
+static constexpr StatusKey<int> SETTER_KEY("gpi:cc:setter.X");
+
+void StatusPostBenchmark::runSetters() {
+	StatusHandle<int> handle = StatusUtil::getHandle<int>("gpi:cc:setter.X");
+	double elapsed[3];
+
+	for (int setter = 0; setter < 3; setter++) {
+		util::TimeUtil timer;
+		timer.startTimer();
+		for (int i = 0; i < NUM_SETS; i++) {
+			switch (setter) {
+			case 0:
+				StatusUtil::setValueAsInt("gpi:cc:setter.X", i);
+				break;
+			case 1:
+				StatusUtil::setValue(SETTER_KEY, i);
+				break;
+			default:
+				handle.set(i);
+			}
+		}
+		timer.stopTimer();
+		elapsed[setter] = timer.getElapsedTime(util::TimeUtil::USEC) / 1000000.0;
+	}
+
+	std::cout << std::endl << "Setting " << NUM_SETS << " values" << std::endl;
+	std::cout << "  By name:   values/second = " << (NUM_SETS / elapsed[0]) << std::endl;
+	std::cout << "  By key:    values/second = " << (NUM_SETS / elapsed[1]) << std::endl;
+	std::cout << "  By handle: values/second = " << (NUM_SETS / elapsed[2]) << std::endl;
+}
+
+void StatusPostBenchmark::runTicks(bool batch) {
+	char name[256];
+	StatusUtil::setBatchPost(batch);
+
+	util::TimeUtil timer;
+	timer.startTimer();
+	for (int tick = 0; tick < NUM_TICKS; tick++) {
+		for (int i = 0; i < ITEMS_PER_TICK; i++) {
+			sprintf(name, "gpi:cc:tick%d", i);
+			StatusUtil::setValueAsInt(name, tick);
+		}
+		StatusUtil::postStatus();
+	}
+	timer.stopTimer();
+
+	double elapsed = timer.getElapsedTime(util::TimeUtil::USEC) / 1000000.0;
+	double items = (double) NUM_TICKS * ITEMS_PER_TICK;
+	//one message per item, or one message per tick in batch mode
+	double msgs = batch ? (double) NUM_TICKS : items;
+
+	std::cout << std::endl << (batch ? "Batch" : "Single")
+			<< " post mode: " << ITEMS_PER_TICK << " items x " << NUM_TICKS
+			<< " ticks in " << elapsed << " seconds" << std::endl;
+	std::cout << "  Messages/second = " << (msgs / elapsed) << std::endl;
+	std::cout << "  Items/second    = " << (items / elapsed) << std::endl;
 }
 
 void StatusPostBenchmark::setUp() {
@@ -68,6 +137,14 @@ void StatusPostBenchmark::setUp() {
 	StatusUtil::createStatusItem("gpi:cc:filter.Z", type::STRING);
 	StatusUtil::createAlarmStatusItem("gpi:cc:filter.H", type::INT);
 	StatusUtil::createHealthStatusItem("gpi:health");
+
+	char name[256];
+	for (int i = 0; i < ITEMS_PER_TICK; i++) {
+		sprintf(name, "gpi:cc:tick%d", i);
+		StatusUtil::createStatusItem(name, type::INT);
+	}
+
+	StatusUtil::createStatusItem(SETTER_KEY);
 }
 
 }
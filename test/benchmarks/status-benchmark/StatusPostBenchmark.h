@@ -20,6 +20,30 @@ class StatusPostBenchmark :
 private:
 	static const int NUM_MESSAGES = 10000;
 
+	/**
+	 * Number of status items that change on every tick, and the
+	 * number of ticks used to compare the single and batch post modes
+	 */
+	static const int ITEMS_PER_TICK = 200;
+	static const int NUM_TICKS = 500;
+
+	/**
+	 * Set all the tick items and post them, NUM_TICKS times, using
+	 * the single or batch mode. Reports messages and items per second.
+	 */
+	void runTicks(bool batch);
+
+	/**
+	 * Number of values set to compare the setters, with no post
+	 */
+	static const int NUM_SETS = 1000000;
+
+	/**
+	 * Set NUM_SETS values by name, through a key and through a handle.
+	 * Reports the values set per second with each.
+	 */
+	void runSetters();
+
 public:
 	StatusPostBenchmark();
 	virtual ~StatusPostBenchmark();
@@ -0,0 +1,73 @@
+/*
+ * StatusStartupBenchmark.cpp
+ */
+
+#include "StatusStartupBenchmark.h"
+
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#include <giapi/StatusUtil.h>
+#include <src/util/TimeUtil.h>
+
+namespace giapi {
+
+static const int SIZES[] = { 10000, 100000 };
+
+StatusStartupBenchmark::StatusStartupBenchmark() {
+}
+
+StatusStartupBenchmark::~StatusStartupBenchmark() {
+}
+
+int StatusStartupBenchmark::getOps() {
+	//every size is created one by one and in a batch
+	return 2 * (SIZES[0] + SIZES[1]);
+}
+
+void StatusStartupBenchmark::run() {
+	std::cout << std::endl;
+	for (size_t i = 0; i < sizeof(SIZES) / sizeof(SIZES[0]); i++) {
+		double single = createItems(SIZES[i], false);
+		double batch = createItems(SIZES[i], true);
+		std::cout << SIZES[i] << " items: one by one " << single
+				<< " ms, batch " << batch << " ms, speedup "
+				<< (single / batch) << std::endl;
+	}
+}
+
+double StatusStartupBenchmark::createItems(int items, bool batch) {
+	//the names must be new every time, the items are never removed
+	static int run = 0;
+	run++;
+
+	std::vector<StatusItemSpec> specs;
+	specs.reserve(items);
+	char name[256];
+	for (int i = 0; i < items; i++) {
+		sprintf(name, "gpi:startup:%d:item%d", run, i);
+		StatusItemSpec::Kind kind = i % 10 == 0 ? StatusItemSpec::ALARM
+				: StatusItemSpec::BASIC;
+		specs.push_back(StatusItemSpec(name, kind, type::DOUBLE));
+	}
+
+	util::TimeUtil timer;
+	timer.startTimer();
+	if (batch) {
+		StatusUtil::createStatusItems(specs);
+	} else {
+		for (std::vector<StatusItemSpec>::const_iterator it = specs.begin(); it
+				!= specs.end(); ++it) {
+			if (it->kind == StatusItemSpec::ALARM) {
+				StatusUtil::createAlarmStatusItem(it->name, it->type);
+			} else {
+				StatusUtil::createStatusItem(it->name, it->type);
+			}
+		}
+	}
+	timer.stopTimer();
+	return timer.getElapsedTime(util::TimeUtil::USEC) / 1000.0;
+}
+
+}
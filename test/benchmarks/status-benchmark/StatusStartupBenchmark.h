@@ -0,0 +1,39 @@
+/*
+ * StatusStartupBenchmark.h
+ */
+
+#ifndef STATUSSTARTUPBENCHMARK_H_
+#define STATUSSTARTUPBENCHMARK_H_
+
+#include <benchmark/BenchmarkBase.h>
+#include <status/StatusDatabase.h>
+
+namespace giapi {
+
+/**
+ * Measures how long an instrument takes to create its status items
+ * at startup, creating them one by one and all at once with
+ * StatusUtil::createStatusItems()
+ */
+class StatusStartupBenchmark :
+	public benchmark::BenchmarkBase<
+		giapi::StatusStartupBenchmark, StatusDatabase, 1>{
+private:
+	/**
+	 * Create <code>items</code> status items and return the
+	 * elapsed time in milliseconds
+	 */
+	double createItems(int items, bool batch);
+
+public:
+	StatusStartupBenchmark();
+	virtual ~StatusStartupBenchmark();
+
+	void run();
+
+	int getOps();
+};
+
+}
+
+#endif /* STATUSSTARTUPBENCHMARK_H_ */
@@ -7,3 +7,17 @@
 
 #include <status-benchmark/StatusPostBenchmark.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusPostBenchmark );
+#include <status-benchmark/StatusDestinationBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusDestinationBenchmark );
+#include <status-benchmark/StatusConcurrencyBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusConcurrencyBenchmark );
+#include <status-benchmark/StatusStartupBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusStartupBenchmark );
+#include <status-benchmark/StatusMemoryBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusMemoryBenchmark );
+#include <status-benchmark/StatusAlarmLatencyBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusAlarmLatencyBenchmark );
+#include <command-benchmark/CommandRoundTripBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::CommandRoundTripBenchmark );
+#include <command-benchmark/ConfigurationDecodeBenchmark.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::ConfigurationDecodeBenchmark );
@@ -0,0 +1,304 @@
+/*
+ * AsyncCommandTest.cpp
+ */
+
+#include "AsyncCommandTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <giapi/AsyncSequenceCommandHandler.h>
+#include <commands/AsyncCommandExecutor.h>
+#include <commands/CompletionTokenImpl.h>
+
+namespace giapi {
+
+namespace {
+
+/**
+ * Keeps the completion information posted by the executor
+ */
+class Recorder {
+public:
+	int post(command::ActionId id, pHandlerResponse response) {
+		std::lock_guard<std::mutex> guard(_lock);
+		_ids.push_back(id);
+		_responses.push_back(response);
+		_posted.notify_all();
+		return status::OK;
+	}
+
+	/**
+	 * Wait until <code>count</code> completions are posted, five
+	 * seconds at most
+	 */
+	bool waitFor(size_t count) {
+		std::unique_lock<std::mutex> lock(_lock);
+		return _posted.wait_for(lock, std::chrono::seconds(5), [this, count] {
+			return _responses.size() >= count;
+		});
+	}
+
+	size_t size() {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _responses.size();
+	}
+
+	command::ActionId getId(size_t i) {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _ids[i];
+	}
+
+	pHandlerResponse getResponse(size_t i) {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _responses[i];
+	}
+
+	AsyncCommandExecutor::Poster poster() {
+		return [this](command::ActionId id, pHandlerResponse response) {
+			return post(id, response);
+		};
+	}
+
+private:
+	std::mutex _lock;
+	std::condition_variable _posted;
+	std::vector<command::ActionId> _ids;
+	std::vector<pHandlerResponse> _responses;
+};
+
+/**
+ * Asynchronous handler that starts the actions with a function
+ */
+class FunctionHandler: public AsyncSequenceCommandHandler {
+public:
+	typedef std::function<pCompletionToken(command::ActionId)> Start;
+
+	static pAsyncSequenceCommandHandler create(const Start &start,
+			long timeout = 0) {
+		pAsyncSequenceCommandHandler handler(new FunctionHandler(start, timeout));
+		return handler;
+	}
+
+	virtual pCompletionToken start(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) {
+		return _start(id);
+	}
+
+private:
+	FunctionHandler(const Start &start, long timeout) :
+		AsyncSequenceCommandHandler(timeout), _start(start) {
+	}
+
+	Start _start;
+};
+
+}
+
+AsyncCommandTest::AsyncCommandTest() {
+}
+
+AsyncCommandTest::~AsyncCommandTest() {
+}
+
+void AsyncCommandTest::setUp() {
+}
+
+void AsyncCommandTest::tearDown() {
+}
+
+void AsyncCommandTest::testCompletionToken() {
+	pCompletionToken token = CompletionToken::create();
+	CPPUNIT_ASSERT(!token->isResolved());
+	CPPUNIT_ASSERT(token->complete());
+	CPPUNIT_ASSERT(token->isResolved());
+	CPPUNIT_ASSERT(!token->complete());
+	CPPUNIT_ASSERT(!token->fail("too late"));
+
+	CompletionTokenImpl *impl = dynamic_cast<CompletionTokenImpl *> (token.get());
+	CPPUNIT_ASSERT(impl != 0);
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::COMPLETED,
+			impl->getResponse()->getResponse());
+
+	//resolved already, the listener is called right away
+	int calls = 0;
+	impl->setListener([&calls](pHandlerResponse response) {
+		calls++;
+	});
+	CPPUNIT_ASSERT_EQUAL(1, calls);
+
+	//the GMP needs a message for errors
+	token = CompletionToken::failed("");
+	impl = dynamic_cast<CompletionTokenImpl *> (token.get());
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::ERROR,
+			impl->getResponse()->getResponse());
+	CPPUNIT_ASSERT(!impl->getResponse()->getMessage().empty());
+
+	token = CompletionToken::create();
+	impl = dynamic_cast<CompletionTokenImpl *> (token.get());
+	pHandlerResponse heard;
+	impl->setListener([&heard](pHandlerResponse response) {
+		heard = response;
+	});
+	CPPUNIT_ASSERT(heard.get() == 0);
+	token->fail("broken");
+	CPPUNIT_ASSERT(heard.get() != 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("broken"), heard->getMessage());
+}
+
+void AsyncCommandTest::testCompletedLater() {
+	Recorder recorder;
+	pCompletionToken token = CompletionToken::create();
+	std::atomic<int> started(0);
+	{
+		AsyncCommandExecutor executor(2, recorder.poster());
+		CPPUNIT_ASSERT(executor.submit(FunctionHandler::create([&](command::ActionId id) {
+			started++;
+			return token;
+		}), 42, command::OBSERVE, command::START, pConfiguration()));
+
+		//the handler has run, but the actions go on
+		for (int i = 0; i < 500 && started == 0; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		CPPUNIT_ASSERT_EQUAL(1, started.load());
+		CPPUNIT_ASSERT_EQUAL((size_t) 0, recorder.size());
+
+		token->complete();
+		CPPUNIT_ASSERT(recorder.waitFor(1));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 1, recorder.size());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 42, recorder.getId(0));
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::COMPLETED,
+			recorder.getResponse(0)->getResponse());
+}
+
+void AsyncCommandTest::testCompletedRightAway() {
+	Recorder recorder;
+	std::atomic<int> started(0);
+	pAsyncSequenceCommandHandler handler = FunctionHandler::create([&](command::ActionId id) {
+		started++;
+		return CompletionToken::completed();
+	}, 5000);
+
+	//what the consumer sends back first
+	pHandlerResponse response = handler->handle(7, command::OBSERVE,
+			command::START, pConfiguration());
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::STARTED, response->getResponse());
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	CPPUNIT_ASSERT_EQUAL(0, started.load());
+
+	//then the actions are started, and over at once
+	{
+		AsyncCommandExecutor executor(1, recorder.poster());
+		CPPUNIT_ASSERT(executor.submit(handler, 7, command::OBSERVE,
+				command::START, pConfiguration()));
+		CPPUNIT_ASSERT(recorder.waitFor(1));
+		CPPUNIT_ASSERT_EQUAL(1, started.load());
+		//the timeout is not watched past the completion
+		for (int i = 0; i < 500 && executor.getPendingTimeouts() > 0; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		CPPUNIT_ASSERT_EQUAL((size_t) 0, executor.getPendingTimeouts());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 1, recorder.size());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 7, recorder.getId(0));
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::COMPLETED,
+			recorder.getResponse(0)->getResponse());
+}
+
+void AsyncCommandTest::testFailures() {
+	Recorder recorder;
+	{
+		AsyncCommandExecutor executor(1, recorder.poster());
+		executor.submit(FunctionHandler::create([](command::ActionId id) -> pCompletionToken {
+			throw std::runtime_error("no power");
+		}), 1, command::INIT, command::START, pConfiguration());
+		executor.submit(FunctionHandler::create([](command::ActionId id) {
+			return pCompletionToken();
+		}), 2, command::INIT, command::START, pConfiguration());
+		executor.submit(FunctionHandler::create([](command::ActionId id) {
+			return CompletionToken::failed("stuck");
+		}), 3, command::INIT, command::START, pConfiguration());
+		CPPUNIT_ASSERT(recorder.waitFor(3));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, recorder.size());
+	for (size_t i = 0; i < 3; i++) {
+		CPPUNIT_ASSERT_EQUAL((command::ActionId) (i + 1), recorder.getId(i));
+		CPPUNIT_ASSERT_EQUAL(HandlerResponse::ERROR,
+				recorder.getResponse(i)->getResponse());
+		CPPUNIT_ASSERT(!recorder.getResponse(i)->getMessage().empty());
+	}
+	CPPUNIT_ASSERT_EQUAL(std::string("no power"),
+			recorder.getResponse(0)->getMessage());
+	CPPUNIT_ASSERT_EQUAL(std::string("stuck"),
+			recorder.getResponse(2)->getMessage());
+}
+
+void AsyncCommandTest::testTimeout() {
+	Recorder recorder;
+	pCompletionToken slow = CompletionToken::create();
+	pCompletionToken fast = CompletionToken::create();
+	{
+		AsyncCommandExecutor executor(2, recorder.poster());
+		executor.submit(FunctionHandler::create([&](command::ActionId id) {
+			return slow;
+		}, 50), 1, command::OBSERVE, command::START, pConfiguration());
+		executor.submit(FunctionHandler::create([&](command::ActionId id) {
+			return fast;
+		}, 5000), 2, command::OBSERVE, command::START, pConfiguration());
+		fast->complete();
+		CPPUNIT_ASSERT(recorder.waitFor(1));
+		//only the slow one is still watched
+		for (int i = 0; i < 500 && executor.getPendingTimeouts() > 1; i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		CPPUNIT_ASSERT(executor.getPendingTimeouts() <= 1);
+
+		CPPUNIT_ASSERT(recorder.waitFor(2));
+		CPPUNIT_ASSERT_EQUAL((size_t) 0, executor.getPendingTimeouts());
+		//too late, the error is out
+		slow->complete();
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, recorder.size());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 2, recorder.getId(0));
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::COMPLETED,
+			recorder.getResponse(0)->getResponse());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 1, recorder.getId(1));
+	CPPUNIT_ASSERT_EQUAL(HandlerResponse::ERROR,
+			recorder.getResponse(1)->getResponse());
+}
+
+void AsyncCommandTest::testSharedThreads() {
+	static const int COMMANDS = 20;
+	Recorder recorder;
+	std::atomic<int> running(0);
+	std::atomic<int> mostRunning(0);
+	{
+		AsyncCommandExecutor executor(2, recorder.poster());
+		for (int i = 0; i < COMMANDS; i++) {
+			executor.submit(FunctionHandler::create([&](command::ActionId id) {
+				int now = ++running;
+				int most = mostRunning;
+				while (now > most && !mostRunning.compare_exchange_weak(most, now)) {
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+				running--;
+				return CompletionToken::completed();
+			}), i, command::APPLY, command::START, pConfiguration());
+		}
+		CPPUNIT_ASSERT(recorder.waitFor(COMMANDS));
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) COMMANDS, recorder.size());
+	CPPUNIT_ASSERT(mostRunning <= 2);
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * AsyncCommandTest.h
+ */
+
+#ifndef ASYNCCOMMANDTEST_H_
+#define ASYNCCOMMANDTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+/**
+ * Tests of the completion tokens and of the executor of the
+ * asynchronous sequence command handlers
+ */
+class AsyncCommandTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( AsyncCommandTest );
+	CPPUNIT_TEST(testCompletionToken);
+	CPPUNIT_TEST(testCompletedLater);
+	CPPUNIT_TEST(testCompletedRightAway);
+	CPPUNIT_TEST(testFailures);
+	CPPUNIT_TEST(testTimeout);
+	CPPUNIT_TEST(testSharedThreads);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	/**
+	 * Tokens are resolved once, and tell their listener
+	 */
+	void testCompletionToken();
+
+	/**
+	 * The completion is posted when the token is resolved, not before
+	 */
+	void testCompletedLater();
+
+	/**
+	 * Answering STARTED leaves the actions alone, so a token resolved
+	 * right away can't be posted before the answer is sent
+	 */
+	void testCompletedRightAway();
+
+	/**
+	 * Handlers that throw, fail or return no token get an ERROR
+	 */
+	void testFailures();
+
+	/**
+	 * ERROR is posted once the timeout expires, and only once. Actions
+	 * resolved in time stop being watched
+	 */
+	void testTimeout();
+
+	/**
+	 * Handlers run on the threads of the executor, no more at a time
+	 */
+	void testSharedThreads();
+
+	AsyncCommandTest();
+	virtual ~AsyncCommandTest();
+};
+
+}
+
+#endif /* ASYNCCOMMANDTEST_H_ */
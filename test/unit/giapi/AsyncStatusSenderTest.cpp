@@ -0,0 +1,256 @@
+/*
+ * AsyncStatusSenderTest.cpp
+ */
+
+#include "AsyncStatusSenderTest.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <giapi/giapi.h>
+#include <giapi/StatusUtil.h>
+
+#include <status/StatusItem.h>
+#include <status/StatusDatabase.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/AsyncStatusSender.h>
+
+namespace giapi {
+
+/**
+ * A status sender that records the values it posts. Posts can be
+ * held back, to fill the queue of the asynchronous sender
+ */
+class GatedStatusSender : public AbstractStatusSender {
+public:
+	GatedStatusSender() :
+		_open(true), _waiting(false) {
+	}
+
+	void close() {
+		std::lock_guard<std::mutex> guard(_lock);
+		_open = false;
+	}
+
+	void open() {
+		std::lock_guard<std::mutex> guard(_lock);
+		_open = true;
+		_changed.notify_all();
+	}
+
+	/**
+	 * Wait until a post is held back by the gate
+	 */
+	void waitBlocked() {
+		std::unique_lock<std::mutex> lock(_lock);
+		_changed.wait(lock, [this] {
+			return _waiting;
+		});
+	}
+
+	std::vector<std::pair<std::string, int> > posted() {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _posted;
+	}
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		//the value that would go out in the message
+		int value = item->getValueAsInt();
+		std::unique_lock<std::mutex> lock(_lock);
+		_waiting = true;
+		_changed.notify_all();
+		_changed.wait(lock, [this] {
+			return _open;
+		});
+		_waiting = false;
+		_posted.push_back(std::make_pair(item->getName(), value));
+		return status::OK;
+	}
+
+private:
+	bool _open;
+	mutable bool _waiting;
+	mutable std::vector<std::pair<std::string, int> > _posted;
+	mutable std::mutex _lock;
+	mutable std::condition_variable _changed;
+};
+
+/**
+ * Opens the gate when it goes out of scope, so a failed assertion
+ * doesn't leave the publisher thread stuck
+ */
+class GateGuard {
+public:
+	explicit GateGuard(GatedStatusSender *sender) :
+		_sender(sender) {
+	}
+
+	~GateGuard() {
+		_sender->open();
+	}
+
+private:
+	GatedStatusSender *_sender;
+};
+
+/**
+ * A status sender that fails to post some status items, returning an
+ * error or throwing
+ */
+class FailingStatusSender : public AbstractStatusSender {
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		if (item->getName() == "async-b") {
+			return status::ERROR;
+		}
+		if (item->getName() == "async-c") {
+			throw PostException("no connection");
+		}
+		return status::OK;
+	}
+};
+
+AsyncStatusSenderTest::~AsyncStatusSenderTest() {
+}
+
+void AsyncStatusSenderTest::setUp() {
+	StatusUtil::createStatusItem("async-a", type::INT);
+	StatusUtil::createStatusItem("async-b", type::INT);
+	StatusUtil::createStatusItem("async-c", type::INT);
+	StatusUtil::createStatusItem("async-d", type::INT);
+}
+
+void AsyncStatusSenderTest::tearDown() {
+}
+
+void AsyncStatusSenderTest::testPostAndFlush() {
+	GatedStatusSender *delegate = new GatedStatusSender();
+	AsyncStatusSender sender((pStatusSender(delegate)));
+
+	StatusUtil::setValueAsInt("async-a", 10);
+	CPPUNIT_ASSERT(sender.postStatus("async-a") == status::OK);
+	CPPUNIT_ASSERT(sender.flush(5000));
+
+	std::vector<std::pair<std::string, int> > posted = delegate->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, posted.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("async-a"), posted[0].first);
+	CPPUNIT_ASSERT_EQUAL(10, posted[0].second);
+
+	//not dirty anymore
+	CPPUNIT_ASSERT(sender.postStatus("async-a") == status::ERROR);
+
+	AsyncPostStatistics stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats.queueDepth);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats.sent);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats.dropped);
+}
+
+void AsyncStatusSenderTest::testLatestValueWins() {
+	GatedStatusSender *delegate = new GatedStatusSender();
+	AsyncStatusSender sender((pStatusSender(delegate)));
+	GateGuard gate(delegate);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("async-a");
+
+	//keep the publisher busy with the first value
+	delegate->close();
+	item->setValueAsInt(1);
+	sender.postStatusItem(item);
+	delegate->waitBlocked();
+
+	item->setValueAsInt(2);
+	CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+	item->setValueAsInt(3);
+	CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+
+	AsyncPostStatistics stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats.queueDepth);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats.coalesced);
+
+	delegate->open();
+	CPPUNIT_ASSERT(sender.flush(5000));
+
+	std::vector<std::pair<std::string, int> > posted = delegate->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)2, posted.size());
+	CPPUNIT_ASSERT_EQUAL(1, posted[0].second);
+	CPPUNIT_ASSERT_EQUAL(3, posted[1].second);
+}
+
+void AsyncStatusSenderTest::testQueueFull() {
+	GatedStatusSender *delegate = new GatedStatusSender();
+	AsyncStatusSender sender(pStatusSender(delegate), 2);
+	GateGuard gate(delegate);
+	pStatusDatabase db = StatusDatabase::Instance();
+
+	//start clean. Pending items may not fit in the queue at once
+	while (sender.postStatus() != status::OK) {
+		sender.flush(5000);
+	}
+	CPPUNIT_ASSERT(sender.flush(5000));
+	size_t sent = delegate->posted().size();
+	AsyncPostStatistics stats;
+	sender.getStatistics(stats);
+	unsigned long dropped = stats.dropped;
+
+	delegate->close();
+	db->getStatusItem("async-a")->setValueAsInt(100);
+	sender.postStatus("async-a");
+	delegate->waitBlocked();
+
+	//room for two items only
+	db->getStatusItem("async-b")->setValueAsInt(101);
+	db->getStatusItem("async-c")->setValueAsInt(102);
+	db->getStatusItem("async-d")->setValueAsInt(103);
+	CPPUNIT_ASSERT(sender.postStatus() == status::ERROR);
+
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(2ul, stats.queueDepth);
+	CPPUNIT_ASSERT_EQUAL(dropped + 1, stats.dropped);
+
+	delegate->open();
+	CPPUNIT_ASSERT(sender.flush(5000));
+	CPPUNIT_ASSERT_EQUAL(sent + 3, delegate->posted().size());
+
+	//the dropped item is still pending and goes out with the next post
+	CPPUNIT_ASSERT(sender.postStatus() == status::OK);
+	CPPUNIT_ASSERT(sender.flush(5000));
+	std::vector<std::pair<std::string, int> > posted = delegate->posted();
+	CPPUNIT_ASSERT_EQUAL(sent + 4, posted.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("async-d"), posted.back().first);
+	CPPUNIT_ASSERT_EQUAL(103, posted.back().second);
+}
+
+void AsyncStatusSenderTest::testFailedPosts() {
+	FailingStatusSender *delegate = new FailingStatusSender();
+	AsyncStatusSender sender((pStatusSender(delegate)));
+	pStatusDatabase db = StatusDatabase::Instance();
+	std::vector<pStatusItem> items;
+	items.push_back(db->getStatusItem("async-a"));
+	items.push_back(db->getStatusItem("async-b"));
+	items.push_back(db->getStatusItem("async-c"));
+
+	db->getStatusItem("async-a")->setValueAsInt(200);
+	db->getStatusItem("async-b")->setValueAsInt(201);
+	db->getStatusItem("async-c")->setValueAsInt(202);
+	sender.postStatusItems(items);
+	CPPUNIT_ASSERT(sender.flush(5000));
+
+	//only the item the delegate posted counts
+	AsyncPostStatistics stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats.sent);
+
+	//the publisher is still there after the exception
+	db->getStatusItem("async-d")->setValueAsInt(203);
+	CPPUNIT_ASSERT(sender.postStatus("async-d") == status::OK);
+	CPPUNIT_ASSERT(sender.flush(5000));
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(2ul, stats.sent);
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * AsyncStatusSenderTest.h
+ */
+
+#ifndef ASYNCSTATUSSENDERTEST_H_
+#define ASYNCSTATUSSENDERTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class AsyncStatusSenderTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( AsyncStatusSenderTest );
+
+	CPPUNIT_TEST( testPostAndFlush );
+	CPPUNIT_TEST( testLatestValueWins );
+	CPPUNIT_TEST( testQueueFull );
+	CPPUNIT_TEST( testFailedPosts );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testPostAndFlush();
+	void testLatestValueWins();
+	void testQueueFull();
+	void testFailedPosts();
+
+	virtual ~AsyncStatusSenderTest();
+};
+
+}
+#endif /* ASYNCSTATUSSENDERTEST_H_ */
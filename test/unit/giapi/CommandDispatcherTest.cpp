@@ -0,0 +1,185 @@
+/*
+ * CommandDispatcherTest.cpp
+ */
+
+#include "CommandDispatcherTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <giapi/SequenceCommandHandler.h>
+#include <giapi/AsyncSequenceCommandHandler.h>
+#include <commands/CommandDispatcher.h>
+
+namespace giapi {
+
+namespace {
+
+/**
+ * Handler that runs a function and keeps the order the commands
+ * were handled in
+ */
+class RecordingHandler: public SequenceCommandHandler {
+public:
+	typedef std::function<void(command::ActionId)> Action;
+
+	static std::tr1::shared_ptr<RecordingHandler> create(const Action &action) {
+		std::tr1::shared_ptr<RecordingHandler> handler(new RecordingHandler(action));
+		return handler;
+	}
+
+	virtual pHandlerResponse handle(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) {
+		_action(id);
+		std::lock_guard<std::mutex> guard(_lock);
+		_handled.push_back(id);
+		return HandlerResponse::create(HandlerResponse::ACCEPTED);
+	}
+
+	std::vector<command::ActionId> getHandled() {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _handled;
+	}
+
+private:
+	RecordingHandler(const Action &action) :
+		_action(action) {
+	}
+
+	Action _action;
+	std::mutex _lock;
+	std::vector<command::ActionId> _handled;
+};
+
+/**
+ * Asynchronous handler that counts the actions it starts
+ */
+class CountingHandler: public AsyncSequenceCommandHandler {
+public:
+	static std::tr1::shared_ptr<CountingHandler> create() {
+		std::tr1::shared_ptr<CountingHandler> handler(new CountingHandler());
+		return handler;
+	}
+
+	virtual pCompletionToken start(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) {
+		_started++;
+		pCompletionToken token = CompletionToken::create();
+		token->complete();
+		return token;
+	}
+
+	int getStarted() {
+		return _started;
+	}
+
+private:
+	CountingHandler() :
+		_started(0) {
+	}
+
+	std::atomic<int> _started;
+};
+
+}
+
+CommandDispatcherTest::CommandDispatcherTest() {
+}
+
+CommandDispatcherTest::~CommandDispatcherTest() {
+}
+
+void CommandDispatcherTest::setUp() {
+}
+
+void CommandDispatcherTest::tearDown() {
+}
+
+void CommandDispatcherTest::testOrder() {
+	std::tr1::shared_ptr<RecordingHandler> handler = RecordingHandler::create(
+			[](command::ActionId id) {
+				//the first command is the slowest
+				std::this_thread::sleep_for(std::chrono::milliseconds(
+						id == 1 ? 100 : 1));
+			});
+	std::tr1::shared_ptr<RecordingHandler> other = RecordingHandler::create(
+			[](command::ActionId id) {
+			});
+	{
+		util::pOrderedExecutor executor(new util::OrderedExecutor(4));
+		CommandDispatcher dispatcher(pSession(), executor);
+		dispatcher.dispatch("GMP.SC.OBSERVE", handler, 1, command::OBSERVE,
+				command::PRESET, pConfiguration(), NULL);
+		dispatcher.dispatch("GMP.SC.OBSERVE", handler, 2, command::OBSERVE,
+				command::START, pConfiguration(), NULL);
+		dispatcher.dispatch("GMP.SC.APPLY.gpi:cc", other, 3, command::APPLY,
+				command::START, pConfiguration(), NULL);
+
+		//another topic doesn't wait
+		for (int i = 0; i < 500 && other->getHandled().empty(); i++) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CPPUNIT_ASSERT_EQUAL((size_t) 1, other->getHandled().size());
+		CPPUNIT_ASSERT(handler->getHandled().size() < 2);
+		dispatcher.close();
+	}
+	std::vector<command::ActionId> handled = handler->getHandled();
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, handled.size());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 1, handled[0]);
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 2, handled[1]);
+}
+
+void CommandDispatcherTest::testCancel() {
+	std::mutex lock;
+	std::condition_variable cancelled;
+	bool cancel = false;
+	bool stopped = false;
+	std::tr1::shared_ptr<RecordingHandler> handler = RecordingHandler::create(
+			[&](command::ActionId id) {
+				std::unique_lock<std::mutex> guard(lock);
+				if (id == 2) {
+					cancel = true;
+					cancelled.notify_all();
+					return;
+				}
+				//the first command runs until it's cancelled
+				stopped = cancelled.wait_for(guard, std::chrono::seconds(5),
+						[&cancel] {return cancel;});
+			});
+	{
+		util::pOrderedExecutor executor(new util::OrderedExecutor(2));
+		CommandDispatcher dispatcher(pSession(), executor);
+		dispatcher.dispatch("GMP.SC.OBSERVE", handler, 1, command::OBSERVE,
+				command::START, pConfiguration(), NULL);
+		dispatcher.dispatch("GMP.SC.OBSERVE", handler, 2, command::OBSERVE,
+				command::CANCEL, pConfiguration(), NULL);
+		dispatcher.close();
+	}
+	CPPUNIT_ASSERT(stopped);
+	std::vector<command::ActionId> handled = handler->getHandled();
+	CPPUNIT_ASSERT_EQUAL((size_t) 2, handled.size());
+	CPPUNIT_ASSERT_EQUAL((command::ActionId) 2, handled[0]);
+}
+
+void CommandDispatcherTest::testNoReply() {
+	std::tr1::shared_ptr<CountingHandler> handler = CountingHandler::create();
+	{
+		util::pOrderedExecutor executor(new util::OrderedExecutor(1));
+		CommandDispatcher dispatcher(pSession(), executor);
+		dispatcher.dispatch("GMP.SC.OBSERVE", handler, 1, command::OBSERVE,
+				command::START, pConfiguration(), NULL);
+		dispatcher.close();
+	}
+	//give a started action the time to run
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	CPPUNIT_ASSERT_EQUAL(0, handler->getStarted());
+}
+
+}
@@ -0,0 +1,50 @@
+/*
+ * CommandDispatcherTest.h
+ */
+
+#ifndef COMMANDDISPATCHERTEST_H_
+#define COMMANDDISPATCHERTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+/**
+ * Tests of the order the command consumers hand the sequence commands
+ * to their handlers in, when the handlers run on a pool of threads
+ */
+class CommandDispatcherTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( CommandDispatcherTest );
+	CPPUNIT_TEST(testOrder);
+	CPPUNIT_TEST(testCancel);
+	CPPUNIT_TEST(testNoReply);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	/**
+	 * Commands on the same topic are handled one after the other,
+	 * commands on different topics at the same time
+	 */
+	void testOrder();
+
+	/**
+	 * A CANCEL doesn't wait for the command it cancels
+	 */
+	void testCancel();
+
+	/**
+	 * The actions of a command that can't be replied to are not started
+	 */
+	void testNoReply();
+
+	CommandDispatcherTest();
+	virtual ~CommandDispatcherTest();
+};
+
+}
+
+#endif /* COMMANDDISPATCHERTEST_H_ */
@@ -0,0 +1,102 @@
+/*
+ * CommandRoutingTableTest.cpp
+ */
+
+#include "CommandRoutingTableTest.h"
+
+#include <commands/CommandRoutingTable.h>
+#include <gmp/GMPKeys.h>
+#include <gmp/JmsUtil.h>
+
+namespace giapi {
+
+/**
+ * A handler that is never invoked, only routed to
+ */
+class RoutedHandler : public SequenceCommandHandler {
+public:
+	pHandlerResponse handle(command::ActionId id,
+			command::SequenceCommand sequenceCommand,
+			command::Activity activity, pConfiguration config) {
+		return HandlerResponse::create(HandlerResponse::ACCEPTED);
+	}
+};
+
+CommandRoutingTableTest::CommandRoutingTableTest() {
+}
+
+CommandRoutingTableTest::~CommandRoutingTableTest() {
+}
+
+void CommandRoutingTableTest::setUp() {
+}
+
+void CommandRoutingTableTest::tearDown() {
+}
+
+void CommandRoutingTableTest::testSequenceCommands() {
+	CommandRoutingTable routes;
+	pSequenceCommandHandler park(new RoutedHandler());
+	routes.add(command::PARK, command::SET_PRESET_START, park);
+
+	command::SequenceCommand id = command::TEST;
+	std::string topic = gmp::JmsUtil::getTopic(command::PARK);
+	CPPUNIT_ASSERT(routes.find(topic, command::PRESET, id) == park);
+	CPPUNIT_ASSERT_EQUAL(command::PARK, id);
+	CPPUNIT_ASSERT(routes.find(topic, command::START, id) == park);
+	CPPUNIT_ASSERT(routes.find(topic, command::PRESET_START, id) == park);
+	CPPUNIT_ASSERT(routes.find(topic, command::CANCEL, id).get() == 0);
+
+	CPPUNIT_ASSERT(routes.find(gmp::JmsUtil::getTopic(command::DATUM),
+			command::PRESET, id).get() == 0);
+	CPPUNIT_ASSERT(routes.find(gmp::GMPKeys::GMP_SEQUENCE_COMMAND_PREFIX
+			+ "UNKNOWN", command::PRESET, id).get() == 0);
+}
+
+void CommandRoutingTableTest::testApply() {
+	CommandRoutingTable routes;
+	pSequenceCommandHandler apply(new RoutedHandler());
+	pSequenceCommandHandler applyCommand(new RoutedHandler());
+	routes.add("gpi:cc", command::SET_START_CANCEL, apply);
+	routes.add(command::APPLY, command::SET_START, applyCommand);
+
+	command::SequenceCommand id = command::TEST;
+	CPPUNIT_ASSERT(routes.find(gmp::JmsUtil::getTopic("gpi:cc"),
+			command::CANCEL, id) == apply);
+	CPPUNIT_ASSERT_EQUAL(command::APPLY, id);
+	CPPUNIT_ASSERT(routes.find(gmp::JmsUtil::getTopic("gpi:cc"),
+			command::PRESET, id).get() == 0);
+	CPPUNIT_ASSERT(routes.find(gmp::JmsUtil::getTopic("gpi"),
+			command::START, id).get() == 0);
+
+	//the apply topic without a prefix is the one of the APPLY command
+	CPPUNIT_ASSERT(routes.find(gmp::JmsUtil::getTopic(command::APPLY),
+			command::START, id) == applyCommand);
+}
+
+void CommandRoutingTableTest::testReplace() {
+	CommandRoutingTable routes;
+	pSequenceCommandHandler first(new RoutedHandler());
+	pSequenceCommandHandler second(new RoutedHandler());
+	routes.add(command::OBSERVE, command::SET_PRESET_START_CANCEL, first);
+	routes.add(command::OBSERVE, command::SET_CANCEL, second);
+
+	command::SequenceCommand id;
+	std::string topic = gmp::JmsUtil::getTopic(command::OBSERVE);
+	CPPUNIT_ASSERT(routes.find(topic, command::CANCEL, id) == second);
+	CPPUNIT_ASSERT(routes.find(topic, command::PRESET, id) == first);
+	CPPUNIT_ASSERT(routes.find(topic, command::START, id) == first);
+}
+
+void CommandRoutingTableTest::testParseActivity() {
+	command::Activity activity;
+	CPPUNIT_ASSERT(CommandRoutingTable::parseActivity(
+			gmp::GMPKeys::GMP_ACTIVITY_PRESET_START, activity));
+	CPPUNIT_ASSERT_EQUAL(command::PRESET_START, activity);
+	CPPUNIT_ASSERT(CommandRoutingTable::parseActivity(
+			gmp::GMPKeys::GMP_ACTIVITY_CANCEL, activity));
+	CPPUNIT_ASSERT_EQUAL(command::CANCEL, activity);
+	CPPUNIT_ASSERT(!CommandRoutingTable::parseActivity("RESET", activity));
+}
+
+}
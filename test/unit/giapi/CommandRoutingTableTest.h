@@ -0,0 +1,54 @@
+/*
+ * CommandRoutingTableTest.h
+ */
+
+#ifndef COMMANDROUTINGTABLETEST_H_
+#define COMMANDROUTINGTABLETEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+/**
+ * Tests of the table the multiplexed command consumer routes the
+ * sequence commands with
+ */
+class CommandRoutingTableTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( CommandRoutingTableTest );
+	CPPUNIT_TEST(testSequenceCommands);
+	CPPUNIT_TEST(testApply);
+	CPPUNIT_TEST(testReplace);
+	CPPUNIT_TEST(testParseActivity);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	/**
+	 * Commands go to the handler of their sequence command, for the
+	 * activities it subscribed to
+	 */
+	void testSequenceCommands();
+
+	/**
+	 * Apply commands go to the handler of their prefix
+	 */
+	void testApply();
+
+	/**
+	 * The last handler subscribed to an activity replaces the previous
+	 * one for that activity only
+	 */
+	void testReplace();
+
+	void testParseActivity();
+
+	CommandRoutingTableTest();
+	virtual ~CommandRoutingTableTest();
+};
+
+}
+
+#endif /* COMMANDROUTINGTABLETEST_H_ */
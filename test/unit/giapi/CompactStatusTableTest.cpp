@@ -0,0 +1,269 @@
+/*
+ * CompactStatusTableTest.cpp
+ */
+
+#include "CompactStatusTableTest.h"
+#include "LocalGmpStatusDecoder.h"
+
+#include <cstdio>
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+
+#include <giapi/StatusUtil.h>
+#include <status/CompactStatusTable.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/StatusSenderFactory.h>
+#include <status/senders/jms-writer/StatusSerializerVisitor.h>
+
+namespace giapi {
+
+/**
+ * A status sender that keeps the ids of the table items it posts
+ */
+class TableStatusSender : public AbstractStatusSender {
+public:
+	mutable std::vector<int> posted;
+	/**
+	 * Posts of tables fail, with ERROR or with an exception
+	 */
+	bool failing;
+	bool throwing;
+
+	TableStatusSender() : failing(false), throwing(false) {
+	}
+
+	~TableStatusSender() {
+		stopScheduledPosts();
+	}
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		return status::OK;
+	}
+
+	int postTableBatch(const CompactStatusTable &table,
+			const std::vector<int> &ids) const throw (PostException) {
+		if (throwing) {
+			throw PostException("broker gone");
+		}
+		if (failing) {
+			return status::ERROR;
+		}
+		posted = ids;
+		return status::OK;
+	}
+};
+
+CompactStatusTableTest::~CompactStatusTableTest() {
+}
+
+void CompactStatusTableTest::setUp() {
+}
+
+void CompactStatusTableTest::tearDown() {
+}
+
+void CompactStatusTableTest::testCreate() {
+	CompactStatusTable table(3);
+	CPPUNIT_ASSERT_EQUAL(0, table.create("c-int", StatusItemSpec::BASIC, type::INT));
+	CPPUNIT_ASSERT_EQUAL(1, table.create("c-alarm", StatusItemSpec::ALARM, type::DOUBLE));
+	//duplicated name, unsupported type
+	CPPUNIT_ASSERT_EQUAL(-1, table.create("c-int", StatusItemSpec::BASIC, type::DOUBLE));
+	CPPUNIT_ASSERT_EQUAL(-1, table.create("c-bool", StatusItemSpec::BASIC, type::BOOLEAN));
+	CPPUNIT_ASSERT_EQUAL(2, table.create("c-health", StatusItemSpec::HEALTH, type::STRING));
+	//full
+	CPPUNIT_ASSERT_EQUAL(-1, table.create("c-more", StatusItemSpec::BASIC, type::INT));
+	CPPUNIT_ASSERT_EQUAL((size_t)3, table.getSize());
+
+	CPPUNIT_ASSERT_EQUAL(1, table.find("c-alarm"));
+	CPPUNIT_ASSERT_EQUAL(2, table.find("c-health"));
+	CPPUNIT_ASSERT_EQUAL(-1, table.find("c-more"));
+
+	CompactStatusTable::Record record;
+	table.read(2, record);
+	CPPUNIT_ASSERT_EQUAL(std::string("c-health"), std::string(record.name));
+	CPPUNIT_ASSERT_EQUAL(type::INT, record.type);
+	CPPUNIT_ASSERT(table.getMemoryUsage() > 0);
+}
+
+void CompactStatusTableTest::testValues() {
+	CompactStatusTable table(10);
+	int intId = table.create("c-int", StatusItemSpec::BASIC, type::INT);
+	int stringId = table.create("c-string", StatusItemSpec::BASIC, type::STRING);
+	int alarmId = table.create("c-alarm", StatusItemSpec::ALARM, type::FLOAT);
+	int healthId = table.create("c-health", StatusItemSpec::HEALTH, type::INT);
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.setValue(intId, 7));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, table.setValue(intId, 7.5));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, table.setValue(12, 7));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.setValue(stringId, std::string("open")));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.setValue(alarmId, 2.5f));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.setAlarm(alarmId,
+			alarm::ALARM_FAILURE, alarm::ALARM_CAUSE_HIHI));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, table.setAlarm(alarmId,
+			alarm::ALARM_FAILURE, alarm::ALARM_CAUSE_OTHER));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, table.setAlarm(intId,
+			alarm::ALARM_FAILURE, alarm::ALARM_CAUSE_HIHI));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.setHealth(healthId, health::BAD));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, table.setHealth(intId, health::BAD));
+
+	CompactStatusTable::Record record;
+	table.read(intId, record);
+	CPPUNIT_ASSERT_EQUAL(7, record.intValue);
+	CPPUNIT_ASSERT(record.timestamp > 0);
+	table.read(stringId, record);
+	CPPUNIT_ASSERT_EQUAL(std::string("open"), record.stringValue);
+	table.read(alarmId, record);
+	CPPUNIT_ASSERT_EQUAL(StatusItemSpec::ALARM, record.kind);
+	CPPUNIT_ASSERT_EQUAL(2.5f, record.floatValue);
+	CPPUNIT_ASSERT_EQUAL(alarm::ALARM_FAILURE, record.severity);
+	CPPUNIT_ASSERT_EQUAL(alarm::ALARM_CAUSE_HIHI, record.cause);
+	table.read(healthId, record);
+	CPPUNIT_ASSERT_EQUAL((int)health::BAD, record.intValue);
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, table.clearAlarm(alarmId));
+	table.read(alarmId, record);
+	CPPUNIT_ASSERT_EQUAL(alarm::ALARM_OK, record.severity);
+}
+
+void CompactStatusTableTest::testChanged() {
+	CompactStatusTable table(200);
+	char name[32];
+	for (int i = 0; i < 200; i++) {
+		sprintf(name, "c-item%d", i);
+		table.create(name, StatusItemSpec::BASIC, type::DOUBLE);
+	}
+	//new items are changed
+	std::vector<int> ids;
+	table.takeChanged(ids);
+	CPPUNIT_ASSERT_EQUAL((size_t)200, ids.size());
+	ids.clear();
+	table.takeChanged(ids);
+	CPPUNIT_ASSERT(ids.empty());
+
+	//returned in id order, across words of the bitmap
+	table.setValue(150, 1.0);
+	table.setValue(3, 1.0);
+	table.setValue(64, 1.0);
+	table.setValue(3, 2.0);
+	//same value, not changed
+	table.setValue(10, 0.0);
+	table.takeChanged(ids);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, ids.size());
+	CPPUNIT_ASSERT_EQUAL(3, ids[0]);
+	CPPUNIT_ASSERT_EQUAL(64, ids[1]);
+	CPPUNIT_ASSERT_EQUAL(150, ids[2]);
+
+	//a failed post puts them back
+	table.markChanged(ids);
+	ids.clear();
+	table.takeChanged(ids);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, ids.size());
+}
+
+void CompactStatusTableTest::testSerialize() {
+	CompactStatusTable table(10);
+	int intId = table.create("c-int", StatusItemSpec::BASIC, type::INT);
+	int alarmId = table.create("c-alarm", StatusItemSpec::ALARM, type::FLOAT);
+	int healthId = table.create("c-health", StatusItemSpec::HEALTH, type::INT);
+	table.setValue(intId, 42);
+	table.setValue(alarmId, 1.5f);
+	table.setAlarm(alarmId, alarm::ALARM_WARNING, alarm::ALARM_CAUSE_OTHER,
+			"too hot");
+	table.setHealth(healthId, health::BAD);
+
+	std::vector<int> ids;
+	table.takeChanged(ids);
+	activemq::commands::ActiveMQBytesMessage msg;
+	StatusSerializerVisitor serializer(&msg);
+	serializer.writeBatch(table, ids);
+	msg.reset();
+
+	//same records as the status items
+	std::vector<StatusRecord> records = LocalGmpStatusDecoder::decode(&msg);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, records.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("c-int"), records[0].name);
+	CPPUNIT_ASSERT_EQUAL(0, records[0].kind);
+	CPPUNIT_ASSERT_EQUAL(42, records[0].intValue);
+	CPPUNIT_ASSERT_EQUAL(10, records[1].kind);
+	CPPUNIT_ASSERT_EQUAL(1.5f, records[1].floatValue);
+	CPPUNIT_ASSERT_EQUAL((int)alarm::ALARM_WARNING, records[1].severity);
+	CPPUNIT_ASSERT_EQUAL((int)alarm::ALARM_CAUSE_OTHER, records[1].cause);
+	CPPUNIT_ASSERT_EQUAL(std::string("too hot"), records[1].message);
+	CPPUNIT_ASSERT_EQUAL(20, records[2].kind);
+	CPPUNIT_ASSERT_EQUAL((int)health::BAD, records[2].intValue);
+}
+
+void CompactStatusTableTest::testPost() {
+	CompactStatusTable table(10);
+	int intId = table.create("p-int", StatusItemSpec::BASIC, type::INT);
+	int alarmId = table.create("p-alarm", StatusItemSpec::ALARM, type::INT);
+	CPPUNIT_ASSERT(!table.isUrgent(intId));
+	CPPUNIT_ASSERT(table.isUrgent(alarmId));
+
+	TableStatusSender sender;
+	table.setValue(intId, 1);
+	table.setValue(alarmId, 2);
+	sender.failing = true;
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, sender.postTable(table));
+	sender.failing = false;
+	sender.throwing = true;
+	CPPUNIT_ASSERT_THROW(sender.postTable(table), PostException);
+	sender.throwing = false;
+	CPPUNIT_ASSERT(sender.posted.empty());
+
+	//nothing was lost
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, sender.postTable(table));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender.posted.size());
+	CPPUNIT_ASSERT_EQUAL(intId, sender.posted[0]);
+	CPPUNIT_ASSERT_EQUAL(alarmId, sender.posted[1]);
+
+	//nothing changed
+	sender.posted.clear();
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, sender.postTable(table));
+	CPPUNIT_ASSERT(sender.posted.empty());
+
+	StatusSenderStatistics stats;
+	sender.getPostStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(2ul, stats.posts);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats.batches);
+	CPPUNIT_ASSERT_EQUAL(2ul, stats.errors);
+}
+
+void CompactStatusTableTest::testStatusUtil() {
+	//the table of the process is created once
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::createTableItem("u-int"));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::createStatusTable(8));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::createStatusTable(8));
+
+	int intId = StatusUtil::createTableItem("u-int");
+	int healthId = StatusUtil::createTableItem("u-health", StatusItemSpec::HEALTH);
+	CPPUNIT_ASSERT(intId >= 0);
+	CPPUNIT_ASSERT(healthId >= 0);
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::createTableItem("u-int"));
+	CPPUNIT_ASSERT_EQUAL(intId, StatusUtil::findTableItem("u-int"));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::findTableItem("u-missing"));
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setTableValue(intId, 5));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::setTableValue(intId, 5.0));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::setTableAlarm(intId,
+			alarm::ALARM_WARNING, alarm::ALARM_CAUSE_HI));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setTableHealth(healthId,
+			health::WARNING));
+
+	//posted through the default sender
+	TableStatusSender *sender = new TableStatusSender();
+	pStatusSender owner(sender);
+	pStatusSenderFactory factory = StatusSenderFactory::Instance();
+	StatusSenderFactory::StatusSenderType previous = factory->getDefaultSenderType();
+	factory->setStatusSender(StatusSenderFactory::SHARED_SENDER, owner);
+	factory->setDefaultSenderType(StatusSenderFactory::SHARED_SENDER);
+	int result = StatusUtil::postStatusTable();
+	factory->setDefaultSenderType(previous);
+	factory->setStatusSender(StatusSenderFactory::SHARED_SENDER, pStatusSender());
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, result);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender->posted.size());
+}
+
+}
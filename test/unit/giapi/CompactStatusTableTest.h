@@ -0,0 +1,50 @@
+/*
+ * CompactStatusTableTest.h
+ */
+
+#ifndef COMPACTSTATUSTABLETEST_H_
+#define COMPACTSTATUSTABLETEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class CompactStatusTableTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( CompactStatusTableTest );
+
+	CPPUNIT_TEST( testCreate );
+	CPPUNIT_TEST( testValues );
+	CPPUNIT_TEST( testChanged );
+	CPPUNIT_TEST( testSerialize );
+	CPPUNIT_TEST( testPost );
+	CPPUNIT_TEST( testStatusUtil );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testCreate();
+	void testValues();
+	void testChanged();
+	void testSerialize();
+
+	/**
+	 * Senders post the changed items together, and keep the ones
+	 * that can't be sent for the next post
+	 */
+	void testPost();
+
+	/**
+	 * The table of the process, through StatusUtil
+	 */
+	void testStatusUtil();
+
+	virtual ~CompactStatusTableTest();
+};
+
+}
+#endif /* COMPACTSTATUSTABLETEST_H_ */
@@ -0,0 +1,289 @@
+/*
+ * CompositeStatusSenderTest.cpp
+ */
+
+#include "CompositeStatusSenderTest.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <giapi/giapi.h>
+#include <giapi/StatusUtil.h>
+
+#include <status/StatusItem.h>
+#include <status/StatusDatabase.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/CompositeStatusSender.h>
+
+namespace giapi {
+
+/**
+ * A sink sender that records the values it posts. It can be stopped
+ * to play a slow sink
+ */
+class RecordingSinkSender : public AbstractStatusSender {
+public:
+	RecordingSinkSender() :
+		_open(true), _waiting(false) {
+	}
+
+	void close() {
+		std::lock_guard<std::mutex> guard(_lock);
+		_open = false;
+	}
+
+	void open() {
+		std::lock_guard<std::mutex> guard(_lock);
+		_open = true;
+		_changed.notify_all();
+	}
+
+	/**
+	 * Wait until a post is held back
+	 */
+	void waitBlocked() {
+		std::unique_lock<std::mutex> lock(_lock);
+		_changed.wait(lock, [this] {
+			return _waiting;
+		});
+	}
+
+	/**
+	 * Wait until <code>count</code> values have been posted
+	 */
+	bool waitPosted(size_t count) {
+		std::unique_lock<std::mutex> lock(_lock);
+		return _changed.wait_for(lock, std::chrono::seconds(5), [this, count] {
+			return _posted.size() >= count;
+		});
+	}
+
+	std::vector<int> posted() {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _posted;
+	}
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		int value = item->getValueAsInt();
+		std::unique_lock<std::mutex> lock(_lock);
+		_waiting = true;
+		_changed.notify_all();
+		_changed.wait(lock, [this] {
+			return _open;
+		});
+		_waiting = false;
+		_posted.push_back(value);
+		_changed.notify_all();
+		return status::OK;
+	}
+
+private:
+	bool _open;
+	mutable bool _waiting;
+	mutable std::vector<int> _posted;
+	mutable std::mutex _lock;
+	mutable std::condition_variable _changed;
+};
+
+/**
+ * Lets a stopped sink go when it goes out of scope, so a failed
+ * assertion doesn't leave its thread stuck
+ */
+class SinkGuard {
+public:
+	explicit SinkGuard(RecordingSinkSender *sender) :
+		_sender(sender) {
+	}
+
+	~SinkGuard() {
+		_sender->open();
+	}
+
+private:
+	RecordingSinkSender *_sender;
+};
+
+/**
+ * A sink sender that can't reach its destination
+ */
+class BrokenSinkSender : public AbstractStatusSender {
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		throw PostException("sink unreachable");
+	}
+};
+
+CompositeStatusSenderTest::~CompositeStatusSenderTest() {
+}
+
+void CompositeStatusSenderTest::setUp() {
+	StatusUtil::createStatusItem("composite-a", type::INT);
+}
+
+void CompositeStatusSenderTest::tearDown() {
+}
+
+void CompositeStatusSenderTest::testFanOut() {
+	RecordingSinkSender *fast = new RecordingSinkSender();
+	RecordingSinkSender *slow = new RecordingSinkSender();
+	CompositeStatusSender sender;
+	sender.addSink("fast", pStatusSender(fast), StatusSink::COALESCE);
+	sender.addSink("slow", pStatusSender(slow), StatusSink::DROP_OLDEST);
+	SinkGuard guard(slow);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("composite-a");
+
+	slow->close();
+	for (int i = 1; i <= 3; i++) {
+		item->setValueAsInt(i);
+		CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+		//the stopped sink doesn't hold up the other one
+		CPPUNIT_ASSERT(fast->waitPosted(i));
+	}
+	CPPUNIT_ASSERT(!sender.flush(100));
+
+	slow->open();
+	CPPUNIT_ASSERT(sender.flush(5000));
+	std::vector<int> posted = slow->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)3, posted.size());
+	CPPUNIT_ASSERT_EQUAL(3, posted[2]);
+	CPPUNIT_ASSERT_EQUAL(3, fast->posted()[2]);
+
+	std::vector<StatusSinkStatistics> stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, stats.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("fast"), stats[0].name);
+	CPPUNIT_ASSERT_EQUAL(3ul, stats[0].sent);
+	CPPUNIT_ASSERT_EQUAL(std::string("slow"), stats[1].name);
+	CPPUNIT_ASSERT_EQUAL(3ul, stats[1].sent);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats[1].queueDepth);
+}
+
+void CompositeStatusSenderTest::testDropOldest() {
+	RecordingSinkSender *sink = new RecordingSinkSender();
+	CompositeStatusSender sender;
+	sender.addSink("sink", pStatusSender(sink), StatusSink::DROP_OLDEST, 1);
+	SinkGuard guard(sink);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("composite-a");
+
+	sink->close();
+	item->setValueAsInt(1);
+	sender.postStatusItem(item);
+	sink->waitBlocked();
+
+	//room for one post only, the latest stays
+	item->setValueAsInt(2);
+	sender.postStatusItem(item);
+	item->setValueAsInt(3);
+	sender.postStatusItem(item);
+
+	std::vector<StatusSinkStatistics> stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats[0].queueDepth);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats[0].dropped);
+
+	sink->open();
+	CPPUNIT_ASSERT(sender.flush(5000));
+	std::vector<int> posted = sink->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)2, posted.size());
+	CPPUNIT_ASSERT_EQUAL(1, posted[0]);
+	CPPUNIT_ASSERT_EQUAL(3, posted[1]);
+}
+
+void CompositeStatusSenderTest::testCoalesce() {
+	RecordingSinkSender *sink = new RecordingSinkSender();
+	CompositeStatusSender sender;
+	sender.addSink("sink", pStatusSender(sink), StatusSink::COALESCE);
+	SinkGuard guard(sink);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("composite-a");
+
+	sink->close();
+	item->setValueAsInt(1);
+	sender.postStatusItem(item);
+	sink->waitBlocked();
+
+	//the item is queued once, with its latest value
+	item->setValueAsInt(2);
+	sender.postStatusItem(item);
+	item->setValueAsInt(3);
+	sender.postStatusItem(item);
+
+	std::vector<StatusSinkStatistics> stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats[0].queueDepth);
+	CPPUNIT_ASSERT_EQUAL(1ul, stats[0].coalesced);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats[0].dropped);
+
+	sink->open();
+	CPPUNIT_ASSERT(sender.flush(5000));
+	std::vector<int> posted = sink->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)2, posted.size());
+	CPPUNIT_ASSERT_EQUAL(1, posted[0]);
+	CPPUNIT_ASSERT_EQUAL(3, posted[1]);
+}
+
+void CompositeStatusSenderTest::testBlock() {
+	RecordingSinkSender *sink = new RecordingSinkSender();
+	CompositeStatusSender sender;
+	sender.addSink("sink", pStatusSender(sink), StatusSink::BLOCK, 1);
+	SinkGuard guard(sink);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("composite-a");
+
+	sink->close();
+	item->setValueAsInt(1);
+	sender.postStatusItem(item);
+	sink->waitBlocked();
+	item->setValueAsInt(2);
+	sender.postStatusItem(item);
+
+	//the queue is full, this post waits for the sink
+	std::thread poster([&sender, &item] {
+		item->setValueAsInt(3);
+		sender.postStatusItem(item);
+	});
+	std::vector<StatusSinkStatistics> stats;
+	for (int i = 0; i < 500; i++) {
+		sender.getStatistics(stats);
+		if (stats[0].blocked > 0) {
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	CPPUNIT_ASSERT_EQUAL(1ul, stats[0].blocked);
+
+	sink->open();
+	poster.join();
+	CPPUNIT_ASSERT(sender.flush(5000));
+	std::vector<int> posted = sink->posted();
+	CPPUNIT_ASSERT_EQUAL((size_t)3, posted.size());
+	CPPUNIT_ASSERT_EQUAL(2, posted[1]);
+	CPPUNIT_ASSERT_EQUAL(3, posted[2]);
+}
+
+void CompositeStatusSenderTest::testFailingSink() {
+	RecordingSinkSender *good = new RecordingSinkSender();
+	CompositeStatusSender sender;
+	sender.addSink("broken", pStatusSender(new BrokenSinkSender()),
+			StatusSink::DROP_OLDEST);
+	sender.addSink("good", pStatusSender(good), StatusSink::DROP_OLDEST);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("composite-a");
+
+	for (int i = 1; i <= 2; i++) {
+		item->setValueAsInt(100 + i);
+		CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+		CPPUNIT_ASSERT(sender.flush(5000));
+	}
+	CPPUNIT_ASSERT(good->waitPosted(2));
+
+	//the broken sink keeps running, but sends nothing
+	std::vector<StatusSinkStatistics> stats;
+	sender.getStatistics(stats);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats[0].sent);
+	CPPUNIT_ASSERT_EQUAL(0ul, stats[0].queueDepth);
+	CPPUNIT_ASSERT_EQUAL(2ul, stats[1].sent);
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+ * CompositeStatusSenderTest.h
+ */
+
+#ifndef COMPOSITESTATUSSENDERTEST_H_
+#define COMPOSITESTATUSSENDERTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class CompositeStatusSenderTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( CompositeStatusSenderTest );
+
+	CPPUNIT_TEST( testFanOut );
+	CPPUNIT_TEST( testDropOldest );
+	CPPUNIT_TEST( testCoalesce );
+	CPPUNIT_TEST( testBlock );
+	CPPUNIT_TEST( testFailingSink );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testFanOut();
+	void testDropOldest();
+	void testCoalesce();
+	void testBlock();
+	void testFailingSink();
+
+	virtual ~CompositeStatusSenderTest();
+};
+
+}
+#endif /* COMPOSITESTATUSSENDERTEST_H_ */
@@ -0,0 +1,144 @@
+/*
+ * ConfigurationTest.cpp
+ */
+
+#include "ConfigurationTest.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <activemq/commands/ActiveMQMapMessage.h>
+
+#include <commands/ConfigurationFactory.h>
+
+namespace giapi {
+
+ConfigurationTest::ConfigurationTest() {
+}
+
+ConfigurationTest::~ConfigurationTest() {
+}
+
+void ConfigurationTest::setUp() {
+}
+
+void ConfigurationTest::tearDown() {
+}
+
+void ConfigurationTest::testSetValue() {
+	pConfiguration config = ConfigurationFactory::getConfiguration();
+	CPPUNIT_ASSERT_EQUAL(0, config->getSize());
+	CPPUNIT_ASSERT(config->getKeys().empty());
+
+	config->setValue("gpi:filter", "H");
+	config->setValue("gpi:adc", "IN");
+	config->setValue("gpi:exposure", "30");
+	config->setValue("gpi:filter", "J");
+
+	const std::vector<std::string> &keys = config->getKeys();
+	CPPUNIT_ASSERT_EQUAL(3, config->getSize());
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, keys.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("gpi:adc"), keys[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("gpi:exposure"), keys[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("gpi:filter"), keys[2]);
+	CPPUNIT_ASSERT_EQUAL(std::string("J"), config->getValue("gpi:filter"));
+	CPPUNIT_ASSERT_EQUAL(std::string(), config->getValue("gpi:missing"));
+	//looking up a missing key doesn't add it
+	CPPUNIT_ASSERT_EQUAL(3, config->getSize());
+}
+
+void ConfigurationTest::testFromMessage() {
+	activemq::commands::ActiveMQMapMessage message;
+	for (int i = 99; i >= 0; i--) {
+		message.setString("gpi:key" + std::to_string(i), std::to_string(i));
+	}
+
+	pConfiguration config = ConfigurationFactory::getConfiguration(&message);
+	CPPUNIT_ASSERT_EQUAL(100, config->getSize());
+	const std::vector<std::string> &keys = config->getKeys();
+	for (size_t i = 1; i < keys.size(); i++) {
+		CPPUNIT_ASSERT(keys[i - 1] < keys[i]);
+	}
+	for (int i = 0; i < 100; i++) {
+		int value = -1;
+		CPPUNIT_ASSERT(config->getInt("gpi:key" + std::to_string(i), value));
+		CPPUNIT_ASSERT_EQUAL(i, value);
+	}
+	//the keys themselves are looked up by position
+	for (size_t i = 0; i < keys.size(); i++) {
+		CPPUNIT_ASSERT_EQUAL(keys[i].substr(7), config->getValue(keys[i]));
+	}
+}
+
+void ConfigurationTest::testTypedValues() {
+	pConfiguration config = ConfigurationFactory::getConfiguration();
+	config->setValue("double", " 2.5 ");
+	config->setValue("int", "-42");
+	config->setValue("bool", "Yes");
+	config->setValue("text", "OPEN");
+	config->setValue("huge", "99999999999");
+
+	double doubleValue = 0;
+	int intValue = 0;
+	bool boolValue = false;
+	CPPUNIT_ASSERT(config->getDouble("double", doubleValue));
+	CPPUNIT_ASSERT_EQUAL(2.5, doubleValue);
+	CPPUNIT_ASSERT(!config->getInt("double", intValue));
+	CPPUNIT_ASSERT(config->getInt("int", intValue));
+	CPPUNIT_ASSERT_EQUAL(-42, intValue);
+	CPPUNIT_ASSERT(config->getDouble("int", doubleValue));
+	CPPUNIT_ASSERT_EQUAL(-42.0, doubleValue);
+	CPPUNIT_ASSERT(config->getBool("bool", boolValue));
+	CPPUNIT_ASSERT(boolValue);
+
+	intValue = 7;
+	CPPUNIT_ASSERT(!config->getInt("text", intValue));
+	CPPUNIT_ASSERT(!config->getDouble("text", doubleValue));
+	CPPUNIT_ASSERT(!config->getBool("text", boolValue));
+	CPPUNIT_ASSERT(!config->getInt("huge", intValue));
+	CPPUNIT_ASSERT(!config->getInt("missing", intValue));
+	CPPUNIT_ASSERT_EQUAL(7, intValue);
+
+	//parsed again when the value changes
+	CPPUNIT_ASSERT(config->getInt("int", intValue));
+	config->setValue("int", "12");
+	CPPUNIT_ASSERT(config->getInt("int", intValue));
+	CPPUNIT_ASSERT_EQUAL(12, intValue);
+	config->setValue("bool", "off");
+	CPPUNIT_ASSERT(config->getBool("bool", boolValue));
+	CPPUNIT_ASSERT(!boolValue);
+}
+
+void ConfigurationTest::testConcurrentReads() {
+	pConfiguration config = ConfigurationFactory::getConfiguration();
+	config->setValue("int", "42");
+	config->setValue("double", "2.5");
+	config->setValue("bool", "yes");
+
+	//the handler and the thread finishing the actions read it together
+	std::atomic<int> mismatches(0);
+	std::vector<std::thread> readers;
+	for (int i = 0; i < 4; i++) {
+		readers.push_back(std::thread([&config, &mismatches] {
+			for (int j = 0; j < 10000; j++) {
+				int intValue = 0;
+				double doubleValue = 0;
+				bool boolValue = false;
+				if (!config->getInt("int", intValue) || intValue != 42
+						|| !config->getDouble("double", doubleValue)
+						|| doubleValue != 2.5
+						|| !config->getBool("bool", boolValue) || !boolValue) {
+					mismatches++;
+				}
+			}
+		}));
+	}
+	for (size_t i = 0; i < readers.size(); i++) {
+		readers[i].join();
+	}
+	CPPUNIT_ASSERT_EQUAL(0, mismatches.load());
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * ConfigurationTest.h
+ */
+
+#ifndef CONFIGURATIONTEST_H_
+#define CONFIGURATIONTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+/**
+ * Tests of the configurations handed to the sequence command handlers
+ */
+class ConfigurationTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( ConfigurationTest );
+	CPPUNIT_TEST(testSetValue);
+	CPPUNIT_TEST(testFromMessage);
+	CPPUNIT_TEST(testTypedValues);
+	CPPUNIT_TEST(testConcurrentReads);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	/**
+	 * Keys are kept sorted, and setting a key again replaces its value
+	 */
+	void testSetValue();
+
+	/**
+	 * A configuration built from a sequence command message has all
+	 * its entries
+	 */
+	void testFromMessage();
+
+	/**
+	 * Values are parsed as numbers and booleans, and a value set again
+	 * is parsed again
+	 */
+	void testTypedValues();
+
+	/**
+	 * Several threads can read the typed values at once
+	 */
+	void testConcurrentReads();
+
+	ConfigurationTest();
+	virtual ~ConfigurationTest();
+};
+
+}
+
+#endif /* CONFIGURATIONTEST_H_ */
@@ -2,6 +2,13 @@
 #include "GiapiStatusTest.h"
 #include <giapi/giapi.h>
 #include <giapi/StatusUtil.h>
+#include <status/StatusDatabase.h>
+#include <status/senders/StatusSenderFactory.h>
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
 using namespace giapi;
 
 namespace giapi {
@@ -52,6 +59,70 @@ void GiapiStatusTest::testCreateHealthStatusItem() {
 	CPPUNIT_ASSERT( StatusUtil::createHealthStatusItem("health-item-2") == giapi::status::OK );
 }
 
+void GiapiStatusTest::testCreateStatusItems() {
+	std::vector<StatusItemSpec> items;
+	items.push_back(StatusItemSpec("bulk-item", StatusItemSpec::BASIC, giapi::type::DOUBLE));
+	items.push_back(StatusItemSpec("bulk-alarm", StatusItemSpec::ALARM, giapi::type::INT));
+	items.push_back(StatusItemSpec("bulk-health", StatusItemSpec::HEALTH));
+	CPPUNIT_ASSERT( StatusUtil::createStatusItems(items) == giapi::status::OK );
+
+	//the items behave as if created one by one
+	CPPUNIT_ASSERT( StatusUtil::setValueAsDouble("bulk-item", 2.5) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("bulk-item", 2) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( StatusUtil::setAlarm("bulk-alarm", giapi::alarm::ALARM_WARNING, giapi::alarm::ALARM_CAUSE_HI) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setHealth("bulk-health", giapi::health::BAD) == giapi::status::OK );
+
+	//error, test-item already exists. bulk-item-2 is created anyway
+	items.clear();
+	items.push_back(StatusItemSpec("test-item"));
+	items.push_back(StatusItemSpec("bulk-item-2"));
+	CPPUNIT_ASSERT( StatusUtil::createStatusItems(items) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("bulk-item-2", 5) == giapi::status::OK );
+}
+
+/**
+ * Write a manifest with the given contents to a temporary file, and
+ * return its name
+ */
+static std::string writeManifest(const std::string &contents) {
+	char name[64];
+	snprintf(name, sizeof(name), "/tmp/giapi-manifest-%d.xml", (int)getpid());
+	std::ofstream file(name);
+	file << contents;
+	return name;
+}
+
+void GiapiStatusTest::testCreateStatusItemsFromManifest() {
+	std::string path = writeManifest("<?xml version=\"1.0\"?>\n"
+			"<Channels>\n"
+			"  <!-- <SimpleChannel><giapiname>commented</giapiname></SimpleChannel> -->\n"
+			"  <SimpleChannel>\n"
+			"    <giapiname> manifest:status </giapiname>\n"
+			"    <epicsname>manifest:status</epicsname>\n"
+			"    <type>STRING</type>\n"
+			"  </SimpleChannel>\n"
+			"  <AlarmChannel><giapiname>manifest:alarm</giapiname><type>FLOAT</type></AlarmChannel>\n"
+			"  <HealthChannel><giapiname>manifest:health</giapiname></HealthChannel>\n"
+			"</Channels>\n");
+	CPPUNIT_ASSERT( StatusUtil::createStatusItems(path) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsString("manifest:status", "value") == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsFloat("manifest:alarm", 1.5f) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setHealth("manifest:health", giapi::health::GOOD) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("commented", 1) == giapi::status::ERROR );
+
+	//error, unknown type. Nothing is created
+	writeManifest("<Channels>\n"
+			"  <SimpleChannel><giapiname>manifest:ok</giapiname><type>INT</type></SimpleChannel>\n"
+			"  <SimpleChannel><giapiname>manifest:bad</giapiname><type>LONG</type></SimpleChannel>\n"
+			"</Channels>\n");
+	CPPUNIT_ASSERT( StatusUtil::createStatusItems(path) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("manifest:ok", 1) == giapi::status::ERROR );
+	remove(path.c_str());
+
+	//error, the file doesn't exist
+	CPPUNIT_ASSERT( StatusUtil::createStatusItems(path) == giapi::status::ERROR );
+}
+
 void GiapiStatusTest::testSetValuesStatusItem() {
 	//should work. test-item is an int
 	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("test-item", 48) == giapi::status::OK );
@@ -116,6 +187,214 @@ void GiapiStatusTest::testClearAlarms() {
 	CPPUNIT_ASSERT( StatusUtil::clearAlarm("alarm-item") == giapi::status::OK);
 }
 
+void GiapiStatusTest::testStatusHandles() {
+	//should work, the types match
+	StatusHandle<int> intHandle = StatusUtil::getHandle<int>("test-item");
+	CPPUNIT_ASSERT( intHandle.isValid() );
+	CPPUNIT_ASSERT( intHandle.getName() == "test-item" );
+	StatusHandle<double> doubleHandle = StatusUtil::getHandle<double>("test-item-double");
+	CPPUNIT_ASSERT( doubleHandle.isValid() );
+	//also for the value of alarm items
+	CPPUNIT_ASSERT( StatusUtil::getHandle<double>("alarm-item").isValid() );
+
+	//not valid. test-item-3 doesn't exist
+	CPPUNIT_ASSERT( !StatusUtil::getHandle<int>("test-item-3").isValid() );
+	//not valid. test-item is not a string
+	StatusHandle<std::string> stringHandle = StatusUtil::getHandle<std::string>("test-item");
+	CPPUNIT_ASSERT( !stringHandle.isValid() );
+	CPPUNIT_ASSERT( stringHandle.set("value") == giapi::status::ERROR );
+	CPPUNIT_ASSERT( stringHandle.post() == giapi::status::ERROR );
+
+	//setting values through the handles
+	CPPUNIT_ASSERT( intHandle.set(52) == giapi::status::OK );
+	CPPUNIT_ASSERT( doubleHandle.set(1.25) == giapi::status::OK );
+	//OK. Value didn't change
+	CPPUNIT_ASSERT( intHandle.set(52) == giapi::status::OK );
+}
+
+/**
+ * Keys of the status items used in the tests
+ */
+static constexpr StatusKey<int> KEY_INT("key-int");
+static constexpr StatusKey<std::string> KEY_STRING("key-string");
+static constexpr StatusKey<double, kind::Alarm> KEY_ALARM("key-alarm");
+static constexpr StatusKey<health::Health, kind::Health> KEY_HEALTH("key-health");
+static constexpr StatusKey<double> KEY_WRONG_TYPE("key-int");
+static constexpr StatusKey<int> KEY_LATE("key-late");
+
+void GiapiStatusTest::testStatusKeys() {
+	pStatusDatabase db = StatusDatabase::Instance();
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem(KEY_INT) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem(KEY_STRING) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem(KEY_ALARM) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem(KEY_HEALTH) == giapi::status::OK );
+	CPPUNIT_ASSERT( db->getStatusItem("key-int")->getStatusType() == giapi::type::INT );
+	CPPUNIT_ASSERT( db->getStatusItem("key-alarm")->getStatusType() == giapi::type::DOUBLE );
+
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_INT, 12) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( 12, db->getStatusItem("key-int")->getValueAsInt() );
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_STRING, "ready") == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( std::string("ready"), db->getStatusItem("key-string")->getValueAsString() );
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_ALARM, 3.5) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setAlarm(KEY_ALARM, giapi::alarm::ALARM_WARNING,
+			giapi::alarm::ALARM_CAUSE_HI) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::clearAlarm(KEY_ALARM) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setHealth(KEY_HEALTH, giapi::health::WARNING) == giapi::status::OK );
+
+	StatusHandle<double> handle = StatusUtil::getHandle(KEY_ALARM);
+	CPPUNIT_ASSERT( handle.isValid() );
+	CPPUNIT_ASSERT( handle.set(4.5) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( 4.5, db->getStatusItem("key-alarm")->getValueAsDouble() );
+
+	//a key declared with the wrong type compiles, but the item is checked
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_WRONG_TYPE, 1.5) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( !StatusUtil::getHandle(KEY_WRONG_TYPE).isValid() );
+	CPPUNIT_ASSERT_EQUAL( 12, db->getStatusItem("key-int")->getValueAsInt() );
+	CPPUNIT_ASSERT( !KEY_WRONG_TYPE.isResolved() );
+
+	//keys are bound to their item by the first value, and skip the
+	//lookup by name from then on
+	CPPUNIT_ASSERT( KEY_INT.isResolved() );
+	CPPUNIT_ASSERT( KEY_STRING.isResolved() );
+	StatusStatistics before;
+	CPPUNIT_ASSERT( StatusUtil::getStatistics(before) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_LATE, 1) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( !KEY_LATE.isResolved() );
+	StatusStatistics stats;
+	CPPUNIT_ASSERT( StatusUtil::getStatistics(stats) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( before.unknownItems + 1, stats.unknownItems );
+
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem(KEY_LATE) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_LATE, 2) == giapi::status::OK );
+	CPPUNIT_ASSERT( KEY_LATE.isResolved() );
+	CPPUNIT_ASSERT( StatusUtil::setValue(KEY_LATE, 3) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( 3, db->getStatusItem("key-late")->getValueAsInt() );
+	CPPUNIT_ASSERT( StatusUtil::getHandle(KEY_LATE).isValid() );
+
+	//a copy is bound on its own
+	StatusKey<int> copy(KEY_LATE);
+	CPPUNIT_ASSERT( !copy.isResolved() );
+	CPPUNIT_ASSERT( StatusUtil::setValue(copy, 4) == giapi::status::OK );
+	CPPUNIT_ASSERT( copy.isResolved() );
+	CPPUNIT_ASSERT_EQUAL( 4, db->getStatusItem("key-late")->getValueAsInt() );
+}
+
+void GiapiStatusTest::testObservers() {
+	std::vector<std::string> names;
+	std::vector<int> values;
+	std::atomic<int> asyncCalls(0);
+	std::atomic<int> alarms(0);
+
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem("obs:a:temp", giapi::type::INT) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem("obs:b:temp", giapi::type::INT) == giapi::status::OK );
+	int inlineId = StatusUtil::addObserver("obs:?:*", [&](const StatusChange &change) {
+		names.push_back(change.name);
+		values.push_back(change.intValue);
+	});
+	CPPUNIT_ASSERT( inlineId > 0 );
+	int asyncId = StatusUtil::addObserver("obs:b:*", [&](const StatusChange &) {
+		asyncCalls++;
+	}, true);
+	CPPUNIT_ASSERT( asyncId > 0 );
+	CPPUNIT_ASSERT( StatusUtil::addObserver("", [](const StatusChange &) {}) == giapi::status::ERROR );
+
+	//created after the observers were added
+	CPPUNIT_ASSERT( StatusUtil::createAlarmStatusItem("obs:c:alarm", giapi::type::INT) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem("other:temp", giapi::type::INT) == giapi::status::OK );
+	int alarmId = StatusUtil::addObserver("obs:c:alarm", [&](const StatusChange &change) {
+		if (change.isAlarm && change.severity == giapi::alarm::ALARM_WARNING) {
+			alarms++;
+		}
+	});
+
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("obs:a:temp", 1) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("obs:a:temp", 1) == giapi::status::OK ); //no change
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("obs:b:temp", 2) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("obs:c:alarm", 3) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("other:temp", 4) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setAlarm("obs:c:alarm", giapi::alarm::ALARM_WARNING,
+			giapi::alarm::ALARM_CAUSE_HI) == giapi::status::OK );
+
+	//the inline observers have been called already
+	CPPUNIT_ASSERT_EQUAL( (size_t) 4, names.size() );
+	CPPUNIT_ASSERT_EQUAL( std::string("obs:a:temp"), names[0] );
+	CPPUNIT_ASSERT_EQUAL( 1, values[0] );
+	CPPUNIT_ASSERT_EQUAL( std::string("obs:b:temp"), names[1] );
+	CPPUNIT_ASSERT_EQUAL( 2, values[1] );
+	CPPUNIT_ASSERT_EQUAL( std::string("obs:c:alarm"), names[2] );
+	CPPUNIT_ASSERT_EQUAL( 1, alarms.load() );
+	for (int i = 0; i < 100 && asyncCalls.load() == 0; i++) {
+		usleep(10000);
+	}
+	CPPUNIT_ASSERT_EQUAL( 1, asyncCalls.load() );
+
+	CPPUNIT_ASSERT( StatusUtil::removeObserver(inlineId) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::removeObserver(inlineId) == giapi::status::ERROR );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("obs:a:temp", 5) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( (size_t) 4, names.size() );
+	StatusUtil::removeObserver(asyncId);
+	StatusUtil::removeObserver(alarmId);
+}
+
+void GiapiStatusTest::testStatistics() {
+	CPPUNIT_ASSERT( StatusUtil::createStatusItem("stats:item", giapi::type::INT) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("stats:item", 1) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("stats:item", 2) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("stats:item", 2) == giapi::status::OK ); //no change
+
+	StatusStatistics before;
+	CPPUNIT_ASSERT( StatusUtil::getStatistics(before) == giapi::status::OK );
+	CPPUNIT_ASSERT( StatusUtil::setValueAsInt("stats:missing", 1) == giapi::status::ERROR );
+
+	//post through the log sender, no GMP needed
+	pStatusSender sender = StatusSenderFactory::Instance()->getStatusSender(
+			StatusSenderFactory::LOG_SENDER);
+	pStatusItem item = StatusDatabase::Instance()->getStatusItem("stats:item");
+	CPPUNIT_ASSERT( sender->postStatusItem(item) == giapi::status::OK );
+	CPPUNIT_ASSERT( sender->postStatusItem(item) == giapi::status::ERROR ); //unchanged
+
+	StatusStatistics stats;
+	CPPUNIT_ASSERT( StatusUtil::getStatistics(stats) == giapi::status::OK );
+	CPPUNIT_ASSERT_EQUAL( before.unknownItems + 1, stats.unknownItems );
+	CPPUNIT_ASSERT( stats.elapsed > 0 );
+
+	const StatusItemStatistics *itemStats = 0;
+	for (size_t i = 0; i < stats.items.size(); i++) {
+		if (stats.items[i].name == "stats:item") {
+			itemStats = &stats.items[i];
+		}
+	}
+	CPPUNIT_ASSERT( itemStats != 0 );
+	CPPUNIT_ASSERT_EQUAL( 2ul, itemStats->updates );
+	CPPUNIT_ASSERT_EQUAL( 1ul, itemStats->posts );
+
+	const StatusSenderStatistics *senderStats = 0;
+	for (size_t i = 0; i < stats.senders.size(); i++) {
+		if (stats.senders[i].name == "log") {
+			senderStats = &stats.senders[i];
+		}
+	}
+	CPPUNIT_ASSERT( senderStats != 0 );
+	CPPUNIT_ASSERT( senderStats->posts >= 1 );
+	CPPUNIT_ASSERT( senderStats->unchanged >= 1 );
+	CPPUNIT_ASSERT( senderStats->latency.count >= 1 );
+	CPPUNIT_ASSERT_EQUAL( (size_t) 24, senderStats->latency.buckets.size() );
+
+	char path[64];
+	snprintf(path, sizeof(path), "/tmp/giapi-statistics-%d.txt", (int)getpid());
+	CPPUNIT_ASSERT( StatusUtil::dumpStatistics(path) == giapi::status::OK );
+	std::ifstream file(path);
+	std::string line;
+	bool found = false;
+	while (std::getline(file, line)) {
+		if (line.find("item stats:item updates 2 posts 1 ") == 0) {
+			found = true;
+		}
+	}
+	unlink(path);
+	CPPUNIT_ASSERT( found );
+}
+
 void GiapiStatusTest::testSetValuesHealth() {
 
 	//should work.
@@ -13,6 +13,8 @@ class GiapiStatusTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST( testCreateStatusItem );
 	CPPUNIT_TEST( testCreateAlarmStatusItem );
 	CPPUNIT_TEST( testCreateHealthStatusItem );
+	CPPUNIT_TEST( testCreateStatusItems );
+	CPPUNIT_TEST( testCreateStatusItemsFromManifest );
 
 	CPPUNIT_TEST(testSetValuesStatusItem);
 	CPPUNIT_TEST(testSetValuesAlarms);
@@ -21,6 +23,11 @@ class GiapiStatusTest : public CppUnit::TestFixture {
 	CPPUNIT_TEST(testSetValuesAlarmsOtherCause);
 	CPPUNIT_TEST(testClearAlarms);
 
+	CPPUNIT_TEST(testStatusHandles);
+	CPPUNIT_TEST(testStatusKeys);
+	CPPUNIT_TEST(testObservers);
+	CPPUNIT_TEST(testStatistics);
+
 	CPPUNIT_TEST(testPostStatusItem);
 	CPPUNIT_TEST(testPostAlarms);
 	CPPUNIT_TEST(testPostHealth);
@@ -38,6 +45,8 @@ public:
 	void testCreateStatusItem();
 	void testCreateAlarmStatusItem();
 	void testCreateHealthStatusItem();
+	void testCreateStatusItems();
+	void testCreateStatusItemsFromManifest();
 
 	void testSetValuesStatusItem();
 	void testSetValuesAlarms();
@@ -46,6 +55,11 @@ public:
 	void testSetValuesAlarmsOtherCause();
 	void testClearAlarms();
 
+	void testStatusHandles();
+	void testStatusKeys();
+	void testObservers();
+	void testStatistics();
+
 	void testPostStatusItem();
 	void testPostAlarms();
 	void testPostHealth();
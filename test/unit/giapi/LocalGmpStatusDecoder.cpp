@@ -0,0 +1,98 @@
+/*
+ * LocalGmpStatusDecoder.cpp
+ */
+
+#include "LocalGmpStatusDecoder.h"
+
+namespace giapi {
+
+std::vector<StatusRecord> LocalGmpStatusDecoder::decode(
+		const cms::BytesMessage *msg) {
+	std::vector<StatusRecord> records;
+
+	int code = msg->readByte();
+	if (code != BATCH_OFFSET) {
+		//a single status item in the message
+		records.push_back(decodeRecord(code, msg));
+		return records;
+	}
+
+	int count = msg->readInt();
+	for (int i = 0; i < count; i++) {
+		records.push_back(decodeRecord(msg->readByte(), msg));
+	}
+	return records;
+}
+
+StatusRecord LocalGmpStatusDecoder::decodeRecord(int code,
+		const cms::BytesMessage *msg) {
+	StatusRecord record;
+	record.kind = (code / 10) * 10;
+	record.intValue = 0;
+	record.doubleValue = 0.0;
+	record.floatValue = 0.0f;
+	record.severity = alarm::ALARM_OK;
+	record.cause = alarm::ALARM_CAUSE_OK;
+	record.arrayLength = 0;
+	record.arrayFirst = 0;
+
+	record.name = msg->readUTF();
+	if (record.kind == 30) {
+		decodeArray(code, msg, record);
+		return record;
+	}
+	switch (code % 10) {
+	case 0:
+		record.type = type::INT;
+		record.intValue = msg->readInt();
+		break;
+	case 1:
+		record.type = type::DOUBLE;
+		record.doubleValue = msg->readDouble();
+		break;
+	case 2:
+		record.type = type::FLOAT;
+		record.floatValue = msg->readFloat();
+		break;
+	case 3:
+		record.type = type::STRING;
+		record.stringValue = msg->readUTF();
+		break;
+	}
+	record.timestamp = msg->readLong();
+
+	if (record.kind == 10) {
+		record.severity = msg->readByte();
+		record.cause = msg->readByte();
+		if (msg->readBoolean()) {
+			record.message = msg->readUTF();
+		}
+	}
+	return record;
+}
+
+void LocalGmpStatusDecoder::decodeArray(int code,
+		const cms::BytesMessage *msg, StatusRecord &record) {
+	record.arrayLength = msg->readInt();
+	record.arrayFirst = msg->readInt();
+	int count = msg->readInt();
+	for (int i = 0; i < count; i++) {
+		switch (code % 10) {
+		case 0:
+			record.type = type::INT;
+			record.arrayValues.push_back(msg->readInt());
+			break;
+		case 1:
+			record.type = type::DOUBLE;
+			record.arrayValues.push_back(msg->readDouble());
+			break;
+		case 2:
+			record.type = type::FLOAT;
+			record.arrayValues.push_back(msg->readFloat());
+			break;
+		}
+	}
+	record.timestamp = msg->readLong();
+}
+
+}
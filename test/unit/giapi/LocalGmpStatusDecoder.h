@@ -0,0 +1,70 @@
+/*
+ * LocalGmpStatusDecoder.h
+ *
+ * A local stand-in for the status reader in the GMP. Decodes the
+ * JMS messages produced by the status senders, so tests can verify
+ * what would be received on the GMP side without a broker.
+ */
+
+#ifndef LOCALGMPSTATUSDECODER_H_
+#define LOCALGMPSTATUSDECODER_H_
+
+#include <string>
+#include <vector>
+
+#include <giapi/giapi.h>
+#include <cms/BytesMessage.h>
+
+namespace giapi {
+
+/**
+ * A status record, as reconstructed by the GMP
+ */
+struct StatusRecord {
+	/**
+	 * Kind of status item: 0 = basic, 10 = alarm, 20 = health,
+	 * 30 = array
+	 */
+	int kind;
+	type::Type type;
+	std::string name;
+	int intValue;
+	double doubleValue;
+	float floatValue;
+	std::string stringValue;
+	long64 timestamp;
+	//alarm information, only for alarm records
+	int severity;
+	int cause;
+	std::string message;
+	//array information, only for array records. The values are
+	//the elements [arrayFirst, arrayFirst + arrayValues.size())
+	int arrayLength;
+	int arrayFirst;
+	std::vector<double> arrayValues;
+};
+
+class LocalGmpStatusDecoder {
+public:
+	/**
+	 * Batch marker, must match the one used by the serializer
+	 */
+	static const int BATCH_OFFSET = 90;
+
+	/**
+	 * Decode all the status records contained in the message. The
+	 * message must be in read-only mode. Both single item and
+	 * batch messages are supported.
+	 */
+	static std::vector<StatusRecord> decode(const cms::BytesMessage *msg);
+
+private:
+	static StatusRecord decodeRecord(int code, const cms::BytesMessage *msg);
+	static void decodeArray(int code, const cms::BytesMessage *msg,
+			StatusRecord &record);
+	LocalGmpStatusDecoder();
+};
+
+}
+
+#endif /* LOCALGMPSTATUSDECODER_H_ */
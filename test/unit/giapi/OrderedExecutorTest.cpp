@@ -0,0 +1,123 @@
+/*
+ * OrderedExecutorTest.cpp
+ */
+
+#include "OrderedExecutorTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <util/OrderedExecutor.h>
+
+namespace giapi {
+
+OrderedExecutorTest::OrderedExecutorTest() {
+}
+
+OrderedExecutorTest::~OrderedExecutorTest() {
+}
+
+void OrderedExecutorTest::setUp() {
+}
+
+void OrderedExecutorTest::tearDown() {
+}
+
+void OrderedExecutorTest::testOrderPerKey() {
+	static const int TASKS = 200;
+	std::mutex lock;
+	std::vector<int> done[2];
+	std::atomic<int> running[2];
+	std::atomic<bool> overlapped(false);
+	running[0] = 0;
+	running[1] = 0;
+	{
+		util::OrderedExecutor executor(4, "test");
+		for (int i = 0; i < TASKS; i++) {
+			int key = i % 2;
+			executor.execute(key == 0 ? "even" : "odd", [&, key, i] {
+				if (running[key]++ > 0) {
+					overlapped = true;
+				}
+				std::this_thread::yield();
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					done[key].push_back(i);
+				}
+				running[key]--;
+			});
+		}
+	}
+	CPPUNIT_ASSERT(!overlapped);
+	for (int key = 0; key < 2; key++) {
+		CPPUNIT_ASSERT_EQUAL((size_t) TASKS / 2, done[key].size());
+		for (int i = 0; i < TASKS / 2; i++) {
+			CPPUNIT_ASSERT_EQUAL(2 * i + key, done[key][i]);
+		}
+	}
+}
+
+void OrderedExecutorTest::testKeysDontWait() {
+	std::mutex lock;
+	std::condition_variable changed;
+	bool released = false;
+	bool otherRan = false;
+
+	util::OrderedExecutor executor(2, "test");
+	executor.execute("blocked", [&] {
+		std::unique_lock<std::mutex> guard(lock);
+		changed.wait(guard, [&] { return released; });
+	});
+	executor.execute("other", [&] {
+		std::lock_guard<std::mutex> guard(lock);
+		otherRan = true;
+		changed.notify_all();
+	});
+
+	std::unique_lock<std::mutex> guard(lock);
+	bool ran = changed.wait_for(guard, std::chrono::seconds(5), [&] {
+		return otherRan;
+	});
+	released = true;
+	changed.notify_all();
+	guard.unlock();
+	CPPUNIT_ASSERT(ran);
+}
+
+void OrderedExecutorTest::testFailingTask() {
+	std::atomic<int> ran(0);
+	{
+		util::OrderedExecutor executor(1, "test");
+		executor.execute("key", [] {
+			throw std::runtime_error("task failed");
+		});
+		executor.execute("key", [&] {
+			ran++;
+		});
+	}
+	CPPUNIT_ASSERT_EQUAL(1, ran.load());
+}
+
+void OrderedExecutorTest::testShutdown() {
+	std::atomic<int> ran(0);
+	util::OrderedExecutor executor(2, "test");
+	for (int i = 0; i < 10; i++) {
+		executor.execute("key", [&] {
+			ran++;
+		});
+	}
+	executor.shutdown();
+	CPPUNIT_ASSERT_EQUAL(10, ran.load());
+	CPPUNIT_ASSERT(!executor.execute("key", [&] {
+		ran++;
+	}));
+	CPPUNIT_ASSERT_EQUAL(10, ran.load());
+}
+
+}
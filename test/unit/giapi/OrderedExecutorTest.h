@@ -0,0 +1,54 @@
+/*
+ * OrderedExecutorTest.h
+ */
+
+#ifndef ORDEREDEXECUTORTEST_H_
+#define ORDEREDEXECUTORTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+/**
+ * Tests of the executor the sequence command handlers run on
+ */
+class OrderedExecutorTest : public CppUnit::TestFixture {
+	CPPUNIT_TEST_SUITE( OrderedExecutorTest );
+	CPPUNIT_TEST(testOrderPerKey);
+	CPPUNIT_TEST(testKeysDontWait);
+	CPPUNIT_TEST(testFailingTask);
+	CPPUNIT_TEST(testShutdown);
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	/**
+	 * Tasks of a key run one at a time, in the order they are submitted
+	 */
+	void testOrderPerKey();
+
+	/**
+	 * A task that blocks doesn't hold up the tasks of other keys
+	 */
+	void testKeysDontWait();
+
+	/**
+	 * The tasks behind one that throws still run
+	 */
+	void testFailingTask();
+
+	/**
+	 * Shutting down runs the queued tasks and refuses new ones
+	 */
+	void testShutdown();
+
+	OrderedExecutorTest();
+	virtual ~OrderedExecutorTest();
+};
+
+}
+
+#endif /* ORDEREDEXECUTORTEST_H_ */
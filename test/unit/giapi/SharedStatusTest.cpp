@@ -0,0 +1,201 @@
+/*
+ * SharedStatusTest.cpp
+ */
+
+#include "SharedStatusTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <giapi/giapi.h>
+
+#include <status/StatusItem.h>
+#include <status/AlarmStatusItem.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/SharedStatusSender.h>
+#include <status/shared/SharedStatusTable.h>
+
+namespace giapi {
+
+/**
+ * A status sender that keeps a copy of the items it posts
+ */
+class CopyingStatusSender : public AbstractStatusSender {
+public:
+	CopyingStatusSender() :
+		_failing(false), _attempts(0) {
+	}
+
+	/**
+	 * Make the posts fail, like a broker that went away
+	 */
+	void setFailing(bool failing) {
+		_failing = failing;
+	}
+
+	int attempts() {
+		return _attempts;
+	}
+
+	std::vector<StatusItem *> copies() {
+		std::lock_guard<std::mutex> guard(_lock);
+		return _copies;
+	}
+
+	~CopyingStatusSender() {
+		for (size_t i = 0; i < _copies.size(); i++) {
+			delete _copies[i];
+		}
+	}
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		_attempts++;
+		if (_failing) {
+			return status::ERROR;
+		}
+		StatusItem *copy = new StatusItem(item->getName(), type::DOUBLE);
+		copy->setValueAsDouble(item->getValueAsDouble());
+		copy->setTimestamp(item->getTimestamp());
+		std::lock_guard<std::mutex> guard(_lock);
+		_copies.push_back(copy);
+		return status::OK;
+	}
+
+private:
+	mutable std::vector<StatusItem *> _copies;
+	mutable std::mutex _lock;
+	std::atomic<bool> _failing;
+	mutable std::atomic<int> _attempts;
+};
+
+SharedStatusTest::~SharedStatusTest() {
+}
+
+void SharedStatusTest::setUp() {
+	std::ostringstream name;
+	name << "/giapi-test-" << getpid();
+	_segment = name.str();
+	SharedStatusTable::remove(_segment);
+}
+
+void SharedStatusTest::tearDown() {
+	SharedStatusTable::remove(_segment);
+}
+
+void SharedStatusTest::testSlots() {
+	SharedStatusTable first(_segment, 64);
+	//the capacity of the existing segment prevails
+	SharedStatusTable second(_segment, 1024);
+	CPPUNIT_ASSERT_EQUAL((size_t)64, second.getCapacity());
+
+	int slot = first.findSlot("shared:int", SharedStatusData::BASIC, type::INT);
+	CPPUNIT_ASSERT(slot >= 0);
+	CPPUNIT_ASSERT_EQUAL(slot, second.findSlot("shared:int",
+			SharedStatusData::BASIC, type::INT));
+	CPPUNIT_ASSERT_EQUAL(-1, second.findSlot("shared:int",
+			SharedStatusData::BASIC, type::DOUBLE));
+	CPPUNIT_ASSERT_EQUAL((size_t)1, second.getSize());
+
+	first.beginWrite(slot).intValue = 42;
+	first.endWrite(slot);
+
+	SharedStatusData data;
+	second.read(slot, data);
+	CPPUNIT_ASSERT_EQUAL(42, (int)data.intValue);
+	CPPUNIT_ASSERT_EQUAL(std::string("shared:int"), std::string(data.name));
+
+	std::vector<int> dirty;
+	second.takeDirtySlots(dirty);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, dirty.size());
+	CPPUNIT_ASSERT_EQUAL(slot, dirty[0]);
+	dirty.clear();
+	first.takeDirtySlots(dirty);
+	CPPUNIT_ASSERT(dirty.empty());
+}
+
+void SharedStatusTest::testElection() {
+	SharedStatusTable table(_segment, 64);
+	CPPUNIT_ASSERT(table.tryBecomePublisher());
+
+	//another process can't take over while this one is alive
+	pid_t child = fork();
+	if (child == 0) {
+		SharedStatusTable other(_segment, 64);
+		_exit(other.tryBecomePublisher() ? 1 : 0);
+	}
+	int result;
+	waitpid(child, &result, 0);
+	CPPUNIT_ASSERT_EQUAL(0, WEXITSTATUS(result));
+	CPPUNIT_ASSERT(table.isPublisher());
+
+	//a publisher that dies without resigning is replaced
+	table.resignPublisher();
+	child = fork();
+	if (child == 0) {
+		SharedStatusTable other(_segment, 64);
+		_exit(other.tryBecomePublisher() ? 1 : 0);
+	}
+	waitpid(child, &result, 0);
+	CPPUNIT_ASSERT_EQUAL(1, WEXITSTATUS(result));
+	CPPUNIT_ASSERT(!table.isPublisher());
+	CPPUNIT_ASSERT(table.tryBecomePublisher());
+}
+
+void SharedStatusTest::testPublish() {
+	pSharedStatusTable table(new SharedStatusTable(_segment, 64));
+	CopyingStatusSender *publisher = new CopyingStatusSender();
+	SharedStatusSender sender(table, pStatusSender(publisher));
+
+	pStatusItem item(new StatusItem("shared:temp", type::DOUBLE));
+	item->setValueAsDouble(12.5);
+	CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+
+	//the publisher thread sends it
+	for (int i = 0; i < 200 && publisher->copies().empty(); i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	std::vector<StatusItem *> copies = publisher->copies();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, copies.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("shared:temp"), copies[0]->getName());
+	CPPUNIT_ASSERT_EQUAL(12.5, copies[0]->getValueAsDouble());
+	CPPUNIT_ASSERT_EQUAL(item->getTimestamp(), copies[0]->getTimestamp());
+
+	//nothing new to publish
+	CPPUNIT_ASSERT_EQUAL(0, sender.publish());
+}
+
+void SharedStatusTest::testPublishFailure() {
+	pSharedStatusTable table(new SharedStatusTable(_segment, 64));
+	CopyingStatusSender *publisher = new CopyingStatusSender();
+	publisher->setFailing(true);
+	SharedStatusSender sender(table, pStatusSender(publisher));
+
+	pStatusItem item(new StatusItem("shared:temp", type::DOUBLE));
+	item->setValueAsDouble(12.5);
+	CPPUNIT_ASSERT(sender.postStatusItem(item) == status::OK);
+
+	for (int i = 0; i < 200 && publisher->attempts() == 0; i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	CPPUNIT_ASSERT(publisher->attempts() > 0);
+	CPPUNIT_ASSERT(publisher->copies().empty());
+
+	//the item wasn't lost, it goes out once the posts work again
+	publisher->setFailing(false);
+	for (int i = 0; i < 200 && publisher->copies().empty(); i++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	std::vector<StatusItem *> copies = publisher->copies();
+	CPPUNIT_ASSERT_EQUAL((size_t)1, copies.size());
+	CPPUNIT_ASSERT_EQUAL(12.5, copies[0]->getValueAsDouble());
+}
+
+}
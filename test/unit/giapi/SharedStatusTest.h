@@ -0,0 +1,40 @@
+/*
+ * SharedStatusTest.h
+ */
+
+#ifndef SHAREDSTATUSTEST_H_
+#define SHAREDSTATUSTEST_H_
+
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class SharedStatusTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( SharedStatusTest );
+
+	CPPUNIT_TEST( testSlots );
+	CPPUNIT_TEST( testElection );
+	CPPUNIT_TEST( testPublish );
+	CPPUNIT_TEST( testPublishFailure );
+
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string _segment;
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testSlots();
+	void testElection();
+	void testPublish();
+	void testPublishFailure();
+
+	virtual ~SharedStatusTest();
+};
+
+}
+#endif /* SHAREDSTATUSTEST_H_ */
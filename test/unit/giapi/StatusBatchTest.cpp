@@ -0,0 +1,484 @@
+/*
+ * StatusBatchTest.cpp
+ */
+
+#include "StatusBatchTest.h"
+#include "LocalGmpStatusDecoder.h"
+
+#include <giapi/giapi.h>
+#include <giapi/StatusUtil.h>
+#include <giapi/StatusTransaction.h>
+
+#include <activemq/commands/ActiveMQBytesMessage.h>
+
+#include <status/StatusItem.h>
+#include <status/StatusDatabase.h>
+#include <status/TransactionLog.h>
+#include <status/AlarmStatusItem.h>
+#include <status/HealthStatusItem.h>
+#include <status/ArrayStatusItem.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/StatusSenderFactory.h>
+#include <status/senders/jms-writer/StatusSerializerVisitor.h>
+
+#include <chrono>
+#include <thread>
+
+namespace giapi {
+
+/**
+ * A status sender that keeps track of what it was asked to post
+ */
+class RecordingStatusSender : public AbstractStatusSender {
+public:
+	mutable int singlePosts;
+	mutable std::vector<size_t> batches;
+	mutable std::vector<pStatusItem> lastBatch;
+	/**
+	 * Batches are recorded, but reported as failed
+	 */
+	bool failing;
+
+	RecordingStatusSender() : singlePosts(0), failing(false) {
+	}
+
+	~RecordingStatusSender() {
+		stopScheduledPosts();
+	}
+
+	using AbstractStatusSender::postStatus;
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		singlePosts++;
+		return status::OK;
+	}
+
+	int postBatch(const std::vector<pStatusItem> &items) const
+			throw (PostException) {
+		batches.push_back(items.size());
+		lastBatch = items;
+		return failing ? status::ERROR : status::OK;
+	}
+};
+
+StatusBatchTest::~StatusBatchTest() {
+}
+
+void StatusBatchTest::setUp() {
+	StatusUtil::createStatusItem("batch-int", type::INT);
+	StatusUtil::createStatusItem("batch-double", type::DOUBLE);
+	StatusUtil::createAlarmStatusItem("batch-alarm", type::INT);
+}
+
+void StatusBatchTest::tearDown() {
+}
+
+void StatusBatchTest::testSerializeSingleItem() {
+	pStatusItem item(new StatusItem("single", type::DOUBLE));
+	item->setValueAsDouble(3.25);
+
+	activemq::commands::ActiveMQBytesMessage msg;
+	StatusSerializerVisitor serializer(&msg);
+	item->accept(serializer);
+	msg.reset();
+
+	std::vector<StatusRecord> records = LocalGmpStatusDecoder::decode(&msg);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, records.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("single"), records[0].name);
+	CPPUNIT_ASSERT(records[0].type == type::DOUBLE);
+	CPPUNIT_ASSERT_EQUAL(3.25, records[0].doubleValue);
+	CPPUNIT_ASSERT_EQUAL(item->getTimestamp(), records[0].timestamp);
+}
+
+void StatusBatchTest::testSerializeBatch() {
+	std::vector<pStatusItem> items;
+	items.push_back(pStatusItem(new StatusItem("b-int", type::INT)));
+	items.push_back(pStatusItem(new StatusItem("b-string", type::STRING)));
+	AlarmStatusItem *alarmItem = new AlarmStatusItem("b-alarm", type::FLOAT);
+	items.push_back(pStatusItem(alarmItem));
+	HealthStatusItem *healthItem = new HealthStatusItem("b-health");
+	items.push_back(pStatusItem(healthItem));
+
+	items[0]->setValueAsInt(42);
+	items[1]->setValueAsString("open");
+	alarmItem->setValueAsFloat(1.5f);
+	alarmItem->setAlarmState(alarm::ALARM_WARNING, alarm::ALARM_CAUSE_OTHER,
+			"too hot");
+	healthItem->setHealth(health::BAD);
+
+	activemq::commands::ActiveMQBytesMessage msg;
+	StatusSerializerVisitor serializer(&msg);
+	serializer.writeBatch(items);
+	msg.reset();
+
+	std::vector<StatusRecord> records = LocalGmpStatusDecoder::decode(&msg);
+	CPPUNIT_ASSERT_EQUAL((size_t)4, records.size());
+
+	CPPUNIT_ASSERT_EQUAL(std::string("b-int"), records[0].name);
+	CPPUNIT_ASSERT_EQUAL(0, records[0].kind);
+	CPPUNIT_ASSERT_EQUAL(42, records[0].intValue);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("b-string"), records[1].name);
+	CPPUNIT_ASSERT_EQUAL(std::string("open"), records[1].stringValue);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("b-alarm"), records[2].name);
+	CPPUNIT_ASSERT_EQUAL(10, records[2].kind);
+	CPPUNIT_ASSERT_EQUAL(1.5f, records[2].floatValue);
+	CPPUNIT_ASSERT_EQUAL((int)alarm::ALARM_WARNING, records[2].severity);
+	CPPUNIT_ASSERT_EQUAL((int)alarm::ALARM_CAUSE_OTHER, records[2].cause);
+	CPPUNIT_ASSERT_EQUAL(std::string("too hot"), records[2].message);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("b-health"), records[3].name);
+	CPPUNIT_ASSERT_EQUAL(20, records[3].kind);
+	CPPUNIT_ASSERT_EQUAL((int)health::BAD, records[3].intValue);
+}
+
+void StatusBatchTest::testSerializeArray() {
+	ArrayStatusItem *profile = new ArrayStatusItem("b-profile", type::DOUBLE, 64);
+	ArrayStatusItem *ranged = new ArrayStatusItem("b-ranged", type::FLOAT, 8, true);
+	std::vector<pStatusItem> items;
+	items.push_back(pStatusItem(profile));
+	items.push_back(pStatusItem(ranged));
+
+	double values[64];
+	for (int i = 0; i < 64; i++) {
+		values[i] = i * 0.5;
+	}
+	profile->setValues(0, values, 64);
+
+	activemq::commands::ActiveMQBytesMessage msg;
+	StatusSerializerVisitor serializer(&msg);
+	serializer.writeBatch(items);
+	msg.reset();
+
+	std::vector<StatusRecord> records = LocalGmpStatusDecoder::decode(&msg);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, records.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("b-profile"), records[0].name);
+	CPPUNIT_ASSERT_EQUAL(30, records[0].kind);
+	CPPUNIT_ASSERT(records[0].type == type::DOUBLE);
+	CPPUNIT_ASSERT_EQUAL(64, records[0].arrayLength);
+	CPPUNIT_ASSERT_EQUAL((size_t)64, records[0].arrayValues.size());
+	for (int i = 0; i < 64; i++) {
+		CPPUNIT_ASSERT_EQUAL(values[i], records[0].arrayValues[i]);
+	}
+	CPPUNIT_ASSERT_EQUAL(profile->getTimestamp(), records[0].timestamp);
+	//the first time, the whole array
+	CPPUNIT_ASSERT_EQUAL((size_t)8, records[1].arrayValues.size());
+
+	//then, once that post is acknowledged, only the changed range
+	ranged->acknowledgePost(ranged->getUpdateCount());
+	float update[] = { 2.5f, 3.5f };
+	ranged->setValues(5, update, 2);
+	activemq::commands::ActiveMQBytesMessage rangeMsg;
+	StatusSerializerVisitor rangeSerializer(&rangeMsg);
+	ranged->accept(rangeSerializer);
+	rangeMsg.reset();
+
+	records = LocalGmpStatusDecoder::decode(&rangeMsg);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, records.size());
+	CPPUNIT_ASSERT(records[0].type == type::FLOAT);
+	CPPUNIT_ASSERT_EQUAL(8, records[0].arrayLength);
+	CPPUNIT_ASSERT_EQUAL(5, records[0].arrayFirst);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, records[0].arrayValues.size());
+	CPPUNIT_ASSERT_EQUAL(3.5, records[0].arrayValues[1]);
+
+	//serializing doesn't forget the range, a failed post neither
+	std::vector<pStatusItem> group(1, items[1]);
+	RecordingStatusSender sender;
+	sender.failing = true;
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, sender.postStatusGroup(group));
+	std::vector<unsigned char> bytes;
+	size_t first;
+	long64 timestamp;
+	CPPUNIT_ASSERT_EQUAL((size_t)2, ranged->readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)5, first);
+
+	//a successful one does
+	sender.failing = false;
+	ranged->retryPost();
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, sender.postStatusGroup(group));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, ranged->readChanged(bytes, first, timestamp));
+}
+
+void StatusBatchTest::testPostBatchMode() {
+	RecordingStatusSender sender;
+	sender.setBatchMode(true);
+	CPPUNIT_ASSERT(sender.isBatchMode());
+
+	//clean up whatever is pending
+	sender.postStatus();
+	sender.batches.clear();
+
+	StatusUtil::setValueAsInt("batch-int", 7);
+	StatusUtil::setValueAsDouble("batch-double", 0.5);
+	StatusUtil::setAlarm("batch-alarm", alarm::ALARM_FAILURE, alarm::ALARM_CAUSE_HI);
+
+	//one post, the alarm in a batch of its own ahead of the rest
+	CPPUNIT_ASSERT( sender.postStatus() == status::OK);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender.batches.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, sender.batches[0]);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender.batches[1]);
+	CPPUNIT_ASSERT_EQUAL(0, sender.singlePosts);
+
+	//nothing pending, nothing sent
+	CPPUNIT_ASSERT( sender.postStatus() == status::OK);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender.batches.size());
+}
+
+void StatusBatchTest::testPostSingleMode() {
+	RecordingStatusSender sender;
+	CPPUNIT_ASSERT(!sender.isBatchMode());
+
+	sender.postStatus();
+	sender.singlePosts = 0;
+
+	StatusUtil::setValueAsInt("batch-int", 8);
+	StatusUtil::setValueAsDouble("batch-double", 0.75);
+
+	CPPUNIT_ASSERT( sender.postStatus() == status::OK);
+	CPPUNIT_ASSERT_EQUAL(2, sender.singlePosts);
+	CPPUNIT_ASSERT(sender.batches.empty());
+}
+
+void StatusBatchTest::testDirtyItemsOrder() {
+	RecordingStatusSender sender;
+	sender.postStatus();
+
+	pStatusDatabase db = StatusDatabase::Instance();
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+
+	//changing an item several times queues it only once
+	StatusUtil::setValueAsDouble("batch-double", 1.0);
+	StatusUtil::setValueAsInt("batch-int", 1);
+	StatusUtil::setValueAsDouble("batch-double", 2.0);
+
+	pStatusItem item = db->nextDirtyItem();
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-double"), item->getName());
+	item = db->nextDirtyItem();
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), item->getName());
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+
+	//still dirty, so they are queued again on the next change
+	StatusUtil::setValueAsInt("batch-int", 2);
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), db->nextDirtyItem()->getName());
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+
+	//alarms overtake the items that changed before them
+	StatusUtil::setValueAsInt("batch-int", 3);
+	StatusUtil::setAlarm("batch-alarm", alarm::ALARM_WARNING, alarm::ALARM_CAUSE_HIHI);
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-alarm"), db->nextDirtyItem()->getName());
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), db->nextDirtyItem()->getName());
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+}
+
+void StatusBatchTest::testMaxRate() {
+	RecordingStatusSender sender;
+	sender.postStatus();
+
+	PublishPolicy policy;
+	policy.maxRate = 20; //50 ms between posts
+	CPPUNIT_ASSERT(StatusUtil::setPublishPolicy("batch-int", policy) == status::OK);
+	StatusUtil::setValueAsInt("batch-int", 100);
+	CPPUNIT_ASSERT(sender.postStatus("batch-int") == status::OK);
+	CPPUNIT_ASSERT_EQUAL(1, sender.singlePosts);
+
+	//too soon, deferred but not lost
+	StatusUtil::setValueAsInt("batch-int", 101);
+	CPPUNIT_ASSERT(sender.postStatus("batch-int") == status::OK);
+	StatusUtil::setValueAsInt("batch-int", 102);
+	CPPUNIT_ASSERT(sender.postStatus() == status::OK);
+	CPPUNIT_ASSERT_EQUAL(1, sender.singlePosts);
+
+	//the latest value goes out once the interval expires
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	CPPUNIT_ASSERT_EQUAL(2, sender.singlePosts);
+	CPPUNIT_ASSERT(!StatusDatabase::Instance()->getStatusItem("batch-int")->isChanged());
+
+	CPPUNIT_ASSERT(StatusUtil::setPublishPolicy("batch-int", PublishPolicy()) == status::OK);
+	CPPUNIT_ASSERT(StatusUtil::setPublishPolicy("missing-item", policy) == status::ERROR);
+}
+
+/**
+ * Make the given sender the default one while in scope
+ */
+class DefaultSenderGuard {
+	StatusSenderFactory::StatusSenderType _previous;
+public:
+	DefaultSenderGuard(pStatusSender sender) {
+		pStatusSenderFactory factory = StatusSenderFactory::Instance();
+		_previous = factory->getDefaultSenderType();
+		factory->setStatusSender(StatusSenderFactory::SHARED_SENDER, sender);
+		factory->setDefaultSenderType(StatusSenderFactory::SHARED_SENDER);
+	}
+
+	~DefaultSenderGuard() {
+		pStatusSenderFactory factory = StatusSenderFactory::Instance();
+		factory->setDefaultSenderType(_previous);
+		factory->setStatusSender(StatusSenderFactory::SHARED_SENDER,
+				pStatusSender());
+	}
+};
+
+void StatusBatchTest::testTransaction() {
+	RecordingStatusSender *sender = new RecordingStatusSender();
+	DefaultSenderGuard guard((pStatusSender(sender)));
+	sender->postStatus();
+	pStatusDatabase db = StatusDatabase::Instance();
+	StatusHandle<double> handle = StatusUtil::getHandle<double>("batch-double");
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::beginTransaction());
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::beginTransaction());
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setValueAsInt("batch-int", 100));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, handle.set(9.5));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setAlarm("batch-alarm",
+			alarm::ALARM_WARNING, alarm::ALARM_CAUSE_LO));
+	//wrong type, reported right away
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::setValueAsString("batch-int", "x"));
+
+	//nothing changes until the commit
+	CPPUNIT_ASSERT(db->getStatusItem("batch-int")->getValueAsInt() != 100);
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::commitTransaction());
+	CPPUNIT_ASSERT_EQUAL(100, db->getStatusItem("batch-int")->getValueAsInt());
+	CPPUNIT_ASSERT_EQUAL(9.5, db->getStatusItem("batch-double")->getValueAsDouble());
+
+	//one message, with one timestamp, even if not in batch mode
+	CPPUNIT_ASSERT(!sender->isBatchMode());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, sender->batches.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)3, sender->lastBatch.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), sender->lastBatch[0]->getName());
+	long64 timestamp = sender->lastBatch[0]->getTimestamp();
+	CPPUNIT_ASSERT_EQUAL(timestamp, sender->lastBatch[1]->getTimestamp());
+	CPPUNIT_ASSERT_EQUAL(timestamp, sender->lastBatch[2]->getTimestamp());
+	CPPUNIT_ASSERT_EQUAL(0, sender->singlePosts);
+	//and nothing left to post
+	CPPUNIT_ASSERT(db->nextDirtyItem().get() == 0);
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::commitTransaction());
+
+	//not committed, discarded
+	{
+		StatusTransaction transaction;
+		CPPUNIT_ASSERT(transaction.isOpen());
+		StatusUtil::setValueAsInt("batch-int", 200);
+	}
+	CPPUNIT_ASSERT_EQUAL(100, db->getStatusItem("batch-int")->getValueAsInt());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, sender->batches.size());
+
+	//committed, only the items that changed
+	{
+		StatusTransaction transaction;
+		StatusUtil::setValueAsInt("batch-int", 300);
+		StatusUtil::setValueAsDouble("batch-double", 9.5);
+		CPPUNIT_ASSERT_EQUAL((int)status::OK, transaction.commit());
+		CPPUNIT_ASSERT(!transaction.isOpen());
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t)2, sender->batches.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, sender->lastBatch.size());
+	CPPUNIT_ASSERT_EQUAL(300, db->getStatusItem("batch-int")->getValueAsInt());
+}
+
+void StatusBatchTest::testTransactionFailures() {
+	RecordingStatusSender *sender = new RecordingStatusSender();
+	DefaultSenderGuard guard((pStatusSender(sender)));
+	sender->postStatus();
+	pStatusDatabase db = StatusDatabase::Instance();
+
+	//an item set by an observer during the commit is not part of it,
+	//and is posted as usual
+	int id = StatusUtil::addObserver("batch-int", [](const StatusChange &) {
+		StatusUtil::setValueAsDouble("batch-double", 77.5);
+	});
+	CPPUNIT_ASSERT(id != status::ERROR);
+	StatusUtil::beginTransaction();
+	StatusUtil::setValueAsInt("batch-int", 500);
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::commitTransaction());
+	StatusUtil::removeObserver(id);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, sender->lastBatch.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), sender->lastBatch[0]->getName());
+	pStatusItem dirty = db->nextDirtyItem();
+	CPPUNIT_ASSERT(dirty.get() != 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-double"), dirty->getName());
+	CPPUNIT_ASSERT_EQUAL(77.5, dirty->getValueAsDouble());
+	sender->postStatus();
+
+	//a failed post leaves the items pending
+	sender->failing = true;
+	StatusUtil::beginTransaction();
+	StatusUtil::setValueAsInt("batch-int", 600);
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::commitTransaction());
+	sender->failing = false;
+	dirty = db->nextDirtyItem();
+	CPPUNIT_ASSERT(dirty.get() != 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), dirty->getName());
+	CPPUNIT_ASSERT(dirty->isChanged());
+	sender->postStatus();
+
+	//a change that throws ends the commit; the items changed later
+	//by this thread are not collected for it
+	TransactionLog::begin();
+	TransactionLog::current()->stage(db->getStatusItem("batch-int"), [] {
+		throw PostException("change failed");
+		return (int) status::OK;
+	});
+	CPPUNIT_ASSERT_THROW(TransactionLog::commit(), PostException);
+	StatusUtil::setValueAsInt("batch-int", 700);
+	dirty = db->nextDirtyItem();
+	CPPUNIT_ASSERT(dirty.get() != 0);
+	CPPUNIT_ASSERT_EQUAL(std::string("batch-int"), dirty->getName());
+	sender->postStatus();
+}
+
+void StatusBatchTest::testAutoPost() {
+	RecordingStatusSender *sender = new RecordingStatusSender();
+	DefaultSenderGuard guard((pStatusSender(sender)));
+	sender->postStatus();
+	pStatusDatabase db = StatusDatabase::Instance();
+
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::startAutoPost(0));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::setAutoPostPeriod(
+			"missing-item", 10));
+	//batch-double waits for its own, long, period
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setAutoPostPeriod(
+			"batch-double", 60000));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::setAutoPostGroup(
+			"other", std::vector<std::string>(1, "batch-double"), 10));
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::startAutoPost(10));
+	StatusUtil::setValueAsInt("batch-int", 400);
+	StatusUtil::setValueAsDouble("batch-double", 40.5);
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	StatusUtil::stopAutoPost();
+
+	CPPUNIT_ASSERT_EQUAL(1, sender->singlePosts);
+	CPPUNIT_ASSERT(!db->getStatusItem("batch-int")->isChanged());
+	CPPUNIT_ASSERT(db->getStatusItem("batch-double")->isChanged());
+
+	AutoPostStatistics stats;
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::getAutoPostStatistics(stats));
+	CPPUNIT_ASSERT(stats.posts >= 5);
+	CPPUNIT_ASSERT(stats.maxJitter >= stats.meanJitter);
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::getAutoPostStatistics(
+			stats, "batch-double"));
+	CPPUNIT_ASSERT_EQUAL(0ul, stats.posts);
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, StatusUtil::getAutoPostStatistics(
+			stats, "other"));
+
+	//now the group goes out at its own period
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setAutoPostPeriod(
+			"batch-double", 20));
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::startAutoPost(1000));
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	StatusUtil::stopAutoPost();
+	CPPUNIT_ASSERT_EQUAL(2, sender->singlePosts);
+	CPPUNIT_ASSERT(!db->getStatusItem("batch-double")->isChanged());
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::getAutoPostStatistics(
+			stats, "batch-double"));
+	CPPUNIT_ASSERT(stats.posts >= 2);
+
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, StatusUtil::setAutoPostPeriod(
+			"batch-double", 0));
+}
+
+}
@@ -0,0 +1,49 @@
+/*
+ * StatusBatchTest.h
+ */
+
+#ifndef STATUSBATCHTEST_H_
+#define STATUSBATCHTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class StatusBatchTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( StatusBatchTest );
+
+	CPPUNIT_TEST( testSerializeSingleItem );
+	CPPUNIT_TEST( testSerializeBatch );
+	CPPUNIT_TEST( testSerializeArray );
+	CPPUNIT_TEST( testPostBatchMode );
+	CPPUNIT_TEST( testPostSingleMode );
+	CPPUNIT_TEST( testDirtyItemsOrder );
+	CPPUNIT_TEST( testMaxRate );
+	CPPUNIT_TEST( testTransaction );
+	CPPUNIT_TEST( testTransactionFailures );
+	CPPUNIT_TEST( testAutoPost );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testSerializeSingleItem();
+	void testSerializeBatch();
+	void testSerializeArray();
+	void testPostBatchMode();
+	void testPostSingleMode();
+	void testDirtyItemsOrder();
+	void testMaxRate();
+	void testTransaction();
+	void testTransactionFailures();
+	void testAutoPost();
+
+	virtual ~StatusBatchTest();
+};
+
+}
+#endif /* STATUSBATCHTEST_H_ */
@@ -0,0 +1,228 @@
+/*
+ * StatusItemTest.cpp
+ */
+
+#include "StatusItemTest.h"
+
+#include <typeinfo>
+#include <thread>
+#include <vector>
+#include <giapi/giapi.h>
+#include <status/StatusItem.h>
+#include <status/ArrayStatusItem.h>
+
+namespace giapi {
+
+/**
+ * Each writer stores values that encode the writer id, so a
+ * torn read can be detected
+ */
+static void writeValues(StatusItem *item, int writer, int count) {
+	for (int i = 0; i < count; i++) {
+		item->setValueAsDouble(writer * 1000000.0 + i);
+	}
+}
+
+StatusItemTest::~StatusItemTest() {
+}
+
+void StatusItemTest::setUp() {
+}
+
+void StatusItemTest::tearDown() {
+}
+
+void StatusItemTest::testInitialValues() {
+	StatusItem intItem("int-item", type::INT);
+	StatusItem doubleItem("double-item", type::DOUBLE);
+	StatusItem floatItem("float-item", type::FLOAT);
+	StatusItem stringItem("string-item", type::STRING);
+
+	CPPUNIT_ASSERT_EQUAL(0, intItem.getValueAsInt());
+	CPPUNIT_ASSERT_EQUAL(0.0, doubleItem.getValueAsDouble());
+	CPPUNIT_ASSERT_EQUAL(0.0f, floatItem.getValueAsFloat());
+	CPPUNIT_ASSERT_EQUAL(std::string(" "), stringItem.getValueAsString());
+	//new items are dirty
+	CPPUNIT_ASSERT(intItem.isChanged());
+}
+
+void StatusItemTest::testSetValues() {
+	StatusItem item("double-item", type::DOUBLE);
+	item.clearChanged();
+
+	CPPUNIT_ASSERT(item.setValueAsDouble(2.5) == status::OK);
+	CPPUNIT_ASSERT_EQUAL(2.5, item.getValueAsDouble());
+	CPPUNIT_ASSERT(item.isChanged());
+
+	//same value, the item stays clean
+	item.clearChanged();
+	CPPUNIT_ASSERT(item.setValueAsDouble(2.5) == status::OK);
+	CPPUNIT_ASSERT(!item.isChanged());
+}
+
+void StatusItemTest::testWrongType() {
+	StatusItem item("int-item", type::INT);
+	item.setValueAsInt(12);
+
+	CPPUNIT_ASSERT(item.setValueAsDouble(1.0) == status::ERROR);
+	CPPUNIT_ASSERT(item.setValueAsString("12") == status::ERROR);
+	//the value is not modified
+	CPPUNIT_ASSERT_EQUAL(12, item.getValueAsInt());
+	CPPUNIT_ASSERT_THROW(item.getValueAsDouble(), std::bad_cast);
+	CPPUNIT_ASSERT_THROW(item.getValueAsString(), std::bad_cast);
+}
+
+void StatusItemTest::testStringValues() {
+	StatusItem item("string-item", type::STRING);
+	std::string longValue(200, 'x');
+
+	CPPUNIT_ASSERT(item.setValueAsString("short") == status::OK);
+	CPPUNIT_ASSERT_EQUAL(std::string("short"), item.getValueAsString());
+	CPPUNIT_ASSERT(item.setValueAsString(longValue) == status::OK);
+	CPPUNIT_ASSERT_EQUAL(longValue, item.getValueAsString());
+	CPPUNIT_ASSERT(item.setValueAsString("") == status::OK);
+	CPPUNIT_ASSERT(item.getValueAsString().empty());
+}
+
+void StatusItemTest::testConcurrentWriters() {
+	const int WRITERS = 4;
+	const int COUNT = 20000;
+	StatusItem item("concurrent-item", type::DOUBLE);
+
+	std::vector<std::thread> writers;
+	for (int w = 1; w <= WRITERS; w++) {
+		writers.push_back(std::thread(writeValues, &item, w, COUNT));
+	}
+
+	//every value read must be one of the values written
+	double value;
+	long64 timestamp;
+	for (int i = 0; i < COUNT; i++) {
+		item.readValue(value, timestamp);
+		int writer = (int) (value / 1000000.0);
+		CPPUNIT_ASSERT(value == 0.0 || (writer >= 1 && writer <= WRITERS));
+		CPPUNIT_ASSERT(timestamp > 0);
+	}
+
+	for (int w = 0; w < WRITERS; w++) {
+		writers[w].join();
+	}
+	CPPUNIT_ASSERT(item.takeChanged());
+	CPPUNIT_ASSERT(!item.takeChanged());
+}
+
+void StatusItemTest::testDeadband() {
+	StatusItem item("temperature", type::DOUBLE);
+	PublishPolicy policy;
+	policy.absoluteDeadband = 0.5;
+	item.setPublishPolicy(policy);
+
+	CPPUNIT_ASSERT(item.setValueAsDouble(20.0) == status::OK);
+	item.clearChanged();
+
+	//small changes are stored, but the item stays clean
+	CPPUNIT_ASSERT(item.setValueAsDouble(20.3) == status::OK);
+	CPPUNIT_ASSERT_EQUAL(20.3, item.getValueAsDouble());
+	CPPUNIT_ASSERT(!item.isChanged());
+	//measured against the last published value, not the last one set
+	CPPUNIT_ASSERT(item.setValueAsDouble(20.6) == status::OK);
+	CPPUNIT_ASSERT(item.isChanged());
+
+	//relative deadband, 10% of the last published value
+	policy.absoluteDeadband = 0;
+	policy.relativeDeadband = 0.1;
+	item.setPublishPolicy(policy);
+	item.clearChanged();
+	CPPUNIT_ASSERT(item.setValueAsDouble(22.0) == status::OK);
+	CPPUNIT_ASSERT(!item.isChanged());
+	CPPUNIT_ASSERT(item.setValueAsDouble(22.7) == status::OK);
+	CPPUNIT_ASSERT(item.isChanged());
+}
+
+void StatusItemTest::testArrayValues() {
+	ArrayStatusItem item("array-item", type::DOUBLE, 8);
+	CPPUNIT_ASSERT_EQUAL((size_t)8, item.getLength());
+	item.clearChanged();
+
+	double values[8];
+	long64 timestamp;
+	item.readValues(values, timestamp);
+	for (int i = 0; i < 8; i++) {
+		CPPUNIT_ASSERT_EQUAL(0.0, values[i]);
+	}
+
+	double update[] = { 1.5, 2.5, 3.5 };
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, item.setValues(2, update, 3));
+	CPPUNIT_ASSERT(item.isChanged());
+	item.readValues(values, timestamp);
+	CPPUNIT_ASSERT_EQUAL(0.0, values[1]);
+	CPPUNIT_ASSERT_EQUAL(1.5, values[2]);
+	CPPUNIT_ASSERT_EQUAL(3.5, values[4]);
+	CPPUNIT_ASSERT_EQUAL(0.0, values[5]);
+
+	//same values, not marked
+	item.clearChanged();
+	CPPUNIT_ASSERT_EQUAL((int)status::OK, item.setValues(2, update, 3));
+	CPPUNIT_ASSERT(!item.isChanged());
+
+	//out of range, wrong type or scalar values
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, item.setValues(6, update, 3));
+	int intUpdate[] = { 1 };
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, item.setValues(0, intUpdate, 1));
+	CPPUNIT_ASSERT_EQUAL((int)status::ERROR, item.setValueAsDouble(1.0));
+	CPPUNIT_ASSERT(!item.isChanged());
+
+	int intValues[8];
+	CPPUNIT_ASSERT_THROW(item.readValues(intValues, timestamp), std::bad_cast);
+}
+
+void StatusItemTest::testArrayChangedRange() {
+	ArrayStatusItem ranged("ranged-array", type::INT, 16, true);
+	std::vector<unsigned char> bytes;
+	size_t first;
+	long64 timestamp;
+
+	//the whole array the first time
+	CPPUNIT_ASSERT_EQUAL((size_t)16, ranged.readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, first);
+	CPPUNIT_ASSERT_EQUAL((size_t)64, bytes.size());
+	//until a post is acknowledged
+	CPPUNIT_ASSERT_EQUAL((size_t)16, ranged.readChanged(bytes, first, timestamp));
+	ranged.acknowledgePost(ranged.getUpdateCount());
+
+	//then only the elements that actually changed
+	int update[] = { 0, 7, 8, 0 };
+	ranged.setValues(3, update, 4);
+	int other[] = { 9 };
+	ranged.setValues(10, other, 1);
+	CPPUNIT_ASSERT_EQUAL((size_t)7, ranged.readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, first);
+	//in network byte order
+	CPPUNIT_ASSERT_EQUAL(28, (int)bytes.size());
+	CPPUNIT_ASSERT_EQUAL(7, (int)bytes[3]);
+	CPPUNIT_ASSERT_EQUAL(8, (int)bytes[7]);
+	CPPUNIT_ASSERT_EQUAL(9, (int)bytes[27]);
+
+	//a post that failed, or changes made after the elements were
+	//read, keep the range
+	unsigned long updates = ranged.getUpdateCount();
+	CPPUNIT_ASSERT_EQUAL((size_t)7, ranged.readChanged(bytes, first, timestamp));
+	int late[] = { 5 };
+	ranged.setValues(12, late, 1);
+	ranged.acknowledgePost(updates);
+	CPPUNIT_ASSERT_EQUAL((size_t)9, ranged.readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, first);
+
+	ranged.acknowledgePost(ranged.getUpdateCount());
+	CPPUNIT_ASSERT_EQUAL((size_t)0, ranged.readChanged(bytes, first, timestamp));
+
+	//without range updates, always the whole array
+	ArrayStatusItem whole("whole-array", type::FLOAT, 4);
+	float value[] = { 1.0f };
+	whole.setValues(1, value, 1);
+	CPPUNIT_ASSERT_EQUAL((size_t)4, whole.readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)4, whole.readChanged(bytes, first, timestamp));
+	CPPUNIT_ASSERT_EQUAL((size_t)0, first);
+}
+
+}
@@ -0,0 +1,45 @@
+/*
+ * StatusItemTest.h
+ */
+
+#ifndef STATUSITEMTEST_H_
+#define STATUSITEMTEST_H_
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class StatusItemTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( StatusItemTest );
+
+	CPPUNIT_TEST( testInitialValues );
+	CPPUNIT_TEST( testSetValues );
+	CPPUNIT_TEST( testWrongType );
+	CPPUNIT_TEST( testStringValues );
+	CPPUNIT_TEST( testConcurrentWriters );
+	CPPUNIT_TEST( testDeadband );
+	CPPUNIT_TEST( testArrayValues );
+	CPPUNIT_TEST( testArrayChangedRange );
+
+	CPPUNIT_TEST_SUITE_END();
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testInitialValues();
+	void testSetValues();
+	void testWrongType();
+	void testStringValues();
+	void testConcurrentWriters();
+	void testDeadband();
+	void testArrayValues();
+	void testArrayChangedRange();
+
+	virtual ~StatusItemTest();
+};
+
+}
+#endif /* STATUSITEMTEST_H_ */
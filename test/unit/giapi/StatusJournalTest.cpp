@@ -0,0 +1,185 @@
+/*
+ * StatusJournalTest.cpp
+ */
+
+#include "StatusJournalTest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+
+#include <giapi/giapi.h>
+
+#include <status/StatusItem.h>
+#include <status/AlarmStatusItem.h>
+#include <status/HealthStatusItem.h>
+#include <status/senders/AbstractStatusSender.h>
+#include <status/senders/JournalStatusSender.h>
+#include <status/journal/StatusJournal.h>
+#include <status/journal/StatusJournalReader.h>
+#include <status/journal/StatusReplayer.h>
+
+namespace giapi {
+
+/**
+ * A status sender that keeps the names and int values it posts
+ */
+class ReplayedStatusSender : public AbstractStatusSender {
+public:
+	std::vector<std::string> names;
+	std::vector<int> values;
+	std::vector<long64> timestamps;
+
+protected:
+	int postStatus(pStatusItem item) const throw (PostException) {
+		ReplayedStatusSender *self = const_cast<ReplayedStatusSender *> (this);
+		self->names.push_back(item->getName());
+		self->values.push_back(item->getStatusType() == type::INT
+				? item->getValueAsInt() : 0);
+		self->timestamps.push_back(item->getTimestamp());
+		return status::OK;
+	}
+};
+
+StatusJournalTest::~StatusJournalTest() {
+}
+
+void StatusJournalTest::setUp() {
+	std::ostringstream name;
+	name << "/tmp/giapi-journal-test-" << getpid();
+	_path = name.str();
+	std::remove(_path.c_str());
+}
+
+void StatusJournalTest::tearDown() {
+	std::remove(_path.c_str());
+}
+
+void StatusJournalTest::testRecord() {
+	pStatusItem number(new StatusItem("journal:int", type::INT));
+	pStatusItem text(new StatusItem("journal:string", type::STRING));
+	AlarmStatusItem *alarmItem = new AlarmStatusItem("journal:alarm", type::DOUBLE);
+	pStatusItem alarm(alarmItem);
+	HealthStatusItem *healthItem = new HealthStatusItem("journal:health");
+	pStatusItem health(healthItem);
+	long64 firstTimestamp;
+	{
+		JournalStatusSender sender(pStatusJournal(new StatusJournal(_path)));
+		number->setValueAsInt(7);
+		firstTimestamp = number->getTimestamp();
+		sender.postStatusItem(number);
+		text->setValueAsString("parked");
+		sender.postStatusItem(text);
+		alarm->setValueAsDouble(2.5);
+		alarmItem->setAlarmState(alarm::ALARM_WARNING, alarm::ALARM_CAUSE_OTHER,
+				"too warm");
+		sender.postStatusItem(alarm);
+		healthItem->setHealth(health::BAD);
+		sender.postStatusItem(health);
+		number->setValueAsInt(8);
+		sender.postStatusItem(number);
+		//not changed, not recorded
+		sender.postStatusItem(number);
+		CPPUNIT_ASSERT_EQUAL(5UL, sender.getJournal()->getRecordCount());
+	}
+
+	StatusJournalReader reader(_path);
+	JournalRecord record;
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT_EQUAL(std::string("journal:int"), record.name);
+	CPPUNIT_ASSERT_EQUAL(7, record.intValue);
+	CPPUNIT_ASSERT_EQUAL(firstTimestamp, record.timestamp);
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT_EQUAL(std::string("parked"), record.stringValue);
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT(record.kind == StatusItemSpec::ALARM);
+	CPPUNIT_ASSERT_EQUAL(2.5, record.doubleValue);
+	CPPUNIT_ASSERT(record.severity == alarm::ALARM_WARNING);
+	CPPUNIT_ASSERT(record.cause == alarm::ALARM_CAUSE_OTHER);
+	CPPUNIT_ASSERT_EQUAL(std::string("too warm"), record.message);
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT(record.kind == StatusItemSpec::HEALTH);
+	CPPUNIT_ASSERT_EQUAL((int) health::BAD, record.intValue);
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT_EQUAL(std::string("journal:int"), record.name);
+	CPPUNIT_ASSERT_EQUAL(8, record.intValue);
+	CPPUNIT_ASSERT(!reader.next(record));
+
+	reader.rewind();
+	CPPUNIT_ASSERT(reader.next(record));
+	CPPUNIT_ASSERT_EQUAL(7, record.intValue);
+}
+
+void StatusJournalTest::testAppend() {
+	JournalRecord record;
+	record.name = "journal:first";
+	record.intValue = 1;
+	{
+		StatusJournal journal(_path);
+		CPPUNIT_ASSERT(journal.append(record) == status::OK);
+	}
+	{
+		//the names of the existing records are reused
+		StatusJournal journal(_path);
+		record.name = "journal:second";
+		record.intValue = 2;
+		CPPUNIT_ASSERT(journal.append(record) == status::OK);
+		record.name = "journal:first";
+		record.intValue = 3;
+		//bigger than the file, which has to grow
+		record.type = type::STRING;
+		record.stringValue.assign(2 << 20, 'x');
+		CPPUNIT_ASSERT(journal.append(record) == status::OK);
+	}
+
+	StatusJournalReader reader(_path);
+	std::vector<std::string> names;
+	while (reader.next(record)) {
+		names.push_back(record.name);
+	}
+	CPPUNIT_ASSERT_EQUAL((size_t) 3, names.size());
+	CPPUNIT_ASSERT_EQUAL(std::string("journal:first"), names[0]);
+	CPPUNIT_ASSERT_EQUAL(std::string("journal:second"), names[1]);
+	CPPUNIT_ASSERT_EQUAL(std::string("journal:first"), names[2]);
+	CPPUNIT_ASSERT_EQUAL((size_t) 2 << 20, record.stringValue.size());
+
+	//not a journal
+	CPPUNIT_ASSERT_THROW(StatusJournalReader("/dev/null"), GiapiException);
+}
+
+void StatusJournalTest::testReplay() {
+	{
+		StatusJournal journal(_path);
+		JournalRecord record;
+		record.name = "journal:replay";
+		for (int i = 0; i < 5; i++) {
+			//100 ms apart
+			record.intValue = i % 2;
+			record.timestamp = 1000000 + i * 100;
+			journal.append(record);
+		}
+	}
+
+	//as fast as possible
+	std::tr1::shared_ptr<ReplayedStatusSender> sender(new ReplayedStatusSender());
+	StatusReplayer replayer(_path, sender);
+	CPPUNIT_ASSERT_EQUAL(5, replayer.replay(0));
+	CPPUNIT_ASSERT_EQUAL((size_t) 5, sender->values.size());
+	CPPUNIT_ASSERT_EQUAL(1, sender->values[3]);
+	CPPUNIT_ASSERT_EQUAL((long64) 1000400, sender->timestamps[4]);
+
+	//ten times faster than recorded: 40 ms. The first value is the
+	//same the item has from the previous replay, and is posted anyway
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	CPPUNIT_ASSERT_EQUAL(5, replayer.replay(10));
+	long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - start).count();
+	CPPUNIT_ASSERT(elapsed >= 35 && elapsed < 400);
+	CPPUNIT_ASSERT_EQUAL((size_t) 10, sender->values.size());
+}
+
+}
@@ -0,0 +1,38 @@
+/*
+ * StatusJournalTest.h
+ */
+
+#ifndef STATUSJOURNALTEST_H_
+#define STATUSJOURNALTEST_H_
+
+#include <string>
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace giapi {
+
+class StatusJournalTest : public CppUnit::TestFixture {
+
+	CPPUNIT_TEST_SUITE( StatusJournalTest );
+
+	CPPUNIT_TEST( testRecord );
+	CPPUNIT_TEST( testAppend );
+	CPPUNIT_TEST( testReplay );
+
+	CPPUNIT_TEST_SUITE_END();
+
+	std::string _path;
+
+public:
+	void setUp();
+
+	void tearDown();
+
+	void testRecord();
+	void testAppend();
+	void testReplay();
+
+	virtual ~StatusJournalTest();
+};
+
+}
+#endif /* STATUSJOURNALTEST_H_ */
@@ -14,3 +14,37 @@ CPPUNIT_TEST_SUITE_REGISTRATION( giapi::GiapiStatusTest );
 #include <giapi/GiapiCommandsTest.h>
 CPPUNIT_TEST_SUITE_REGISTRATION( giapi::GiapiCommandsTest );
 
+#include <giapi/StatusBatchTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusBatchTest );
+
+#include <giapi/StatusItemTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusItemTest );
+
+#include <giapi/AsyncStatusSenderTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::AsyncStatusSenderTest );
+
+#include <giapi/SharedStatusTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::SharedStatusTest );
+
+#include <giapi/CompactStatusTableTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::CompactStatusTableTest );
+
+#include <giapi/StatusJournalTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::StatusJournalTest );
+
+#include <giapi/CompositeStatusSenderTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::CompositeStatusSenderTest );
+
+#include <giapi/OrderedExecutorTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::OrderedExecutorTest );
+#include <giapi/AsyncCommandTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::AsyncCommandTest );
+
+#include <giapi/CommandRoutingTableTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::CommandRoutingTableTest );
+
+#include <giapi/CommandDispatcherTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::CommandDispatcherTest );
+
+#include <giapi/ConfigurationTest.h>
+CPPUNIT_TEST_SUITE_REGISTRATION( giapi::ConfigurationTest );